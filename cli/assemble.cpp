@@ -0,0 +1,177 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 21:16:29 PDT 2026
+// Last Modified: Sun Oct 18 21:16:29 PDT 2026
+// Filename:      ...sig/examples/all/assemble.cpp
+// Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/assemble.cpp
+// Syntax:        C++; museinfo
+//
+// Description:   Join Humdrum files side by side, lining up their data
+//                lines by rhythmic position with HumdrumFile::assemble().
+//                The -f option uses only one spine of each input file.
+//
+
+#include "humdrum.h"
+
+#include <string.h>
+
+#include <iostream>
+
+using namespace std;
+
+
+// function declarations:
+void      checkOptions          (Options& opts, int argc, char** argv);
+void      example               (void);
+void      usage                 (const char* command);
+void      prepareInput          (HumdrumFile& piece, HumdrumFile& infile);
+
+// User interface variables:
+Options   options;
+int       field = 0;             // used with -f option
+
+//////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   checkOptions(options, argc, argv);
+   HumdrumStream streamer(options);
+
+   Array<HumdrumFile*> pieces;
+   pieces.setSize(0);
+   HumdrumFile infile;
+   while (streamer.read(infile)) {
+      HumdrumFile* piece = new HumdrumFile;
+      prepareInput(*piece, infile);
+      pieces.append(piece);
+   }
+
+   if (pieces.getSize() == 0) {
+      // nothing to do
+      exit(1);
+   }
+
+   HumdrumFile output;
+   int status = HumdrumFile::assemble(output, pieces.getSize(),
+         pieces.getBase());
+   cout << output;
+
+   for (int i=0; i<pieces.getSize(); i++) {
+      delete pieces[i];
+      pieces[i] = NULL;
+   }
+
+   if (!status) {
+      cerr << "Error: the inputs could not be lined up" << endl;
+      exit(1);
+   }
+
+   return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// prepareInput -- copy an input file for assembly.  With the -f option
+//     only the given spine is copied, and data lines which then contain
+//     only null tokens are removed.
+//
+
+void prepareInput(HumdrumFile& piece, HumdrumFile& infile) {
+   if (field == 0) {
+      piece = infile;
+   } else {
+      HumdrumFile spine = infile.extract(field > 0 ? field - 1 : field);
+      // the rhythm of the extracted spine must match the whole input:
+      spine.analyzeRhythm("4");
+      infile.analyzeRhythm("4");
+      if (spine.getTotalDurationR() != infile.getTotalDurationR()) {
+         cerr << "Error: spine " << field << " of "
+              << infile.getFilename() << " has the wrong duration" << endl;
+         exit(1);
+      }
+      piece = spine.removeNullRecords();
+      piece.analyzeSpines();
+      piece.analyzeDots();
+   }
+   piece.analyzeRhythm("4");
+}
+
+
+
+//////////////////////////////
+//
+// checkOptions --
+//
+
+void checkOptions(Options& opts, int argc, char* argv[]) {
+   opts.define("f|field=i:0", "use only the given spine of each input");
+
+   opts.define("author=b",  "author of program");
+   opts.define("version=b", "compilation info");
+   opts.define("example=b", "example usages");
+   opts.define("h|help=b",  "short description");
+   opts.process(argc, argv);
+
+   // handle basic options:
+   if (opts.getBoolean("author")) {
+      cout << "Written by Craig Stuart Sapp, "
+           << "craig@ccrma.stanford.edu, October 2026" << endl;
+      exit(0);
+   } else if (opts.getBoolean("version")) {
+      cout << argv[0] << ", version: 18 October 2026" << endl;
+      cout << "compiled: " << __DATE__ << endl;
+      cout << MUSEINFO_VERSION << endl;
+      exit(0);
+   } else if (opts.getBoolean("help")) {
+      usage(opts.getCommand().data());
+      exit(0);
+   } else if (opts.getBoolean("example")) {
+      example();
+      exit(0);
+   }
+
+   field = opts.getInteger("field");
+}
+
+
+
+//////////////////////////////
+//
+// example --
+//
+
+void example(void) {
+   cout <<
+   "                                                                        \n"
+   "# join the top spines of two files:                                     \n"
+   "     assemble -f -1 file1.krn file2.krn                                 \n"
+   "                                                                        \n"
+   << endl;
+}
+
+
+
+//////////////////////////////
+//
+// usage --
+//
+
+void usage(const char* command) {
+   cout <<
+   "                                                                        \n"
+   "Join Humdrum files side by side, lining up their data lines by rhythm.  \n"
+   "                                                                        \n"
+   "Usage: " << command << " [-f field] input1 input2 [input3 ...]\n"
+   "                                                                        \n"
+   "Options:                                                                \n"
+   "   -f field  = use only the given spine of each input (1 = first spine, \n"
+   "               -1 = last spine).  Spines must not split or join.        \n"
+   "   --options = list of all options, aliases and default values          \n"
+   "                                                                        \n"
+   << endl;
+}
+
+
+
@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Sep 16 13:53:47 PDT 2013
 // Last Modified: Thu Sep 19 16:10:27 PDT 2013
+// Last Modified: Sun Oct 18 16:55:16 PDT 2026 Added --frequency option
 // Filename:      ...museinfo/examples/all/cint.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/cint.cpp
 // Syntax:        C++; museinfo
@@ -14,10 +15,14 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "humdrum.h"
@@ -65,6 +70,13 @@ class NoteNode {
 };
 
 
+// Interval modules are stored for counting as a string of 16-bit interval
+// codes (see getModuleKey()), which fit into the short-string buffer for
+// the usual module lengths.
+typedef u16string ModuleKey;
+typedef unordered_map<ModuleKey, int> ModuleCounts;
+
+
 NoteNode::NoteNode(NoteNode& anode) {
 	b40          = anode.b40;
 	line         = anode.line;
@@ -173,6 +185,18 @@ void      printLattice         (vector<vector<NoteNode> >& notes,
 void      printSpacer          (ostream& out);
 int       printInterval        (ostream& out, NoteNode& note1, NoteNode& note2,
                                 int type, int octaveadjust = 0);
+int       getIntervalCode      (NoteNode& note1, NoteNode& note2, int type,
+                                int octaveadjust, int& cross);
+void      printIntervalCode    (ostream& out, int code);
+int       getModuleKey         (ModuleKey& key,
+                                vector<vector<NoteNode> >& notes, int n,
+                                int startline, int part1, int part2);
+void      countModules         (ModuleCounts& counts, HumdrumFile& infile,
+                                vector<vector<NoteNode> >& notes, int n);
+char16_t  getModuleKeyUnit     (int code);
+int       getModuleKeyCode     (char16_t unit);
+void      printModuleKey       (ostream& out, const ModuleKey& key);
+void      printModuleFrequencies(ostream& out, ModuleCounts& counts);
 int       printLatticeItem     (vector<vector<NoteNode> >& notes, int n,
                                 int currentindex, int fileline);
 int       printLatticeItemRows (vector<vector<NoteNode> >& notes, int n,
@@ -272,6 +296,9 @@ int       suspensionsQ = 0;      // used with --suspensions option
 int       uncrossQ     = 0;      // used with -c option
 int       retroQ       = 0;      // used with --retro option
 int       idQ          = 0;      // used with --id option
+int       frequencyQ   = 0;      // used with --frequency option
+int       threads      = 1;      // used with -j option
+ModuleCounts Modulecounts;       // used with --frequency option
 vector<string> Ids;              // used with --id option
 string    NoteMarker;            // used with -N option
 PerlRegularExpression SearchString;
@@ -306,6 +333,10 @@ int main(int argc, char** argv) {
 		cout << totalcount << endl;
 	}
 
+	if (frequencyQ) {
+		printModuleFrequencies(cout, Modulecounts);
+	}
+
 }
 
 
@@ -359,6 +390,11 @@ int processFile(HumdrumFile& infile, const string& filename, Options& options) {
 		exit(0);
 	}
 
+	if (frequencyQ) {
+		countModules(Modulecounts, infile, notes, Chaincount);
+		return 0;
+	}
+
 	int count = 0;
 	if (latticeQ) {
 		printLattice(notes, infile, ktracks, reverselookup, Chaincount);
@@ -1402,6 +1438,336 @@ int printCombinationModule(ostream& out, const string& filename,
 
 
 
+//////////////////////////////
+//
+// getModuleKey -- Store a counterpoint module as a string of interval
+//    codes for counting with the --frequency option.  The module
+//    chain is followed in the same way as printCombinationModule(),
+//    and the intervals are stored in the order that they would be
+//    printed: the first harmonic interval, then for each following
+//    sonority the bottom (and/or top) melodic interval followed by the
+//    harmonic interval.  Returns 0 if there is no complete module at
+//    the given position.
+//
+
+int getModuleKey(ModuleKey& key, vector<vector<NoteNode> >& notes, int n,
+		int startline, int part1, int part2) {
+	key.clear();
+
+	if ((int)notes.size() == 0) {
+		return 0;
+	}
+	if (n + startline >= (int)notes[0].size()) {
+		return 0;
+	}
+	if (norestsQ) {
+		if ((notes[part1][startline].b40 == 0) ||
+				(notes[part2][startline].b40 == 0)) {
+			return 0;
+		}
+	}
+	if ((notes[part1][startline].b40 <= 0) &&
+			(notes[part2][startline].b40 <= 0)) {
+		return 0;
+	}
+
+	int octaveadjust = 0;
+	if (octaveQ) {
+		octaveadjust = getOctaveAdjustForCombinationModule(notes, n, startline,
+				part1, part2);
+	}
+
+	int i;
+	int cross;
+	int count = 0;
+	int countm = 0;
+	int attackcount = 0;
+	int lastindex = -1;
+	int retroline = 0;
+
+	for (i=startline; i<(int)notes[0].size(); i++) {
+		if ((notes[part1][i].b40 <= 0) && (notes[part2][i].b40 <= 0)) {
+			continue;
+		}
+		if (norestsQ) {
+			if ((notes[part1][i].b40 == 0) || (notes[part2][i].b40 == 0)) {
+				return 0;
+			}
+		}
+		if (attackQ && ((notes[part1][i].b40 <= 0) ||
+					(notes[part2][i].b40 <= 0))) {
+			if (attackcount == 0) {
+				return 0;
+			}
+		}
+
+		if ((count > 0) && !nomelodicQ) {
+			if (nounisonsQ) {
+				if ((notes[part1][i].b40 != 0) &&
+					(abs(notes[part1][i].b40) == abs(notes[part1][lastindex].b40))) {
+					return 0;
+				}
+				if ((notes[part2][i].b40 != 0) &&
+					(abs(notes[part2][i].b40) == abs(notes[part2][lastindex].b40))) {
+					return 0;
+				}
+			}
+			if (!toponlyQ) {
+				key += getModuleKeyUnit(getIntervalCode(notes[part1][lastindex],
+						notes[part1][i], INTERVAL_MELODIC, 0, cross));
+			}
+			if (topQ || toponlyQ) {
+				key += getModuleKeyUnit(getIntervalCode(notes[part2][lastindex],
+						notes[part2][i], INTERVAL_MELODIC, 0, cross));
+			}
+		}
+
+		countm++;
+
+		if (!noharmonicQ) {
+			key += getModuleKeyUnit(getIntervalCode(notes[part1][i],
+					notes[part2][i], INTERVAL_HARMONIC, octaveadjust, cross));
+		}
+
+		if ((count == n) && !attackQ) {
+			retroline = i;
+			break;
+		}
+		lastindex = i;
+		count++;
+
+		if ((notes[part1][i].b40 > 0) && (notes[part2][i].b40 > 0)) {
+			if (attackcount >= n) {
+				retroline = i;
+				break;
+			} else {
+				attackcount++;
+			}
+		}
+	}
+
+	if (attackQ && (attackcount == n)) {
+		return retroline;
+	} else if ((countm>1) && (count == n)) {
+		return retroline;
+	} else if (n == 0) {
+		return retroline;
+	}
+
+	return 0;
+}
+
+
+
+//////////////////////////////
+//
+// getModuleKeyUnit -- Convert an interval code into a ModuleKey
+//     character.  Rests are stored as 0.
+//
+
+char16_t getModuleKeyUnit(int code) {
+	if (code == RESTINT) {
+		return 0;
+	}
+	if (code <= -0x8000) {
+		code = -0x7fff;
+	} else if (code > 0x7fff) {
+		code = 0x7fff;
+	}
+	return (char16_t)(code + 0x8000);
+}
+
+
+
+//////////////////////////////
+//
+// countModules -- Count all modules for all pairs of voices in the
+//    file.  Voice pairs are processed in parallel with the -j option.
+//
+
+void countModules(ModuleCounts& counts, HumdrumFile& infile,
+		vector<vector<NoteNode> >& notes, int n) {
+	vector<int> part1s;
+	vector<int> part2s;
+	int i, j;
+	for (i=0; i<(int)notes.size(); i++) {
+		for (j=i+1; j<(int)notes.size(); j++) {
+			part1s.push_back(i);
+			part2s.push_back(j);
+		}
+	}
+	int paircount = (int)part1s.size();
+	if (paircount == 0) {
+		return;
+	}
+
+	// only modules starting on data lines are counted (not on the
+	// rests inserted at double barlines).
+	vector<int> starts;
+	for (i=0; i<(int)notes[0].size(); i++) {
+		if (infile[notes[0][i].line].isData()) {
+			starts.push_back(i);
+		}
+	}
+
+	int tcount = threads;
+	if (tcount <= 0) {
+		tcount = thread::hardware_concurrency();
+	}
+	if (tcount > paircount) {
+		tcount = paircount;
+	}
+	if (tcount < 1) {
+		tcount = 1;
+	}
+
+	vector<ModuleCounts> localcounts(tcount);
+	atomic<int> next(0);
+	auto worker = [&](int t) {
+		ModuleKey key;
+		int index;
+		int k;
+		while ((index = next++) < paircount) {
+			for (k=0; k<(int)starts.size(); k++) {
+				if (getModuleKey(key, notes, n, starts[k], part1s[index],
+						part2s[index])) {
+					localcounts[t][key]++;
+				}
+			}
+		}
+	};
+
+	if (tcount == 1) {
+		worker(0);
+	} else {
+		vector<thread> workers;
+		for (i=0; i<tcount; i++) {
+			workers.emplace_back(worker, i);
+		}
+		for (i=0; i<(int)workers.size(); i++) {
+			workers[i].join();
+		}
+	}
+
+	for (i=0; i<(int)localcounts.size(); i++) {
+		for (auto& entry : localcounts[i]) {
+			counts[entry.first] += entry.second;
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// printModuleKey -- Print a module in the same format as
+//    printCombinationModule().
+//
+
+void printModuleKey(ostream& out, const ModuleKey& key) {
+	int melodiccount = 0;
+	if (!nomelodicQ) {
+		if (!toponlyQ) {
+			melodiccount++;
+		}
+		if (topQ || toponlyQ) {
+			melodiccount++;
+		}
+	}
+	int harmoniccount = noharmonicQ ? 0 : 1;
+	int itemsize = melodiccount + harmoniccount;
+
+	if (parenQ) {
+		out << "(";
+	}
+	int index = 0;
+	int item = 0;
+	while (index < (int)key.size()) {
+		if ((item > 0) && (melodiccount > 0)) {
+			if (mparenQ) {
+				out << "{";
+			}
+			for (int m=0; m<melodiccount; m++) {
+				if (m > 0) {
+					printSpacer(out);
+				}
+				printIntervalCode(out, getModuleKeyCode(key[index++]));
+				if (mmarkerQ) {
+					out << "m";
+				}
+			}
+			if (mparenQ) {
+				out << "}";
+			}
+			printSpacer(out);
+		}
+		if (harmoniccount) {
+			if (hparenQ) {
+				out << "[";
+			}
+			printIntervalCode(out, getModuleKeyCode(key[index++]));
+			if (hmarkerQ) {
+				out << "h";
+			}
+			if (hparenQ) {
+				out << "]";
+			}
+			if (attackQ || (index + itemsize <= (int)key.size())) {
+				printSpacer(out);
+			}
+		}
+		item++;
+		if (itemsize == 0) {
+			break;
+		}
+	}
+	if (parenQ) {
+		out << ")";
+	}
+}
+
+
+
+//////////////////////////////
+//
+// getModuleKeyCode -- Convert a ModuleKey character back into an
+//    interval code.
+//
+
+int getModuleKeyCode(char16_t unit) {
+	if (unit == 0) {
+		return RESTINT;
+	}
+	return (int)unit - 0x8000;
+}
+
+
+
+//////////////////////////////
+//
+// printModuleFrequencies -- Print the counts of modules found with the
+//     --frequency option, sorted from most to least frequent.  Modules
+//     with the same count are sorted alphabetically.
+//
+
+void printModuleFrequencies(ostream& out, ModuleCounts& counts) {
+	vector<pair<int, string> > table;
+	table.reserve(counts.size());
+	for (auto& entry : counts) {
+		stringstream text;
+		printModuleKey(text, entry.first);
+		table.push_back(make_pair(-entry.second, text.str()));
+	}
+	sort(table.begin(), table.end());
+
+	int i;
+	for (i=0; i<(int)table.size(); i++) {
+		out << -table[i].first << "\t" << table[i].second << "\n";
+	}
+}
+
+
+
 //////////////////////////////
 //
 // printAsCombination --
@@ -1980,11 +2346,30 @@ int printLatticeItem(vector<vector<NoteNode> >& notes, int n, int currentindex,
 
 int printInterval(ostream& out, NoteNode& note1, NoteNode& note2,
 		int type, int octaveadjust) {
+	int cross = 0;
+	int code = getIntervalCode(note1, note2, type, octaveadjust, cross);
+	printIntervalCode(out, code);
+	return cross;
+}
+
+
+
+//////////////////////////////
+//
+// getIntervalCode -- Return the interval between two notes as it will
+//    be displayed, in the form (interval * 8 + flags), where bit 2 of
+//    the flags indicates that sustain/attack states are displayed, bit
+//    1 is set if the first note is sustained, and bit 0 if the second
+//    note is sustained.  Returns RESTINT if either note is a rest.
+//    cross is set to 1 if a harmonic interval is crossed.
+//
+
+int getIntervalCode(NoteNode& note1, NoteNode& note2, int type,
+		int octaveadjust, int& cross) {
+	cross = 0;
 	if ((note1.b40 == REST) || (note2.b40 == REST)) {
-		out << RESTSTRING;
-		return 0;
+		return RESTINT;
 	}
-	int cross = 0;
 	int pitch1 = abs(note1.b40);
 	int pitch2 = abs(note2.b40);
 	int interval = pitch2 - pitch1;
@@ -2048,6 +2433,35 @@ int printInterval(ostream& out, NoteNode& note1, NoteNode& note2,
 		interval = interval + octaveadjust  * 7;
 	}
 
+	int flags = 0;
+	if (sustainQ || ((type == INTERVAL_HARMONIC) && xoptionQ)) {
+		// display sustain/attack information of intervals.
+		flags |= 4;
+		if (note1.b40 < 0) {
+			flags |= 2;
+		}
+		if (note2.b40 < 0) {
+			flags |= 1;
+		}
+	}
+
+	return interval * 8 + flags;
+}
+
+
+
+//////////////////////////////
+//
+// printIntervalCode -- Print an interval generated by getIntervalCode().
+//
+
+void printIntervalCode(ostream& out, int code) {
+	if (code == RESTINT) {
+		out << RESTSTRING;
+		return;
+	}
+	int flags = code & 7;
+	int interval = (code - flags) / 8;
 
 	if (chromaticQ) {
 		char buffer[1024] = {0};
@@ -2065,21 +2479,11 @@ int printInterval(ostream& out, NoteNode& note1, NoteNode& note2,
 		}
 	}
 
-	if (sustainQ || ((type == INTERVAL_HARMONIC) && xoptionQ)) {
+	if (flags & 4) {
 		// print sustain/attack information of intervals.
-		if (note1.b40 < 0) {
-			out << "s";
-		} else {
-			out << "x";
-		}
-		if (note2.b40 < 0) {
-			out << "s";
-		} else {
-			out << "x";
-		}
+		out << ((flags & 2) ? "s" : "x");
+		out << ((flags & 1) ? "s" : "x");
 	}
-
-	return cross;
 }
 
 
@@ -2763,6 +3167,10 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("search=s:", "search string");
 	opts.define("mark=b", "mark matches notes from searches in data");
 	opts.define("count=b", "count matched modules from search query");
+	opts.define("freq|frequency=b",
+			"count modules in all input files and print a frequency table");
+	opts.define("j|threads=i:1",
+			"number of voice pairs to analyze at once (0=all cores)");
 	opts.define("debug=b");              // determine bad input line num
 	opts.define("author=b");             // author of program
 	opts.define("version=b");            // compilation info
@@ -2851,6 +3259,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	uncrossQ     = opts.getBoolean("uncross");
 	locationQ    = opts.getBoolean("location");
 	retroQ       = opts.getBoolean("retrospective");
+	frequencyQ   = opts.getBoolean("frequency");
+	threads      = opts.getInteger("threads");
 	NoteMarker   = "";
 	if (opts.getBoolean("note-marker")) {
 		NoteMarker = opts.getString("note-marker");
@@ -0,0 +1,187 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 20:37:33 PDT 2026
+// Last Modified: Sun Oct 18 20:37:33 PDT 2026
+// Filename:      ...sig/examples/all/cliche.cpp
+// Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/cliche.cpp
+// Syntax:        C++; museinfo
+//
+// Description:   Marks repeated sequences of sonorities with
+//                HumdrumFile::analyzeCliche().  The start of the first
+//                occurrence of each cliche is marked with -N in an
+//                added **cliche spine, and its repetitions with N.
+//
+
+#include <iostream>
+#include <string>
+
+#include "humdrum.h"
+
+using namespace std;
+
+
+// function declarations
+void      checkOptions       (Options& opts, int argc, char* argv[]);
+void      example            (void);
+void      printClicheAnalysis(HumdrumFile& infile, Array<int>& cliche);
+void      usage              (const string& command);
+
+// global variables
+Options   options;            // database for command-line arguments
+double    duration  = 1.0;    // used with -d option
+int       mincount  = 1;      // used with -m option
+double    startbeat = -1.0;   // used with -s option
+double    stopbeat  = -1.0;   // used with -e option
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[]) {
+	checkOptions(options, argc, argv);
+	HumdrumStream streamer(options);
+	HumdrumFile infile;
+	Array<int> cliche;
+
+	while (streamer.read(infile)) {
+		infile.analyzeRhythm("4");
+		infile.analyzeCliche(cliche, duration, mincount, startbeat, stopbeat);
+		printClicheAnalysis(infile, cliche);
+	}
+
+	return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// checkOptions -- validate and process command-line options.
+//
+
+void checkOptions(Options& opts, int argc, char* argv[]) {
+	opts.define("d|duration=d:1.0");      // duration of cliche in quarters
+	opts.define("m|min|minimum=i:1");     // minimum number of repetitions
+	opts.define("s|start=d:-1.0");        // starting beat of search
+	opts.define("e|stop=d:-1.0");         // ending beat of search
+
+	opts.define("debug=b");                // determine bad input line num
+	opts.define("author=b");               // author of program
+	opts.define("version=b");              // compilation info
+	opts.define("example=b");              // example usages
+	opts.define("h|help=b");               // short description
+	opts.process(argc, argv);
+
+	// handle basic options:
+	if (opts.getBoolean("author")) {
+		cout << "Written by Craig Stuart Sapp, "
+			  << "craig@ccrma.stanford.edu, October 2026" << endl;
+		exit(0);
+	} else if (opts.getBoolean("version")) {
+		cout << argv[0] << ", version: 18 October 2026" << endl;
+		cout << "compiled: " << __DATE__ << endl;
+		cout << MUSEINFO_VERSION << endl;
+		exit(0);
+	} else if (opts.getBoolean("help")) {
+		usage(opts.getCommand());
+		exit(0);
+	} else if (opts.getBoolean("example")) {
+		example();
+		exit(0);
+	}
+
+	duration  = opts.getDouble("duration");
+	mincount  = opts.getInteger("minimum");
+	startbeat = opts.getDouble("start");
+	stopbeat  = opts.getDouble("stop");
+	if (duration <= 0.0) {
+		cerr << "Error: duration must be positive" << endl;
+		exit(1);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// example -- example usage of the cliche program
+//
+
+void example(void) {
+	cout <<
+	"                                                                         \n"
+	"# example usage of the cliche program.                                   \n"
+	"# mark repeated sonority sequences lasting a half note:                  \n"
+	"     cliche -d 2 chor217.krn                                             \n"
+	"                                                                         \n"
+	<< endl;
+}
+
+
+
+//////////////////////////////
+//
+// printClicheAnalysis -- print the input with a **cliche spine added.
+//
+
+void printClicheAnalysis(HumdrumFile& infile, Array<int>& cliche) {
+	for (int i=0; i<infile.getNumLines(); i++) {
+		switch (infile[i].getType()) {
+			case E_humrec_data_comment:
+				cout << infile[i] << "\t!\n";
+				break;
+			case E_humrec_data_kern_measure:
+				cout << infile[i] << '\t' << infile[i][0] << '\n';
+				break;
+			case E_humrec_interpretation:
+				cout << infile[i] << '\t';
+				if (strncmp(infile[i][0], "**", 2) == 0) {
+					cout << "**cliche\n";
+				} else if (strcmp(infile[i][0], "*-") == 0) {
+					cout << "*-\n";
+				} else {
+					cout << "*\n";
+				}
+				break;
+			case E_humrec_data:
+				cout << infile[i] << '\t';
+				if (cliche[i] == 0) {
+					cout << ".\n";
+				} else {
+					cout << cliche[i] << '\n';
+				}
+				break;
+			default:
+				cout << infile[i] << '\n';
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// usage -- gives the usage statement for the cliche program
+//
+
+void usage(const string& command) {
+	cout <<
+	"                                                                         \n"
+	"Marks repeated sequences of sonorities.  The first occurrence of each    \n"
+	"cliche is marked with -N in an added **cliche spine, and each repetition \n"
+	"is marked with N.                                                        \n"
+	"                                                                         \n"
+	"Usage: " << command << " [-d dur][-m count] [input1 [input2 ...]]\n"
+	"                                                                         \n"
+	"Options:                                                                 \n"
+	"   -d dur    = duration of the cliches in quarter notes (default 1.0)    \n"
+	"   -m count  = minimum number of repetitions (default 1)                 \n"
+	"   -s beat   = starting beat of the search                               \n"
+	"   -e beat   = ending beat of the search                                 \n"
+	"   --options = list of all options, aliases and default values           \n"
+	"                                                                         \n"
+	<< endl;
+}
+
+
+
@@ -9,6 +9,7 @@
 // Last Modified: Thu Oct 24 12:32:47 PDT 2013 Switch to HumdrumStream class
 // Last Modified: Sat Mar 12 18:34:05 PST 2016 Switch to STL
 // Last Modified: Sat Mar 12 18:34:05 PST 2016 Add -k option
+// Last Modified: Sun Oct 18 19:28:24 PDT 2026 Buffered output, no endl flush
 // Filename:      ...sig/examples/all/extractx.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/extractx.cpp
 // Syntax:        C++; museinfo
@@ -748,6 +749,7 @@ void excludeFields(HumdrumFile& infile, vector<int>& field,
 	int i;
 	int j;
 	int start = 0;
+	HumdrumWriter out(cout);
 
 	for (i=0; i<infile.getNumLines(); i++) {
 		switch (infile[i].getType()) {
@@ -755,7 +757,7 @@ void excludeFields(HumdrumFile& infile, vector<int>& field,
 			case E_humrec_empty:
 			case E_humrec_global_comment:
 			case E_humrec_bibliography:
-				cout << infile[i] << '\n';
+				out.writeLine(infile[i]);
 				break;
 			case E_humrec_data_comment:
 			case E_humrec_data_kern_measure:
@@ -767,17 +769,17 @@ void excludeFields(HumdrumFile& infile, vector<int>& field,
 						continue;
 					}
 					if (start != 0) {
-						cout << '\t';
+						out << '\t';
 					}
 					start = 1;
-					cout << infile[i][j];
+					out << infile[i][j];
 				}
 				if (start != 0) {
-					cout << endl;
+					out << '\n';
 				}
 				break;
 			default:
-				cout << "!!Line = UNKNOWN:" << infile[i] << endl;
+				out << "!!Line = UNKNOWN:" << infile[i] << '\n';
 				break;
 		}
 	}
@@ -911,7 +913,7 @@ void extractFields(HumdrumFile& infile, vector<int>& field,
 					}
 				}
 				if (start != 0) {
-					cout << endl;
+					cout << '\n';
 				}
 				break;
 			default:
@@ -1807,7 +1809,7 @@ void printTraceLine(HumdrumFile& infile, int line, vector<int>& field) {
 		}
 	}
 	if (start != 0) {
-		cout << endl;
+		cout << '\n';
 	}
 }
 
@@ -1861,7 +1863,7 @@ void extractInterpretations(HumdrumFile& infile, string& interps) {
 					cout << infile[i][j];
 				}
 				if (column != 0) {
-					cout << endl;
+					cout << '\n';
 				}
 				break;
 			default:
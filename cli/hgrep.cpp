@@ -7,51 +7,121 @@
 // Last Modified: Wed Apr 28 18:49:29 PDT 2010 Added -T and -D options
 // Last Modified: Wed Sep 14 10:40:48 PDT 2011 Added -F option
 // Last Modified: Sat Apr  6 01:16:22 PDT 2013 Enabled multiple segment input
+// Last Modified: Sun Oct 18 17:06:44 PDT 2026 PCRE2 JIT, literal prefilter, -j
+// Last Modified: Sun Oct 18 20:22:01 PDT 2026 POSIX default, --perl-regexp
 // Filename:      ...sig/examples/all/hgrep.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/hgrep.cpp
 // Syntax:        C++; museinfo
 //
 // Description:   Grep with Humdrum intelligence built into it.
 //
+// Search strings are POSIX extended regular expressions (or basic ones
+// with -G), as with egrep.  The --perl-regexp option uses PCRE2 syntax
+// instead (if hgrep was compiled with PCRE2), which is faster and is
+// needed for combining --and searches into one expression, but which
+// does not understand POSIX-only forms such as \< and \> word
+// boundaries, a{,2} or backslashes inside of brackets.
+//
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 #include <string.h>
 #include <math.h>
 #include <regex.h>
 
+#ifdef HAVE_PCRE2
+   #define PCRE2_CODE_UNIT_WIDTH 8
+   #include "pcre2.h"
+#endif
+
 #include "humdrum.h"
 
 using namespace std;
 
 //////////////////////////////////////////////////////////////////////////
 
+//////////////////////////////
+//
+// SearchPattern -- A regular expression which is compiled once for the
+//    whole run.  Literal substrings which any match must contain are
+//    extracted from the expression and checked with strstr() before the
+//    regular expression is run, and patterns which are only a literal
+//    string never run the regular expression at all.  Expressions are
+//    compiled with POSIX regcomp(), or with PCRE2 (JIT) when the
+//    --perl-regexp option is given.
+//
+
+class SearchPattern {
+	public:
+		            SearchPattern    (void);
+		           ~SearchPattern    ();
+		void        compile          (const string& pattern);
+		void        compileAll       (const vector<string>& patterns);
+		int         search           (const char* text);
+		int         isCombinable     (void);
+		const string& getPattern     (void) { return pattern; }
+
+	protected:
+		void        clear            (void);
+		void        compileRegex     (const string& pattern);
+		static int  findLiterals     (vector<string>& output,
+		                              const string& pattern, int basic,
+		                              int perl);
+
+	private:
+		string         pattern;      // the uncompiled expression
+		vector<string> literals;     // substrings required in a match
+		int            literalQ;     // pattern is a single literal string
+		int            posixQ;       // compiled with regcomp()
+		int            compiledQ;    // regex needs to be freed
+		regex_t        posix;
+#ifdef HAVE_PCRE2
+		pcre2_code*    code;
+#endif
+};
+
+
 // function declarations:
 void      checkOptions        (Options& opts, int argc, char** argv);
 void      example             (void);
 void      usage               (const string& command);
-void      doSearch            (const string& searchstring, HumdrumFile& infile,
-                               const string& filename);
-void      printPreInfo        (const string& filename, HumdrumFile& infile,
-                               double measure, int line, int spine = -1);
+void      doSearch            (ostream& out, HumdrumFile& infile,
+                               const string& filename, int& markcount,
+                               int& markmatchcount);
+void      printPreInfo        (ostream& out, const string& filename,
+                               HumdrumFile& infile, double measure, int line,
+                               int spine = -1);
 char*     searchAndReplace    (char* buffer, const string& searchstring,
                                const string& replacestring,
                                const string& datastring);
-void      displayFraction     (double fraction);
-void      fillAndSearches     (vector<regex_t>& relist,
+void      displayFraction     (ostream& out, double fraction);
+void      fillAndSearches     (vector<SearchPattern*>& relist,
                                vector<string>& exlist,
                                const string& string);
 int       tokenSearch         (int& column, HumdrumFile& infile, int line,
-                               regex_t& re);
+                               SearchPattern& re);
 int       singleTokenSearch   (int& column, HumdrumFile& infile, int line,
-                               regex_t& re, const string& exstring);
-void      destroyAndSearches  (vector<regex_t>& relist);
+                               SearchPattern& re, const string& exstring);
+void      destroyAndSearches  (vector<SearchPattern*>& relist);
+void      prepareCombinedSearch(void);
 double    getBeatOfNextData   (HumdrumFile& infile, int line);
-void      printDitto          (HumdrumFile& infile, int line);
-void      markKernNotes       (HumdrumFile& infile, int line);
-void      analyzeFile         (HumdrumFile& infile);
+void      printDitto          (ostream& out, HumdrumFile& infile, int line);
+void      markKernNotes       (HumdrumFile& infile, int line, int& markcount,
+                               int& markmatchcount);
+void      analyzeFile         (ostream& out, HumdrumFile& infile);
+void      analyzeFilesParallel(HumdrumStream& streamer);
+void      searchFiles         (void);
+void      printSearchResults  (int count);
+void      finishSearches      (void);
 
 // User interface variables:
 Options     options;
@@ -78,10 +148,12 @@ int         datastopQ       = 0;     // used with -D option
 int         markQ           = 0;     // used with --mark option
 string      exinterps       = "";    // used with -x option
 char        separator[1024] = {0};   // used with --sep option
-vector<regex_t> Andlist;              // used with --and option
-vector<string> Andexinterp;     // used with --and option
-int         MarkerCount     = 0;
-int         MarkerMatchCount= 0;
+vector<SearchPattern*> Andlist;      // used with --and option
+vector<string> Andexinterp;          // used with --and option
+int         threads         = 1;     // used with -j option
+SearchPattern Searchpattern;         // first argument, compiled
+SearchPattern Combined;              // first argument and --and list
+int         combinedQ       = 0;     // Combined is used for line searches
 
 // standard grep option emulations:
 int         fileQ           = 0;     // used with -H option
@@ -89,6 +161,7 @@ int         matchfilesQ     = 0;     // used with -l option
 int         nomatchfilesQ   = 0;     // used with -L option
 int         ignorecaseQ     = 0;     // used with -i option
 int         basicQ          = 0;     // used with -G option
+int         perlQ           = 0;     // used with --perl-regexp option
 int         lineQ           = 0;     // used with -n option
 int         invertQ         = 0;     // used with -v option
 
@@ -97,10 +170,14 @@ int         invertQ         = 0;     // used with -v option
 int main(int argc, char** argv) {
 	checkOptions(options, argc, argv);
 	HumdrumStream streamer(options);
-	HumdrumFile infile;
 
-	while (streamer.read(infile)) {
-		analyzeFile(infile);
+	if (threads == 1) {
+		HumdrumFile infile;
+		while (streamer.read(infile)) {
+			analyzeFile(cout, infile);
+		}
+	} else {
+		analyzeFilesParallel(streamer);
 	}
 
 	destroyAndSearches(Andlist);
@@ -110,26 +187,214 @@ int main(int argc, char** argv) {
 
 
 
+//////////////////////////////
+//
+// SearchQueue -- Input files which are waiting to be searched or printed
+//    by analyzeFilesParallel().  Files are read in the main thread and
+//    searched by worker threads, and the results are printed in input
+//    order.  If the program exits while reading (or searching) a file,
+//    finishSearches() is called by exit() to print the results of the
+//    files before it, so that the output is the same as when the files
+//    are searched one at a time.
+//
+
+class SearchQueue {
+	public:
+		mutex                  lock;
+		condition_variable     changed;
+		vector<HumdrumFile>    infiles;   // ring buffer of input files
+		vector<stringstream>   outputs;   // search results for infiles
+		vector<int>            done;      // 1 = file has been searched
+		vector<thread>         workers;
+		int                    readcount   = 0; // number of files read
+		int                    searchcount = 0; // number of files started
+		int                    printcount  = 0; // number of files printed
+		int                    finishedQ   = 0; // all files have been read
+		int                    activeQ     = 0; // workers are running
+};
+
+// The queue is never deleted, so that it is still usable (and its threads
+// are not destroyed) while the program exits:
+SearchQueue& Queue = *(new SearchQueue);
+thread_local int CurrentFile = -1;   // file index being searched by thread
+
+
+
+//////////////////////////////
+//
+// analyzeFilesParallel -- Read the input files one at a time and search
+//    them in separate threads.  The results of a file are printed as
+//    soon as it and all files before it have been searched.
+//
+
+void analyzeFilesParallel(HumdrumStream& streamer) {
+	int tcount = threads;
+	if (tcount <= 0) {
+		tcount = thread::hardware_concurrency();
+	}
+	if (tcount < 1) {
+		tcount = 1;
+	}
+
+	int size = tcount * 4;
+	Queue.infiles.resize(size);
+	Queue.outputs.resize(size);
+	Queue.done.resize(size);
+	Queue.activeQ = 1;
+	atexit(finishSearches);
+
+	int i;
+	for (i=0; i<tcount; i++) {
+		Queue.workers.emplace_back(searchFiles);
+	}
+
+	int slot;
+	while (1) {
+		// wait for a free place to store the next file
+		printSearchResults(Queue.readcount - size + 1);
+		slot = Queue.readcount % size;
+		if (!streamer.read(Queue.infiles[slot])) {
+			break;
+		}
+		{
+			lock_guard<mutex> guard(Queue.lock);
+			Queue.readcount++;
+		}
+		Queue.changed.notify_all();
+	}
+
+	finishSearches();
+}
+
+
+
+//////////////////////////////
+//
+// searchFiles -- Search the files in the queue (in a worker thread)
+//    until all files have been read and searched.
+//
+
+void searchFiles(void) {
+	int size = (int)Queue.infiles.size();
+	int slot;
+	unique_lock<mutex> guard(Queue.lock);
+	while (1) {
+		Queue.changed.wait(guard, [](void) {
+			return Queue.finishedQ || (Queue.searchcount < Queue.readcount);
+		});
+		if (Queue.searchcount >= Queue.readcount) {
+			break;
+		}
+		CurrentFile = Queue.searchcount++;
+		slot = CurrentFile % size;
+		guard.unlock();
+
+		Queue.outputs[slot].str("");
+		analyzeFile(Queue.outputs[slot], Queue.infiles[slot]);
+
+		guard.lock();
+		Queue.done[slot] = 1;
+		CurrentFile = -1;
+		Queue.changed.notify_all();
+	}
+}
+
+
+
+//////////////////////////////
+//
+// printSearchResults -- Print the results of the searched files in input
+//    order, waiting until at least count files have been printed.
+//
+
+void printSearchResults(int count) {
+	int size = (int)Queue.infiles.size();
+	int slot;
+	unique_lock<mutex> guard(Queue.lock);
+	while (Queue.printcount < Queue.readcount) {
+		slot = Queue.printcount % size;
+		if (!Queue.done[slot]) {
+			if (Queue.printcount >= count) {
+				break;
+			}
+			Queue.changed.wait(guard);
+			continue;
+		}
+		cout << Queue.outputs[slot].str();
+		Queue.outputs[slot].str("");
+		Queue.done[slot] = 0;
+		Queue.printcount++;
+	}
+	cout.flush();
+}
+
+
+
+//////////////////////////////
+//
+// finishSearches -- Stop reading input files, and print the results of
+//    all files which were read (if called by the reading thread) or of
+//    the files before the one being searched (if a worker thread is
+//    exiting the program).  A file which makes the program exit is
+//    printed as far as it was searched.
+//
+
+void finishSearches(void) {
+	int count;
+	{
+		lock_guard<mutex> guard(Queue.lock);
+		if (!Queue.activeQ) {
+			return;
+		}
+		Queue.finishedQ = 1;
+		count = Queue.readcount;
+		if (CurrentFile >= 0) {
+			count = CurrentFile;
+		}
+	}
+	Queue.changed.notify_all();
+	printSearchResults(count);
+
+	if (CurrentFile >= 0) {
+		// A worker thread is exiting the program: the other threads are
+		// left running until the program ends.
+		lock_guard<mutex> guard(Queue.lock);
+		cout << Queue.outputs[CurrentFile % Queue.infiles.size()].str();
+		cout.flush();
+		Queue.activeQ = 0;
+		return;
+	}
+
+	for (int i=0; i<(int)Queue.workers.size(); i++) {
+		Queue.workers[i].join();
+	}
+	Queue.workers.clear();
+	lock_guard<mutex> guard(Queue.lock);
+	Queue.activeQ = 0;
+}
+
+
+
 //////////////////////////////
 //
 // analyzeFile --
 //
 
-void analyzeFile(HumdrumFile& infile) {
+void analyzeFile(ostream& out, HumdrumFile& infile) {
 	if (absbeatQ || beatQ || measureQ || fracQ) {
 		// need to do this for measureQ because of pickup information
 		infile.analyzeRhythm("4");
 	}
 
-	doSearch(searchstring.c_str(), infile, infile.getFilename());
+	int markcount = 0;
+	int markmatchcount = 0;
+	doSearch(out, infile, infile.getFilename(), markcount, markmatchcount);
 	if (markQ) {
-		cout << infile;
-		if (MarkerCount) {
-			cout << "!!!RDF**kern: @ = marked note ("
-					<< MarkerCount << " marks in " << MarkerMatchCount
+		out << infile;
+		if (markcount) {
+			out << "!!!RDF**kern: @ = marked note ("
+					<< markcount << " marks in " << markmatchcount
 					<< " matches)" << endl;
-			MarkerCount = 0;
-			MarkerMatchCount = 0;
 		}
 	}
 }
@@ -142,29 +407,15 @@ void analyzeFile(HumdrumFile& infile) {
 // doSearch --
 //
 
-void doSearch(const string& searchstring, HumdrumFile& infile,
-		const string& filename) {
-	regex_t re;
-	int flags = 0;
+void doSearch(ostream& out, HumdrumFile& infile, const string& filename,
+		int& markcount, int& markmatchcount) {
+	SearchPattern& re = Searchpattern;
 	double measure = 1;
 	if (infile.getPickupDur() != 0.0) {
 		measure = 0;
 	}
 
-	if (!basicQ) {
-		flags = flags | REG_EXTENDED;
-	}
-	if (ignorecaseQ) {
-		flags = flags | REG_ICASE;
-	}
 	int status;
-	status = regcomp(&re, searchstring.c_str(), flags);
-	if (status != 0) {
-		char errstring[1024] = {0};
-		regerror(status, &re, errstring, 1000);
-		cerr << errstring << endl;
-		exit(1);
-	}
 	int i;
 	int matchcount = 0;
 
@@ -175,10 +426,10 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 		if (formQ && !infile[i].isData()) {
 			if (!invertQ) {
 				if (nullQ) {
-					printDitto(infile, i);
-					cout << endl;
+					printDitto(out, infile, i);
+					out << endl;
 				} else {
-					cout << infile[i] << endl;
+					out << infile[i] << endl;
 				}
 			} else {
 				if (strcmp(infile[i][0], "*-") == 0) {
@@ -187,10 +438,10 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 					// handled at marker xyga
 				} else {
 					if (nullQ) {
-						printDitto(infile, i);
-						cout << endl;
+						printDitto(out, infile, i);
+						out << endl;
 					} else {
-						cout << infile[i] << endl;
+						out << infile[i] << endl;
 					}
 				}
 			}
@@ -220,7 +471,7 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 			// status == 0 means a match was found
 			// status != 0 means a match was not found
 			if (markQ && !status) {
-				markKernNotes(infile, i);
+				markKernNotes(infile, i, markcount, markmatchcount);
 				continue;
 			}
 
@@ -230,22 +481,22 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 			if (status == 0) {
 				matchcount++;
 				if (matchfilesQ) {
-					cout << filename << endl;
+					out << filename << endl;
 					return;
 				}
 				if (nomatchfilesQ) {
 					continue;
 				}
-				printPreInfo(filename, infile, measure, i, column);
+				printPreInfo(out, filename, infile, measure, i, column);
 				if (!quietQ) {
 					// marker xyga
 					if (nullQ) {
-						printDitto(infile, i);
+						printDitto(out, infile, i);
 					} else {
-						cout << infile[i];
+						out << infile[i];
 					}
 				}
-				cout << endl;
+				out << endl;
 			}
 
 		} else { // search entire line as a single unit
@@ -254,26 +505,28 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 				for (int ii=0; ii<infile[i].getFieldCount(); ii++) {
 					status = tokenSearch(ii, infile, i, re);
 					if (markQ && !status) {
-						markKernNotes(infile, i);
+						markKernNotes(infile, i, markcount, markmatchcount);
 						continue;
 					}
 					if (status == 0) {
 						break;
 					}
 				}
+			} else if (combinedQ) {
+				// first argument and all --and searches in a single match
+				status = !Combined.search(infile[i].getLine());
 			} else {
-				status = regexec(&re, infile[i].getLine(), 0, NULL, 0);
+				status = !re.search(infile[i].getLine());
 				if (markQ && !status) {
-					markKernNotes(infile, i);
+					markKernNotes(infile, i, markcount, markmatchcount);
 					continue;
 				}
 			}
-			if (Andlist.size() > 0) {
+			if ((Andlist.size() > 0) && !combinedQ) {
 				for (int aa=0; aa<(int)Andlist.size(); aa++) {
-					int newstatus = regexec(&Andlist[aa], infile[i].getLine(),
-							0, NULL, 0);
-					if (newstatus != 0) {
+					if (!Andlist[aa]->search(infile[i].getLine())) {
 						status = 1;
+						break;
 					}
 				}
 			}
@@ -283,29 +536,28 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 			if (status == 0) {
 				matchcount++;
 				if (matchfilesQ) {
-					cout << filename << endl;
+					out << filename << endl;
 					return;
 				}
 				if (nomatchfilesQ) {
 					continue;
 				}
-				printPreInfo(filename, infile, measure, i, -1);
+				printPreInfo(out, filename, infile, measure, i, -1);
 				if (!quietQ) {
 					if (nullQ) {
-						printDitto(infile, i);
+						printDitto(out, infile, i);
 					} else {
-						cout << infile[i];
+						out << infile[i];
 					}
 				}
-				cout << endl;
+				out << endl;
 			}
 
 		}
 	}
 
-	regfree(&re);
 	if (nomatchfilesQ && matchcount == 0) {
-		cout << filename << endl;
+		out << filename << endl;
 	}
 }
 
@@ -318,12 +570,13 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 // which are currently sounding.
 //
 
-void markKernNotes(HumdrumFile& infile, int line) {
+void markKernNotes(HumdrumFile& infile, int line, int& markcount,
+		int& markmatchcount) {
 	int j;
 	if (!infile[line].isData()) {
 		return;
 	}
-	MarkerMatchCount++;
+	markmatchcount++;
 	char buffer[1024] = {0};
 	HumdrumFileAddress add;
 	for (j=0; j<infile[line].getFieldCount(); j++) {
@@ -339,7 +592,7 @@ void markKernNotes(HumdrumFile& infile, int line) {
 			// don't duplicate @ marker in a token
 			continue;
 		}
-		MarkerCount++;
+		markcount++;
 		strcpy(buffer, infile[add]);
 		strcat(buffer, "@");
 		infile.changeField(add, buffer);
@@ -353,10 +606,10 @@ void markKernNotes(HumdrumFile& infile, int line) {
 // printDitto -- fill in null tokens with/without parentheses
 //
 
-void printDitto(HumdrumFile& infile, int line) {
+void printDitto(ostream& out, HumdrumFile& infile, int line) {
 	int j, ii, jj;
 	if (!infile[line].isData()) {
-		cout << infile[line] << endl;
+		out << infile[line] << endl;
 	}
 	int count = infile[line].getFieldCount();
 	int null = 0;
@@ -370,12 +623,12 @@ void printDitto(HumdrumFile& infile, int line) {
 			null = 1;
 		}
 		if (null && parenQ) {
-			cout << "(" << infile[ii][jj] << ")";
+			out << "(" << infile[ii][jj] << ")";
 		} else {
-			cout << infile[ii][jj];
+			out << infile[ii][jj];
 		}
 		if (j<count-1) {
-			cout << '\t';
+			out << '\t';
 		}
 	}
 }
@@ -389,9 +642,8 @@ void printDitto(HumdrumFile& infile, int line) {
 //   returns 1 (or a non-zero) if no match.
 //
 
-int singleTokenSearch(int& column, HumdrumFile& infile, int line, regex_t& re,
-		const string& exstring) {
-	int status;
+int singleTokenSearch(int& column, HumdrumFile& infile, int line,
+		SearchPattern& re, const string& exstring) {
 	for (int j=0; j<infile[line].getFieldCount(); j++) {
 		if (exstring.size() == 0) {
 			// don't filter out based on exclusive interpretation types
@@ -410,11 +662,8 @@ int singleTokenSearch(int& column, HumdrumFile& infile, int line, regex_t& re,
 			}
 		}
 
-		status = regexec(&re, infile[line][j], 0, NULL, 0);
-		if (status == 0) {
-//cout << "AND MATCH FOUND IN TOKEN: " << infile[line][j] << endl;
-//cout << "USING REGEX " << (int)(&re) << endl;
-			return status;
+		if (re.search(infile[line][j])) {
+			return 0;
 		}
 	}
 
@@ -430,7 +679,8 @@ int singleTokenSearch(int& column, HumdrumFile& infile, int line, regex_t& re,
 //
 //
 
-int tokenSearch(int& column, HumdrumFile& infile, int line, regex_t& re) {
+int tokenSearch(int& column, HumdrumFile& infile, int line,
+		SearchPattern& re) {
 	int matchfound = 0;
 
 	if (kernQ) {
@@ -447,14 +697,13 @@ int tokenSearch(int& column, HumdrumFile& infile, int line, regex_t& re) {
 		return matchfound;
 	}
 
-//cout << "CHECKING AND DATA" << endl;
 	for (int i=0; i<(int)Andlist.size(); i++) {
 		if (kernQ && Andexinterp[i].empty()) {
 			matchfound = singleTokenSearch(column, infile, line,
-					Andlist[i], "**kern");
+					*Andlist[i], "**kern");
 		} else {
 			matchfound = singleTokenSearch(column, infile, line,
-					Andlist[i], Andexinterp[i]);
+					*Andlist[i], Andexinterp[i]);
 		}
 		if (matchfound != 0) {
 			column = -1;  // don't identify spine for anded searches
@@ -513,37 +762,37 @@ char* searchAndReplace(char* buffer, const string& searchstring,
 //    default value: spine = -1
 //
 
-void printPreInfo(const string& filename, HumdrumFile& infile, double measure,
-		int line, int spine) {
+void printPreInfo(ostream& out, const string& filename, HumdrumFile& infile,
+		double measure, int line, int spine) {
 	if (fileQ) {
-		cout << filename << separator;
+		out << filename << separator;
 	}
 	if (lineQ) {
-		cout << "line " << line+1 << separator;
+		out << "line " << line+1 << separator;
 	}
 	if (spineQ && (spine >= 0)) {
-		cout << "spine " << spine+1 << separator;
+		out << "spine " << spine+1 << separator;
 	} /* else if (spineQ) {
-		cout << "spine " << 1 << separator;
+		out << "spine " << 1 << separator;
 	} */
 
 	if (measureQ) {
-		cout << "measure " << measure << separator;
+		out << "measure " << measure << separator;
 	}
 	if (beatQ) {
 		if (infile[line].getBeat() == 0.0) {
-			cout << "beat " << getBeatOfNextData(infile, line) << separator;
+			out << "beat " << getBeatOfNextData(infile, line) << separator;
 		} else {
-			cout << "beat " << infile[line].getBeat() << separator;
+			out << "beat " << infile[line].getBeat() << separator;
 		}
 	}
 	if (absbeatQ) {
-		cout << "absbeat " << infile[line].getAbsBeat() << separator;
+		out << "absbeat " << infile[line].getAbsBeat() << separator;
 	}
 	if (fracQ) {
-		cout << "frac ";
-		displayFraction(infile[line].getAbsBeat()/infile.getTotalDuration());
-		cout << separator;
+		out << "frac ";
+		displayFraction(out, infile[line].getAbsBeat()/infile.getTotalDuration());
+		out << separator;
 	}
 }
 
@@ -577,20 +826,20 @@ double getBeatOfNextData(HumdrumFile& infile, int line) {
 // displayFraction
 //
 
-void displayFraction(double fraction) {
+void displayFraction(ostream& out, double fraction) {
 	int value;
 	if (fraction == 0.0) {
-		cout << "0.000";
+		out << "0.000";
 	} else if (fraction == 1.0) {
-		cout << "1.000";
+		out << "1.000";
 	} else if (fraction > 0.0 && fraction < 1.0) {
 		value = int(fraction * 1000.0 + 0.5);
-		cout << "0.";
-		if (value < 100) { cout << "0"; }
-		if (value < 10) { cout << "0"; }
-		cout << value;
+		out << "0.";
+		if (value < 100) { out << "0"; }
+		if (value < 10) { out << "0"; }
+		out << value;
 	} else {
-		cout << fraction;
+		out << fraction;
 	}
 }
 
@@ -625,9 +874,11 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("sep|separator=s::", "data separator string");
 	opts.define("no-paren=b",        "don't display null parentheses");
 	opts.define("and=s:",            "anded search strings");
+	opts.define("j|threads=i:1",     "number of files to search at once (0=all cores)");
 
 	// options which mimic regular grep program:
 	opts.define("G|basic-regexp=b",  "use basic regular expression syntax");
+	opts.define("perl-regexp=b",     "use Perl-compatible (PCRE2) regular expressions");
 	opts.define("H|with-filename=b",  "display filename at start match line");
 	opts.define("h|no-filename=b","do not display filename on match line");
 	opts.define("L|files-without-match=b", "list files without match");
@@ -666,6 +917,18 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	}
 	searchstring  =  opts.getArg(1);
 	basicQ        =  opts.getBoolean("basic-regexp");
+	perlQ         =  opts.getBoolean("perl-regexp");
+	if (perlQ && basicQ) {
+		cerr << "Error: -G and --perl-regexp cannot be used together" << endl;
+		exit(1);
+	}
+#ifndef HAVE_PCRE2
+	if (perlQ) {
+		cerr << "Error: hgrep was compiled without PCRE2, so --perl-regexp "
+		     << "cannot be used" << endl;
+		exit(1);
+	}
+#endif
 	fileQ         =  opts.getBoolean("with-filename");
 	matchfilesQ   =  opts.getBoolean("files-with-match");
 	nomatchfilesQ =  opts.getBoolean("files-without-match");
@@ -702,11 +965,46 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 		nomatchfilesQ = 0;
 	}
 
-	Andlist.resize(0);
+	threads       =  opts.getInteger("threads");
+
+	Searchpattern.compile(searchstring);
+	destroyAndSearches(Andlist);
 	Andexinterp.resize(0);
 	if (opts.getBoolean("and")) {
 		fillAndSearches(Andlist, Andexinterp, opts.getString("and").c_str());
 	}
+	prepareCombinedSearch();
+}
+
+
+
+//////////////////////////////
+//
+// prepareCombinedSearch -- When whole lines are searched with an --and
+//    list, match the first argument and all of the --and searches with
+//    a single regular expression (one lookahead for each search).
+//    Not used with --mark, since marking only depends on the first
+//    search string.
+//
+
+void prepareCombinedSearch(void) {
+	combinedQ = 0;
+	if (Andlist.empty() || markQ || tokenizeQ || kernQ || exinterpQ) {
+		return;
+	}
+	if (!Searchpattern.isCombinable()) {
+		return;
+	}
+	vector<string> patterns;
+	patterns.push_back(Searchpattern.getPattern());
+	for (int i=0; i<(int)Andlist.size(); i++) {
+		if (!Andlist[i]->isCombinable()) {
+			return;
+		}
+		patterns.push_back(Andlist[i]->getPattern());
+	}
+	Combined.compileAll(patterns);
+	combinedQ = 1;
 }
 
 
@@ -716,7 +1014,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 // fillAndSearches -- exinterp strings are sticky.
 //
 
-void fillAndSearches(vector<regex_t>& relist, vector<string>& exlist,
+void fillAndSearches(vector<SearchPattern*>& relist, vector<string>& exlist,
 		const string& astring) {
 	char* buffer;
 	int bufsize = (int)astring.size() * 2 + 128;
@@ -729,15 +1027,6 @@ void fillAndSearches(vector<regex_t>& relist, vector<string>& exlist,
 
 	char exbuff[1024] = {0};
 
-	int status;
-	int compflags = 0;
-	if (!basicQ) {
-		compflags = compflags | REG_EXTENDED;
-	}
-	if (ignorecaseQ) {
-		compflags = compflags | REG_ICASE;
-	}
-
 	searchAndReplace(buffer, "[\\]n", "\n", astring);
 	char* ptr = strtok(buffer, "\n");
 	while (ptr != NULL) {
@@ -747,15 +1036,8 @@ void fillAndSearches(vector<regex_t>& relist, vector<string>& exlist,
 			ptr = strtok(NULL, "\n");
 			continue;
 		}
-		relist.resize(relist.size()+1);
-//cout << "SEARCH STRING ADDED: " << ptr << endl;
-//cout << "ADDRESS IS " << (int)(&(relist[relist.size()-1])) << endl;
-		status = regcomp(&(relist[(int)relist.size()-1]), ptr, compflags);
-		if (status !=0) {
-			regerror(status, &(relist[(int)relist.size()-1]), buffer, 1024);
-			cerr << buffer << endl;
-			exit(1);
-		}
+		relist.push_back(new SearchPattern);
+		relist.back()->compile(ptr);
 		exlist.push_back(exbuff);
 		ptr = strtok(NULL, "\n");
 	}
@@ -769,15 +1051,409 @@ void fillAndSearches(vector<regex_t>& relist, vector<string>& exlist,
 // destroyAndSearches --
 //
 
-void destroyAndSearches(vector<regex_t>& relist) {
+void destroyAndSearches(vector<SearchPattern*>& relist) {
 	for (int i=0; i<(int)relist.size(); i++) {
-		regfree(&(relist[i]));
+		delete relist[i];
+		relist[i] = NULL;
 	}
 	relist.resize(0);
 }
 
 
 
+//////////////////////////////////////////////////////////////////////////
+//
+// SearchPattern class functions
+//
+
+//////////////////////////////
+//
+// SearchPattern::SearchPattern --
+//
+
+SearchPattern::SearchPattern(void) {
+	literalQ  = 0;
+	posixQ    = 1;
+	compiledQ = 0;
+#ifdef HAVE_PCRE2
+	code      = NULL;
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::~SearchPattern --
+//
+
+SearchPattern::~SearchPattern() {
+	clear();
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::clear --
+//
+
+void SearchPattern::clear(void) {
+	if (compiledQ && posixQ) {
+		regfree(&posix);
+	}
+#ifdef HAVE_PCRE2
+	if (code != NULL) {
+		pcre2_code_free(code);
+		code = NULL;
+	}
+	posixQ = !perlQ;
+#else
+	posixQ = 1;
+#endif
+	compiledQ = 0;
+	literalQ  = 0;
+	literals.clear();
+	pattern.clear();
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::compile -- Prepare a search string for searching
+//    (uses the -G and -i options).
+//
+
+void SearchPattern::compile(const string& apattern) {
+	clear();
+	pattern  = apattern;
+	literalQ = findLiterals(literals, pattern, basicQ, perlQ);
+	if (ignorecaseQ) {
+		literals.clear();
+		literalQ = 0;
+	}
+	if (!literalQ) {
+		compileRegex(pattern);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::compileAll -- Prepare a list of extended regular
+//    expressions which must all match somewhere in the searched text.
+//    Can only be used when isCombinable() is true for each expression.
+//
+
+void SearchPattern::compileAll(const vector<string>& patterns) {
+	clear();
+	string regex = "^";
+	vector<string> found;
+	for (int i=0; i<(int)patterns.size(); i++) {
+		if (i > 0) {
+			pattern += '\n';
+		}
+		pattern += patterns[i];
+		regex += "(?=.*?(?:";
+		regex += patterns[i];
+		regex += "))";
+		findLiterals(found, patterns[i], 0, 1);
+		if (!ignorecaseQ) {
+			literals.insert(literals.end(), found.begin(), found.end());
+		}
+	}
+	compileRegex(regex);
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::isCombinable -- Returns true if the expression can be
+//    used in compileAll(), which is not the case for basic regular
+//    expressions or expressions with back references (which would
+//    be renumbered).
+//
+
+int SearchPattern::isCombinable(void) {
+#ifdef HAVE_PCRE2
+	if (posixQ) {
+		return 0;
+	}
+	for (int i=0; i<(int)pattern.size() - 1; i++) {
+		if (pattern[i] != '\\') {
+			continue;
+		}
+		if (isdigit(pattern[i+1]) || (pattern[i+1] == 'g') ||
+				(pattern[i+1] == 'k')) {
+			return 0;
+		}
+		i++;
+	}
+	if (pattern.find("(?P") != string::npos) {
+		return 0;
+	}
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::search -- Returns 1 if the text contains a match,
+//    otherwise returns 0.  Can be called from several threads at once.
+//
+
+int SearchPattern::search(const char* text) {
+	for (int i=0; i<(int)literals.size(); i++) {
+		if (literals[i].size() == 1) {
+			if (strchr(text, literals[i][0]) == NULL) {
+				return 0;
+			}
+		} else if (strstr(text, literals[i].c_str()) == NULL) {
+			return 0;
+		}
+	}
+	if (literalQ) {
+		return 1;
+	}
+	if (posixQ) {
+		return regexec(&posix, text, 0, NULL, 0) == 0;
+	}
+
+#ifdef HAVE_PCRE2
+	struct MatchData {
+		pcre2_match_data* data;
+		MatchData(void) { data = pcre2_match_data_create(1, NULL); }
+		~MatchData() { pcre2_match_data_free(data); }
+	};
+	static thread_local MatchData matchdata;
+	int status = pcre2_match(code, (PCRE2_SPTR)text, strlen(text), 0, 0,
+			matchdata.data, NULL);
+	return status >= 0;
+#else
+	return 0;
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::compileRegex --
+//
+
+void SearchPattern::compileRegex(const string& regex) {
+	if (posixQ) {
+		int flags = REG_NOSUB;
+		if (!basicQ) {
+			flags |= REG_EXTENDED;
+		}
+		if (ignorecaseQ) {
+			flags |= REG_ICASE;
+		}
+		int status = regcomp(&posix, regex.c_str(), flags);
+		if (status != 0) {
+			char errstring[1024] = {0};
+			regerror(status, &posix, errstring, 1000);
+			cerr << errstring << endl;
+			exit(1);
+		}
+		compiledQ = 1;
+		return;
+	}
+
+#ifdef HAVE_PCRE2
+	int errornumber;
+	PCRE2_SIZE erroroffset;
+	uint32_t flags = 0;
+	if (ignorecaseQ) {
+		flags |= PCRE2_CASELESS;
+	}
+	code = pcre2_compile((PCRE2_SPTR)regex.c_str(), regex.size(), flags,
+			&errornumber, &erroroffset, NULL);
+	if (code == NULL) {
+		PCRE2_UCHAR message[1024];
+		pcre2_get_error_message(errornumber, message, sizeof(message));
+		cerr << "Error in search string " << regex << " at offset "
+		     << erroroffset << ": " << message << endl;
+		exit(1);
+	}
+	// If JIT compiling is not available, pcre2_match() will use
+	// the interpreter instead.
+	pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+	compiledQ = 1;
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// SearchPattern::findLiterals -- Find the longest string of characters
+//    which must be present in any match of the expression.  Returns 1
+//    if the expression contains no special characters (in which case
+//    the output is the expression itself).  Alternations, groups, inline
+//    options and escapes which are not a single character are not
+//    analyzed, so the output may be empty.  Backslashes are literal
+//    inside of brackets in POSIX expressions, and \<, \>, \` and \' are
+//    anchors, so the perl parameter is needed to parse the expression.
+//
+
+int SearchPattern::findLiterals(vector<string>& output,
+		const string& pattern, int basic, int perl) {
+	output.clear();
+	if (basic) {
+		if (pattern.find_first_of("\\.[*^$") != string::npos) {
+			return 0;
+		}
+		if (!pattern.empty()) {
+			output.push_back(pattern);
+		}
+		return 1;
+	}
+	if (pattern.find_first_of("\\.[](){}*+?|^$") == string::npos) {
+		if (!pattern.empty()) {
+			output.push_back(pattern);
+		}
+		return 1;
+	}
+	if ((pattern.find("(?") != string::npos) ||
+			(pattern.find("\\Q") != string::npos)) {
+		return 0;
+	}
+
+	int len = (int)pattern.size();
+	string best;
+	string current;
+	int depth = 0;
+	int i = 0;
+	int j;
+	char ch;
+	while (i < len) {
+		ch = pattern[i];
+		if (ch == '\\') {
+			if (i+1 >= len) {
+				return 0;
+			}
+			ch = pattern[i+1];
+			if (isalnum(ch) || (!perl && strchr("<>`'", ch))) {
+				// only single-character escapes such as \d or \t
+				if (perl && (strchr("dDwWsSbBhHvVRXAzZGKtnrfea", ch) == NULL)) {
+					return 0;
+				}
+				if (current.size() > best.size()) {
+					best = current;
+				}
+				current.clear();
+			} else if (depth == 0) {
+				current += ch;
+			}
+			i += 2;
+			continue;
+		}
+
+		if (ch == '[') {
+			if (current.size() > best.size()) {
+				best = current;
+			}
+			current.clear();
+			j = i + 1;
+			if ((j < len) && (pattern[j] == '^')) {
+				j++;
+			}
+			if ((j < len) && (pattern[j] == ']')) {
+				j++;
+			}
+			while ((j < len) && (pattern[j] != ']')) {
+				if (perl && (pattern[j] == '\\')) {
+					j += 2;
+				} else if ((pattern[j] == '[') && (j+1 < len) &&
+						strchr(":.=", pattern[j+1])) {
+					char ending[3] = {pattern[j+1], ']', '\0'};
+					size_t loc = pattern.find(ending, j+2);
+					j = (loc == string::npos) ? j+1 : (int)loc+2;
+				} else {
+					j++;
+				}
+			}
+			i = j + 1;
+			continue;
+		}
+
+		if (ch == '(') {
+			if (depth == 0) {
+				if (current.size() > best.size()) {
+					best = current;
+				}
+				current.clear();
+			}
+			depth++;
+		} else if (ch == ')') {
+			depth--;
+			if (depth < 0) {
+				return 0;
+			}
+		}
+		if (depth > 0) {
+			i++;
+			continue;
+		}
+
+		switch (ch) {
+			case '|':
+				output.clear();
+				return 0;
+			case '*':
+			case '?':
+			case '{':
+				// the previous character is optional
+				if (!current.empty()) {
+					current.resize(current.size() - 1);
+				}
+				if (current.size() > best.size()) {
+					best = current;
+				}
+				current.clear();
+				if (ch == '{') {
+					j = (int)pattern.find('}', i);
+					if (j != (int)string::npos) {
+						i = j;
+					}
+				}
+				break;
+			case '+':
+			case '.':
+			case '^':
+			case '$':
+			case ')':
+				if (current.size() > best.size()) {
+					best = current;
+				}
+				current.clear();
+				break;
+			default:
+				current += ch;
+		}
+		i++;
+	}
+
+	if (current.size() > best.size()) {
+		best = current;
+	}
+	if (!best.empty()) {
+		output.push_back(best);
+	}
+	return 0;
+}
+
+
+
 //////////////////////////////
 //
 // example --
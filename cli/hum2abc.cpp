@@ -18,6 +18,7 @@
 // Last Modified: Sat Oct  6 07:45:11 PDT 2012 added --cb and --db options
 // Last Modified: Sun Oct 21 13:26:51 PDT 2012 added --key for keysig modality
 // Last Modified: Fri Dec 14 00:39:32 PST 2012 made compiler OS X happy
+// Last Modified: Sun Oct 18 18:32:36 PDT 2026 added --jobs for --dir
 // Filename:      ...sig/examples/all/hum2abc.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/hum2abc.cpp
 // Syntax:        C++; museinfo
@@ -99,7 +100,6 @@
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
-#include <dirent.h>
 
 #include <iostream>
 #include <sstream>
@@ -110,6 +110,7 @@ using namespace std;
 
 #include "PerlRegularExpression.h"
 #include "CheckSum.h"
+#include "CorpusWalker.h"
 #include "humdrum.h"
 
 #define EMPTY '\0'
@@ -430,10 +431,8 @@ void     printNumberFromString (ostream& out, const char* filename,
                                 const char* ending);
 void     printFilenameBase     (ostream& out, const char* filename);
 int      norhythm              (const char* buffer);
-void     getFileListing        (Array<Array<char> >& filelist,
-		                          const char* directoryname,
-                                const char* filemask);
-int      sortfiles             (const void* a, const void* b);
+void     processDirectoryFile  (int index, const string& filename,
+                                void* userdata);
 void     printGraceRhythm      (ostream& out, const char* buffer,
 		                int top, int bot, int groupflag);
 int     getGraceNoteGroupFlag  (Array<double>& notedurs, int index);
@@ -482,6 +481,9 @@ int    graceQ            = 1;      // used with --no-grace option
 int    directoryQ        = 0;      // used with --dir option
 string directoryname     = ".";    // used with --dir option
 string filemask          = ".krn"; // used with --mask option
+int    jobs              = 1;      // used with --jobs option
+int    Argc              = 0;      // used to reprocess options for --dir
+char** Argv              = NULL;   // used to reprocess options for --dir
 int    nonaturalQ        = 0;      // used with --nn option
 int    linebreakQ        = 0;      // used with --linebreak option
 int    notempoQ          = 0;      // used with --no-tempo option
@@ -522,27 +524,20 @@ int main(int argc, char** argv) {
    checkOptions(options, argc, argv, 1, infiles[0]);
 
    int i = 0;
-   int j;
    if (directoryQ) {
-      Array<Array<char> > filelist;
-      getFileListing(filelist, directoryname.c_str(), filemask.c_str());
-
-      for (i=0; i<filelist.getSize(); i++) {
-         infiles.read(filelist[i].getBase());
-         for (j=0; j<infiles.getCount(); j++) {
-            checkMarks(infiles[j]);
-            checkOptions(options, argc, argv, i+1, infiles[j]);
-            convertHumdrumToAbc(cout, infiles[j], i+1, filelist[i].getBase());
-            if (j<infiles.getCount()-1) {
-               if (i < filelist.getSize() - 1) {
-                  cout << "\n\n\n";
-               }
-            }
-         }
-         if (i < filelist.getSize() - 1) {
-            cout << "\n\n\n";
-         }
+      if (!CorpusWalker::isDirectory(directoryname)) {
+         cerr << "Error: could not open directory " << directoryname
+              << " for reading." << endl;
+         exit(1);
       }
+      CorpusWalker corpus;
+      corpus.setMask(filemask);
+      corpus.addPath(directoryname);
+      Argc = argc;
+      Argv = argv;
+      int count = corpus.getFileCount();
+      cout.flush();
+      corpus.run(processDirectoryFile, &count, jobs);
    } else {
       for (i=0; i<infiles.getCount(); i++) {
          // process the command-line options
@@ -712,68 +707,28 @@ void getColorAssignment(double& red, double& green, double& blue,
 
 //////////////////////////////
 //
-// getFileListing --
+// processDirectoryFile -- convert a file found with the --dir option.
+//    The userdata is the number of files in the directory.
 //
 
-void getFileListing(Array<Array<char> >& filelist, const char* directoryname,
-      const char* filemask) {
-
-   filelist.setSize(1000000);
-   filelist.setGrowth(1000000);
-   filelist.setSize(0);
-   int length;
-   int dirlen = strlen(directoryname);
-   const char* connector = "/";
-   if (directoryname[dirlen-1] == '/') {
-      connector = "";
-   }
-   int conlen = strlen(connector);
-   int storlen;
-
-   DIR *d;
-   struct dirent *dir;
-   d = opendir(directoryname);
-
-   if (!d) {
-      cerr << "Error: could not open directory " << directoryname
-           << " for reading." << endl;
-      exit(1);
-   }
-
-   while ((dir = readdir(d)) != NULL) {
-      if (strstr(dir->d_name, filemask) == NULL)  {
-         // ignore files which do not match to mask.
-         continue;
+void processDirectoryFile(int index, const string& filename, void* userdata) {
+   int count = *((int*)userdata);
+   HumdrumFileSet infiles;
+   infiles.read(filename.c_str());
+   int j;
+   for (j=0; j<infiles.getCount(); j++) {
+      checkMarks(infiles[j]);
+      checkOptions(options, Argc, Argv, index+1, infiles[j]);
+      convertHumdrumToAbc(cout, infiles[j], index+1, filename.c_str());
+      if (j<infiles.getCount()-1) {
+         if (index < count - 1) {
+            cout << "\n\n\n";
+         }
       }
-      filelist.setSize(filelist.getSize()+1);
-      length = strlen(dir->d_name);
-      storlen = length + dirlen + conlen + 1;
-      filelist[filelist.getSize()-1].setSize(storlen);
-      strcpy(filelist[filelist.getSize()-1].getBase(), directoryname);
-      strcat(filelist[filelist.getSize()-1].getBase(), connector);
-      strcat(filelist[filelist.getSize()-1].getBase(), dir->d_name);
    }
-   closedir(d);
-
-
-   // sort the filelist (it is not sorted currently)
-
-   qsort(filelist.getBase(), filelist.getSize(), sizeof(Array<char>),
-      sortfiles);
-
-}
-
-
-
-//////////////////////////////
-//
-// sortfiles --
-//
-
-typedef Array<char> chararray;
-
-int sortfiles(const void* a, const void* b) {
-   return strcmp((((chararray*)a))->getBase(), (((chararray*)b))->getBase());
+   if (index < count - 1) {
+      cout << "\n\n\n";
+   }
 }
 
 
@@ -5756,6 +5711,7 @@ void storeOptionSet(Options& opts) {
    opts.define("label=b",    "Explicitly write measure number for every bar");
    opts.define("dir|directory=s", "directory for reading files from");
    opts.define("mask=s:.krn",  "filemask for reading from a directory");
+   opts.define("jobs=i:1",     "number of --dir files to convert at once");
    opts.define("no-invisible=b", "Print all invisible items as visible");
    opts.define("no-veritas=b", "Don't calculate veritas data");
    opts.define("filenum=s:",   "Prepend a filenumber value infront of title");
@@ -5961,6 +5917,7 @@ void checkOptions(Options& opts, int argc, char* argv[], int fcount,
    directoryQ      = opts.getBoolean("directory");
    directoryname   = opts.getString("directory").c_str();
    filemask        = opts.getString("mask").c_str();
+   jobs            = opts.getInteger("jobs");
 
    landscapeQ      = opts.getBoolean("landscape");
    musicscaleQ     = opts.getBoolean("scale");
@@ -0,0 +1,1036 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 19:08:55 PDT 2026
+// Last Modified: Sun Oct 18 20:42:22 PDT 2026 Added --print option
+// Filename:      ...sig/examples/all/humbench.cpp
+// Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/humbench.cpp
+// Syntax:        C++; museinfo
+//
+// Description:   Measure the speed of the core parsing and analysis
+//                functions of the library on a deterministic synthetic
+//                **kern score (or on input files).  The results are
+//                printed as a Humdrum table so that they can be compared
+//                between versions of the library.
+//
+
+#include "humdrum.h"
+
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define TICKS_PER_QUARTER  24
+#define TICKS_PER_MEASURE  (4 * TICKS_PER_QUARTER)   /* 4/4 meter */
+
+// phases which are timed:
+#define PHASE_READ       0
+#define PHASE_RHYTHM     1
+#define PHASE_NOTEARRAY  2
+#define PHASE_KEYKS      3
+#define PHASE_NOTELIST   4
+#define PHASE_EXTRACT    5
+#define PHASE_COMBINE    6
+#define PHASE_WRITE      7
+#define PHASE_COUNT      8
+
+const char* PhaseNames[PHASE_COUNT] = {
+   "read", "analyzeRhythm", "getNoteArray", "analyzeKeyKS", "getNoteList",
+   "extract", "combine", "write"
+};
+
+
+// Random number generator which gives the same sequence on all computers
+// (xorshift64*), so that a seed always generates the same score.
+class SynthRandom {
+   public:
+      SynthRandom(unsigned long long seed = 1) { setSeed(seed); }
+      void setSeed(unsigned long long seed) {
+         state = seed * 0x9E3779B97F4A7C15ULL + 1;
+      }
+      unsigned long long next(void) {
+         state ^= state >> 12;
+         state ^= state << 25;
+         state ^= state >> 27;
+         return state * 0x2545F4914F6CDD1DULL;
+      }
+      // random integer from 0 to count-1:
+      int range(int count) { return (int)((next() >> 11) % count); }
+      // true with the given percent probability:
+      int chance(double percent) {
+         return (next() >> 11) * (1.0 / 9007199254740992.0) * 100.0 < percent;
+      }
+   protected:
+      unsigned long long state;
+};
+
+
+// Current state of a voice in the synthetic score:
+class SynthVoice {
+   public:
+      SynthVoice(void) { pitch = 0; center = 0; tie = 0; }
+      int pitch;           // diatonic pitch of the last note (C0 = 0)
+      int center;          // diatonic pitch around which the voice wanders
+      int tie;             // the last note is tied to the next one
+      string accidental;   // accidental of the last note
+};
+
+
+// A note or rest in a measure of the synthetic score:
+class SynthEvent {
+   public:
+      SynthEvent(void) { tick = 0; }
+      int    tick;         // starting time in the measure
+      string token;        // **kern data token
+};
+
+
+// function declarations
+void      checkOptions       (Options& opts, int argc, char* argv[]);
+void      getPhases          (const string& list);
+void      example            (void);
+void      usage              (const char* command);
+void      generateScore      (ostream& out);
+void      generateMeasure    (ostream& out, vector<SynthVoice>& voices,
+                              int measure, int lastQ);
+void      generateVoice      (vector<SynthEvent>& events, SynthVoice& voice,
+                              int tieQ);
+void      addBeat            (vector<int>& durations, int tick);
+string    makeNote           (SynthVoice& voice, int duration, int tiein,
+                              int tieout);
+string    getKernPitch       (int diatonic, const string& accidental);
+string    getRecip           (int duration);
+void      benchmarkData      (const string& name, const string& data);
+void      printPhaseOutput   (const string& name, const string& data);
+int       isExtractable      (HumdrumFile& infile);
+void      removeNullLines    (HumdrumFile& output, HumdrumFile& input);
+int       checkRoundTrip     (HumdrumFile& infile, const string& text);
+double    getTime            (void);
+long      getPeakMemory      (void);
+void      printHeader        (void);
+void      printResult        (const string& name, int phase, int lines,
+                              long bytes, vector<double>& times, long memory);
+
+
+// global variables
+Options     options;            // database for command-line arguments
+int         generateQ  = 0;     // used with -g option
+int         spines     = 4;     // used with -s option
+int         lines      = 100000;  // used with -l option
+int         seed       = 1;     // used with --seed option
+double      chords     = 10.0;  // used with --chords option
+double      tuplets    = 5.0;   // used with --tuplets option
+double      ties       = 5.0;   // used with --ties option
+double      splits     = 5.0;   // used with --splits option
+double      rests      = 5.0;   // used with --rests option
+int         repeat     = 3;     // used with -r option
+vector<int> phaseQ(PHASE_COUNT, 1);  // used with -p option
+int         printphase = -1;    // used with --print option
+int         failures   = 0;     // number of round-trip errors
+SynthRandom rng;                // random numbers for synthetic score
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[]) {
+   checkOptions(options, argc, argv);
+   rng.setSeed(seed);
+
+   if (generateQ) {
+      generateScore(cout);
+      return 0;
+   }
+
+   int numinputs = options.getArgCount();
+   if (printphase >= 0) {
+      for (int i=0; i<numinputs; i++) {
+         ifstream infile(options.getArg(i+1).c_str());
+         if (!infile.is_open()) {
+            cerr << "Error: cannot read file " << options.getArg(i+1) << endl;
+            exit(1);
+         }
+         stringstream contents;
+         contents << infile.rdbuf();
+         printPhaseOutput(options.getArg(i+1), contents.str());
+      }
+      if (numinputs == 0) {
+         stringstream synth;
+         generateScore(synth);
+         printPhaseOutput("synthetic", synth.str());
+      }
+      return 0;
+   }
+
+   printHeader();
+
+   if (numinputs == 0) {
+      stringstream synth;
+      generateScore(synth);
+      benchmarkData("synthetic", synth.str());
+   }
+   for (int i=0; i<numinputs; i++) {
+      ifstream infile(options.getArg(i+1).c_str());
+      if (!infile.is_open()) {
+         cerr << "Error: cannot read file " << options.getArg(i+1) << endl;
+         exit(1);
+      }
+      stringstream contents;
+      contents << infile.rdbuf();
+      benchmarkData(options.getArg(i+1), contents.str());
+   }
+
+   cout << "*-\t*-\t*-\t*-\t*-\t*-\t*-\t*-\t*-\n";
+   cout << "!!!round-trip-failures: " << failures << endl;
+
+   return failures ? 1 : 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// benchmarkData -- time each phase on the given Humdrum data.  The data
+//    is read from memory so that disk speed is not measured.  Each phase
+//    is repeated, and the fastest time is used for the throughput.
+//
+
+void benchmarkData(const string& name, const string& data) {
+   vector<vector<double> > times(PHASE_COUNT);
+   vector<long> memory(PHASE_COUNT, 0);
+   int linecount = 0;
+   double start;
+   int r, i;
+
+   for (r=0; r<repeat; r++) {
+      HumdrumFile infile;
+
+      // parse the data:
+      stringstream input(data);
+      start = getTime();
+      infile.read(input);
+      times[PHASE_READ].push_back(getTime() - start);
+      memory[PHASE_READ] = getPeakMemory();
+      linecount = infile.getNumLines();
+
+      // rhythm analysis (always done since the other phases need it):
+      start = getTime();
+      infile.analyzeRhythm("4");
+      times[PHASE_RHYTHM].push_back(getTime() - start);
+      memory[PHASE_RHYTHM] = getPeakMemory();
+
+      // note array:
+      if (phaseQ[PHASE_NOTEARRAY]) {
+         Array<double> absbeat;
+         Array<int>    pitches;
+         Array<double> durations;
+         Array<double> levels;
+         start = getTime();
+         infile.getNoteArray(absbeat, pitches, durations, levels);
+         times[PHASE_NOTEARRAY].push_back(getTime() - start);
+         memory[PHASE_NOTEARRAY] = getPeakMemory();
+      }
+
+      // key analysis of the entire file:
+      if (phaseQ[PHASE_KEYKS]) {
+         Array<double> scores;
+         start = getTime();
+         infile.analyzeKeyKS(scores, 0, infile.getNumLines() - 1);
+         times[PHASE_KEYKS].push_back(getTime() - start);
+         memory[PHASE_KEYKS] = getPeakMemory();
+      }
+
+      // sounding notes on each line:
+      if (phaseQ[PHASE_NOTELIST]) {
+         Array<int> notes;
+         start = getTime();
+         for (i=0; i<infile.getNumLines(); i++) {
+            if (infile[i].isData()) {
+               infile.getNoteList(notes, i, NL_FILL | NL_SORT);
+            }
+         }
+         times[PHASE_NOTELIST].push_back(getTime() - start);
+         memory[PHASE_NOTELIST] = getPeakMemory();
+      }
+
+      // extract the first and last spines and combine them again (only
+      // possible if these spines are never split):
+      if ((phaseQ[PHASE_EXTRACT] || phaseQ[PHASE_COMBINE]) &&
+            isExtractable(infile)) {
+         start = getTime();
+         HumdrumFile firstspine = infile.extract(0);
+         HumdrumFile lastspine  = infile.extract(-1);
+         times[PHASE_EXTRACT].push_back(getTime() - start);
+         memory[PHASE_EXTRACT] = getPeakMemory();
+
+         if (phaseQ[PHASE_COMBINE]) {
+            HumdrumFile first;
+            HumdrumFile last;
+            removeNullLines(first, firstspine);
+            removeNullLines(last, lastspine);
+            first.analyzeRhythm("4");
+            last.analyzeRhythm("4");
+            HumdrumFile combined;
+            start = getTime();
+            HumdrumFile::combine(combined, first, last);
+            times[PHASE_COMBINE].push_back(getTime() - start);
+            memory[PHASE_COMBINE] = getPeakMemory();
+         }
+      }
+
+      // write the data and check that it is the same when read again:
+      if (phaseQ[PHASE_WRITE]) {
+         stringstream output;
+         start = getTime();
+         infile.write(output);
+         times[PHASE_WRITE].push_back(getTime() - start);
+         memory[PHASE_WRITE] = getPeakMemory();
+         if ((r == 0) && !checkRoundTrip(infile, output.str())) {
+            cerr << "Error: " << name << " changed after writing and reading"
+                 << endl;
+            failures++;
+         }
+      }
+   }
+
+   for (i=0; i<PHASE_COUNT; i++) {
+      if (phaseQ[i]) {
+         printResult(name, i, linecount, data.size(), times[i], memory[i]);
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// printPhaseOutput -- print the results of the extract or combine phase
+//    instead of timing them, so that they can be checked.  For extract,
+//    the first and last spines are printed, each followed by its
+//    duration from analyzeRhythm().
+//
+
+void printPhaseOutput(const string& name, const string& data) {
+   HumdrumFile infile;
+   stringstream input(data);
+   infile.read(input);
+   infile.analyzeRhythm("4");
+   if (!isExtractable(infile)) {
+      cerr << "Error: the first and last spines of " << name
+           << " cannot be extracted" << endl;
+      exit(1);
+   }
+
+   HumdrumFile firstspine = infile.extract(0);
+   HumdrumFile lastspine  = infile.extract(-1);
+   if (printphase == PHASE_EXTRACT) {
+      firstspine.analyzeRhythm("4");
+      lastspine.analyzeRhythm("4");
+      cout << firstspine;
+      cout << "!!!duration: " << firstspine.getTotalDurationR() << "\n";
+      cout << lastspine;
+      cout << "!!!duration: " << lastspine.getTotalDurationR() << "\n";
+      return;
+   }
+
+   HumdrumFile first;
+   HumdrumFile last;
+   removeNullLines(first, firstspine);
+   removeNullLines(last, lastspine);
+   first.analyzeRhythm("4");
+   last.analyzeRhythm("4");
+   HumdrumFile combined;
+   HumdrumFile::combine(combined, first, last);
+   cout << combined;
+}
+
+
+
+//////////////////////////////
+//
+// isExtractable -- returns true if the first and last spines are **kern
+//    spines which are never split or joined, so that HumdrumFile::extract()
+//    can be used on them, and the results have the same duration for
+//    HumdrumFile::combine().
+//
+
+int isExtractable(HumdrumFile& infile) {
+   int i, last;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (!infile[i].isInterpretation()) {
+         continue;
+      }
+      last = infile[i].getFieldCount() - 1;
+      if ((infile[i].getExInterpNum(0) != E_KERN_EXINT) ||
+          (infile[i].getExInterpNum(last) != E_KERN_EXINT)) {
+         return 0;
+      }
+      if ((strcmp(infile[i][0], "*^") == 0) ||
+          (strcmp(infile[i][0], "*v") == 0) ||
+          (strcmp(infile[i][0], "*x") == 0) ||
+          (strcmp(infile[i][last], "*^") == 0) ||
+          (strcmp(infile[i][last], "*v") == 0) ||
+          (strcmp(infile[i][last], "*x") == 0)) {
+         return 0;
+      }
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// removeNullLines -- copy a file without the data lines which contain
+//     only null tokens (HumdrumFile::combine() needs a data token on
+//     every data line of its inputs).
+//
+
+void removeNullLines(HumdrumFile& output, HumdrumFile& input) {
+   stringstream text;
+   for (int i=0; i<input.getNumLines(); i++) {
+      if (input[i].isData() && input[i].isNull()) {
+         continue;
+      }
+      text << input[i] << "\n";
+   }
+   output.read(text);
+}
+
+
+
+//////////////////////////////
+//
+// checkRoundTrip -- returns true if the written text gives the same
+//     lines when it is read again.
+//
+
+int checkRoundTrip(HumdrumFile& infile, const string& text) {
+   HumdrumFile copy;
+   stringstream input(text);
+   copy.read(input);
+   if (copy.getNumLines() != infile.getNumLines()) {
+      return 0;
+   }
+   for (int i=0; i<infile.getNumLines(); i++) {
+      if (strcmp(copy[i].getLine(), infile[i].getLine()) != 0) {
+         return 0;
+      }
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// printHeader -- print the settings of the benchmark and the start of
+//     the result table.
+//
+
+void printHeader(void) {
+   cout << "!!!bench-compiled: " << __DATE__ << endl;
+   cout << "!!!bench-library: " << MUSEINFO_VERSION << endl;
+   cout << "!!!bench-repeat: " << repeat << endl;
+   if (options.getArgCount() == 0) {
+      cout << "!!!bench-synthetic: -s " << spines << " -l " << lines
+           << " --seed " << seed << " --chords " << chords
+           << " --tuplets " << tuplets << " --ties " << ties
+           << " --splits " << splits << " --rests " << rests << endl;
+   }
+   cout << "**input\t**phase\t**lines\t**bytes\t**best-ms\t**mean-ms"
+        << "\t**lines/s\t**MB/s\t**peak-kb\n";
+}
+
+
+
+//////////////////////////////
+//
+// printResult -- print the timing of one phase.  The throughput is
+//    calculated from the fastest repetition.  The peak memory is the
+//    largest resident size of the program up to the end of the phase.
+//
+
+void printResult(const string& name, int phase, int lines, long bytes,
+      vector<double>& times, long memory) {
+   if (times.empty()) {
+      return;
+   }
+   double best = times[0];
+   double sum  = 0.0;
+   for (int i=0; i<(int)times.size(); i++) {
+      if (times[i] < best) {
+         best = times[i];
+      }
+      sum += times[i];
+   }
+   double mean = sum / times.size();
+   if (best <= 0.0) {
+      best = 1.0e-9;
+   }
+
+   char buffer[1024];
+   snprintf(buffer, sizeof(buffer), "\t%s\t%d\t%ld\t%.3f\t%.3f\t%.0f\t%.2f\t%ld",
+         PhaseNames[phase], lines, bytes, best * 1000.0, mean * 1000.0,
+         lines / best, bytes / best / 1000000.0, memory);
+   cout << name << buffer << "\n";
+}
+
+
+
+//////////////////////////////
+//
+// getTime -- return the current time in seconds.
+//
+
+double getTime(void) {
+   return chrono::duration<double>(
+         chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+//////////////////////////////
+//
+// getPeakMemory -- return the largest resident memory size of the program
+//     so far in kilobytes.
+//
+
+long getPeakMemory(void) {
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0;
+   }
+   #ifdef __APPLE__
+      return usage.ru_maxrss / 1024;   // bytes on OS X
+   #else
+      return usage.ru_maxrss;          // kilobytes on linux
+   #endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// Synthetic score generation
+//
+
+//////////////////////////////
+//
+// generateScore -- print a **kern score in 4/4 with the given number of
+//    spines until at least the given number of lines are printed.
+//    Inner spines are occasionally split into two voices for a measure,
+//    but the first and last spines are never split so that they can be
+//    extracted.
+//
+
+void generateScore(ostream& out) {
+   vector<SynthVoice> voices(spines);
+   int i;
+   for (i=0; i<spines; i++) {
+      // start the lowest spine around C3, and the others higher:
+      voices[i].center = 21 + i * 5;
+      if (voices[i].center > 42) {
+         voices[i].center = 42;
+      }
+      voices[i].pitch = voices[i].center;
+   }
+
+   stringstream header;
+   header << "!!!COM: humbench\n";
+   header << "!!!OTL: Synthetic benchmark score " << seed << "\n";
+   const char* interps[4] = {"**kern", "*M4/4", "*C:", "*k[]"};
+   for (int j=0; j<4; j++) {
+      for (i=0; i<spines; i++) {
+         header << interps[j];
+         header << (i < spines - 1 ? "\t" : "\n");
+      }
+   }
+   string text = header.str();
+   out << text;
+
+   // count the lines printed so far, leaving two for the ending:
+   int count = 6 + 2;
+   int measure = 1;
+   while (count < lines) {
+      stringstream mdata;
+      generateMeasure(mdata, voices, measure, 0);
+      text = mdata.str();
+      out << text;
+      for (i=0; i<(int)text.size(); i++) {
+         if (text[i] == '\n') {
+            count++;
+         }
+      }
+      measure++;
+   }
+   // final measure must not leave any ties open:
+   generateMeasure(out, voices, measure, 1);
+
+   for (i=0; i<spines; i++) {
+      out << "==" << (i < spines - 1 ? "\t" : "\n");
+   }
+   for (i=0; i<spines; i++) {
+      out << "*-" << (i < spines - 1 ? "\t" : "\n");
+   }
+}
+
+
+
+//////////////////////////////
+//
+// generateMeasure -- print a barline and one measure of music.  The
+//     notes of all voices are aligned on a common time grid, with null
+//     tokens for sustained notes.
+//
+
+void generateMeasure(ostream& out, vector<SynthVoice>& voices, int measure,
+      int lastQ) {
+   int i, j, k;
+
+   // decide which spines are split into two voices in this measure:
+   vector<int> splitQ(spines, 0);
+   int anysplit = 0;
+   for (i=1; i<spines-1; i++) {
+      if (rng.chance(splits)) {
+         splitQ[i] = 1;
+         anysplit = 1;
+      }
+   }
+
+   for (i=0; i<spines; i++) {
+      out << "=" << measure << (i < spines - 1 ? "\t" : "\n");
+   }
+
+   if (anysplit) {
+      for (i=0; i<spines; i++) {
+         out << (splitQ[i] ? "*^" : "*") << (i < spines - 1 ? "\t" : "\n");
+      }
+   }
+
+   // generate the notes of each voice (an added voice of a split
+   // spine starts and ends in the measure, so it cannot have ties
+   // leaving the measure):
+   vector<vector<SynthEvent> > events;
+   vector<SynthVoice> added;
+   added.reserve(spines);
+   for (i=0; i<spines; i++) {
+      events.resize(events.size() + 1);
+      generateVoice(events.back(), voices[i], !lastQ);
+      if (splitQ[i]) {
+         added.push_back(voices[i]);
+         added.back().center += 4;
+         added.back().pitch   = added.back().center;
+         added.back().tie     = 0;
+         events.resize(events.size() + 1);
+         generateVoice(events.back(), added.back(), 0);
+      }
+   }
+
+   // merge the starting times of the notes in all voices:
+   vector<int> ticks;
+   for (i=0; i<(int)events.size(); i++) {
+      for (j=0; j<(int)events[i].size(); j++) {
+         ticks.push_back(events[i][j].tick);
+      }
+   }
+   sort(ticks.begin(), ticks.end());
+   ticks.erase(unique(ticks.begin(), ticks.end()), ticks.end());
+
+   vector<int> position(events.size(), 0);
+   for (k=0; k<(int)ticks.size(); k++) {
+      for (i=0; i<(int)events.size(); i++) {
+         if ((position[i] < (int)events[i].size()) &&
+               (events[i][position[i]].tick == ticks[k])) {
+            out << events[i][position[i]].token;
+            position[i]++;
+         } else {
+            out << ".";
+         }
+         out << (i < (int)events.size() - 1 ? "\t" : "\n");
+      }
+   }
+
+   // join the split spines one at a time, since adjacent *v tokens
+   // would merge more than two voices:
+   for (k=0; k<spines; k++) {
+      if (!splitQ[k]) {
+         continue;
+      }
+      for (i=0; i<spines; i++) {
+         if (i == k) {
+            out << "*v\t*v";
+         } else {
+            out << (splitQ[i] ? "*\t*" : "*");
+         }
+         out << (i < spines - 1 ? "\t" : "\n");
+      }
+      splitQ[k] = 0;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// generateVoice -- create the notes and rests of one voice for a measure.
+//     If tieQ is zero, then the last note of the measure will not be tied
+//     to the next measure.
+//
+
+void generateVoice(vector<SynthEvent>& events, SynthVoice& voice, int tieQ) {
+   vector<int> durations;
+   int tick = 0;
+   while (tick < TICKS_PER_MEASURE) {
+      addBeat(durations, tick);
+      tick = 0;
+      for (int i=0; i<(int)durations.size(); i++) {
+         tick += durations[i];
+      }
+   }
+
+   events.resize(durations.size());
+   tick = 0;
+   int tiein, tieout;
+   for (int i=0; i<(int)durations.size(); i++) {
+      events[i].tick = tick;
+      tiein = voice.tie;
+      tieout = rng.chance(ties);
+      if ((i == (int)durations.size() - 1) && !tieQ) {
+         tieout = 0;
+      }
+      events[i].token = makeNote(voice, durations[i], tiein, tieout);
+      tick += durations[i];
+   }
+}
+
+
+
+//////////////////////////////
+//
+// addBeat -- add the durations of the next beat (or half or whole note)
+//     of a voice.  Beats are occasionally divided into triplets.
+//
+
+void addBeat(vector<int>& durations, int tick) {
+   const int q = TICKS_PER_QUARTER;
+   if ((tick == 0) && rng.chance(3.0)) {
+      durations.push_back(4 * q);                   // whole note
+      return;
+   }
+   if ((tick % (2 * q) == 0) && rng.chance(12.0)) {
+      durations.push_back(2 * q);                   // half note
+      return;
+   }
+   if (rng.chance(tuplets)) {
+      if (rng.range(2)) {
+         durations.push_back(q / 3);                // 12 12 12
+         durations.push_back(q / 3);
+         durations.push_back(q / 3);
+      } else {
+         durations.push_back(2 * q / 3);            // 6 12
+         durations.push_back(q / 3);
+      }
+      return;
+   }
+   switch (rng.range(6)) {
+      case 0:
+      case 1:
+         durations.push_back(q);                    // 4
+         break;
+      case 2:
+         durations.push_back(q / 2);                // 8 8
+         durations.push_back(q / 2);
+         break;
+      case 3:
+         durations.push_back(3 * q / 4);            // 8. 16
+         durations.push_back(q / 4);
+         break;
+      case 4:
+         durations.push_back(q / 4);                // 16 16 8
+         durations.push_back(q / 4);
+         durations.push_back(q / 2);
+         break;
+      default:
+         durations.push_back(q / 4);                // 16 16 16 16
+         durations.push_back(q / 4);
+         durations.push_back(q / 4);
+         durations.push_back(q / 4);
+         break;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// makeNote -- create a **kern token for a note, chord or rest.  A note
+//    which is tied from the previous note has the same pitch.
+//
+
+string makeNote(SynthVoice& voice, int duration, int tiein, int tieout) {
+   string recip = getRecip(duration);
+   voice.tie = 0;
+
+   if (tiein) {
+      string pitch = getKernPitch(voice.pitch, voice.accidental);
+      voice.tie = tieout;
+      return recip + pitch + (tieout ? "_" : "]");
+   }
+
+   if (!tieout && rng.chance(rests)) {
+      return recip + "r";
+   }
+
+   // wander up or down by a step or skip, staying near the center:
+   int motion = rng.range(5) - 2;
+   if (voice.pitch - voice.center > 5) {
+      motion = -1 - rng.range(2);
+   } else if (voice.center - voice.pitch > 5) {
+      motion = 1 + rng.range(2);
+   }
+   voice.pitch += motion;
+   voice.accidental = "";
+   if (rng.chance(5.0)) {
+      voice.accidental = rng.range(2) ? "#" : "-";
+   }
+   string pitch = getKernPitch(voice.pitch, voice.accidental);
+
+   if (tieout) {
+      voice.tie = 1;
+      return "[" + recip + pitch;
+   }
+
+   if (rng.chance(chords)) {
+      // add a third, and sometimes a fifth, above the note:
+      string output = recip + pitch + " " + recip +
+            getKernPitch(voice.pitch + 2, "");
+      if (rng.range(2)) {
+         output += " " + recip + getKernPitch(voice.pitch + 4, "");
+      }
+      return output;
+   }
+
+   return recip + pitch;
+}
+
+
+
+//////////////////////////////
+//
+// getKernPitch -- convert a diatonic pitch number (C0 = 0) into **kern
+//     pitch letters.
+//
+
+string getKernPitch(int diatonic, const string& accidental) {
+   const char* uppers = "CDEFGAB";
+   const char* lowers = "cdefgab";
+   int octave = diatonic / 7;
+   int step   = diatonic % 7;
+   string output;
+   if (octave >= 4) {
+      output.append(octave - 3, lowers[step]);
+   } else {
+      output.append(4 - octave, uppers[step]);
+   }
+   return output + accidental;
+}
+
+
+
+//////////////////////////////
+//
+// getRecip -- convert a duration in ticks into a **kern rhythm.
+//
+
+string getRecip(int duration) {
+   const int q = TICKS_PER_QUARTER;
+   if (duration == 4 * q)     { return "1";  }
+   if (duration == 2 * q)     { return "2";  }
+   if (duration == q)         { return "4";  }
+   if (duration == 3 * q / 4) { return "8."; }
+   if (duration == 2 * q / 3) { return "6";  }
+   if (duration == q / 2)     { return "8";  }
+   if (duration == q / 3)     { return "12"; }
+   if (duration == q / 4)     { return "16"; }
+   cerr << "Error: unknown duration " << duration << endl;
+   exit(1);
+}
+
+
+
+//////////////////////////////
+//
+// checkOptions --
+//
+
+void checkOptions(Options& opts, int argc, char* argv[]) {
+   opts.define("g|generate=b",   "print the synthetic score only");
+   opts.define("s|spines=i:4",   "number of spines in synthetic score");
+   opts.define("l|lines=i:100000", "minimum lines in synthetic score");
+   opts.define("seed=i:1",       "random seed for synthetic score");
+   opts.define("chords=d:10",    "percent of notes which are chords");
+   opts.define("tuplets=d:5",    "percent of beats divided into triplets");
+   opts.define("ties=d:5",       "percent of notes tied to the next note");
+   opts.define("splits=d:5",     "percent of measures in which a spine splits");
+   opts.define("rests=d:5",      "percent of notes which are rests");
+   opts.define("r|repeat=i:3",   "number of times to run each phase");
+   opts.define("p|phases=s",     "comma-separated list of phases to time");
+   opts.define("print=s",        "print output of extract or combine phase");
+
+   opts.define("author=b");      // author of program
+   opts.define("version=b");     // compilation info
+   opts.define("example=b");     // example usages
+   opts.define("h|help=b");      // short description
+   opts.process(argc, argv);
+
+   // handle basic options:
+   if (opts.getBoolean("author")) {
+      cout << "Written by Craig Stuart Sapp, "
+           << "craig@ccrma.stanford.edu, Oct 2026" << endl;
+      exit(0);
+   } else if (opts.getBoolean("version")) {
+      cout << argv[0] << ", version: 18 October 2026" << endl;
+      cout << "compiled: " << __DATE__ << endl;
+      cout << MUSEINFO_VERSION << endl;
+      exit(0);
+   } else if (opts.getBoolean("help")) {
+      usage(opts.getCommand().c_str());
+      exit(0);
+   } else if (opts.getBoolean("example")) {
+      example();
+      exit(0);
+   }
+
+   generateQ = opts.getBoolean("generate");
+   spines    = opts.getInteger("spines");
+   lines     = opts.getInteger("lines");
+   seed      = opts.getInteger("seed");
+   chords    = opts.getDouble("chords");
+   tuplets   = opts.getDouble("tuplets");
+   ties      = opts.getDouble("ties");
+   splits    = opts.getDouble("splits");
+   rests     = opts.getDouble("rests");
+   repeat    = opts.getInteger("repeat");
+
+   if (opts.getBoolean("phases")) {
+      getPhases(opts.getString("phases"));
+   }
+   if (opts.getBoolean("print")) {
+      string phase = opts.getString("print");
+      if (phase == PhaseNames[PHASE_EXTRACT]) {
+         printphase = PHASE_EXTRACT;
+      } else if (phase == PhaseNames[PHASE_COMBINE]) {
+         printphase = PHASE_COMBINE;
+      } else {
+         cerr << "Error: only the extract or combine phase can be printed"
+              << endl;
+         exit(1);
+      }
+   }
+
+   if (spines < 1) {
+      spines = 1;
+   }
+   if (repeat < 1) {
+      repeat = 1;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// getPhases -- select the phases to time from a list of phase names.
+//     Reading and rhythm analysis are always done, since the other
+//     phases need them, but they are only printed if listed.
+//
+
+void getPhases(const string& list) {
+   int i;
+   for (i=0; i<PHASE_COUNT; i++) {
+      phaseQ[i] = 0;
+   }
+   stringstream names(list);
+   string name;
+   while (getline(names, name, ',')) {
+      for (i=0; i<PHASE_COUNT; i++) {
+         if (name == PhaseNames[i]) {
+            phaseQ[i] = 1;
+            break;
+         }
+      }
+      if (i >= PHASE_COUNT) {
+         cerr << "Error: unknown phase " << name << endl;
+         cerr << "Phases:";
+         for (i=0; i<PHASE_COUNT; i++) {
+            cerr << " " << PhaseNames[i];
+         }
+         cerr << endl;
+         exit(1);
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// example --
+//
+
+void example(void) {
+   cout <<
+   "                                                                        \n"
+   "# benchmark a synthetic score of one million lines:                     \n"
+   "     humbench -l 1000000                                                \n"
+   "# save the synthetic score:                                             \n"
+   "     humbench -g -s 6 -l 5000 --seed 7 > synth.krn                      \n"
+   "# time only parsing and writing a larger score:                         \n"
+   "     humbench -l 2000000 -p read,write                                  \n"
+   "# benchmark existing files:                                             \n"
+   "     humbench file1.krn file2.krn                                       \n"
+   "# check the result of combining the first and last spines:              \n"
+   "     humbench --print combine file.krn                                  \n"
+   "                                                                        \n"
+   << endl;
+}
+
+
+
+//////////////////////////////
+//
+// usage --
+//
+
+void usage(const char* command) {
+   cout <<
+   "                                                                        \n"
+   "Measures the speed of reading, analyzing and writing Humdrum data.      \n"
+   "If no files are given, a synthetic score is generated for the test.     \n"
+   "                                                                        \n"
+   "Usage: " << command << " [-g][-s spines][-l lines][--seed n] [input(s)]\n"
+   "                                                                        \n"
+   "Options:                                                                \n"
+   "   -g         = print the synthetic score instead of timing it          \n"
+   "   -s spines  = number of **kern spines in the synthetic score          \n"
+   "   -l lines   = minimum number of lines in the synthetic score          \n"
+   "   -r count   = number of times to run each phase (default 3)           \n"
+   "   -p phases  = comma-separated phases to time (default all)            \n"
+   "   --print ph = print output of the extract or combine phase instead     \n"
+   "   --options  = list of all options, aliases and default values         \n"
+   "                                                                        \n"
+   << endl;
+}
+
+
+
@@ -3,6 +3,7 @@
 // Creation Date: Mon May  3 21:54:58 PDT 2010
 // Last Modified: Thu May  6 23:16:19 PDT 2010
 // Last Modified  Mon Feb  7 17:55:04 PST 2011 (fixed md5sum calculation)
+// Last Modified: Sun Oct 18 21:51:40 PDT 2026 (reject xref streams)
 // Filename:      ...sig/examples/all/make64.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/humpdf.cpp
 // Syntax:        C++; museinfo
@@ -120,6 +121,13 @@ int main(int argc, char** argv) {
       exit(1);
    }
 
+   // A classic xref section is appended to the file, which cannot follow
+   // a cross-reference stream.
+   if (pdffile.hasXrefStream()) {
+      cerr << "ERROR: unsupported xref stream in file " << pdffilename << endl;
+      exit(1);
+   }
+
    // figure out the number of input files to process
    int numinputs = options.getArgCount();
 
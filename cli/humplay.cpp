@@ -9,6 +9,11 @@
 // Last Modified: Thu Mar 24 04:22:03 PDT 2011 Fixes for 64-bit compiling.
 // Last Modified: Wed Mar  6 20:35:15 PST 2013 SetKey() was missing?
 // Last Modified: Wed Mar  6 20:35:15 PST 2013 Various changes.
+// Last Modified: Sun Oct 18 18:35:43 PDT 2026 Precompiled event schedule.
+// Last Modified: Sun Oct 18 18:35:43 PDT 2026 Added --virtual and --stats.
+// Last Modified: Sun Oct 18 20:48:24 PDT 2026 Added --schedule.
+// Last Modified: Sun Oct 18 21:42:38 PDT 2026 Accents raise the velocity as before.
+// Last Modified: Sun Oct 18 21:42:44 PDT 2026 Accents only change their own velocity.
 // Filename:      ...sig/doc/examples/all/hplay/hplay.cpp
 // Syntax:        C++
 //
@@ -16,8 +21,12 @@
 //
 
 #include <sstream>
+#include <fstream>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
 #include <string.h>
 
@@ -43,9 +52,49 @@ using namespace std;
 #define COLOR_MARKS          8
 #define COLOR_COMMENT        9
 
+// schedule event types:
+#define EVENT_NOTE           0
+#define EVENT_TEMPO          1
+#define EVENT_LINE           2
+
+// note articulations stored in PlayEvent::flags:
+#define ARTIC_STACCATO       1
+#define ARTIC_ACCENT         2
+#define ARTIC_SFORZANDO      4
+
+// PlayEvent -- an entry in the schedule of a file, which is created before
+//    the file starts to play.  Events are in the order of the lines in the
+//    file, which is also the order of their start times.  Notes are stored
+//    without the interactive settings (tempo, transposition, muting and
+//    velocity), which are applied when the note is played.
+class PlayEvent {
+   public:
+      double beat;        // start time in quarter notes from start of file
+      int    type;        // EVENT_NOTE, EVENT_TEMPO or EVENT_LINE
+      int    line;        // line in the file which generated the event
+      int    track;       // primary track of a note (for muting)
+      int    key;         // MIDI key number of a note (untransposed)
+      int    flags;       // articulations of a note
+      double value;       // duration of note (with ties) or new tempo
+};
+
+// NoteOff -- a note which has been started and will be turned off.
+class NoteOff {
+   public:
+      double time;        // time in milliseconds to turn off the note
+      int    key;         // MIDI key number of the note
+};
+
 double tempo = 120.0;     // current metronome tempo
-SigTimer timer;           // for playing the humdrum file
-EventBuffer eventBuffer;  // for storing note offs when playing notes
+vector<PlayEvent> schedule;    // events of the current file
+vector<int> lineEvents;   // index of first event in schedule for each line
+int eventIndex    = 0;    // next event in schedule to play
+double dueTime    = 0.0;  // time in ms when the next event should be played
+vector<NoteOff> noteoffs; // heap of notes waiting to be turned off
+int    latecount  = 0;    // number of MIDI messages sent
+double latesum    = 0.0;  // sum of message lateness in ms
+double latesumsq  = 0.0;  // sum of squared message lateness
+double latemax    = 0.0;  // largest message lateness in ms
 
 HumdrumStream streamer;   // for inputting multiple Humdrum files/segments
 HumdrumFile data;         // humdrum file to play
@@ -68,15 +117,31 @@ int markerindex   =  0;   // place to store first marker
 int mine          = 30;   // used with the -m option
 int shortenQ      =  0;   // used with the -s option
 int shortenamount = 30;   // used with the -s option
+int statsQ        =  0;   // used with --stats option
+int virtualQ      =  0;   // used with --virtual option
+ofstream virtualout;      // used with --virtual option
 
 // non-synthImprov function declarations:
 
 void     checkOptions            (void);
 void     inputNewFile            (void);
-void     playdata                (HumdrumFile& data, int& linenum,
-                                  SigTimer& timer);
+void     playdata                (double now);
 void     printInputLine          (HumdrumFile& infile, int line);
-void     processNotes            (HumdrumRecord& record);
+void     compileSchedule         (vector<PlayEvent>& schedule,
+                                  vector<int>& lineEvents, HumdrumFile& infile);
+void     storeNotes              (vector<PlayEvent>& schedule,
+                                  HumdrumFile& infile, int line);
+void     playNote                (PlayEvent& event, double due, double now);
+void     sendNoteOffs            (double now);
+void     silenceNotes            (void);
+void     sendMidi                (int command, int key, int velocity,
+                                  double due, double now);
+void     resetSchedule           (void);
+void     printSchedule           (ostream& out, vector<PlayEvent>& schedule,
+                                  vector<int>& lineEvents, HumdrumFile& infile);
+double   getCurrentTime          (void);
+void     printLatencyStats       (ostream& out);
+int      noteoffcompare          (const NoteOff& a, const NoteOff& b);
 int      getMeasureLine          (HumdrumFile& data, int number);
 ostream& colormessage            (ostream& out, int messagetype, int mode,
                                   int status);
@@ -132,11 +197,7 @@ void description(void) {
 
 void initialization(void) {
 	checkOptions();
-	timer.setPeriod(500);
-	timer.reset();
 	eventIdler.setPeriod(0);
-	eventBuffer.setPollPeriod(10);
-	eventBuffer.setPort(synth.getOutputPort());
 	if (colorQ) {
 		colormessage(cout, COLOR_INIT, colormode, colorQ);
 		colormessage(cout, COLOR_CLEAR_SCREEN, colormode, colorQ);
@@ -162,10 +223,17 @@ void initialization(void) {
 //
 
 void finishup(void) {
-	eventBuffer.off();
+	silenceNotes();
 	printAllMarkers(cout, markers, data);
 	std::fill(markers.begin(), markers.end(), 0);
 	colormessage(cout, COLOR_RESET, colormode, colorQ);
+	if (statsQ || virtualQ) {
+		printLatencyStats(cerr);
+	}
+	if (virtualQ) {
+		virtualout << "*-\t*-\t*-\n";
+		virtualout.close();
+	}
 }
 
 
@@ -174,18 +242,19 @@ void finishup(void) {
 //////////////////////////////
 //
 // mainloopalgorithms -- This function is called continuously while
-//    the programming is running.  It checks to determine whether another
-//    line of the Humdrum file is ready to be played.
+//    the programming is running.  It turns off notes which have ended
+//    and checks whether the next events in the schedule are due.
 //
 
 void mainloopalgorithms(void) {
-	eventBuffer.checkPoll();
+	double now = getCurrentTime();
+	sendNoteOffs(now);
 	if (pauseQ) {
 		return;
 	}
-	if (timer.expired()) {
-		playdata(data, linenum, timer);
-		if (linenum >= data.getNumLines()) {
+	if (now >= dueTime) {
+		playdata(now);
+		if (eventIndex >= (int)schedule.size()) {
 			printAllMarkers(cout, markers, data);
 			std::fill(markers.begin(), markers.end(), 0);
 			inputNewFile();
@@ -308,8 +377,8 @@ void keyboardchar(int key) {
 			}
 			break;
 		case 'p':               // toggle music pausing
-			eventBuffer.off();
-			timer.reset();
+			silenceNotes();
+			resetSchedule();
 			pauseQ = !pauseQ;
 			if (pauseQ) {
 				cout << "!! Paused" << endl;
@@ -327,20 +396,20 @@ void keyboardchar(int key) {
 			if (number == 0) {
 				linenum = markers[0];
 				cout << "!! Going to line " << linenum << endl;
-				eventBuffer.off();
-				timer.reset();
+				silenceNotes();
+				resetSchedule();
 			} else if (number < (int)markers.size()) {
 				linenum = markers[number];
 				cout << "!! Going to line " << linenum << endl;
-				eventBuffer.off();
-				timer.reset();
+				silenceNotes();
+				resetSchedule();
 			}
 			break;
 		case 'R':               // Print a list of all markers
 			printAllMarkers(cout, markers, data);
 			break;
 		case 's':    // silence notes
-			eventBuffer.off();
+			silenceNotes();
 			break;
 		case 't':    // increase tab size
 			tabsize++;
@@ -408,8 +477,8 @@ void keyboardchar(int key) {
 						  << " =" << number
 						  << endl;
 					linenum = newline;
-					eventBuffer.off();
-					timer.reset();
+					silenceNotes();
+					resetSchedule();
 				}
 			}
 			break;
@@ -419,8 +488,8 @@ void keyboardchar(int key) {
 				cout << "!! back " << number << " measure"
 		 << (number==1? "":"s") << endl;
 				linenum = newline;
-				eventBuffer.off();
-				timer.reset();
+				silenceNotes();
+				resetSchedule();
 			}
 			break;
 		case ')':
@@ -429,8 +498,8 @@ void keyboardchar(int key) {
 				cout << "!! forward " << number << " measure"
 					  << (number==1? "":"s") << endl;
 				linenum = newline;
-				eventBuffer.off();
-				timer.reset();
+				silenceNotes();
+				resetSchedule();
 			}
 			break;
 		case '+':    // louder
@@ -452,11 +521,15 @@ void keyboardchar(int key) {
 		case '^':    // go to the start of the file
 			linenum = 0;
 			cout << "!! Going to start of file" << endl;
+			silenceNotes();
+			resetSchedule();
 			break;
 
 		case '$':    // go to the end of the file
 			linenum = data.getNumLines() - 1;
 			cout << "!! Going to end of file" << endl;
+			silenceNotes();
+			resetSchedule();
 			break;
 	}
 
@@ -729,6 +802,9 @@ void checkOptions(void) {
 	options.define("v|velocity=i:64", "Default MIDI key velocity");
 	options.define("m|min=i:30",      "minimum millisecond duration of notes");
 	options.define("s|shorten=i:30",  "shortening millisecond value for note durations");
+	options.define("virtual=s", "write MIDI messages with times to file or pipe instead of playing them");
+	options.define("stats=b", "print timing accuracy of MIDI messages when done");
+	options.define("schedule=b", "print the events to play for each file and exit");
 	options.process();
 
 	velocity = options.getInteger("velocity");
@@ -747,6 +823,15 @@ void checkOptions(void) {
 	options.getArgList(list);
 	streamer.setFileList(list);
 
+	if (options.getBoolean("schedule")) {
+		while (streamer.read(data)) {
+			data.analyzeRhythm("4");
+			compileSchedule(schedule, lineEvents, data);
+			printSchedule(cout, schedule, lineEvents, data);
+		}
+		exit(0);
+	}
+
 	mine = options.getInteger("min");
 	if (mine < 0) {
 		mine = 0;
@@ -754,6 +839,18 @@ void checkOptions(void) {
 	shortenQ = !options.getBoolean("shorten");
 	shortenamount = options.getInteger("shorten");
 
+	statsQ = options.getBoolean("stats");
+	virtualQ = options.getBoolean("virtual");
+	if (virtualQ) {
+		string filename = options.getString("virtual");
+		virtualout.open(filename.c_str());
+		if (!virtualout.is_open()) {
+			cerr << "Error: cannot write to " << filename << endl;
+			exit(1);
+		}
+		virtualout << "**due\t**sent\t**midi\n";
+	}
+
 	colorQ = !options.getBoolean("color");
 	colormode = options.getString("color").c_str()[0];
 	if ((colormode != 'b') && (colormode != 'w')) {
@@ -777,54 +874,248 @@ void inputNewFile(void) {
 	}
 
 	data.analyzeRhythm("4");
+	compileSchedule(schedule, lineEvents, data);
 
 	if (fileNumber > 1) {
 		millisleep((float)(1000 * options.getDouble("pause")));
 	}
 	fileNumber++;
+	resetSchedule();
 }
 
 
 
 //////////////////////////////
 //
-// playdata -- play the next line of the humdrum file, update the
-//     line number and the time for the next events to be read
-//     from the file.
+// playdata -- play the next events in the schedule which all start at
+//     the same time, update the line number, and calculate the time at
+//     which the following events are due.  The due time is advanced from
+//     the previous due time rather than from the current time so that
+//     delays in processing do not accumulate.
 //
 
-void playdata(HumdrumFile& data, int& linenum, SigTimer& timer) {
-	double duration = 0;     // duration of the current line;
-
-	if (data.getNumLines() == 0) {
-		// ignore empty files.
+void playdata(double now) {
+	if (eventIndex >= (int)schedule.size()) {
 		return;
 	}
+	if (now - dueTime > 1000.0) {
+		// the program was stalled, so don't rush to catch up
+		dueTime = now;
+	}
+
+	double beat = schedule[eventIndex].beat;
+	while ((eventIndex < (int)schedule.size()) &&
+			(schedule[eventIndex].beat <= beat)) {
+		PlayEvent& event = schedule[eventIndex];
+		switch (event.type) {
+			case EVENT_NOTE:
+				playNote(event, dueTime, now);
+				break;
+			case EVENT_TEMPO:
+				tempo = event.value;
+				break;
+			case EVENT_LINE:
+				if (echoTextQ) {
+					printInputLine(data, event.line);
+				}
+				linenum = event.line + 1;
+				break;
+		}
+		eventIndex++;
+	}
 
-	int type = data[linenum].getType();
+	if (eventIndex < (int)schedule.size()) {
+		dueTime += 60000.0 / tempo / tempoScale *
+				(schedule[eventIndex].beat - beat);
+	}
+}
 
-	while (linenum < data.getNumLines() && duration == 0.0) {
-		duration = data[linenum].getDuration();
 
-		if (type == E_humrec_data) {
-			processNotes(data[linenum]);
-		} else if (type == E_humrec_interpretation) {
-			if (strncmp(data[linenum][0], "*MM", 3) == 0) {
-				tempo = atoi(&data[linenum][0][3]);
+
+//////////////////////////////
+//
+// compileSchedule -- create the list of events to play for a file.  Each
+//     line of the file has an EVENT_LINE for displaying it, which is
+//     preceded by the notes and tempo changes on the line.
+//
+
+void compileSchedule(vector<PlayEvent>& schedule, vector<int>& lineEvents,
+		HumdrumFile& infile) {
+	schedule.resize(0);
+	schedule.reserve(infile.getNumLines() * 4);
+	lineEvents.resize(infile.getNumLines() + 1);
+
+	PlayEvent event;
+	int i;
+	for (i=0; i<infile.getNumLines(); i++) {
+		lineEvents[i] = (int)schedule.size();
+		if (infile[i].isData()) {
+			storeNotes(schedule, infile, i);
+		} else if (infile[i].isInterpretation()) {
+			if (strncmp(infile[i][0], "*MM", 3) == 0) {
+				event.beat  = infile[i].getAbsBeat();
+				event.type  = EVENT_TEMPO;
+				event.line  = i;
+				event.track = 0;
+				event.key   = 0;
+				event.flags = 0;
+				event.value = atoi(&infile[i][0][3]);
+				if (event.value > 0.0) {
+					schedule.push_back(event);
+				}
 			}
 		}
-		if (echoTextQ) {
-			printInputLine(data, linenum);
+		event.beat  = infile[i].getAbsBeat();
+		event.type  = EVENT_LINE;
+		event.line  = i;
+		event.track = 0;
+		event.key   = 0;
+		event.flags = 0;
+		event.value = 0.0;
+		schedule.push_back(event);
+	}
+	lineEvents[infile.getNumLines()] = (int)schedule.size();
+}
+
+
+
+//////////////////////////////
+//
+// printSchedule -- print the events of a file in the order that they
+//     will be played, as a Humdrum table.  The playing loop needs the
+//     events to be in order of start time, with the notes and tempo
+//     changes of a line before the line itself, and lineEvents pointing
+//     at the first event of each line.  A reference record at the end
+//     reports whether this is true.
+//
+
+void printSchedule(ostream& out, vector<PlayEvent>& schedule,
+		vector<int>& lineEvents, HumdrumFile& infile) {
+	out << "**beat\t**event\t**line\t**track\t**key\t**value\n";
+	int ordered = 1;
+	int i;
+	for (i=0; i<(int)schedule.size(); i++) {
+		PlayEvent& event = schedule[i];
+		out << event.beat << '\t';
+		switch (event.type) {
+			case EVENT_NOTE:  out << "note";  break;
+			case EVENT_TEMPO: out << "tempo"; break;
+			case EVENT_LINE:  out << "line";  break;
+		}
+		out << '\t' << event.line + 1 << '\t' << event.track
+		    << '\t' << event.key << '\t' << event.value << '\n';
+		if ((i > 0) && (schedule[i-1].beat > event.beat)) {
+			ordered = 0;
 		}
-		if (duration > 0.0) {
-			timer.setPeriod(60000 / tempo / tempoScale * duration);
-			timer.reset();
+		if ((i > 0) && (schedule[i-1].line > event.line)) {
+			ordered = 0;
 		}
-		linenum++;
-		if (linenum < data.getNumLines()) {
-			type = data[linenum].getType();
+		if ((i > 0) && (schedule[i-1].type == EVENT_LINE) &&
+				(schedule[i-1].line == event.line)) {
+			ordered = 0;
 		}
 	}
+	for (i=0; i<infile.getNumLines(); i++) {
+		if ((lineEvents[i] >= (int)schedule.size()) ||
+				(schedule[lineEvents[i]].line != i)) {
+			ordered = 0;
+		}
+	}
+	out << "*-\t*-\t*-\t*-\t*-\t*-\n";
+	out << "!!!ordered: " << (ordered ? "yes" : "no") << "\n";
+}
+
+
+
+//////////////////////////////
+//
+// storeNotes -- add the notes which start on a line to the schedule,
+//     skipping rests and the continuations of tied notes.
+//
+
+void storeNotes(vector<PlayEvent>& schedule, HumdrumFile& infile, int line) {
+	HumdrumRecord& record = infile[line];
+	PlayEvent event;
+	event.beat = record.getAbsBeat();
+	event.type = EVENT_NOTE;
+	event.line = line;
+
+	char buffer[128] = {0};
+	int i, j;
+	int tokencount;
+	for (i=0; i<record.getFieldCount(); i++) {
+		if (record.getExInterpNum(i) != E_KERN_EXINT) {
+			continue;
+		}
+		if (strcmp(record[i], ".") == 0) {
+			continue;
+		}
+		tokencount = record.getTokenCount(i);
+		for (j=0; j<tokencount; j++) {
+			record.getToken(buffer, i, j);
+			event.key = Convert::kernToMidiNoteNumber(buffer);
+			// skip rests
+			if (event.key < 0) {
+				continue;
+			}
+			// skip tied notes
+			if (strchr(buffer, '_') || strchr(buffer, ']')) {
+				continue;
+			}
+			if (strchr(buffer, '[')) {
+				// total tied note durations
+				event.value = infile.getTiedDuration(line, i, j);
+			} else {
+				event.value = Convert::kernToDuration(buffer);
+			}
+			event.track = record.getPrimaryTrack(i);
+			event.flags = 0;
+			if (strchr(buffer, '\'')) {
+				event.flags |= ARTIC_STACCATO;
+			}
+			if (strchr(buffer, '^')) {
+				event.flags |= ARTIC_ACCENT;
+			}
+			if (strchr(buffer, 'z')) {
+				event.flags |= ARTIC_SFORZANDO;
+			}
+			schedule.push_back(event);
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// resetSchedule -- continue playing from the current line number at the
+//     current time.
+//
+
+void resetSchedule(void) {
+	if (linenum < 0) {
+		linenum = 0;
+	}
+	if (linenum >= (int)lineEvents.size()) {
+		eventIndex = (int)schedule.size();
+	} else {
+		eventIndex = lineEvents[linenum];
+	}
+	dueTime = getCurrentTime();
+}
+
+
+
+//////////////////////////////
+//
+// getCurrentTime -- return the time in milliseconds since the
+//     first call to the function.
+//
+
+double getCurrentTime(void) {
+	static chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+	return elapsed.count();
 }
 
 
@@ -1028,89 +1319,148 @@ int getKernNoteOnlyLen(char* buffer, const char* ptr) {
 
 //////////////////////////////
 //
-// processNotes -- play all kern notes in the current record and
-//    return the shortest note duration.  Don't play notes
-//    if they are in a track which is muted.
+// playNote -- start a note from the schedule, applying the current
+//    transposition, tempo and velocity, and store the time at which
+//    it should be turned off.  Don't play notes if they are in a track
+//    which is muted.
 //
 
-void processNotes(HumdrumRecord& record) {
-	NoteEvent note;
-	int pitch = 0;
-	double duration = 0.0;
-	int staccatoQ = 0;
-	int accentQ = 0;
-	int sforzandoQ = 0;
-	int i, j;
-	int notecount = 0;
-	char buffer[128] = {0};
-	for (i=0; i<record.getFieldCount(); i++) {
-		if ((record.getPrimaryTrack(i) < (int)trackmute.size())
-				&& trackmute[record.getPrimaryTrack(i)]) {
-			continue;
+void playNote(PlayEvent& event, double due, double now) {
+	if ((event.track < (int)trackmute.size()) && trackmute[event.track]) {
+		return;
+	}
+	int pitch = event.key + transpose;
+	// don't play note which is transposed too extremely
+	if (pitch < 0)   { return; }
+	if (pitch > 127) { return; }
+
+	double duration = event.value * 60000 / tempo / tempoScale;
+	if (shortenQ) {
+		duration -= shortenamount;
+		if (duration < mine) {
+			duration = mine;
 		}
-		if (record.getExInterpNum(i) == E_KERN_EXINT) {
-			notecount = record.getTokenCount(i);
-			if (strcmp(record[i], ".") == 0) {
-				continue;
-			}
-			for (j=0; j<notecount; j++) {
-				record.getToken(buffer, i, j);
-				if (strchr(buffer, '[')) {
-					// total tied note durations
-					duration = data.getTiedDuration(linenum, i, j);
-				} else {
-					duration = Convert::kernToDuration(buffer);
-				}
-				pitch = Convert::kernToMidiNoteNumber(buffer);
-				// skip rests
-				if (pitch < 0) {
-					continue;
-				}
-				pitch += transpose;
-				// don't play note which is transposed too extremely
-				if (pitch < 0)   { continue; }
-				if (pitch > 127) { continue; }
-
-				// skip tied notes
-				if (strchr(buffer, '_') || strchr(buffer, ']')) {
-					continue;
-				}
+	}
+	duration = (int)duration;
+	if (event.flags & ARTIC_STACCATO) {
+		duration = (int)(0.5 * duration);
+	}
 
-				accentQ    = strchr(buffer, '^')  == NULL? 0 : 1;
-				sforzandoQ = strchr(buffer, 'z')  == NULL? 0 : 1;
-				staccatoQ  = strchr(buffer, '\'') == NULL? 0 : 1;
-				note.setChannel(0);
-				note.setKey(pitch);
-				note.setOnTime(t_time);
-				duration = duration * 60000 / tempo / tempoScale;
-				if (shortenQ) {
-					duration -= shortenamount;
-					if (duration < mine) {
-						duration = mine;
-					}
-				}
-				note.setDur((int)duration);
-				if (staccatoQ) {
-					note.setDur((int)(0.5 * note.getDur()));
-				}
-				note.setKey(pitch);
-				if (accentQ) {
-					velocity *= 1.3;
-				}
-				if (sforzandoQ) {
-					velocity *= 1.5;
-				}
-				if (velocity > 127) {
-					velocity = 127;
-				}
-				note.setVelocity(velocity);
+	int notevelocity = velocity;
+	if (event.flags & ARTIC_ACCENT) {
+		notevelocity *= 1.3;
+	}
+	if (event.flags & ARTIC_SFORZANDO) {
+		notevelocity *= 1.5;
+	}
+	if (notevelocity > 127) {
+		notevelocity = 127;
+	}
 
-				note.activate();
-				note.action(eventBuffer);
-				eventBuffer.insert(note);
-			}
-		}
+	sendMidi(0x90, pitch, notevelocity, due, now);
+
+	NoteOff noteoff;
+	noteoff.time = due + duration;
+	noteoff.key  = pitch;
+	noteoffs.push_back(noteoff);
+	push_heap(noteoffs.begin(), noteoffs.end(), noteoffcompare);
+}
+
+
+
+//////////////////////////////
+//
+// noteoffcompare -- order note offs so that the earliest one is at
+//     the top of the heap.
+//
+
+int noteoffcompare(const NoteOff& a, const NoteOff& b) {
+	return a.time > b.time;
+}
+
+
+
+//////////////////////////////
+//
+// sendNoteOffs -- turn off notes which have ended.
+//
+
+void sendNoteOffs(double now) {
+	while (!noteoffs.empty() && (noteoffs.front().time <= now)) {
+		sendMidi(0x80, noteoffs.front().key, 0, noteoffs.front().time, now);
+		pop_heap(noteoffs.begin(), noteoffs.end(), noteoffcompare);
+		noteoffs.pop_back();
+	}
+}
+
+
+
+//////////////////////////////
+//
+// silenceNotes -- turn off all notes which are currently playing.
+//
+
+void silenceNotes(void) {
+	double now = getCurrentTime();
+	for (int i=0; i<(int)noteoffs.size(); i++) {
+		sendMidi(0x80, noteoffs[i].key, 0, now, now);
+	}
+	noteoffs.resize(0);
+}
+
+
+
+//////////////////////////////
+//
+// sendMidi -- send a note message on the first channel to the
+//     synthesizer, or write it to the --virtual file along with the time
+//     at which it was due and the time at which it was sent.  The lateness
+//     of the message is added to the timing statistics.
+//
+
+void sendMidi(int command, int key, int velocity, double due, double now) {
+	if (virtualQ) {
+		char buffer[128];
+		snprintf(buffer, sizeof(buffer), "%.3f\t%.3f\t%02x %02x %02x\n",
+				due, now, command, key, velocity);
+		virtualout << buffer;
+	} else if (command == 0x90) {
+		synth.play(0, key, velocity);
+	} else {
+		synth.play(0, key, 0);
+	}
+
+	double late = now - due;
+	latecount++;
+	latesum   += late;
+	latesumsq += late * late;
+	if (late > latemax) {
+		latemax = late;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// printLatencyStats -- print the timing accuracy of the MIDI messages
+//     which have been sent.
+//
+
+void printLatencyStats(ostream& out) {
+	if (latecount == 0) {
+		out << "!! No MIDI messages were sent" << endl;
+		return;
+	}
+	double mean = latesum / latecount;
+	double variance = latesumsq / latecount - mean * mean;
+	if (variance < 0.0) {
+		variance = 0.0;
 	}
+	out << "!! MIDI messages:\t"         << latecount << "\n";
+	out << "!! Mean lateness (ms):\t"    << mean << "\n";
+	out << "!! Maximum lateness (ms):\t" << latemax << "\n";
+	out << "!! Jitter (ms):\t"           << sqrt(variance) << endl;
 }
 
 
@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed Dec 13 13:35:37 PST 2000
 // Last Modified: Wed Nov 13 08:19:37 PST 2013 Updated to allow data downloading
+// Last Modified: Sun Oct 18 16:29:47 PDT 2026 Moved conversion into library
 // Filename:      ...sig/examples/all/kern2melisma.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/kern2melisma.cpp
 // Syntax:        C++; museinfo
@@ -28,8 +29,6 @@
 // function declarations:
 void      checkOptions      (Options& opts, int argc, char** argv);
 void      example           (void);
-void      preparePitch      (char* buffer2, const char* buffer1);
-void      printOutput       (HumdrumFile& hfile);
 void      usage             (const char* command);
 
 // User interface variables:
@@ -51,7 +50,7 @@ int main(int argc, char** argv) {
       exit(1);
    }
    hfile.analyzeRhythm("4");
-   printOutput(hfile);
+   hfile.printMelismaNotes(cout, tdefault, classQ);
    return 0;
 }
 
@@ -131,188 +130,6 @@ void example(void) {
 
 
 
-//////////////////////////////
-//
-// printOutput -- one small bug: the duration of the notes
-//   are calculated under constant tempo.  A tempo change during
-//   a tied note will not give the correct ending point of the
-//   tied note.  This bug is minor and the work to fix it is major.
-//
-
-void printOutput(HumdrumFile& hfile) {
-   Array<double> tempo;
-   hfile.analyzeTempoMarkings(tempo, tdefault);
-
-   double currentmillisecond = 0.0;
-   double lastduration = 0.0;
-   double endmillisecond;
-
-   int i, j, k;
-   char buffer1[1024] = {0};
-   char buffer2[1024] = {0};
-   double duration;
-   for (i=0; i<hfile.getNumLines(); i++) {
-      currentmillisecond = currentmillisecond +
-            lastduration * 60000.0 / tempo[i];
-      lastduration = hfile[i].getDuration();
-
-      if (hfile[i].getType() == E_humrec_global_comment) {
-         cout << "Comment\t" << &(hfile[i].getLine()[3]) << endl;
-      }
-
-      if (hfile[i].getType() == E_humrec_bibliography) {
-         cout << "Reference " << &(hfile[i].getLine()[3]) << endl;
-      }
-
-      if (hfile[i].getType() == E_humrec_interpretation) {
-         for (j=0; j<hfile[i].getFieldCount(); j++) {
-            if (hfile[i].getExInterpNum(j) != E_KERN_EXINT) {
-               continue;
-            }
-            int direction = 0;
-            int acount = 0;
-            if (strncmp(hfile[i][j], "*k[", 3) == 0) {
-               if (strchr(hfile[i][j], '-') != NULL) {
-                  direction = -1;
-               } else if (strchr(hfile[i][j], '#') != NULL) {
-                  direction = 1;
-               }
-               acount = (strlen(hfile[i][j]) - 4)/2;
-               if (direction == 0) {
-                  cout << "Info keysig no accidentals" << endl;
-                  break;
-               } else {
-                  cout << "Info keysig " << acount;
-                  if (acount < 0) {
-                     cout << " flat";
-                  } else {
-                     cout << " sharp";
-                  }
-                  if (acount > 1) {
-                     cout << "s";
-                  }
-                  cout << endl;
-                  break;
-               }
-            }
-         }
-      }
-
-      // look for key interpretations
-      if (hfile[i].getType() == E_humrec_interpretation) {
-         for (j=0; j<hfile[i].getFieldCount(); j++) {
-            if (hfile[i].getExInterpNum(j) != E_KERN_EXINT) {
-               continue;
-            }
-            int length = strlen(hfile[i][j]);
-            if (length < 3 || length > 4) {
-               continue;
-            }
-            if (hfile[i][j][length-1] == ':') {
-               cout << "Info key ";
-               cout << (char)toupper(hfile[i][j][1]);
-               if (hfile[i][j][2] == '-') {
-                  cout << "-flat";
-               }
-               if (hfile[i][j][2] == '#') {
-                  cout << "-sharp";
-               }
-               if (std::islower(hfile[i][j][1])) {
-                  cout << " Minor";
-               } else {
-                  cout << " Major";
-               }
-               cout << endl;
-               break;
-            }
-         }
-      }
-
-      // look for tempo markings
-      if (hfile[i].getType() == E_humrec_interpretation) {
-         for (j=0; j<hfile[i].getFieldCount(); j++) {
-            if (hfile[i].getExInterpNum(j) != E_KERN_EXINT) {
-               continue;
-            }
-            double tempomark = 0.0;
-            if (strncmp(hfile[i][j], "*MM", 3) == 0 &&
-                  std::isdigit(hfile[i][j][3])) {
-               sscanf(hfile[i][j], "*MM%lf", &tempomark);
-               cout << "Info Tempo " << tempomark << " MM per quarter note"
-                    << endl;
-               break;
-            }
-         }
-      }
-
-      if (hfile[i].getType() != E_humrec_data) {
-         continue;
-      }
-
-      for (j=0; j<hfile[i].getFieldCount(); j++) {
-         if (hfile[i].getExInterpNum(j) != E_KERN_EXINT) {
-            continue;
-         }
-
-         for (k=0; k<hfile[i].getTokenCount(j); k++) {
-            if (strcmp(hfile[i][j], ".") == 0) {
-               continue;
-            }
-            hfile[i].getToken(buffer1, j, k);
-            if (strchr(buffer1, '_') != NULL) {
-               // ignore notes which are tied
-               continue;
-            }
-            if (strchr(buffer1, ']') != NULL) {
-               // ignore notes which are tied
-               continue;
-            }
-
-            preparePitch(buffer2, buffer1);
-            duration = hfile.getTiedDuration(i, j, k);
-
-            int note = Convert::kernToMidiNoteNumber(buffer2);
-            if (classQ) {
-               note = note % 12;
-            }
-            if (note < 0) {
-               // don't display rests.
-               continue;
-            }
-
-            cout << "Note\t";
-            // cout << hfile.getAbsBeat(i) << "\t";
-            cout << (int)(currentmillisecond+0.5) << "\t";
-
-            // cout << duration << "\t";
-            endmillisecond = currentmillisecond + duration * 60000 / tempo[i];
-            if (int(endmillisecond+0.5) == int(currentmillisecond+0.5)) {
-               // give grace notes 1 millisecond duration...
-               cout << (int)(endmillisecond+0.5)+1 << "\t";
-            } else {
-               cout << (int)(endmillisecond+0.5) << "\t";
-            }
-
-            cout << note;
-
-            cout << "\n";
-         }
-      }
-   }
-}
-
-
-
-//////////////////////////////
-//
-// preparePitch --
-//
-
-void preparePitch(char* buffer2, const char* buffer1) {
-   strcpy(buffer2, buffer1);
-}
-
-
 //////////////////////////////
 //
 // usage --
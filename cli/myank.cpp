@@ -5,6 +5,9 @@
 // Last Modified: Wed Feb  2 12:13:11 PST 2011 Added *met extraction
 // Last Modified: Mon Apr  1 00:28:01 PDT 2013 Enabled multiple segment input
 // Last Modified: Tue Feb 23 04:40:04 PST 2016 Added --section option
+// Last Modified: Sun Oct 18 18:11:18 PDT 2026 Added --index measure index
+// Last Modified: Sun Oct 18 20:43:25 PDT 2026 Check index by size and mtime
+// Last Modified: Sun Oct 18 21:18:16 PDT 2026 Seek to indexed measures, added --trust-index
 // Filename:      ...sig/examples/all/myank.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/myank.cpp
 // Syntax:        C++; museinfo
@@ -15,11 +18,17 @@
 #include "humdrum.h"
 #include "PerlRegularExpression.h"
 #include "MuseData.h"
+#include "CheckSum.h"
 
 #include <string.h>
+#include <ctype.h>
 #include <math.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
+#include <fstream>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -206,6 +215,22 @@ int       atEndOfFile          (HumdrumFile& infile, int line);
 void      processFile          (HumdrumFile& infile, int segmentCount);
 int       getSectionCount      (HumdrumFile& infile);
 void      getSectionString     (string& sstring, HumdrumFile& infile, int sec);
+int       readFileContents     (string& contents, const char* filename);
+void      getLineOffsets       (Array<int>& offsets, string& contents);
+void      getIndexFilename     (string& indexname, const char* filename);
+void      printLineByte        (ostream& out, Array<int>& offsets, int line);
+void      writeMeasureIndex    (const char* filename);
+int       getFileCrc           (unsigned long& crc, FILE* input,
+                                unsigned long filesize);
+int       getLineEnd           (FILE* input, int start);
+int       appendFileRange      (string& output, FILE* input, int start,
+                                int stop);
+int       appendLines          (string& output, FILE* input,
+                                Array<int>& starts, int line1, int line2);
+int       appendLayoutLines    (string& output, FILE* input,
+                                Array<int>& starts, Array<int>& layout,
+                                int line1, int line2, int extra);
+int       processIndexedFile   (const char* filename);
 
 
 // User interface variables:
@@ -225,6 +250,9 @@ int    doubleQ     = 0;            // used with --mdsep option
 int    barnumtextQ = 0;            // used with -T option
 int    Section     = 0;            // used with --section option
 int    sectionCountQ = 0;          // used with --section-count option
+int    indexQ      = 0;            // used with --index option
+int    noindexQ    = 0;            // used with --no-index option
+int    trustQ      = 0;            // used with --trust-index option
 Array<MeasureInfo> MeasureOutList; // used with -m option
 Array<MeasureInfo> MeasureInList;  // used with -m option
 
@@ -237,9 +265,26 @@ int main(int argc, char** argv) {
 
    // initial processing of the command-line options
    checkOptions(options, argc, argv);
-   infiles.read(options);
 
    int i;
+   if (indexQ) {
+      for (i=1; i<=options.getArgCount(); i++) {
+         writeMeasureIndex(options.getArg(i).c_str());
+      }
+      return 0;
+   }
+
+   if ((!noindexQ) && (options.getArgCount() == 1) &&
+         options.getBoolean("measures") && !(markQ || Section ||
+         sectionCountQ || debugQ || inlistQ || outlistQ || maxQ || minQ)) {
+      // extract the measures with the help of the file's measure index
+      if (processIndexedFile(options.getArg(1).c_str())) {
+         return 0;
+      }
+   }
+
+   infiles.read(options);
+
    for (i=0; i<infiles.getCount(); i++) {
       processFile(infiles[i], infiles.getCount());
    }
@@ -2339,6 +2384,665 @@ void removeDollarsFromString(Array<char>& buffer, int maxx) {
 
 
 
+//////////////////////////////
+//
+// readFileContents -- read an entire file into memory.  Returns 0 if
+//    the file could not be opened.
+//
+
+int readFileContents(string& contents, const char* filename) {
+   ifstream input(filename, ios::in | ios::binary);
+   if (!input.is_open()) {
+      return 0;
+   }
+   stringstream buffer;
+   buffer << input.rdbuf();
+   contents = buffer.str();
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// getLineOffsets -- store the byte offset of the start of each line
+//    in the file contents, counting lines the same way as
+//    HumdrumFileBasic::read().  An extra entry at the end stores the
+//    size of the file.
+//
+
+void getLineOffsets(Array<int>& offsets, string& contents) {
+   int size = (int)contents.size();
+   offsets.setSize(size / 16 + 2);
+   offsets.setGrowth(size / 16 + 2);
+   offsets.setSize(0);
+   if (size == 0) {
+      offsets.append(size);
+      return;
+   }
+   int value = 0;
+   offsets.append(value);
+   const char* base = contents.c_str();
+   const char* ptr  = base;
+   const char* end  = base + size;
+   while ((ptr = (const char*)memchr(ptr, '\n', end - ptr)) != NULL) {
+      ptr++;
+      if (ptr >= end) {
+         break;
+      }
+      value = (int)(ptr - base);
+      offsets.append(value);
+   }
+   offsets.append(size);
+}
+
+
+
+//////////////////////////////
+//
+// getIndexFilename -- the measure index for a file is stored next to it
+//    with an extra ".myx" extension.
+//
+
+void getIndexFilename(string& indexname, const char* filename) {
+   indexname = filename;
+   indexname += ".myx";
+}
+
+
+
+//////////////////////////////
+//
+// printLineByte -- print a line number and the byte offset of the line
+//    in the file (-1 if there is no line).
+//
+
+void printLineByte(ostream& out, Array<int>& offsets, int line) {
+   out << line << '\t' << (line < 0 ? -1 : offsets[line]);
+}
+
+
+
+//////////////////////////////
+//
+// writeMeasureIndex -- Create a measure index for the given file.
+//    The index lists the barline numbers, the line and byte ranges
+//    of each measure (as used by the -m option), and the location
+//    of every interpretation record and barline in the file.  The size,
+//    modification time and CRC32 of the file are stored so that a stale
+//    index is ignored (see processIndexedFile()).
+//
+// Format of the index file:
+//    #myx   2
+//    size   <bytes in file>
+//    mtime  <modification time of file in seconds>
+//    crc32  <cksum-style CRC of file>
+//    lines  <number of lines in file>
+//    seek   <1 if measures can be extracted via the index, 0 otherwise>
+//    H      <line> <byte>       last line of the header which is always
+//                               parsed (the first numbered barline after
+//                               line 9, see insertZerothMeasure())
+//    E      <line> <byte>       last data or barline in file
+//    I      <line> <byte>       interpretation line after H
+//    B      <line> <byte>       barline after H
+//    M      <num> <startline> <stopline> <startbyte> <stopbyte>
+//           <next data line after stop> <byte>
+//
+// Line values of -1 indicate that there is no such line.
+//
+
+void writeMeasureIndex(const char* filename) {
+   string contents;
+   if (!readFileContents(contents, filename)) {
+      cerr << "Error: cannot read file " << filename << endl;
+      exit(1);
+   }
+   Array<int> offsets;
+   getLineOffsets(offsets, contents);
+
+   HumdrumFileSet infiles;
+   stringstream instream;
+   instream << contents;
+   infiles.read(instream);
+   if (infiles.getCount() != 1) {
+      cerr << "Error: cannot index multi-segment file " << filename << endl;
+      exit(1);
+   }
+   HumdrumFile& infile = infiles[0];
+   if (infile.getNumLines() != offsets.getSize() - 1) {
+      cerr << "Error: cannot index lines in " << filename << endl;
+      exit(1);
+   }
+
+   Array<MeasureInfo> measurelist;
+   getMeasureStartStop(measurelist, infile);
+
+   int i;
+   int lines = infile.getNumLines();
+   int exinterp = -1;
+   int headerend = -1;
+   int lastline = -1;
+   PerlRegularExpression pre;
+   for (i=0; i<lines; i++) {
+      if (infile[i].isInterpretation()) {
+         exinterp = i;
+         break;
+      }
+   }
+   if (exinterp >= 0) {
+      // keep the lines which insertZerothMeasure() looks at in the header
+      headerend = lines - 1;
+      for (i=(exinterp > 9 ? exinterp : 9); i<lines; i++) {
+         if (infile[i].isMeasure() && pre.search(infile[i][0], "^=.*\\d+", "")) {
+            headerend = i;
+            break;
+         }
+      }
+   }
+   for (i=lines-1; i>=0; i--) {
+      if (infile[i].isData() || infile[i].isMeasure()) {
+         lastline = i;
+         break;
+      }
+   }
+
+   // measures can only be extracted through the index if every numbered
+   // barline is a measure known to fillGlobalDefaults().
+   int maxmeasure = -1;
+   for (i=0; i<measurelist.getSize(); i++) {
+      if (maxmeasure < measurelist[i].num) {
+         maxmeasure = measurelist[i].num;
+      }
+   }
+   int seek = ((headerend >= 0) && (maxmeasure > 0)) ? 1 : 0;
+   Array<int> inmap(maxmeasure > 0 ? maxmeasure+1 : 1);
+   inmap.setAll(-1);
+   for (i=0; i<measurelist.getSize(); i++) {
+      if (measurelist[i].num >= 0) {
+         inmap[measurelist[i].num] = i;
+      }
+   }
+   int number;
+   for (i=0; seek && (i<lines); i++) {
+      if (!infile[i].isMeasure()) {
+         continue;
+      }
+      if (!pre.search(infile[i][0], "(\\d+)", "")) {
+         continue;
+      }
+      number = atoi(pre.getSubmatch(1));
+      if ((number > maxmeasure) || (inmap[number] < 0)) {
+         seek = 0;
+      }
+   }
+
+   // next data line after each line
+   Array<int> nextdata(lines+1);
+   nextdata[lines] = -1;
+   for (i=lines-1; i>=0; i--) {
+      nextdata[i] = infile[i].isData() ? i : nextdata[i+1];
+   }
+
+   string indexname;
+   getIndexFilename(indexname, filename);
+   ofstream output(indexname.c_str());
+   if (!output.is_open()) {
+      cerr << "Error: cannot write index file " << indexname << endl;
+      exit(1);
+   }
+
+   output << "#myx\t2\n";
+   struct stat filestat;
+   long mtime = -1;
+   if (stat(filename, &filestat) == 0) {
+      mtime = (long)filestat.st_mtime;
+   }
+   output << "size\t"  << contents.size() << "\n";
+   output << "mtime\t" << mtime << "\n";
+   output << "crc32\t"
+          << CheckSum::crc32(contents.c_str(), (int)contents.size()) << "\n";
+   output << "lines\t" << lines << "\n";
+   output << "seek\t"  << seek << "\n";
+   output << "H\t";
+   printLineByte(output, offsets, headerend);
+   output << "\n";
+   output << "E\t";
+   printLineByte(output, offsets, lastline);
+   output << "\n";
+   for (i=headerend+1; (headerend >= 0) && (i<lines); i++) {
+      if (infile[i].isInterpretation()) {
+         output << "I\t";
+      } else if (infile[i].isMeasure()) {
+         output << "B\t";
+      } else {
+         continue;
+      }
+      printLineByte(output, offsets, i);
+      output << "\n";
+   }
+   int start, stop, after;
+   for (i=0; i<measurelist.getSize(); i++) {
+      start = measurelist[i].start;
+      stop  = measurelist[i].stop;
+      after = nextdata[stop+1 < lines ? stop+1 : lines];
+      output << "M\t" << measurelist[i].num
+             << '\t' << start << '\t' << stop
+             << '\t' << offsets[start] << '\t' << offsets[stop]
+             << '\t';
+      printLineByte(output, offsets, after);
+      output << "\n";
+   }
+
+   output.close();
+}
+
+
+
+//////////////////////////////
+//
+// getFileCrc -- calculate the CRC32 of a file, reading it in blocks.
+//    Returns 0 if the file does not have the given size.
+//
+
+int getFileCrc(unsigned long& crc, FILE* input, unsigned long filesize) {
+   CRC32_CTX context;
+   CheckSum::crc32Init(&context);
+   char buffer[65536];
+   unsigned long total = 0;
+   size_t count;
+   if (fseek(input, 0, SEEK_SET) != 0) {
+      return 0;
+   }
+   while ((count = fread(buffer, 1, sizeof(buffer), input)) > 0) {
+      CheckSum::crc32Update(&context, buffer, (int)count);
+      total += count;
+   }
+   crc = CheckSum::crc32Final(&context);
+   return total == filesize;
+}
+
+
+
+//////////////////////////////
+//
+// getLineEnd -- return the byte offset after the end of the line
+//    which starts at the given offset (the file size for the last line
+//    if it is not terminated).  Returns -1 if the file cannot be read.
+//
+
+int getLineEnd(FILE* input, int start) {
+   if (fseek(input, start, SEEK_SET) != 0) {
+      return -1;
+   }
+   char buffer[4096];
+   int position = start;
+   size_t count;
+   const char* newline;
+   while ((count = fread(buffer, 1, sizeof(buffer), input)) > 0) {
+      newline = (const char*)memchr(buffer, '\n', count);
+      if (newline != NULL) {
+         return position + (int)(newline - buffer) + 1;
+      }
+      position += (int)count;
+   }
+   return ferror(input) ? -1 : position;
+}
+
+
+
+//////////////////////////////
+//
+// appendFileRange -- append the bytes from start up to (but not
+//    including) stop in the file.  Returns 0 if they cannot be read.
+//
+
+int appendFileRange(string& output, FILE* input, int start, int stop) {
+   if ((start < 0) || (stop < start)) {
+      return 0;
+   }
+   if (stop == start) {
+      return 1;
+   }
+   if (fseek(input, start, SEEK_SET) != 0) {
+      return 0;
+   }
+   size_t oldsize = output.size();
+   output.resize(oldsize + (stop - start));
+   if (fread(&output[oldsize], 1, stop - start, input) != (size_t)(stop - start)) {
+      output.resize(oldsize);
+      return 0;
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// appendLines -- copy a range of lines from the file, making sure that
+//    the last line is terminated.  Returns 0 if the lines cannot be read.
+//
+
+int appendLines(string& output, FILE* input, Array<int>& starts,
+      int line1, int line2) {
+   if ((line1 < 0) || (line2 < line1)) {
+      return 1;
+   }
+   int stop = getLineEnd(input, starts[line2]);
+   if (!appendFileRange(output, input, starts[line1], stop)) {
+      return 0;
+   }
+   if ((output.size() > 0) && (output[output.size()-1] != '\n')) {
+      output += '\n';
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// appendLayoutLines -- copy the given layout lines (interpretations
+//    and/or barlines) which occur between two lines of the file.  The
+//    extra line (if it is also between the two lines) is copied in its
+//    proper position as well.  Returns 0 if the lines cannot be read.
+//
+
+int appendLayoutLines(string& output, FILE* input, Array<int>& starts,
+      Array<int>& layout, int line1, int line2, int extra) {
+   int i;
+   if ((extra <= line1) || (extra >= line2)) {
+      extra = -1;
+   }
+   for (i=0; i<layout.getSize(); i++) {
+      if (layout[i] <= line1) {
+         continue;
+      }
+      if (layout[i] >= line2) {
+         break;
+      }
+      if ((extra >= 0) && (extra < layout[i])) {
+         if (!appendLines(output, input, starts, extra, extra)) {
+            return 0;
+         }
+         extra = -1;
+      }
+      if (!appendLines(output, input, starts, layout[i], layout[i])) {
+         return 0;
+      }
+   }
+   if (extra >= 0) {
+      return appendLines(output, input, starts, extra, extra);
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// processIndexedFile -- Extract the measures given by the -m option
+//    using the measure index of the file.  Only the file header, the
+//    requested measures, the interpretation records and barlines around
+//    them (to preserve the spine layout, measure list and clef/key/meter
+//    state) and the end of the file are read from the file and parsed.
+//    Returns 0 if the file does not have a valid index, in which case the
+//    whole file should be processed instead.
+//
+//    An index is stale if the size or the CRC32 of the file has changed.
+//    With the --trust-index option the CRC32 is not checked if the file
+//    has the modification time stored in the index and is older than the
+//    index.  Only use that option if files are never replaced by copies
+//    which keep the old time (as with "cp -p", "touch -r" or rsync).
+//
+
+int processIndexedFile(const char* filename) {
+   string indexname;
+   getIndexFilename(indexname, filename);
+   ifstream index(indexname.c_str());
+   if (!index.is_open()) {
+      return 0;
+   }
+   struct stat filestat;
+   struct stat indexstat;
+   if ((stat(filename, &filestat) != 0) ||
+         (stat(indexname.c_str(), &indexstat) != 0)) {
+      return 0;
+   }
+
+   // line -> byte offset for lines mentioned in the index
+   map<int, int> bytes;
+   Array<int> interps;
+   Array<int> layout;
+   Array<int> mnum;
+   Array<int> mstart;
+   Array<int> mstop;
+   Array<int> afterdata;
+   interps.setSize(10000);
+   interps.setGrowth(10000);
+   interps.setSize(0);
+   layout.setSize(10000);
+   layout.setGrowth(10000);
+   layout.setSize(0);
+   mnum.setSize(1000);
+   mnum.setGrowth(10000);
+   mnum.setSize(0);
+   mstart.setSize(1000);
+   mstart.setGrowth(10000);
+   mstart.setSize(0);
+   mstop.setSize(1000);
+   mstop.setGrowth(10000);
+   mstop.setSize(0);
+   afterdata.setSize(1000);
+   afterdata.setGrowth(10000);
+   afterdata.setSize(0);
+
+   unsigned long filesize = 0;
+   unsigned long crc = 0;
+   long mtime = -1;
+   int version = 0;
+   int lines = -1;
+   int seek = 0;
+   int headerend = -1;
+   int lastline = -1;
+   int line, byte, line2, byte2, line3, byte3, num;
+
+   string record;
+   while (getline(index, record)) {
+      const char* rec = record.c_str();
+      if (sscanf(rec, "#myx\t%d", &version) == 1) {
+         continue;
+      }
+      if (sscanf(rec, "size\t%lu", &filesize) == 1) {
+         continue;
+      }
+      if (sscanf(rec, "mtime\t%ld", &mtime) == 1) {
+         continue;
+      }
+      if (sscanf(rec, "crc32\t%lu", &crc) == 1) {
+         continue;
+      }
+      if (sscanf(rec, "lines\t%d", &lines) == 1) {
+         continue;
+      }
+      if (sscanf(rec, "seek\t%d", &seek) == 1) {
+         continue;
+      }
+      if (sscanf(rec, "I\t%d\t%d", &line, &byte) == 2) {
+         interps.append(line);
+         layout.append(line);
+         bytes[line] = byte;
+      } else if (sscanf(rec, "B\t%d\t%d", &line, &byte) == 2) {
+         layout.append(line);
+         bytes[line] = byte;
+      } else if (sscanf(rec, "M\t%d\t%d\t%d\t%d\t%d\t%d\t%d", &num, &line,
+            &line2, &byte, &byte2, &line3, &byte3) == 7) {
+         mnum.append(num);
+         mstart.append(line);
+         mstop.append(line2);
+         afterdata.append(line3);
+         bytes[line]  = byte;
+         bytes[line2] = byte2;
+         if (line3 >= 0) {
+            bytes[line3] = byte3;
+         }
+      } else if (sscanf(rec, "H\t%d\t%d", &line, &byte) == 2) {
+         headerend = line;
+         bytes[line] = byte;
+      } else if (sscanf(rec, "E\t%d\t%d", &line, &byte) == 2) {
+         lastline = line;
+         bytes[line] = byte;
+      }
+   }
+
+   if ((version != 2) || (seek == 0) || (headerend < 0) ||
+         (filesize != (unsigned long)filestat.st_size)) {
+      // stale or unusable index
+      return 0;
+   }
+
+
+   // find the measures to extract
+   int i;
+   int maxmeasure = -1;
+   for (i=0; i<mnum.getSize(); i++) {
+      if (maxmeasure < mnum[i]) {
+         maxmeasure = mnum[i];
+      }
+   }
+   if (maxmeasure <= 0) {
+      return 0;
+   }
+   Array<int> inmap(maxmeasure+1);
+   inmap.setAll(-1);
+   for (i=0; i<mnum.getSize(); i++) {
+      if (mnum[i] >= 0) {
+         inmap[mnum[i]] = i;
+      }
+   }
+
+   Array<char> measurestring;
+   measurestring.setSize(strlen(options.getString("measure").c_str())+1);
+   strcpy(measurestring.getBase(), options.getString("measure").c_str());
+   removeDollarsFromString(measurestring, maxmeasure);
+
+   int lo = -1;
+   int hi = -1;
+   int value;
+   const char* ptr = measurestring.getBase();
+   while (*ptr != '\0') {
+      if (!isdigit(*ptr)) {
+         ptr++;
+         continue;
+      }
+      value = strtol(ptr, NULL, 10);
+      while (isdigit(*ptr)) {
+         ptr++;
+      }
+      if (value > maxmeasure) {
+         // let the full parse deal with out-of-range measures
+         return 0;
+      }
+      if ((lo < 0) || (value < lo)) {
+         lo = value;
+      }
+      if (value > hi) {
+         hi = value;
+      }
+   }
+   if (lo < 0) {
+      return 0;
+   }
+
+   int startline = -1;
+   int stopline  = -1;
+   int nextdata  = -1;
+   for (i=lo; i<=hi; i++) {
+      if (inmap[i] < 0) {
+         continue;
+      }
+      if ((startline < 0) || (mstart[inmap[i]] < startline)) {
+         startline = mstart[inmap[i]];
+      }
+      if (mstop[inmap[i]] > stopline) {
+         stopline = mstop[inmap[i]];
+         nextdata = afterdata[inmap[i]];
+      }
+   }
+   if ((startline < 0) || (stopline < startline)) {
+      return 0;
+   }
+
+   // start bytes of the lines mentioned in the index
+   Array<int> starts(lines+1);
+   starts.setAll(-1);
+   map<int, int>::iterator it;
+   for (it = bytes.begin(); it != bytes.end(); it++) {
+      if ((it->first < 0) || (it->first > lines) || (it->second < 0) ||
+            ((unsigned long)it->second > filesize)) {
+         return 0;
+      }
+      starts[it->first] = it->second;
+   }
+
+   FILE* input = fopen(filename, "rb");
+   if (input == NULL) {
+      return 0;
+   }
+   int trusted = trustQ && (mtime >= 0) &&
+         (mtime == (long)filestat.st_mtime) &&
+         (filestat.st_mtime < indexstat.st_mtime);
+   unsigned long filecrc = 0;
+   if (!trusted && (!getFileCrc(filecrc, input, filesize) ||
+         (filecrc != crc))) {
+      // stale index
+      fclose(input);
+      return 0;
+   }
+
+   // header, then the interpretations and barlines up to the first measure
+   string reduced;
+   int status = 1;
+   if (startline <= headerend) {
+      status &= appendFileRange(reduced, input, 0, starts[startline]);
+   } else {
+      status &= appendFileRange(reduced, input, 0,
+            getLineEnd(input, starts[headerend]));
+      status &= appendLayoutLines(reduced, input, starts, layout,
+            headerend, startline, -1);
+   }
+
+   // the requested measures
+   status &= appendLines(reduced, input, starts, startline, stopline);
+
+   // interpretations between the last measure and the end of the data,
+   // then the end of the file
+   if (lastline > stopline) {
+      status &= appendLayoutLines(reduced, input, starts, interps,
+            stopline, lastline, nextdata);
+      status &= appendFileRange(reduced, input, starts[lastline],
+            (int)filesize);
+   } else {
+      status &= appendFileRange(reduced, input,
+            getLineEnd(input, starts[stopline]), (int)filesize);
+   }
+   fclose(input);
+   if (!status) {
+      return 0;
+   }
+
+   HumdrumFile infile;
+   stringstream instream;
+   instream << reduced;
+   infile.read(instream);
+
+   options.setModified("measure", measurestring.getBase());
+   processFile(infile, 1);
+   return 1;
+}
+
+
+
 //////////////////////////////
 //
 // checkOptions --
@@ -2360,6 +3064,9 @@ void checkOptions(Options& opts, int argc, char** argv) {
    opts.define("min=b",  "print minimum measure number");
    opts.define("section-count=b", "count the number of sections, JRP style");
    opts.define("section=i:0", "extract given section number (indexed from 1");
+   opts.define("index=b", "write a measure index (file.myx) for each input file");
+   opts.define("no-index=b", "do not use measure index files");
+   opts.define("trust-index=b", "do not check CRC of file if index has same mtime");
 
    opts.define("author=b",    "Program author");
    opts.define("version=b",   "Program version");
@@ -2400,6 +3107,9 @@ void checkOptions(Options& opts, int argc, char** argv) {
    barnumtextQ   =  opts.getBoolean("bar-number-text");
    sectionCountQ =  opts.getBoolean("section-count");
    Section       =  opts.getInteger("section");
+   indexQ        =  opts.getBoolean("index");
+   noindexQ      =  opts.getBoolean("no-index");
+   trustQ        =  opts.getBoolean("trust-index");
 
    if (!Section) {
       if (!(opts.getBoolean("measures") || markQ)) {
@@ -8,6 +8,7 @@
 // Last Modified: Sun Oct 20 17:41:10 PDT 2013 Fixed tie problem
 // Last Modified: Tue Nov 12 14:37:11 PST 2013 Added column for measure duration
 // Last Modified: Sat Mar 12 20:41:25 PST 2016 Switched to STL
+// Last Modified: Sun Oct 18 18:21:55 PDT 2026 Added --npy output
 // Filename:      ...sig/examples/all/notearray.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/notearray.cpp
 // Syntax:        C++; museinfo
@@ -21,6 +22,7 @@
 //
 
 #include "humdrum.h"
+#include "NpyWriter.h"
 
 #include <iostream>
 #include <vector>
@@ -53,6 +55,18 @@ void getNoteArray           (vector<vector<int> >& notes, vector<int>& measpos,
 void printNoteArray         (vector<vector<int> >& notes, vector<int>& measpos,
                              vector<int>& linenum, HumdrumFile& infile,
                              vector<double>& bardur, vector<double>& beatdur);
+void storeNoteArray         (NpyWriter& array, vector<vector<int> >& notes,
+                             vector<int>& measpos, vector<int>& linenum,
+                             HumdrumFile& infile, vector<double>& bardur,
+                             vector<double>& beatdur);
+void storeLine              (NpyWriter& array, vector<vector<int> >& notes,
+                             vector<vector<int> >& attacks,
+                             vector<vector<int> >& lasts,
+                             vector<vector<int> >& nexts, vector<int>& measpos,
+                             vector<int>& linenum, vector<double>& bardur,
+                             vector<double>& beatdur, HumdrumFile& infile,
+                             int index, int style);
+void writeArray             (NpyWriter& array, const string& filename);
 void printComments          (HumdrumFile& infile, int startline, int stopline,
                              int style);
 void printExclusiveInterpretations(int basecount);
@@ -124,6 +138,8 @@ int       kernQ     = 0;       // used with -k option
 int       kerntieQ  = 1;       // used with --no-tie option
 int       doubletieQ= 0;       // used with -T option
 int       zeroQ     = 1;       // used with -Z option
+int       npyQ      = 0;       // used with --npy option
+string    npydir    = "";      // used with --npy-dir option
 RationalNumber Absoffset;      // used with --sa option
 
 const char* commentStart = "%";
@@ -147,6 +163,12 @@ int main(int argc, char** argv) {
    // process the command-line options
    checkOptions(options, argc, argv);
 
+   // binary array output (all inputs, or one array per input)
+   NpyWriter array;
+   if (!(measuredurQ || beatdurQ || beatQ || absoluteQ || linedurQ)) {
+      array.setType(NPY_INT32);
+   }
+
    // figure out the number of input files to process
    int numinputs = options.getArgCount();
    Count = numinputs;
@@ -172,14 +194,26 @@ int main(int argc, char** argv) {
       getBeatDurations(beatdur, infile);
 
       getNoteArray(notelist, measpos, linenum, infile, base, doubleQ);
-      printNoteArray(notelist, measpos, linenum, infile, bardur, beatdur);
+      if (npyQ) {
+         if (!npydir.empty()) {
+            array.clear();
+         }
+         storeNoteArray(array, notelist, measpos, linenum, infile, bardur,
+               beatdur);
+         if (!npydir.empty()) {
+            writeArray(array, NpyWriter::makeFilename(npydir,
+                  numinputs < 1 ? "" : options.getArg(i+1), i));
+         }
+      } else {
+         printNoteArray(notelist, measpos, linenum, infile, bardur, beatdur);
+      }
       OffsetSum += notelist.size();
 
       if (!saQ) {
          Absoffset += infile.getTotalDurationR();
       }
 
-      if (sepQ && (Count > 1) && (Current < Count - 1)) {
+      if (sepQ && !npyQ && (Count > 1) && (Current < Count - 1)) {
          // add a separate between input file analyses:
          if (mathQ) {
             cout << "(* ********** *)\n";
@@ -191,6 +225,10 @@ int main(int argc, char** argv) {
       }
    }
 
+   if (npyQ && npydir.empty()) {
+      writeArray(array, "");
+   }
+
    return 0;
 }
 
@@ -534,6 +572,176 @@ void printNoteArray(vector<vector<int> >& notes, vector<int>& measpos,
 
 
 
+//////////////////////////////
+//
+// storeNoteArray -- store the note array in a binary array instead of
+//    printing it.  Comments, headers and **kern columns are not stored.
+//
+
+void storeNoteArray(NpyWriter& array, vector<vector<int> >& notes,
+      vector<int>& measpos, vector<int>& linenum, HumdrumFile& infile,
+      vector<double>& bardur, vector<double>& beatdur) {
+
+   vector<vector<int> > attacks;
+   vector<vector<int> > lasts;
+   vector<vector<int> > nexts;
+   if (attackQ) {
+      getNoteAttackIndexes(attacks, notes, Offset + OffsetSum);
+   }
+   if (lastQ) {
+      getLastAttackIndexes(lasts, notes, Offset + OffsetSum);
+   }
+   if (nextQ) {
+      getNextAttackIndexes(nexts, notes, Offset + OffsetSum);
+   }
+
+   int i;
+   for (i=0; i<(int)notes.size(); i++) {
+      if (typeQ && i == 0) {
+         storeLine(array, notes, attacks, lasts, nexts, measpos, linenum,
+               bardur, beatdur, infile, i, 1);
+      } else {
+         storeLine(array, notes, attacks, lasts, nexts, measpos, linenum,
+               bardur, beatdur, infile, i, 0);
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// storeLine -- store a line of the note array in a binary array.  The
+//    columns are the same as the ones printed by printLine().
+//
+
+void storeLine(NpyWriter& array, vector<vector<int> >& notes,
+      vector<vector<int> >& attacks, vector<vector<int> >& lasts,
+      vector<vector<int> >& nexts, vector<int>& measpos,
+      vector<int>& linenum, vector<double>& bardur, vector<double>& beatdur,
+      HumdrumFile& infile, int index, int style) {
+
+   int& i = index;
+   int j;
+
+   if (indexQ) {
+      array.append(i + Offset + OffsetSum);
+   }
+
+   if (lineQ) {
+      array.append(linenum[i]+1);
+   }
+
+   if (measureQ) {
+      array.append(measpos[i]);
+   }
+
+   if (measuredurQ) {
+      if ((i == 0) && (linenum[i] == TYPE_LINE)) {
+         array.append(TYPE_BARDUR);
+      } else {
+         array.append(bardur[linenum[i]]);
+      }
+   }
+
+   if (beatdurQ) {
+      if ((i == 0) && (linenum[i] == TYPE_LINE)) {
+         array.append(TYPE_BEATDUR);
+      } else {
+         array.append(beatdur[linenum[i]]);
+      }
+   }
+
+   if (beatQ) {
+      if (style == 1) {
+         array.append(TYPE_BEAT);
+      } else {
+         array.append(infile[linenum[i]].getBeat() - 1);
+      }
+   }
+
+   if (absoluteQ) {
+      if (style == 1) {
+         array.append(TYPE_ABSOLUTE);
+      } else {
+         array.append(infile[linenum[i]].getAbsBeat() + Absoffset.getFloat());
+      }
+   }
+
+   if (linedurQ) {
+      if (style == 1) {
+         array.append(TYPE_LINEDUR);
+      } else {
+         array.append(infile[linenum[i]].getDuration());
+      }
+   }
+
+   int vv;
+   int sign;
+   for (j=0; j<(int)notes[i].size(); j++) {
+      vv = notes[i][j];
+      if (vv < TYPE_NOTES) {
+         if (vv < 0) {
+            sign = -1;
+            vv = -vv;
+         } else {
+            sign = +1;
+         }
+         if (vv != 0) {
+            switch (style) {
+               case STYLE_BASE12:
+                  vv = Convert::base40ToMidiNoteNumber(vv);
+                break;
+               case STYLE_BASE7:
+                  vv = Convert::base40ToDiatonic(vv);
+                  break;
+            }
+         }
+         vv *= sign;
+      }
+      array.append(vv);
+
+      if (attackQ) {
+         array.append(attacks[i][j]);
+      }
+      if (lastQ) {
+         array.append(lasts[i][j]);
+      }
+      if (nextQ) {
+         array.append(nexts[i][j]);
+      }
+   }
+
+   array.endRow();
+}
+
+
+
+//////////////////////////////
+//
+// writeArray -- write the binary array to a file, or to standard output
+//    if there is no filename.
+//
+
+void writeArray(NpyWriter& array, const string& filename) {
+   int status;
+   if (filename.empty()) {
+      status = array.write(cout);
+   } else {
+      status = array.write(filename);
+   }
+   if (!status) {
+      if (filename.empty()) {
+         cerr << "Error: rows of the array have different lengths" << endl;
+      } else {
+         cerr << "Error: could not write array " << filename << endl;
+      }
+      exit(1);
+   }
+}
+
+
+
 //////////////////////////////
 //
 // getLastAttackIndexes -- return an index of the attack portion
@@ -1390,6 +1598,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    opts.define("sep|separator=b",  "print a separator between input analyses");
    opts.define("quote=b",          "print quotes around kern names");
    opts.define("Z|no-zero-beat=b", "start first beat of measure at 1 rather than 0");
+   opts.define("npy=b",           "print data as a binary NumPy array");
+   opts.define("npy-dir=s",       "write a NumPy array file for each input");
 
    opts.define("debug=b");        // determine bad input line num
    opts.define("author=b");       // author of program
@@ -1489,6 +1699,10 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    Offset    =  opts.getInteger("offset");
    zeroQ     = !opts.getInteger("no-zero-beat");
    quoteQ    =  opts.getBoolean("quote");
+   npyQ      =  opts.getBoolean("npy") || opts.getBoolean("npy-dir");
+   if (opts.getBoolean("npy-dir")) {
+      npydir = opts.getString("npy-dir");
+   }
    doubletieQ=  opts.getBoolean("all-tie");
    if (doubletieQ) {
       kerntieQ = 1;
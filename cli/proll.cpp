@@ -10,6 +10,7 @@
 // Last Modified: Mon Feb  2 00:13:08 PST 2015 Fixed due to new comp. restr.
 // Last Modified: Tue Aug 29 13:59:05 PDT 2017 Added physical time to JSON output
 // Last Modified: Wed Oct 23 14:38:21 PDT 2019 Convert to STL
+// Last Modified: Sun Oct 18 18:18:12 PDT 2026 Added tiled streaming renderer
 // Filename:      ...sig/examples/all/proll.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/proll.cpp
 // Syntax:        C++; museinfo
@@ -21,6 +22,10 @@
 #include "humdrum.h"
 #include "PerlRegularExpression.h"
 
+#ifdef HAVE_ZLIB
+	#include <zlib.h>
+#endif
+
 #include <string.h>
 #include <ctype.h>
 
@@ -29,6 +34,74 @@
 
 typedef vector<PixelColor> PixelRow;
 
+// number of image columns rendered at a time by the streaming renderer:
+#define TILE_WIDTH 4096
+
+enum { IMAGE_P3, IMAGE_P6, IMAGE_PNG };
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// NoteEvent -- a note in the piano roll: the row is given by the MIDI
+//    pitch of the note, and the note covers the picture columns from
+//    start to stop (inclusive).
+//
+
+class NoteEvent {
+	public:
+		int        start;
+		int        stop;
+		int        match;
+		PixelColor color;
+};
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// RowCursor -- position in the note list of a pitch while a row of the
+//    picture is rendered tile by tile from left to right.
+//
+
+class RowCursor {
+	public:
+		           RowCursor (void) { clear(); }
+		void       clear     (void) { next = 0; active.resize(0); }
+		int         next;    // next note to consider
+		vector<int> active;  // notes which may touch the current tile
+};
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// ImageWriter -- write an image one pixel row at a time, as P3 or P6
+//    portable pixmaps or as a PNG image (if compiled with zlib).
+//
+
+class ImageWriter {
+	public:
+		           ImageWriter  (ostream& out, int imageformat);
+		          ~ImageWriter  ();
+		void       begin        (int width, int height);
+		void       beginRow     (void);
+		void       writePixel   (PixelColor& color);
+		void       endRow       (void);
+		void       end          (void);
+
+	private:
+		ostream&      output;
+		int           format;
+#ifdef HAVE_ZLIB
+		z_stream      zstream;
+		vector<uchar> pending;       // raw image bytes waiting for deflate
+		vector<uchar> compressed;    // output buffer for deflate
+		void          addByte       (uchar value);
+		void          compressBytes (int flush);
+		void          writeChunk    (const char* type, const uchar* data,
+		                             int size);
+		void          writeLong     (unsigned long value);
+#endif
+};
+
 
 // function declarations
 void   checkOptions             (Options& opts, int argc, char* argv[]);
@@ -43,9 +116,17 @@ void   printPicture             (vector<PixelRow>& picturedata,
 							            vector<PixelRow>& background, int rfactor,
 							            int cfactor, int minp, int maxp,
 							            HumdrumFile& infile);
-void   placeNote                (vector<PixelRow>& picture, int pitch,
-							            double start, double duration, int min,
-							            PixelColor& color, double factor, int match);
+void   placeNote                (PixelRow& row, int offset, NoteEvent& note);
+int    getColumnCount           (HumdrumFile& infile);
+void   getNoteEvents            (HumdrumFile& infile,
+							            vector<vector<NoteEvent> >& notes, int style,
+							            int factor);
+void   getBarColumns            (HumdrumFile& infile, int factor,
+							            vector<int>& bars);
+void   renderRowTile            (PixelRow& tile, int offset,
+							            vector<NoteEvent>& notes, RowCursor& cursor,
+							            PixelColor& backcolor);
+void   printStreamingPicture    (HumdrumFile& infile, int style);
 PixelColor makeColor            (HumdrumFile& infile, int line, int spine,
 							            int style, vector<int>& rhylev, int track);
 void   getMarkChars             (vector<char>& marks, HumdrumFile& infile);
@@ -91,6 +172,9 @@ int       P6Q       = 0;         // used with -6 option
 int       jsonQ     = 0;
 int       metQ      = 0;         // used with --met option
 int       met2Q     = 0;         // used with --met2 option
+int       streamQ   = 0;         // used with --stream option
+int       pngQ      = 0;         // used with --png option
+int       lodfactor = 1;         // used with --lod option
 string optionfilename = "";      // used with -f option
 string keyboardcolor = "151515"; // used with the -k option
 string bgcolor = "000000";       // used with the -b option
@@ -118,6 +202,9 @@ int main(int argc, char* argv[]) {
 
 	if (jsonQ) {
 		createJsonProll(infile);
+	} else if (streamQ || pngQ || (lodfactor != 1) ||
+			(getColumnCount(infile) > 50000)) {
+		printStreamingPicture(infile, style);
 	} else {
 		int rfactor = generatePicture(infile, picturedata, style);
 		generateBackground(infile, rfactor, picturedata, background);
@@ -941,6 +1028,223 @@ void printPicture(vector<PixelRow>& picturedata, vector<PixelRow>& background,
 
 
 
+//////////////////////////////
+//
+// printStreamingPicture -- render the picture directly from the list
+//    of notes, one row at a time in tiles of TILE_WIDTH columns, so that
+//    the memory used does not depend on the length of the score.  When
+//    lodfactor is larger than one, groups of lodfactor columns are
+//    merged into a single output pixel (a value of 0 will choose the
+//    merging so that the image fits into the maximum width).  With a
+//    merge factor of 1 the image is identical to the one created by
+//    printPicture().
+//
+
+void printStreamingPicture(HumdrumFile& infile, int style) {
+	int columns = getColumnCount(infile);
+	int factor = (int)(maxwidth / columns);
+	if (factor <= 0) {
+		factor = 1;
+	}
+	if (factor > maxfactor) {
+		factor = maxfactor;
+	}
+
+	vector<vector<NoteEvent> > notes;
+	getNoteEvents(infile, notes, style, factor);
+	vector<int> bars;
+	getBarColumns(infile, factor, bars);
+
+	int width = columns * factor;
+	int lod = lodfactor;
+	if (lod <= 0) {
+		lod = (width + maxwidth - 1) / maxwidth;
+	}
+	if (lod <= 0) {
+		lod = 1;
+	}
+	int tilewidth = TILE_WIDTH / lod;
+	if (tilewidth <= 0) {
+		tilewidth = 1;
+	}
+	tilewidth *= lod;
+
+	int minp = gminpitch;
+	int maxp = gmaxpitch;
+	if (minp > 0) {
+		minp--;
+	}
+	if (maxp < 127) {
+		maxp++;
+	}
+	int height = (maxp - minp + 1);
+	int cfactor = (int)(maxheight / height);
+	if (cfactor <= 0) {
+		cfactor = 1;
+	}
+	if (cfactor > maxfactor) {
+		cfactor = maxfactor;
+	}
+
+	int format = IMAGE_P6;
+	if (pngQ) {
+		format = IMAGE_PNG;
+	} else if (P3Q) {
+		format = IMAGE_P3;
+	}
+	ImageWriter writer(cout, format);
+	writer.begin((width + lod - 1) / lod, height * cfactor);
+
+	PixelColor backcolor(bgcolor.c_str());
+	PixelColor whitekeys(keyboardcolor.c_str());
+	PixelColor measureColor;
+	measureColor.setColor(25, 25, 25);
+	PixelColor rowcolor;
+	PixelColor pixel;
+	PixelRow tile;
+	PixelRow below;
+	vector<char> barflags;
+	RowCursor cursor;
+	RowCursor belowcursor;
+
+	int i, j, k, m;
+	int c0, size, bar, darkenQ, count;
+	int red, green, blue;
+	for (i=maxp; i>=minp; i--) {
+		rowcolor = backcolor;
+		if (keyboardQ) {
+			switch (i % 12) {
+				case 0: case 2: case 4: case 5: case 7: case 9: case 11:
+					rowcolor = whitekeys;
+					break;
+			}
+		}
+		for (m=0; m<cfactor; m++) {
+			darkenQ = (i > 0) && (cfactor > 1) && (m == cfactor-1);
+			cursor.clear();
+			belowcursor.clear();
+			bar = 0;
+			writer.beginRow();
+			for (c0=0; c0<width; c0+=tilewidth) {
+				size = width - c0;
+				if (size > tilewidth) {
+					size = tilewidth;
+				}
+				tile.resize(size);
+				renderRowTile(tile, c0, notes[i], cursor, backcolor);
+				if (darkenQ) {
+					below.resize(size);
+					renderRowTile(below, c0, notes[i-1], belowcursor, backcolor);
+				}
+				barflags.assign(size, 0);
+				while ((bar < (int)bars.size()) && (bars[bar] < c0 + size)) {
+					if (bars[bar] >= c0) {
+						barflags[bars[bar] - c0] = 1;
+					}
+					bar++;
+				}
+
+				for (j=0; j<size; j+=lod) {
+					red = green = blue = 0;
+					count = 0;
+					for (k=j; (k<j+lod) && (k<size); k++) {
+						if (tile[k] == backcolor) {
+							continue;
+						}
+						if (darkenQ && (below[k] == tile[k])) {
+							pixel = tile[k] * 0.667;
+						} else {
+							pixel = tile[k];
+						}
+						red   += pixel.Red;
+						green += pixel.Green;
+						blue  += pixel.Blue;
+						count++;
+					}
+					if (count > 0) {
+						pixel.Red   = (red   + count/2) / count;
+						pixel.Green = (green + count/2) / count;
+						pixel.Blue  = (blue  + count/2) / count;
+					} else {
+						pixel = rowcolor;
+						for (k=j; (k<j+lod) && (k<size); k++) {
+							if (barflags[k]) {
+								pixel = measureColor;
+								break;
+							}
+						}
+					}
+					writer.writePixel(pixel);
+				}
+			}
+			writer.endRow();
+		}
+	}
+	writer.end();
+}
+
+
+
+//////////////////////////////
+//
+// renderRowTile -- draw the notes of a single pitch into a tile of
+//    a picture row which starts at column offset.  The cursor keeps
+//    track of the notes which still extend past the tile, so tiles must
+//    be rendered from left to right after clearing the cursor.
+//
+
+void renderRowTile(PixelRow& tile, int offset, vector<NoteEvent>& notes,
+		RowCursor& cursor, PixelColor& backcolor) {
+	int size = (int)tile.size();
+	int end  = offset + size;
+	int i;
+	for (i=0; i<size; i++) {
+		tile[i] = backcolor;
+	}
+
+	// Notes of a pitch are in score order, so their start times are
+	// non-decreasing.  A note also touches the column before its start.
+	while ((cursor.next < (int)notes.size()) &&
+			(notes[cursor.next].start - 1 < end)) {
+		cursor.active.push_back(cursor.next++);
+	}
+
+	int count = 0;
+	int last;
+	for (i=0; i<(int)cursor.active.size(); i++) {
+		NoteEvent& note = notes[cursor.active[i]];
+		placeNote(tile, offset, note);
+		last = note.stop;
+		if (last < note.start - 1) {
+			last = note.start - 1;
+		}
+		if (last >= end) {
+			cursor.active[count++] = cursor.active[i];
+		}
+	}
+	cursor.active.resize(count);
+}
+
+
+
+//////////////////////////////
+//
+// getBarColumns -- return the picture columns of the barlines
+//    in the score, in increasing order.
+//
+
+void getBarColumns(HumdrumFile& infile, int factor, vector<int>& bars) {
+	int min = infile.getMinTimeBase();
+	bars.resize(0);
+	for (int i=0; i<infile.getNumLines(); i++) {
+		if (infile[i].isMeasure()) {
+			bars.push_back((int)(infile[i].getAbsBeat() * min / 4.0 * factor));
+		}
+	}
+}
+
+
+
 //////////////////////////////
 //
 // generatePicture -- create the picture.  Returns the number of
@@ -950,15 +1254,7 @@ void printPicture(vector<PixelRow>& picturedata, vector<PixelRow>& background,
 int generatePicture(HumdrumFile& infile, vector<PixelRow>& picture, int
 		style) {
 
-	vector<char> marks;
-	getMarkChars(marks, infile);
-	PixelColor matchcolor(255,255,255);
-
-	infile.analyzeRhythm("4");
-	int min = infile.getMinTimeBase();
-	double totaldur = infile.getTotalDuration();
-
-	int columns = (int)(totaldur * min / 4.0 + 0.5) + 5;
+	int columns = getColumnCount(infile);
 	if (columns > 50000) {
 		cout << "Error: picture will be too big to generate" << endl;
 		exit(1);
@@ -974,7 +1270,7 @@ int generatePicture(HumdrumFile& infile, vector<PixelRow>& picture, int
 	// Set picture to black first.  Black regions will be filled in
 	// with the background later.
 	picture.resize(128);
-	int i, j, k;
+	int i, j;
 	PixelColor backcolor(bgcolor.c_str());
 	for (i=0; i<(int)picture.size(); i++) {
 		picture[i].resize(columns * factor);
@@ -986,6 +1282,57 @@ int generatePicture(HumdrumFile& infile, vector<PixelRow>& picture, int
 		}
 	}
 
+	vector<vector<NoteEvent> > notes;
+	getNoteEvents(infile, notes, style, factor);
+	for (i=0; i<(int)notes.size(); i++) {
+		for (j=0; j<(int)notes[i].size(); j++) {
+			placeNote(picture[i], 0, notes[i][j]);
+		}
+	}
+
+	return factor;
+}
+
+
+
+//////////////////////////////
+//
+// getColumnCount -- return the number of picture columns needed for
+//    the score before horizontal scaling.
+//
+
+int getColumnCount(HumdrumFile& infile) {
+	infile.analyzeRhythm("4");
+	int min = infile.getMinTimeBase();
+	double totaldur = infile.getTotalDuration();
+	return (int)(totaldur * min / 4.0 + 0.5) + 5;
+}
+
+
+
+//////////////////////////////
+//
+// getNoteEvents -- extract the notes to draw from the score, sorted
+//    by MIDI pitch.  The notes of each pitch are kept in score order
+//    (which is the order in which they are drawn).  Also sets the
+//    global pitch range of the score.
+//
+
+void getNoteEvents(HumdrumFile& infile, vector<vector<NoteEvent> >& notes,
+		int style, int factor) {
+
+	vector<char> marks;
+	getMarkChars(marks, infile);
+
+	infile.analyzeRhythm("4");
+	int min = infile.getMinTimeBase();
+
+	notes.resize(128);
+	int i, j, k;
+	for (i=0; i<(int)notes.size(); i++) {
+		notes[i].resize(0);
+	}
+
 	// examine metric levels for metric coloration
 	vector<int>rhylev;
 	infile.analyzeMetricLevel(rhylev);
@@ -994,6 +1341,7 @@ int generatePicture(HumdrumFile& infile, vector<PixelRow>& picture, int
 		rhylev[i] = -rhylev[i];
 	}
 
+	NoteEvent note;
 	PixelColor color;
 	int minpitch = 128;
 	int maxpitch = -1;
@@ -1035,13 +1383,11 @@ int generatePicture(HumdrumFile& infile, vector<PixelRow>& picture, int
 					if (pitch > maxpitch) {
 						maxpitch = pitch;
 					}
-					if (isMatch(marks, buffer)) {
-						placeNote(picture, pitch, start, duration, min,
-							   color, factor, 1);
-					} else {
-						placeNote(picture, pitch, start, duration, min,
-							   color, factor, 0);
-					}
+					note.start = (int)(start * min / 4.0 * factor);
+					note.stop  = (int)((start + duration) * min / 4.0 * factor) - 1;
+					note.match = isMatch(marks, buffer);
+					note.color = color;
+					notes[pitch].push_back(note);
 				}
 			}
 		}
@@ -1050,7 +1396,6 @@ int generatePicture(HumdrumFile& infile, vector<PixelRow>& picture, int
 
 	gmaxpitch = maxpitch;
 	gminpitch = minpitch;
-	return factor;
 }
 
 
@@ -1173,44 +1518,47 @@ string getInstrument(HumdrumFile& infile, int track) {
 
 //////////////////////////////
 //
-// placeNote -- draw a note in the picture area
+// placeNote -- draw a note in the picture area.  The row contains the
+//    picture columns starting at offset (the whole picture row or a
+//    tile of it); the parts of the note outside of the row are ignored.
 //
 
-void placeNote(vector<PixelRow>& picture, int pitch, double start,
-		double duration, int min, PixelColor& color, double factor, int match) {
-	int startindex = (int)(start * min / 4.0 * factor);
-	int endindex = (int)((start + duration) * min / 4.0 * factor) - 1;
+void placeNote(PixelRow& row, int offset, NoteEvent& note) {
+	int startindex = note.start - offset;
+	int endindex   = note.stop - offset;
+	int size       = (int)row.size();
+	PixelColor& color = note.color;
 
 	PixelColor zcolor = color;
-	if (match) {
+	if (note.match) {
 		zcolor.Red   = (zcolor.Red   + 4*255)/5;
 		zcolor.Green = (zcolor.Green + 4*255)/5;
 		zcolor.Blue  = (zcolor.Blue  + 4*255)/5;
 	}
 	PixelColor black(0,0,0);
-	if (startindex-1 >= 0) {
-		if (picture[pitch][startindex-1] == color) {
-			picture[pitch][startindex-1] *= 0.667;
+	if ((note.start-1 >= 0) && (startindex-1 >= 0) && (startindex-1 < size)) {
+		if (row[startindex-1] == color) {
+			row[startindex-1] *= 0.667;
 		}
 	}
+	if (startindex < 0) {
+		startindex = 0;
+	}
+	if (endindex >= size) {
+		endindex = size - 1;
+	}
 	for (int i=startindex; i<=endindex; i++) {
-		if (picture[pitch][i] == black) {
-			picture[pitch][i] = zcolor;
+		if (row[i] == black) {
+			row[i] = zcolor;
 		} else {
-			if (match) {
-				picture[pitch][i].Red   = (2*zcolor.Red
-						+ picture[pitch][i].Red)/3;
-				picture[pitch][i].Green = (2*zcolor.Green
-						+ picture[pitch][i].Green)/3;
-				picture[pitch][i].Blue  = (2*zcolor.Blue
-						+ picture[pitch][i].Blue)/3;
+			if (note.match) {
+				row[i].Red   = (2*zcolor.Red   + row[i].Red)/3;
+				row[i].Green = (2*zcolor.Green + row[i].Green)/3;
+				row[i].Blue  = (2*zcolor.Blue  + row[i].Blue)/3;
 			} else {
-				picture[pitch][i].Red   = (color.Red
-						+ picture[pitch][i].Red)/2;
-				picture[pitch][i].Green = (color.Green
-						+ picture[pitch][i].Green)/2;
-				picture[pitch][i].Blue  = (color.Blue
-						+ picture[pitch][i].Blue)/2;
+				row[i].Red   = (color.Red   + row[i].Red)/2;
+				row[i].Green = (color.Green + row[i].Green)/2;
+				row[i].Blue  = (color.Blue  + row[i].Blue)/2;
 			}
 		}
 	}
@@ -1286,6 +1634,9 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("3|p3|P3=b",           "output as P3 (ASCII) Portable anymap");
 	opts.define("6|p6|P6=b",           "output as P6 (binary) Portable anymap");
 	opts.define("j|json=b",            "output proll data in JSON format");
+	opts.define("png=b",               "output as PNG image");
+	opts.define("stream=b",            "render image in tiles without size limit");
+	opts.define("lod=i:1",             "input columns per pixel (0 = fit to width)");
 	opts.define("met=d:232",           "tempo control from metrical symbols");
 	opts.define("met2=d:336",          "tempo control from metrical symbols, older era");
 
@@ -1326,6 +1677,18 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	optionfilename =  opts.getString("filename").c_str();
 	P6Q            =  opts.getBoolean("p6");
 	bgcolor        =  opts.getString("background").c_str();
+	streamQ        =  opts.getBoolean("stream");
+	pngQ           =  opts.getBoolean("png");
+	lodfactor      =  opts.getInteger("lod");
+	if (lodfactor < 0) {
+		lodfactor = 1;
+	}
+#ifndef HAVE_ZLIB
+	if (pngQ) {
+		cerr << "Error: PNG output requires compiling with zlib" << endl;
+		exit(1);
+	}
+#endif
 	if (opts.getBoolean("p6")) {
 		P3Q = 0;
 	} else {
@@ -1543,3 +1906,217 @@ double checkForTempo(HumdrumRecord& record) {
 
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// ImageWriter class functions --
+//
+
+ImageWriter::ImageWriter(ostream& out, int imageformat) : output(out) {
+	format = imageformat;
+#ifdef HAVE_ZLIB
+	memset(&zstream, 0, sizeof(zstream));
+#else
+	if (format == IMAGE_PNG) {
+		format = IMAGE_P6;
+	}
+#endif
+}
+
+
+ImageWriter::~ImageWriter() {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// ImageWriter::begin -- write the image header.
+//
+
+void ImageWriter::begin(int width, int height) {
+	switch (format) {
+		case IMAGE_P3:
+			output << "P3\n" << width << " " << height << "\n255\n";
+			break;
+		case IMAGE_P6:
+			output << "P6\n" << width << " " << height << "\n255\n";
+			break;
+#ifdef HAVE_ZLIB
+		case IMAGE_PNG:
+			{
+				const uchar signature[8] = {137, 'P', 'N', 'G', 13, 10, 26, 10};
+				output.write((const char*)signature, 8);
+				uchar header[13];
+				int i;
+				for (i=0; i<4; i++) {
+					header[i]   = (uchar)((width  >> (24 - 8*i)) & 0xff);
+					header[4+i] = (uchar)((height >> (24 - 8*i)) & 0xff);
+				}
+				header[8]  = 8;   // bits per sample
+				header[9]  = 2;   // RGB color
+				header[10] = 0;   // deflate compression
+				header[11] = 0;   // adaptive filtering
+				header[12] = 0;   // not interlaced
+				writeChunk("IHDR", header, 13);
+				deflateInit(&zstream, Z_DEFAULT_COMPRESSION);
+				pending.reserve(0x10000);
+				pending.resize(0);
+				compressed.resize(0x10000);
+			}
+			break;
+#endif
+	}
+}
+
+
+
+//////////////////////////////
+//
+// ImageWriter::beginRow -- start a new row of pixels.
+//
+
+void ImageWriter::beginRow(void) {
+#ifdef HAVE_ZLIB
+	if (format == IMAGE_PNG) {
+		addByte(0);    // no filtering for row
+	}
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// ImageWriter::writePixel -- append a pixel to the current row.
+//
+
+void ImageWriter::writePixel(PixelColor& color) {
+	switch (format) {
+		case IMAGE_P3:
+			color.writePpm3(output);
+			break;
+		case IMAGE_P6:
+			color.writePpm6(output);
+			break;
+#ifdef HAVE_ZLIB
+		case IMAGE_PNG:
+			addByte(color.Red);
+			addByte(color.Green);
+			addByte(color.Blue);
+			break;
+#endif
+	}
+}
+
+
+
+//////////////////////////////
+//
+// ImageWriter::endRow -- finish the current row of pixels.
+//
+
+void ImageWriter::endRow(void) {
+	if (format == IMAGE_P3) {
+		output << "\n";
+	}
+}
+
+
+
+//////////////////////////////
+//
+// ImageWriter::end -- finish writing the image.
+//
+
+void ImageWriter::end(void) {
+#ifdef HAVE_ZLIB
+	if (format == IMAGE_PNG) {
+		compressBytes(Z_FINISH);
+		deflateEnd(&zstream);
+		writeChunk("IEND", NULL, 0);
+	}
+#endif
+	output.flush();
+}
+
+
+#ifdef HAVE_ZLIB
+
+//////////////////////////////
+//
+// ImageWriter::addByte -- add a byte to the PNG image data, compressing
+//    the data whenever the staging buffer is full.
+//
+
+void ImageWriter::addByte(uchar value) {
+	pending.push_back(value);
+	if (pending.size() >= 0x10000) {
+		compressBytes(Z_NO_FLUSH);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// ImageWriter::compressBytes -- compress the staged image data and
+//    write the output as IDAT chunks.
+//
+
+void ImageWriter::compressBytes(int flush) {
+	zstream.next_in  = pending.data();
+	zstream.avail_in = (uInt)pending.size();
+	int status;
+	int size;
+	do {
+		zstream.next_out  = compressed.data();
+		zstream.avail_out = (uInt)compressed.size();
+		status = deflate(&zstream, flush);
+		size = (int)compressed.size() - (int)zstream.avail_out;
+		if (size > 0) {
+			writeChunk("IDAT", compressed.data(), size);
+		}
+	} while ((zstream.avail_out == 0) ||
+			((flush == Z_FINISH) && (status != Z_STREAM_END)));
+	pending.resize(0);
+}
+
+
+
+//////////////////////////////
+//
+// ImageWriter::writeChunk -- write a PNG chunk: length, type, data
+//     and the CRC of the type and data.
+//
+
+void ImageWriter::writeChunk(const char* type, const uchar* data, int size) {
+	writeLong(size);
+	output.write(type, 4);
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, (const Bytef*)type, 4);
+	if (size > 0) {
+		output.write((const char*)data, size);
+		crc = crc32(crc, data, size);
+	}
+	writeLong(crc);
+}
+
+
+
+//////////////////////////////
+//
+// ImageWriter::writeLong -- write a 4-byte big-endian number.
+//
+
+void ImageWriter::writeLong(unsigned long value) {
+	output.put((char)((value >> 24) & 0xff));
+	output.put((char)((value >> 16) & 0xff));
+	output.put((char)((value >>  8) & 0xff));
+	output.put((char)(value & 0xff));
+}
+
+#endif
+
+
+
@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Thu May 12 20:08:36 PDT 2016
 // Last Modified: Thu May 12 20:08:40 PDT 2016
+// Last Modified: Sun Oct 18 18:21:55 PDT 2026 Added --npy output
 // Filename:      ...museinfo/examples/all/rnn-input.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/rnn-input.cpp
 // Syntax:        C++; museinfo
@@ -13,6 +14,7 @@
 #include <vector>
 #include <stdlib.h>
 #include "PerlRegularExpression.h"
+#include "NpyWriter.h"
 
 ///////////////////////////////////////////////////////////////////////////
 
@@ -20,13 +22,17 @@
 void      checkOptions         (Options& opts, int argc, char* argv[]);
 void      example              (void);
 void      usage                (const char* command);
-void      processFile          (HumdrumFile& infile);
+void      processFile          (HumdrumFile& infile, int index);
 void      printAnalysis        (vector<vector<vector<int> > >& data);
+void      storeAnalysis        (NpyWriter& array,
+                                vector<vector<vector<int> > >& data);
 void      storeNote            (vector<vector<int> >& pcs, int startrow, int endrow, int pc);
 
 // global variables
 Options   options;             // database for command-line arguments
 int       debugQ = 0;          // used with --debug option
+int       npyQ   = 0;          // used with --npy option
+string    npydir = "";         // used with --npy-dir option
 
 ///////////////////////////////////////////////////////////////////////////
 
@@ -35,9 +41,12 @@ int main(int argc, char** argv) {
    HumdrumStream streamer(options);
    HumdrumFile infile;
 
+   int index = 0;
    while (streamer.read(infile)) {
-      processFile(infile);
-      break; // only allowing one input at the moment
+      processFile(infile, index++);
+      if (npydir.empty()) {
+         break; // only allowing one input at the moment
+      }
    }
 
    return 0;
@@ -50,7 +59,7 @@ int main(int argc, char** argv) {
 // processFile -- Do requested analysis on a given file.
 //
 
-void processFile(HumdrumFile& infile) {
+void processFile(HumdrumFile& infile, int index) {
    infile.analyzeRhythm("4");
    vector<int> ktracks;
    infile.getKernTracks(ktracks);
@@ -131,8 +140,25 @@ void processFile(HumdrumFile& infile) {
       }
    }
 
+   if (!npyQ) {
+      printAnalysis(pcs);
+      return;
+   }
 
-   printAnalysis(pcs);
+   NpyWriter array(NPY_UINT8);
+   storeAnalysis(array, pcs);
+   int status;
+   string filename;
+   if (npydir.empty()) {
+      status = array.write(cout);
+   } else {
+      filename = NpyWriter::makeFilename(npydir, infile.getFilename(), index);
+      status = array.write(filename);
+   }
+   if (!status) {
+      cerr << "Error: could not write array " << filename << endl;
+      exit(1);
+   }
 }
 
 
@@ -179,6 +205,25 @@ void printAnalysis(vector<vector<vector<int> > >& data) {
 
 
 
+//////////////////////////////
+//
+// storeAnalysis -- store the analysis as a binary array: one row for
+//    each frame, with twelve pitch-class columns for each voice.
+//
+
+void storeAnalysis(NpyWriter& array, vector<vector<vector<int> > >& data) {
+   int i, j, k;
+   for (j=0; j<(int)data[0].size(); j++) {
+      for (i=0; i<(int)data.size(); i++) {
+         for (k=0; k<(int)data[i][j].size(); k++) {
+            array.append(data[i][j][k]);
+         }
+      }
+      array.endRow();
+   }
+}
+
+
 
 //////////////////////////////
 //
@@ -186,6 +231,8 @@ void printAnalysis(vector<vector<vector<int> > >& data) {
 //
 
 void checkOptions(Options& opts, int argc, char* argv[]) {
+   opts.define("npy=b");                // binary NumPy output
+   opts.define("npy-dir=s");            // one .npy file per input
    opts.define("debug=b");              // determine bad input line num
    opts.define("author=b");             // author of program
    opts.define("version=b");            // compilation info
@@ -212,6 +259,10 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    }
 
    debugQ = opts.getBoolean("debug");
+   npyQ   = opts.getBoolean("npy") || opts.getBoolean("npy-dir");
+   if (opts.getBoolean("npy-dir")) {
+      npydir = opts.getString("npy-dir");
+   }
 
 }
 
@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Oct 23 19:44:36 PDT 2000
 // Last Modified: Tue Feb 11 07:26:13 PST 2020 Added --total option
+// Last Modified: Sun Oct 18 21:30:14 PDT 2026 Added -r option
 // Filename:      ...sig/examples/all/scordur.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/scordur.cpp
 // Syntax:        C++; museinfo
@@ -31,6 +32,8 @@ void      usage              (const string& command);
 // global variables:
 Options   options;            // database for command-line arguments
 int       numinputs;          // the total number of input files
+int       rationalQ = 0;      // used with -r option
+RationalNumber rtotal(0, 1);  // used with -r and -t options
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -63,7 +66,11 @@ int main(int argc, char** argv) {
 		counter++;
 	}
 	if (counter && options.getBoolean("total")) {
-		cout << "Total:\t" << total << endl;
+		if (rationalQ) {
+			cout << "Total:\t" << rtotal << endl;
+		} else {
+			cout << "Total:\t" << total << endl;
+		}
 	}
 
 	return 0;
@@ -79,6 +86,7 @@ int main(int argc, char** argv) {
 
 void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("t|total=b", "display total duration of all inputs");
+	opts.define("r|rational=b", "display durations as exact fractions");
 	opts.define("author=b");               // author of program
 	opts.define("version=b");              // compilation info
 	opts.define("example=b");              // example usages
@@ -91,7 +99,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 			  << "craig@ccrma.stanford.edu, October 2000" << endl;
 		exit(0);
 	} else if (opts.getBoolean("version")) {
-		cout << argv[0] << ", version: 11 February 2020" << endl;
+		cout << argv[0] << ", version: 18 October 2026" << endl;
 		cout << "compiled: " << __DATE__ << endl;
 		cout << MUSEINFO_VERSION << endl;
 		exit(0);
@@ -102,6 +110,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 		example();
 		exit(0);
 	}
+
+	rationalQ = opts.getBoolean("rational");
 }
 
 
@@ -120,7 +130,14 @@ double displayResults(HumdrumFile& hfile, int count, const string& filename) {
 	}
 	output = hfile[maxline].getAbsBeat();
 	cout << filename << ":\t";
-	cout << output << "\n";
+	if (rationalQ) {
+		// exact duration from the integer tick timeline
+		RationalNumber duration = hfile.ticksToBeatR(hfile.getTotalTicks());
+		rtotal += duration;
+		cout << duration << "\n";
+	} else {
+		cout << output << "\n";
+	}
 	return output;
 }
 
@@ -157,6 +174,8 @@ void usage(const string& command) {
 	"Usage: " << command << " [input1 [input2 ...]]                           \n"
 	"                                                                         \n"
 	"Options:                                                                 \n"
+	"   -r        = display durations as exact fractions of quarter notes     \n"
+	"   -t        = display the total duration of all inputs                  \n"
 	"   --options = list of all options, aliases and default values           \n"
 	"                                                                         \n"
 	<< endl;
@@ -2,6 +2,9 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Mar 26 09:12:54 PST 2002
 // Last Modified: Sat Mar 30 14:24:32 PST 2002
+// Last Modified: Sun Oct 18 16:17:44 PDT 2026 in-memory VTS, batch mode
+// Last Modified: Sun Oct 18 21:23:18 PDT 2026 threaded reading with -j
+// Last Modified: Sun Oct 18 21:28:55 PDT 2026 keep input paths with -d
 // Filename:      ...sig/examples/all/scorepitch.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/score/scorepitch.cpp
 // Syntax:        C++; museinfo
@@ -15,6 +18,7 @@
 
 #include "humdrum.h"
 #include "ScorePageSimple.h"
+#include "CheckSum.h"
 
 #include <stdlib.h>
 #include <ctype.h>
@@ -22,8 +26,17 @@
 #include <math.h>
 #include <stdio.h>
 
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <map>
+#include <thread>
+#include <vector>
+
 #ifndef OLDCPP
    #include <fstream>
+   #include <sstream>
 #else
    #include <fstream.h>
 #endif
@@ -149,6 +162,10 @@ int   findNearestMeasure (ScorePageSimple& score, float pos, int staff);
 double   findDuration    (Array<Thing>& things, int measure);
 ostream& operator<<      (ostream& out, Thru& thru);
 void     printNoRep      (Array<Thru>& thruinfo, ostream& out);
+void     getInputList    (Array<string>& inputs, Options& opts);
+void     getOutputName   (string& outname, const string& dir,
+                          const string& inputname);
+void     makeDirectories (const string& filename);
 
 
 // interface variables:
@@ -157,6 +174,7 @@ int     verboseQ  = 0;    // Display debugging information
 int     rhythmQ   = 1;    // used with the -r option
 int     titleQ    = 0;    // used with the -t option
 int     checksumQ = 0;    // used with the -c option
+string  outdir    = "";   // used with the -d option
 
 
 int main(int argc, char** argv) {
@@ -166,11 +184,17 @@ int main(int argc, char** argv) {
    options.define("g|global-ref=s",   "global reference record file");
    options.define("l|local-ref=s",    "local reference record file");
    options.define("R|no-rhythm=b",    "don't display rhythm information");
+   options.define("d|directory=s",    "write each conversion into directory");
+   options.define("f|file-list=s",    "file containing list of input files");
+   options.define("j|threads=i:1",    "number of files to read at once (0=all cores)");
    options.process(argc, argv);
    checksumQ =  options.getBoolean("checksum");
    verboseQ  =  options.getBoolean("verbose");
    rhythmQ   = !options.getBoolean("no-rhythm");
    titleQ    =  options.getBoolean("title");
+   if (options.getBoolean("directory")) {
+      outdir = options.getString("directory");
+   }
    const char* globalfilename = "";
    const char* localfilename  = "";
    if (options.getBoolean("global-ref")) {
@@ -189,50 +213,100 @@ int main(int argc, char** argv) {
    trailer.setSize(0);
    getHeaderAndTrailer(globalfilename, localfilename, header, trailer, extras);
 
-   if (options.getArgCount() == 0) {
+   Array<string> inputs;
+   getInputList(inputs, options);
+   if (inputs.getSize() == 0) {
       cout << "Usage: " << argv[0] << " input.mus " << endl;
       exit(1);
    }
 
-   ScorePageSimple score;
+   // with -d, check that no two inputs are written to the same file
+   // before anything is converted.
+   vector<string> outnames;
+   if (outdir.size() > 0) {
+      map<string, int> used;
+      outnames.resize(inputs.getSize());
+      for (int k=0; k<inputs.getSize(); k++) {
+         getOutputName(outnames[k], outdir, inputs[k]);
+         if (used.find(outnames[k]) != used.end()) {
+            cerr << "Error: " << inputs[used[outnames[k]]] << " and "
+                 << inputs[k] << " would both be written to "
+                 << outnames[k] << endl;
+            exit(1);
+         }
+         used[outnames[k]] = k;
+      }
+   }
+
+   // read the input files in blocks, several at once with the -j option,
+   // and convert them one at a time in the order of the input list.
+   int threads = options.getInteger("threads");
+   if (threads <= 0) {
+      threads = (int)std::thread::hardware_concurrency();
+   }
+   if (threads <= 0) {
+      threads = 1;
+   }
+   int blocksize = threads > 1 ? 4 * threads : 1;
+   vector<ScorePageSimple> scores(blocksize);
+   vector<ScorePageBaseSimple*> pages;
+   vector<string> filenames;
+
    Array<Thing> things;
    Array<Thru> thruinfo;
-   int i;
-   for (i=1; i<=options.getArgCount(); i++) {
-      score.clear();
-      score.readFile(options.getArg(i).c_str(), verboseQ);
+   stringstream kernstream;
+   string kerndata;
+   string outname;
+   ofstream outfile;
+   int i, j;
+   for (i=0; i<inputs.getSize(); i++) {
+      j = i % blocksize;
+      if (j == 0) {
+         pages.clear();
+         filenames.clear();
+         for (j=0; (j<blocksize) && (i+j<inputs.getSize()); j++) {
+            pages.push_back(&scores[j]);
+            filenames.push_back(inputs[i+j]);
+         }
+         ScorePageBaseSimple::readFiles(pages, filenames, threads, verboseQ);
+         j = 0;
+      }
+      ScorePageSimple& score = scores[j];
       getThings(score, things);
       assignMeasure(score, things);
       applySlurs(score, things);
       findMetronome(score, things);
       cleanupThings(score, things, extras, thruinfo);
 
-      printKern(cout, score, things, header, trailer, extras, thruinfo);
-#ifndef VISUAL
+      // generate the conversion in memory, so that the checksum
+      // can be calculated without writing to a temporary file.
+      kernstream.str("");
+      printKern(kernstream, score, things, header, trailer, extras, thruinfo);
+      kerndata = kernstream.str();
+
+      ostream* out = &cout;
+      if (outdir.size() > 0) {
+         outname = outnames[i];
+         makeDirectories(outname);
+         outfile.open(outname.c_str(), ios::out | ios::binary);
+         if (!outfile.is_open()) {
+            cerr << "Error: cannot write file: " << outname << endl;
+            exit(1);
+         }
+         out = &outfile;
+      }
+
+      out->write(kerndata.c_str(), kerndata.size());
       if (checksumQ) {
-         fstream outfile("/tmp/scrmono2hum-temp", ios::out);
-         printKern(outfile, score, things, header, trailer, extras, thruinfo);
+         unsigned long value = CheckSum::crc32(kerndata.c_str(),
+               kerndata.size());
+         *out << "!!!VTS: " << value << endl;
+      }
+
+      if (outfile.is_open()) {
          outfile.close();
-         int status = system("chmod 0666 /tmp/scrmono2hum-temp");
-         status = system("cksum /tmp/scrmono2hum-temp | sed 's/ .*//' > /tmp/scrmono2hum-temp2");
-         status = system("chmod 0666 /tmp/scrmono2hum-temp2");
-         #ifndef OLDCPP
-            fstream infile("/tmp/scrmono2hum-temp2", ios::in);
-         #else
-            fstream infile("/tmp/scrmono2hum-temp2", ios::in | ios::nocreate);
-         #endif
-         unsigned long value;
-         infile >> value;
-         cout << "!!!VTS: " << value << endl;
-         infile.close();
-         status = system("rm /tmp/scrmono2hum-temp2");
-         status = system("rm /tmp/scrmono2hum-temp");
-         if (status < 0) {
-            // avoid compiler warning
-            status--;
-         }
       }
-#endif /* VISUAL */
+      score.clear();
    }
 
    cout << flush;
@@ -240,6 +314,121 @@ int main(int argc, char** argv) {
 }
 
 
+
+//////////////////////////////
+//
+// getInputList -- Collect the list of input files from the command-line
+//    arguments and from the file given with the -f option (one filename
+//    per line, or "-" to read the list from standard input).
+//
+
+void getInputList(Array<string>& inputs, Options& opts) {
+   inputs.setSize(opts.getArgCount() + 1000);
+   inputs.setGrowth(10000);
+   inputs.setSize(0);
+
+   string filename;
+   int i;
+   for (i=1; i<=opts.getArgCount(); i++) {
+      filename = opts.getArg(i);
+      inputs.append(filename);
+   }
+
+   if (!opts.getBoolean("file-list")) {
+      return;
+   }
+
+   string listname = opts.getString("file-list");
+   ifstream listfile;
+   istream* list = &cin;
+   if (listname != "-") {
+      listfile.open(listname.c_str(), ios::in);
+      if (!listfile.is_open()) {
+         cerr << "Error: cannot read file list: " << listname << endl;
+         exit(1);
+      }
+      list = &listfile;
+   }
+
+   while (getline(*list, filename)) {
+      if ((filename.size() > 0) && (filename.back() == '\r')) {
+         filename.resize(filename.size() - 1);
+      }
+      if (filename.size() == 0) {
+         continue;
+      }
+      inputs.append(filename);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// getOutputName -- Generate the name of the output file for an input
+//    file when using the -d option.  The path of the input file is kept
+//    below the output directory, so that inputs with the same name in
+//    different directories do not overwrite each other ("." and ".."
+//    in the path are dropped).  The filename extension is replaced
+//    with ".krn".
+//
+
+void getOutputName(string& outname, const string& dir,
+      const string& inputname) {
+   string path;
+   string part;
+   size_t start = 0;
+   size_t pos;
+   while (start <= inputname.size()) {
+      pos = inputname.find('/', start);
+      if (pos == string::npos) {
+         pos = inputname.size();
+      }
+      part = inputname.substr(start, pos - start);
+      start = pos + 1;
+      if (part.empty() || (part == ".") || (part == "..")) {
+         continue;
+      }
+      if (!path.empty()) {
+         path += '/';
+      }
+      path += part;
+   }
+   pos = path.rfind('.');
+   size_t slash = path.rfind('/');
+   if ((pos != string::npos) && (pos > 0) &&
+         ((slash == string::npos) || (pos > slash + 1))) {
+      path.resize(pos);
+   }
+   outname = dir;
+   if ((outname.size() > 0) && (outname.back() != '/')) {
+      outname += '/';
+   }
+   outname += path;
+   outname += ".krn";
+}
+
+
+
+//////////////////////////////
+//
+// makeDirectories -- create the directories in the path of an output
+//    file which do not exist yet.
+//
+
+void makeDirectories(const string& filename) {
+   size_t pos = filename.find('/', 1);
+   while (pos != string::npos) {
+      string dir = filename.substr(0, pos);
+      if (mkdir(dir.c_str(), 0755) && (errno != EEXIST)) {
+         return;
+      }
+      pos = filename.find('/', pos + 1);
+   }
+}
+
+
+
 //////////////////////////////////////////////////////////////////////////
 
 
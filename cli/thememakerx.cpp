@@ -3,6 +3,7 @@
 // Creation Date: Sat May  1 16:20:50 PDT 2004
 // Last Modified: Sat May  1 16:20:52 PDT 2004
 // Last Modified: Wed May 27 01:00:49 PDT 2009 (fixed out filename in cwd)
+// Last Modified: Sun Oct 18 18:32:36 PDT 2026 (sorted file order, --jobs)
 // Filename:      ...museinfo/examples/all/thememakerx.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/thememakerx.cpp
 // Syntax:        C++; museinfo
@@ -12,6 +13,7 @@
 //
 
 #include "humdrum.h"
+#include "CorpusWalker.h"
 
 #ifndef OLDCPP
    #include <iostream>
@@ -22,10 +24,10 @@
    #include <fstream.h>
 #endif
 
-// includes needed for file/directory processing:
+// includes needed for creating output directories:
 #include <sys/types.h>
 #include <sys/stat.h>
-#include <dirent.h>
+#include <errno.h>
 #include <string.h>
 
 
@@ -37,9 +39,8 @@ void      createIncipit          (HumdrumFile& hfile, const char* filename,
                                   const char* sourcebase, int limit);
 void      extractPitchSequence   (Array<int>& pitches, Array<int>& phrase,
                                   HumdrumFile& hfile);
-int       is_directory           (const char* path);
-int       is_file                (const char* path);
-void      processArgument        (const char* path);
+void      processFile            (int index, const string& path,
+                                  void* userdata);
 void      createOutputName       (char* outfile, const char* filename,
                                   const char* target, const char* sourcebase);
 void      checkTargetDirectory   (const char* outfile);
@@ -54,7 +55,8 @@ int       debugQ  = 0;         // used with --debug option
 int       limitQ  = 0;         // used with -l option
 int       limit   = 30;        // used with -l option
 int       minval  = 10;        // used with -m option
-const char* target = ".";        // used with -b option
+string    target  = ".";         // used with -t option
+int       jobs    = 1;         // used with --jobs option
 char sourcebase[2048] = {0};
 
 
@@ -63,25 +65,39 @@ char sourcebase[2048] = {0};
 int main(int argc, char** argv) {
    checkOptions(options, argc, argv); // process the command-line options
 
-   int i;
+   int i, j;
    int numinputs = options.getArgCount();
    HumdrumFile hfile;
    strcpy(sourcebase, ".");
 
-   for (i=0; i<numinputs || i==0; i++) {
-      hfile.clear();
+   // if no command-line arguments read data file from standard input
+   if (numinputs < 1) {
+      hfile.read(cin);
+      createIncipit(hfile, "", sourcebase, limit);
+      return 0;
+   }
 
-      // if no command-line arguments read data file from standard input
-      if (numinputs < 1) {
-         hfile.read(cin);
-         createIncipit(hfile, "", sourcebase, limit);
-      } else {
-         if (is_directory(options.getArg(i+1).c_str())) {
-            strcpy(sourcebase, options.getArg(i+1).c_str());
-         }
-         processArgument(options.getArg(i+1).c_str());
+   // otherwise process files and all files in directories.  The
+   // source base for each file is the last directory argument
+   // before the file.
+   CorpusWalker corpus;
+   corpus.setRecursive();
+   corpus.addExtension(".krn");
+   corpus.addExtension(".KRN");
+   vector<string> sourcebases;
+   string currentbase = sourcebase;
+   int count;
+   for (i=0; i<numinputs; i++) {
+      if (CorpusWalker::isDirectory(options.getArg(i+1))) {
+         currentbase = options.getArg(i+1);
+      }
+      count = corpus.addPath(options.getArg(i+1));
+      for (j=0; j<count; j++) {
+         sourcebases.push_back(currentbase);
       }
    }
+   cout.flush();
+   corpus.run(processFile, &sourcebases, jobs);
 
    return 0;
 }
@@ -92,83 +108,15 @@ int main(int argc, char** argv) {
 
 //////////////////////////////
 //
-// processArgument -- check if the argument is a file or a directory.
-//    If a directory, then process all files/subdirectories in it.
+// processFile -- create the incipit for a file.  The userdata is the
+//    list of source bases for the files.
 //
 
-void processArgument(const char* path) {
+void processFile(int index, const string& path, void* userdata) {
+   vector<string>& sourcebases = *((vector<string>*)userdata);
    HumdrumFile hfile;
-   DIR* dir = NULL;
-   char* fullname;
-   struct dirent* entry;
-   int namelen = 0;
-   int valid = 0;
-
-   if (is_file(path)) {
-      namelen = strlen(path);
-      valid = 0;
-      if (strcmp(&(path[namelen-4]), ".krn") == 0) {
-         valid = 1;
-      } else if (strcmp(&(path[namelen-4]), ".KRN") == 0) {
-         valid = 1;
-      }
-      if (!valid) {
-         return;
-      }
-      hfile.read(path);
-      createIncipit(hfile, path, sourcebase, limit);
-   } else if (is_directory(path)) {
-      dir = opendir(path);
-      if (dir == NULL) {
-         return;
-      }
-      entry = readdir(dir);
-      while (entry != NULL) {
-         if (strncmp(entry->d_name, ".", 1) == 0) {
-            entry = readdir(dir);
-            continue;
-         }
-
-         fullname = new char[strlen(path) + 1 + strlen(entry->d_name) + 1];
-         strcpy(fullname, path);
-         strcat(fullname, "/");
-         strcat(fullname, entry->d_name);
-         processArgument(fullname);
-         entry = readdir(dir);
-      }
-   }
-
-   closedir(dir);
-}
-
-
-
-//////////////////////////////
-//
-// is_file -- returns true if the string is a file.
-//
-
-int is_file(const char* path) {
-   struct stat filestat;
-   if (stat(path, &filestat)) {
-      return 0;
-   }
-   return S_ISREG(filestat.st_mode);
-}
-
-
-
-//////////////////////////////
-//
-// is_directory -- returns true if the string is a directory.
-//
-
-int is_directory(const char* path) {
-   struct stat filestat;
-   if (stat(path, &filestat)) {
-      return 0;
-   }
-   return S_ISDIR(filestat.st_mode);
+   hfile.read(path.c_str());
+   createIncipit(hfile, path.c_str(), sourcebases[index].c_str(), limit);
 }
 
 
@@ -181,7 +129,7 @@ int is_directory(const char* path) {
 void createIncipit(HumdrumFile& hfile, const char* filename,
       const char* sourcebase, int limit) {
    char outfile[4096] = {0};
-   createOutputName(outfile, filename, target, sourcebase);
+   createOutputName(outfile, filename, target.c_str(), sourcebase);
    cout << "creating incipit for: " << filename << "\toutput: " << outfile << endl;
 
    fstream output;
@@ -385,7 +333,7 @@ void checkTargetDirectory(const char* outfile) {
       return;
    }
    end[0] = '\0';
-   if (is_directory(buffer)) {
+   if (CorpusWalker::isDirectory(buffer)) {
       return;
    }
 
@@ -397,9 +345,10 @@ void checkTargetDirectory(const char* outfile) {
    char* ptr = strtok(buffer, "/");
    while (ptr != NULL) {
       strcat(fulldir, ptr);
-      if (!is_directory(fulldir)) {
+      if (!CorpusWalker::isDirectory(fulldir)) {
          cout << "Creating the directory: " << fulldir << endl;
-         if (mkdir(fulldir, 0755)) {
+         // another job may have just created the directory
+         if (mkdir(fulldir, 0755) && (errno != EEXIST)) {
             cout << "ERROR creating the directory: "<< fulldir << endl;
             exit(1);
          }
@@ -485,6 +434,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    opts.define("l|limit=i:30",   "upper limit the number of extracted notes");
    opts.define("m|min=i:10",     "lower limit on number of extracted notes");
    opts.define("t|target=s:.",   "filename target base for recursive output");
+   opts.define("jobs=i:1",       "number of files to process at once (0=all cpus)");
 
    opts.define("author=b",  "author of program");
    opts.define("version=b", "compilation info");
@@ -514,9 +464,10 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    limitQ      = opts.getBoolean("limit");
    limit       = opts.getInteger("limit");
    minval      = opts.getInteger("min");
-   target      = opts.getString("target").c_str();
+   target      = opts.getString("target");
+   jobs        = opts.getInteger("jobs");
 
-   if (!is_directory(target)) {
+   if (!CorpusWalker::isDirectory(target)) {
       cout << "Error: target directory does not exist: " << target << endl;
       exit(1);
    }
@@ -3,6 +3,7 @@
 // Creation Date: Wed Dec 13 13:35:37 PST 2000
 // Last Modified: Sun Oct  9 02:06:07 PDT 2005 (converted from kern2melisma)
 // Last Modified: Tue Dec 13 22:16:14 PST 2005 (small fixes)
+// Last Modified: Sun Oct 18 18:21:55 PDT 2026 (added --npy output)
 // Filename:      ...sig/examples/all/time2matlab.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/time2matlab.cpp
 // Syntax:        C++; museinfo
@@ -20,6 +21,7 @@
 #include <stdio.h>
 
 #include "humdrum.h"
+#include "NpyWriter.h"
 
 using namespace std;
 
@@ -27,7 +29,7 @@ using namespace std;
 void      checkOptions      (Options& opts, int argc, char** argv);
 void      example           (void);
 void      preparePitch      (string& buffer2, const string& buffer1);
-void      printOutput       (HumdrumFile& hfile);
+void      printOutput       (HumdrumFile& hfile, NpyWriter* array);
 void      usage             (const string& command);
 double    getEndTime        (HumdrumFile& hfile, int startindex,
                              double duration);
@@ -36,6 +38,8 @@ int       getMeasureNum     (HumdrumFile& hfile, int index);
 double    getTimeToEnd      (HumdrumFile& infile, double starttime,
                              int startindex);
 void      printSaccid       (ostream& out, const string& string);
+int       getSaccid         (const string& astring);
+void      writeArray        (NpyWriter& array, const string& filename);
 void      comment           (ostream& out, int count, int style);
 
 // User interface variables:
@@ -47,6 +51,8 @@ int       classQ    = 0;      // used with -c option
 int       auxdataQ  = 0;      // used with -a option
 double    tdefault  = 60.0;   // used with -t option
 int       humdrumQ  = 0;      // used with --humdrum option
+int       npyQ      = 0;      // used with --npy option
+string    npydir    = "";     // used with --npy-dir option
 
 char      humComment = '!';
 char      matComment = '%';
@@ -57,9 +63,29 @@ int main(int argc, char** argv) {
 	// process the command-line options
 	checkOptions(options, argc, argv);
 
-	HumdrumFile hfile(options.getArg(1).c_str());
-	hfile.analyzeRhythm("4");
-	printOutput(hfile);
+	if (!npyQ) {
+		HumdrumFile hfile(options.getArg(1).c_str());
+		hfile.analyzeRhythm("4");
+		printOutput(hfile, NULL);
+		return 0;
+	}
+
+	// binary output: one array for the first input, or one
+	// file for each input when --npy-dir is given.
+	NpyWriter array(NPY_FLOAT64);
+	int count = npydir.empty() ? 1 : options.getArgCount();
+	for (int i=0; i<count; i++) {
+		HumdrumFile hfile(options.getArg(i+1).c_str());
+		hfile.analyzeRhythm("4");
+		array.clear();
+		printOutput(hfile, &array);
+		if (npydir.empty()) {
+			writeArray(array, "");
+		} else {
+			writeArray(array, NpyWriter::makeFilename(npydir,
+					options.getArg(i+1), i));
+		}
+	}
 	return 0;
 }
 
@@ -79,6 +105,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("c|class=b", "display pitches in pitch class notation");
 	opts.define("t|tempo|default-tempo=d:60.0", "tempo if none specified");
 	opts.define("humdrum=b", "print data in Humdrum file format");
+	opts.define("npy=b", "print data as a binary NumPy array");
+	opts.define("npy-dir=s", "write a NumPy array file for each input");
 
 	opts.define("debug=b", "Debugging flag");
 	opts.define("author=b",  "author of program");
@@ -130,6 +158,31 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	}
 	auxdataQ = opts.getBoolean("auxiliary-data");
 	humdrumQ = opts.getBoolean("humdrum");
+	npyQ     = opts.getBoolean("npy") || opts.getBoolean("npy-dir");
+	if (opts.getBoolean("npy-dir")) {
+		npydir = opts.getString("npy-dir");
+	}
+}
+
+
+
+//////////////////////////////
+//
+// writeArray -- write the note array to a file, or to standard output
+//     if there is no filename.
+//
+
+void writeArray(NpyWriter& array, const string& filename) {
+	int status;
+	if (filename.empty()) {
+		status = array.write(cout);
+	} else {
+		status = array.write(filename);
+	}
+	if (!status) {
+		cerr << "Error: could not write array " << filename << endl;
+		exit(1);
+	}
 }
 
 
@@ -165,10 +218,11 @@ void comment(ostream& out, int count, int style) {
 
 //////////////////////////////
 //
-// printOutput --
+// printOutput -- print the note list.  If array is not NULL, then
+//     store the numeric columns in the array instead of printing.
 //
 
-void printOutput(HumdrumFile& hfile) {
+void printOutput(HumdrumFile& hfile, NpyWriter* array) {
 	vector<double> tempo;
 	hfile.analyzeTempoMarkings(tempo, tdefault);
 
@@ -190,12 +244,14 @@ void printOutput(HumdrumFile& hfile) {
 				lastduration * 60000.0 / tempo[i];
 		lastduration = hfile[i].getDuration();
 
-		if (hfile[i].getType() == E_humrec_global_comment) {
-			cout << "%% " << &(hfile[i].getLine()[3]) << endl;
-		}
+		if (array == NULL) {
+			if (hfile[i].getType() == E_humrec_global_comment) {
+				cout << "%% " << &(hfile[i].getLine()[3]) << endl;
+			}
 
-		if (hfile[i].getType() == E_humrec_bibliography) {
-			cout << "%%%" << &(hfile[i].getLine()[3]) << endl;
+			if (hfile[i].getType() == E_humrec_bibliography) {
+				cout << "%%%" << &(hfile[i].getLine()[3]) << endl;
+			}
 		}
 
 
@@ -207,7 +263,7 @@ void printOutput(HumdrumFile& hfile) {
 			cout << "RECORD: " << hfile[i] << endl;
 		}
 
-		if (founddata == 0) {
+		if ((founddata == 0) && (array == NULL)) {
 			founddata = 1;
 
 			comment(cout, 2, humdrumQ);
@@ -307,11 +363,6 @@ void printOutput(HumdrumFile& hfile) {
 					exit(1);
 				}
 
-				//cout << "Note\t";
-				// cout << hfile.getAbsBeat(i) << "\t";
-				// cout << (int)(currentmillisecond+0.5) << "\t";
-				cout << linestarttime << "\t";
-
 				if (debugQ && (lineendtime - linestarttime < 0)) {
 					cerr << "Error duration of note on line: " << hfile[i] << endl;
 					cerr << "Starttime: " << linestarttime << endl;
@@ -319,6 +370,30 @@ void printOutput(HumdrumFile& hfile) {
 					cerr << "Line Index:     " << i << endl;
 					exit(1);
 				}
+
+				if (array != NULL) {
+					array->append(linestarttime);
+					if (lineendtime != -1) {
+						array->append(lineendtime - linestarttime);
+					} else {
+						array->append((int)(getTimeToEnd(hfile, linestarttime,
+								i) + 0.5));
+					}
+					array->append(note);
+					array->append(getMetricLevel(hfile, i));
+					array->append(getMeasureNum(hfile, i));
+					array->append(hfile[i].getAbsBeat());
+					array->append(hfile[i].getPrimaryTrack(j)-1);
+					array->append(getSaccid(buffer2));
+					array->endRow();
+					continue;
+				}
+
+				//cout << "Note\t";
+				// cout << hfile.getAbsBeat(i) << "\t";
+				// cout << (int)(currentmillisecond+0.5) << "\t";
+				cout << linestarttime << "\t";
+
 				if (lineendtime != -1) {
 					cout << lineendtime - linestarttime << "\t";
 				} else {
@@ -349,7 +424,7 @@ void printOutput(HumdrumFile& hfile) {
 		}
 	}
 
-	if (humdrumQ) {
+	if (humdrumQ && (array == NULL)) {
 		cout << "*-\t*-\t*-\t*-\t*-\t*-\t*-\t*-\n";
 	}
 }
@@ -367,9 +442,20 @@ void printOutput(HumdrumFile& hfile) {
 //
 
 void printSaccid(ostream& out, const string& astring) {
+	out << getSaccid(astring);
+}
+
+
+
+//////////////////////////////
+//
+// getSaccid -- return the sounding accidental of the note (see
+//    printSaccid()).
+//
+
+int getSaccid(const string& astring) {
 	if (astring.find('n') != std::string::npos) {
-		out << 10;
-		return;
+		return 10;
 	}
 
 	int accid = 0;
@@ -392,8 +478,7 @@ void printSaccid(ostream& out, const string& astring) {
 			accid = accid-10;
 		}
 	}
-	out << accid;
-	return;
+	return accid;
 }
 
 
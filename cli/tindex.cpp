@@ -21,6 +21,8 @@
 // Last Modified: Thu May 24 12:28:08 PDT 2012 added -u and -I options
 // Last Modified: Mon Nov 12 13:56:29 PST 2012 added !noff: processing
 // Last Modified: Sun Apr  7 00:38:49 PDT 2013 Enabled multiple segment input
+// Last Modified: Sun Oct 18 18:32:36 PDT 2026 Sorted directory order, --jobs
+// Last Modified: Sun Oct 18 18:40:54 PDT 2026 Metric levels once per file
 // Filename:      ...museinfo/examples/all/tindex.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/tindex.cpp
 // Syntax:        C++; museinfo
@@ -54,9 +56,6 @@
 // an opening tie, that tied note should be indexed.
 // This case occurs at multiple repeat endings in scores.
 
-#include <sys/types.h>
-#include <dirent.h>
-#include <sys/stat.h>
 #include <string.h>
 
 #include <iostream>
@@ -65,6 +64,8 @@
 
 #include "humdrum.h"
 #include "PerlRegularExpression.h"
+#include "CorpusWalker.h"
+#include "AnalysisPipeline.h"
 
 using namespace std;
 
@@ -180,9 +181,8 @@ void      printDuration           (vector<double>& levels);
 void      printMetricPosition     (vector<RationalNumber>& positions);
 
 void      extractFeatureSet      (const char* features);
-int       is_directory           (const char* path);
-int       is_file                (const char* path);
-void      processArgument        (const char* path);
+void      processFile            (int index, const string& path,
+                                  void* userdata);
 void      fillIstnDatabase       (vector<ISTN>& istndatabase,
                                   const char* istnfile);
 string    getIstn                (const string& filename);
@@ -224,6 +224,8 @@ int         instrumentQ = 0;   // used with -i option
 int         dirprefixQ = 0;    // used with -d option
 string dirprefix;         // used with -d option
 int         allQ       = 0;    // used with --all option
+int         jobs       = 1;    // used with --jobs option
+AnalysisPipeline analyses;     // metric levels of the current file
 
 const char* bibfilter = "";    // used with -B option
 const char* istnfile= "";      // used with --istn option
@@ -291,17 +293,29 @@ int main(int argc, char** argv) {
 	}
 
 
-	for (int i=0; i<numinputs || i==0; i++) {
-		// if no command-line arguments read data file from standard input
-		if (numinputs < 1) {
-			infiles.read(cin);
-			for (int j=0; j<infiles.getCount(); j++) {
-				createIndex(infiles[j], infiles[j].getFilename());
-			}
-		} else {
-			processArgument(options.getArg(i+1).c_str());
+	// if no command-line arguments read data file from standard input
+	if (numinputs < 1) {
+		infiles.read(cin);
+		for (int j=0; j<infiles.getCount(); j++) {
+			createIndex(infiles[j], infiles[j].getFilename());
 		}
+		return 0;
+	}
+
+	// otherwise process files and all files in directories
+	CorpusWalker corpus;
+	corpus.setRecursive();
+	if (!allQ) {
+		corpus.addExtension(".thm");
+		corpus.addExtension(".krn");
+		corpus.addExtension(".THM");
+		corpus.addExtension(".KRN");
+	}
+	for (int i=0; i<numinputs; i++) {
+		corpus.addPath(options.getArg(i+1));
 	}
+	cout.flush();
+	corpus.run(processFile, NULL, jobs);
 
 	return 0;
 }
@@ -312,97 +326,21 @@ int main(int argc, char** argv) {
 
 //////////////////////////////
 //
-// processArgument -- check if the argument is a file or a directory.
-//    if a directory, then process all files/subdirectories in it.
+// processFile -- create the index entries for each segment in a file.
 //
 
-void processArgument(const char* path) {
+void processFile(int index, const string& path, void* userdata) {
 	HumdrumFileSet infiles;
-	DIR* dir = NULL;
-	char* fullname;
-	struct dirent* entry;
-	int namelen = 0;
-	int valid = 0;
 	string filename;
-
-	if (is_file(path)) {
-		namelen = strlen(path);
-		valid = 0;
-		if (allQ) {
-			valid = 1;
-		} else {
-			if (strcmp(&(path[namelen-4]), ".thm") == 0) {
-				valid = 1;
-			} else if (strcmp(&(path[namelen-4]), ".krn") == 0) {
-				valid = 1;
-			} else if (strcmp(&(path[namelen-4]), ".THM") == 0) {
-				valid = 1;
-			} else if (strcmp(&(path[namelen-4]), ".KRN") == 0) {
-				valid = 1;
-			}
-		}
-		if (!valid) {
-			return;
-		}
-		infiles.read(path);
-		int i;
-		for (i=0; i<infiles.getCount(); i++) {
-			filename = infiles[i].getFilename();
-			if (filename.empty()) {
-				filename = path;
-			}
-			createIndex(infiles[i], filename);
-		}
-	} else if (is_directory(path)) {
-		dir = opendir(path);
-		if (dir == NULL) {
-			return;
-		}
-		entry = readdir(dir);
-		while (entry != NULL) {
-			if (strncmp(entry->d_name, ".", 1) == 0) {
-				entry = readdir(dir);
-				continue;
-			}
-
-			fullname = new char[strlen(path) + 1 + strlen(entry->d_name) + 1];
-			strcpy(fullname, path);
-			strcat(fullname, "/");
-			strcat(fullname, entry->d_name);
-			processArgument(fullname);
-			entry = readdir(dir);
+	infiles.read(path.c_str());
+	int i;
+	for (i=0; i<infiles.getCount(); i++) {
+		filename = infiles[i].getFilename();
+		if (filename.empty()) {
+			filename = path;
 		}
+		createIndex(infiles[i], filename);
 	}
-
-	if (dir != NULL) {
-		// can't close a NULL dir in OS X or program will crash.
-		closedir(dir);
-	}
-}
-
-
-//////////////////////////////
-//
-// is_file -- returns true if the string is a file.
-//
-
-int is_file(const char* path) {
-	struct stat filestat;
-	stat(path, &filestat);
-	return S_ISREG(filestat.st_mode);
-}
-
-
-
-//////////////////////////////
-//
-// is_directory -- returns true if the string is a directory.
-//
-
-int is_directory(const char* path) {
-	struct stat filestat;
-	stat(path, &filestat);
-	return S_ISDIR(filestat.st_mode);
 }
 
 
@@ -465,6 +403,12 @@ void createIndex(HumdrumFile& infile, const string& xfilename) {
 
 	pre.sar(printname, ":", "&colon;", "g");
 
+	if (rhythmQ) {
+		// analyze the file once for all of the spines to be indexed
+		analyses.request(ANALYSIS_METRICLEVEL);
+		analyses.run(infile);
+	}
+
 	if (polyQ) {
 		for (i=1; i<=maxtracks; i++) {
 			if (infile.getTrackExInterp(i) != "**kern") {
@@ -1629,9 +1573,7 @@ void extractMetricSequence(vector<double>& metriclevels,
 		vector<RationalNumber>& metricpositions, HumdrumFile& infile,
 		int track, int layer) {
 	PerlRegularExpression pre;
-	vector<int> metlev;
-	infile.analyzeMetricLevel(metlev);
-	infile.analyzeRhythm();  // should already be done
+	Array<int>& metlev = analyses.getMetricLevels();
 
 	int i, j;
 
@@ -2064,6 +2006,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("file=s",         "filename to use for standard input data");
 	opts.define("t|istn|translate=s", "translation file which contains istn values");
 	opts.define("l|limit=i:20",   "limit the number of extracted features");
+	opts.define("jobs=i:1",       "number of files to process at once (0=all cpus)");
 
 	opts.define("author=b",  "author of program");
 	opts.define("version=b", "compilation info");
@@ -2109,6 +2052,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	graceQ      =!opts.getBoolean("no-grace");
 	quietQ      = opts.getBoolean("quiet");
 	allQ        = opts.getBoolean("all-files");
+	jobs        = opts.getInteger("jobs");
 	rhythmQ     = opts.getBoolean("rhythm");
 	fileQ       = opts.getBoolean("file");
 	if (fileQ) {
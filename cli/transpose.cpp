@@ -10,6 +10,7 @@
 // Last Modified: Thu Nov 19 15:12:01 PST 2009 Added -I options and *ITr marks
 // Last Modified: Thu Nov 19 19:28:26 PST 2009 Added -W and -C options
 // Last Modified: Sat Apr 28 08:49:41 PDT 2018
+// Last Modified: Sun Oct 18 19:35:04 PDT 2026 Added --all and --intervals
 // Filename:      ...sig/examples/all/transpose.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/transpose.cpp
 // Syntax:        C++; museinfo
@@ -37,7 +38,6 @@ void      usage                 (const char* command);
 void      printFile             (HumdrumFile& infile);
 void      processFile           (HumdrumFile& infile);
 void      processFile           (HumdrumFile& infile, Array<int>& spines);
-void      printNewKernString    (const char* string, int transval);
 void      printHumdrumKernToken (HumdrumRecord& record, int index,
                                  int transval);
 void      printHumdrumDataRecord(HumdrumRecord& record,
@@ -102,6 +102,8 @@ void      processFieldEntry      (Array<int>& field, const char* astring,
 void      fillFieldData          (Array<int>& field, const string& fieldstring,
                                   HumdrumFile& infile);
 void      removeDollarsFromString(Array<char>& buffer, int maxtrack);
+void      printTranspositions    (HumdrumFile& infile);
+void      fillTranspositions     (vector<int>& list, const string& intervals);
 
 
 // User interface variables:
@@ -119,6 +121,7 @@ int         concertQ     = 0;    // used with -C option
 int         writtenQ     = 0;    // used with -W option
 int         quietQ       = 0;    // used with -q option
 int         instrumentQ  = 0;    // used with -I option
+vector<int> transpositions;      // used with --all and --intervals
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -129,13 +132,43 @@ int main(int argc, char** argv) {
    HumdrumFile infile;
 
    while (streamer.read(infile)) {
-      processFile(infile);
+      if (transpositions.size() > 0) {
+         printTranspositions(infile);
+      } else {
+         processFile(infile);
+      }
    }
 
    return 0;
 }
 
 
+//////////////////////////////
+//
+// printTranspositions -- print the file once for each transposition in
+//     the --all or --intervals list, from a single reading of the file.
+//     Each copy starts with a segment label which gives the interval of
+//     the transposition, so that the copies can be separated again.
+//
+
+void printTranspositions(HumdrumFile& infile) {
+   char interval[128] = {0};
+   string filename = infile.getFilename();
+   int i;
+   for (i=0; i<(int)transpositions.size(); i++) {
+      transval = transpositions[i] + 40 * octave;
+      Convert::base40ToIntervalAbbr(interval, 128, transval);
+      cout << "!!!!SEGMENT: ";
+      if (!filename.empty()) {
+         cout << filename << ":";
+      }
+      cout << interval << "\n";
+      processFile(infile);
+   }
+}
+
+
+
 //////////////////////////////
 //
 // processFile --
@@ -855,60 +888,14 @@ void printHumdrumDataRecord(HumdrumRecord& record, Array<int>& spineprocess) {
 //
 
 void printHumdrumKernToken(HumdrumRecord& record, int index, int transval) {
-   if (strcmp(record[index], ".") == 0) {
-      // null record element (no pitch).
-      cout << ".";
-      return;
-   }
-
-   int k;
-   static char buffer[1024] = {0};
-   int tokencount = record.getTokenCount(index);
-
-   for (k=0; k<tokencount; k++) {
-      record.getToken(buffer, index, k);
-      printNewKernString(buffer, transval);
-      if (k<tokencount-1) {
-         cout << " ";
-      }
-   }
-}
-
-
-
-//////////////////////////////
-//
-// printNewKernString --
-//
+   // reused for each token, so that it does not have to be reallocated:
+   static string buffer;
 
-void printNewKernString(const char* string, int transval) {
-   if (strchr(string, 'r') != NULL) {
-      // don't transpose rests...
-      cout << string;
-      return;
-   }
-
-   char buffer[1024] = {0};
-   char buffer2[1024] = {0};
-   strcpy(buffer, string);
-   int base40 = Convert::kernToBase40(string);
-   char* ptr1 = strtok(buffer, "ABCDEFGabcdefg#-n");
-   char* ptr2 = strtok(NULL, "ABCDEFGabcdefg#-n");
-   char* ptr3 = strtok(NULL, "ABCDEFGabcdefg#-n");
-
-   if (ptr3 != NULL) {
-      cout << "Error in **kern pitch token: " << string << endl;
+   if (!Convert::transposeKern(buffer, record[index], transval)) {
+      cout << "Error in **kern pitch token: " << record[index] << endl;
       exit(1);
    }
-
-   if (ptr1 != NULL) {
-      cout << ptr1;
-   }
-   cout << Convert::base40ToKern(buffer2, 1024, base40 + transval);
-   if (ptr2 != NULL) {
-      cout << ptr2;
-   }
-
+   cout << buffer;
 }
 
 
@@ -933,6 +920,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    opts.define("C|concert=b",    "transpose written score to concert pitch");
    opts.define("W|written=b",    "trans. concert pitch score to written score");
    opts.define("rotation=b",     "display transposition in half-steps");
+   opts.define("all=b",          "print 12 transpositions, from -P4 to A4");
+   opts.define("intervals=s",    "print a transposition for each interval");
 
    opts.define("author=b",  "author of program");
    opts.define("version=b", "compilation info");
@@ -993,6 +982,41 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 
    transval += 40 * octave;
 
+   if (opts.getBoolean("all")) {
+      fillTranspositions(transpositions,
+            "-P4,-M3,-m3,-M2,-m2,P1,m2,M2,m3,M3,P4,A4");
+   } else if (opts.getBoolean("intervals")) {
+      fillTranspositions(transpositions, opts.getString("intervals"));
+   }
+   if ((transpositions.size() > 0) && (ssetkeyQ || autoQ || concertQ ||
+         writtenQ || opts.getBoolean("rotation"))) {
+      cerr << "Error: --all and --intervals cannot be used with the "
+           << "-k, -C, -W, --auto or --rotation options" << endl;
+      exit(1);
+   }
+
+}
+
+
+
+//////////////////////////////
+//
+// fillTranspositions -- convert a list of intervals separated by commas
+//     or spaces (such as "P1,M2,-m3") into base-40 transpositions.
+//
+
+void fillTranspositions(vector<int>& list, const string& intervals) {
+   list.clear();
+   PerlRegularExpression pre;
+   vector<string> pieces;
+   pre.getTokens(pieces, "[,\\s]+", intervals.c_str());
+   int i;
+   for (i=0; i<(int)pieces.size(); i++) {
+      if (pieces[i].empty()) {
+         continue;
+      }
+      list.push_back(getBase40ValueFromInterval(pieces[i].c_str()));
+   }
 }
 
 
@@ -5,56 +5,40 @@
 //						not appending to original data
 // Last Modified: Wed Jun 24 15:41:09 PDT 2009 Updated for GCC 4.4
 // Last Modified: Mon Jun  5 04:36:52 PDT 2017 Convert to STL
+// Last Modified: Sun Oct 18 16:29:47 PDT 2026 In-process root analysis
+// Last Modified: Sun Oct 18 21:43:59 PDT 2026 Sliding window roots (-w)
 //
 // Filename:      ...sig/examples/all/tsroot.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/tsroot.cpp
 // Syntax:        C++; museinfo
 //
-// Description:   Analyze the chord root analysis from Temperley &
+// Description:   Chord root analysis in the style of the Temperley &
 //                Sleator Melisma Music Analysis <i>harmony</i> program
 //                (2003 version) and optionally append to original **kern data.
 //
-// Requires the following ancillary programs:
-//	(1) meter -- Melisma meter program which adds Beat information to
-//	    note data.
-//      (2) harmony -- Melisma root analysis program which adds chord
-//	    analysis data to meter program output.
-// 	(3) kern2melisma -- museinfo program which converts **kern data into
-//          melisma Note data.
-// 	(4) harmony2humdrum -- PERL program which converts Melisma harmony
-//  	    program output into a temporary Humdrum data file.
-//
-// For roman-numeral analysis, two more programs are required:
-//      (5) key -- Melisma key analysis program
-//      (6) key2humdrum -- PERL program which converts Melisma Roman Numeral
-//          analysis into a temprary Humdrum data file.
-//
-// programs are expected to be in two directories:
-//
-// meldir = set with --meldir option.  This is the location of the
-//          melisma music analyzer command-line programs (meter, harmony, key).
-// midir  = set with --midir option.  This is the location of museinfo programs.
-//
-// key parameter file contents for roman numeral analysis:
-//
-//   verbosity=2                      <-- required for segment times
-//   default_profile_value = 1.5
-//   npc_or_tpc_profile=1
-//   scoring_mode = 1
-//   segment_beat_level=3
-//   beat_printout_level=2
-//   romnums=1                        <-- required for roman numeral analysis
-//   romnum_type=0
-//   running=0
+// The root analysis was originally done by running the Melisma
+// kern2melisma | meter | harmony | harmony2humdrum programs (and key |
+// key2humdrum for roman numerals) through temporary files.  The analysis
+// is now done in-process with HumdrumFile::analyzeMelismaRoots(), which
+// segments the music by beats and scores roots with RootSpectrum, and
+// the key of each section for roman numerals is measured with
+// HumdrumFile::analyzeKeyKS().
+// Multiple input files can be analyzed at once with the -j option.
+// The -w option instead gives the root of the notes attacked in a
+// sliding window of time which ends at each line.
 //
 
 #include "humdrum.h"
 #include "stdlib.h"
 #include "string.h"
-#include "time.h"
 #include "stdio.h"
+#include "math.h"
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
 
-#include <fstream>
 using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////
@@ -64,73 +48,90 @@ using namespace std;
 void      checkOptions       (Options& opts, int argc, char* argv[]);
 void      example            (void);
 void      usage              (const string& command);
-void      processFile        (const string& filename, HumdrumFile& infile);
-void      analyzeTiming      (HumdrumFile& infile, vector<double>& timings,
-                              vector<double>& tempo);
-void      getAnalysisTimes   (vector<int>& analysistimes,
-                              HumdrumFile& rootanalysis);
-void      printAnalysis      (HumdrumFile& rootanalysis,
-                              HumdrumFile& romananalysis,
+void      processFile        (ostream& out, HumdrumFile& infile);
+void      analyzeWindowRoots (Array<int>& roots, HumdrumFile& infile,
+                              double duration);
+void      printAnalysis      (ostream& out, HumdrumFile& infile,
+                              vector<string>& rootdata,
+                              vector<string>& romandata,
+                              vector<string>& keydata);
+void      getRootData        (vector<string>& rootdata, Array<int>& roots,
+                              HumdrumFile& infile);
+void      getRomanData       (vector<string>& romandata,
+                              vector<string>& keydata, Array<int>& roots,
                               HumdrumFile& infile);
-int       getClosestRootLine (vector<int>& analysistimes, int targettime);
-void      getDataLineTimings (vector<int>& linetimes, HumdrumFile& infile);
-string    getMatchRoot     (int matchline, HumdrumFile& hfile);
-void      createParameterFile(const string& parametertmpname);
-void      getRomanAnalysisTimes(vector<int>& romantimes,
-                              HumdrumFile& romananalysis);
-void      getRomanAnalysisLines(vector<int>& romanlines,
-                              vector<int>& romantimes,
-                              vector<int>& linetimes,
-                              HumdrumFile& romananalysis);
-string    getRomanData       (HumdrumFile& romananalysis,
-                              vector<int>& romanlines, int target);
-void      printRomanKey      (HumdrumFile& romananalysis,
-                              vector<int>& romanlines, int target,
+void      getSections        (vector<int>& sections, HumdrumFile& infile);
+string    getRomanNumeral    (int root, int tonic, int minorQ,
+                              vector<int>& notes);
+void      printRomanKey      (ostream& out, const string& key,
                               HumdrumRecord& aRecord);
 
-/////////////////////////////////////////////////////////////////
-// Setting the default tempo to the same one used by kern2melisma
-//
-double    dtempo = 60.0;
-
 // global variables
 Options   options;            // database for command-line arguments
 int       debugQ   = 0;       // used with --debug option
+int       verboseQ = 0;       // used with -v option
 int       appendQ  = 0;       // used with -a option
 int       prependQ = 0;       // used with -p option
-int       verboseQ = 0;       // used with -v option
-int       harmonyQ = 0;       // used with -h option
-string tmpdir = "/tmp";  // used with --tmpdir option
-string meldir = "/usr/ccarh/melisma/bin";  // used with --meldir option
-string midir  = "/var/www/websites/museinfo/bin"; // used with --midir
+int       harmonyQ = 0;       // used with -r option
+double    changeweight = 1.0; // used with -c option
+int       threads  = 1;       // used with -j option
+double    window   = 0.0;     // used with -w option
 
 
 ///////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char* argv[]) {
-   #ifndef VISUAL
-      srand48(time(NULL)*12345);   // seed rand num generator with current time
-   #else
-      srand(time(NULL)*12345);
-   #endif
-
-   HumdrumFile infile;
-
    // process the command-line options
    checkOptions(options, argc, argv);
 
-   string filename;
    // if no command-line arguments read data file from standard input
    int numinputs = options.getArgCount();
    if (numinputs < 1) {
       cout << "Error: you must supply at least one input fileme" << endl;
       exit(1);
+   }
+
+   // Files are read in this thread, and then analyzed in parallel
+   // with the results printed in the order of the input files.
+   vector<HumdrumFile> infiles(numinputs);
+   vector<stringstream> outputs(numinputs);
+   int i;
+   for (i=0; i<numinputs; i++) {
+      infiles[i].read(options.getArg(i+1));
+   }
+
+   int tcount = threads;
+   if (tcount <= 0) {
+      tcount = thread::hardware_concurrency();
+   }
+   if (tcount > numinputs) {
+      tcount = numinputs;
+   }
+   if (tcount <= 1) {
+      for (i=0; i<numinputs; i++) {
+         processFile(outputs[i], infiles[i]);
+      }
    } else {
-      filename = options.getArg(1);
-      infile.read(options.getArg(1));
+      atomic<int> next(0);
+      vector<thread> workers;
+      for (i=0; i<tcount; i++) {
+         workers.emplace_back([&]() {
+            int index;
+            while ((index = next++) < numinputs) {
+               processFile(outputs[index], infiles[index]);
+            }
+         });
+      }
+      for (i=0; i<(int)workers.size(); i++) {
+         workers[i].join();
+      }
+   }
+
+   for (i=0; i<numinputs; i++) {
+      cout << outputs[i].str();
    }
-   processFile(filename, infile);
 
+   return 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -138,159 +139,221 @@ int main(int argc, char* argv[]) {
 
 //////////////////////////////
 //
-// processFile --
+// processFile -- analyze the chord roots (and optionally roman numerals)
+//     for a file and print them with the original data.
 //
 
-void processFile(const string& filename, HumdrumFile& infile) {
-   // first convert the file to melisma format
-
-   if (verboseQ) {
-      cout << "The filename is: " << filename << endl;
-   }
-   string buffer;
-
-   auto loc = filename.rfind("/");
-   if (loc != string::npos) {
-      buffer = filename.substr(loc+1);
+void processFile(ostream& out, HumdrumFile& infile) {
+   Array<int> roots;
+   if (window > 0.0) {
+      analyzeWindowRoots(roots, infile, window);
    } else {
-      buffer = filename;
+      infile.analyzeMelismaRoots(roots, changeweight, debugQ);
    }
 
-   if (verboseQ) {
-      cout << "The filename base is: " << buffer << endl;
+   vector<string> rootdata;
+   getRootData(rootdata, roots, infile);
+
+   vector<string> romandata;
+   vector<string> keydata;
+   if (harmonyQ) {
+      getRomanData(romandata, keydata, roots, infile);
    }
 
-   #ifndef VISUAL
-      int randval = lrand48();
-   #else
-      int randval = rand();
-   #endif
+   printAnalysis(out, infile, rootdata, romandata, keydata);
+}
 
-   if (verboseQ) {
-      cout << "Random value is: " << randval << endl;
-      cout << "Creating temporary Melisma file: " << endl;
-      cout << "\t" << tmpdir << "/" << buffer << "." << randval << endl;
-   }
-   string commandbuffer;
-   string tmpname;           // output from the harmony2humdrum command
-   string tmpname2;          // output from the key2humdrum command
-   string parametertmpname;  // key parameter file
-   string harmonytmpname;
-
-   tmpname  = tmpdir;
-   tmpname += "/";
-   tmpname += buffer;
-   tmpname += ".";
-   tmpname += to_string(randval);
-
-   harmonytmpname  = tmpdir;
-   harmonytmpname += "/";
-   harmonytmpname += buffer;
-   harmonytmpname += "-";
-   harmonytmpname += "harmony";
-   harmonytmpname += ".";
-   harmonytmpname += to_string(randval);
-
-   tmpname2 = tmpdir;
-   tmpname2 += "/";
-   tmpname2 += buffer;
-   tmpname2 += "-";
-   tmpname2 += "roman";
-   tmpname2 += ".";
-   tmpname2 += to_string(randval);
-
-   parametertmpname = tmpdir;
-   parametertmpname += "/";
-   parametertmpname += buffer;
-   parametertmpname += "-";
-   parametertmpname += "parameters";
-   parametertmpname += ".";
-   parametertmpname += to_string(randval);
 
-   if (harmonyQ) {
-      createParameterFile(parametertmpname);
-      commandbuffer = midir;
-      commandbuffer += "/kern2melisma ";
-      commandbuffer += filename;
-      commandbuffer += " | egrep -v 'Reference|Comment|Info)' | ";
-      commandbuffer += meldir;
-      commandbuffer += "/meter | ";
-      commandbuffer += meldir;
-      commandbuffer += "/harmony > ";
-      commandbuffer += harmonytmpname;
-      commandbuffer += "; ";
-      commandbuffer += meldir;
-      commandbuffer += "/harmony2humdrum ";
-      commandbuffer += harmonytmpname;
-      commandbuffer += " > ";
-      commandbuffer += tmpname;
-      commandbuffer += "; ";
-      commandbuffer += meldir;
-      commandbuffer += "/key -p ";
-      commandbuffer += parametertmpname;
-      commandbuffer += " ";
-      commandbuffer += harmonytmpname;
-      commandbuffer += " | ";
-      commandbuffer += meldir;
-      commandbuffer += "/key2humdrum > ";
-      commandbuffer += tmpname2;
-   } else {
-      commandbuffer  = midir;
-      commandbuffer += "/kern2melisma ";
-      commandbuffer += filename;
-      commandbuffer += " | egrep -v '(Reference|Comment|Info)' | ";
-      commandbuffer += meldir;
-      commandbuffer += "/meter | ";
-      commandbuffer += meldir;
-      commandbuffer += "/harmony | ";
-      commandbuffer += meldir;
-      commandbuffer += "/harmony2humdrum > ";
-      commandbuffer += tmpname;
-   }
 
-   if (verboseQ) {
-      cout << "COMMAND: " << commandbuffer << endl;
-   }
-   int status = system(commandbuffer.c_str());
-   if (status < 0) {
-      cout << "ERROR: command not successful:\n" << commandbuffer << endl;
-      exit(1);
+//////////////////////////////
+//
+// analyzeWindowRoots -- find the root of the notes attacked in the
+//     window of time (in quarter notes) which ends at each data line.
+//     As the window moves down the file, notes which enter it are
+//     added to a RootSpectrum and notes which leave it are removed,
+//     rather than scoring all of the notes in the window again.
+//
+
+void analyzeWindowRoots(Array<int>& roots, HumdrumFile& infile,
+      double duration) {
+   infile.analyzeRhythm("4");
+   roots.setSize(infile.getNumLines());
+   roots.setAll(-1);
+
+   Array<int> metlev;
+   infile.analyzeMetricLevel(metlev);
+
+   IntervalWeight distances;
+   distances.setChromatic1(10.0);
+   RootSpectrum spectrum;
+   spectrum.melodyOff();
+   spectrum.clearNotes();
+
+   // notes in the order that they entered the window:
+   vector<double> starts;
+   vector<int>    pitches;
+   vector<double> durations;
+   vector<double> levels;
+   int oldest = 0;
+
+   char buffer[128] = {0};
+   double absbeat;
+   double notedur;
+   double level;
+   int pitch;
+   int i, j, k;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (!infile[i].isData()) {
+         continue;
+      }
+      absbeat = infile[i].getAbsBeat();
+      level = 1.0 / pow(2.0, metlev[i]);
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         if (infile[i].getExInterpNum(j) != E_KERN_EXINT) {
+            continue;
+         }
+         if (strcmp(infile[i][j], ".") == 0) {
+            continue;
+         }
+         for (k=0; k<infile[i].getTokenCount(j); k++) {
+            infile[i].getToken(buffer, j, k, 128);
+            if ((strchr(buffer, 'r') != NULL) ||
+                  (strchr(buffer, '_') != NULL) ||
+                  (strchr(buffer, ']') != NULL)) {
+               continue;
+            }
+            pitch = Convert::kernToBase40(buffer);
+            notedur = infile.getTiedDuration(i, j, k);
+            if ((pitch < 0) || (notedur <= 0.0)) {
+               continue;
+            }
+            spectrum.addNote(pitch, notedur, level);
+            starts.push_back(absbeat);
+            pitches.push_back(pitch);
+            durations.push_back(notedur);
+            levels.push_back(level);
+         }
+      }
+      while ((oldest < (int)starts.size()) &&
+            (starts[oldest] <= absbeat - duration + 0.0001)) {
+         spectrum.removeNote(pitches[oldest], durations[oldest],
+               levels[oldest]);
+         oldest++;
+      }
+      roots[i] = spectrum.calculate(distances);
+      if (debugQ) {
+         cerr << "Line " << i + 1 << ": " << spectrum.getNoteCount()
+              << " notes, root " << roots[i] << endl;
+      }
    }
+}
 
 
-   // read in the newly created Humdrum file:
-   HumdrumFile rootanalysis;
-   rootanalysis.read(tmpname);
 
-   HumdrumFile romananalysis;
-   if (harmonyQ) {
-      romananalysis.read(tmpname2);
+//////////////////////////////
+//
+// getRootData -- convert the base-40 root of each line into **tsroot
+//     tokens.  Lines with no sounding notes are given a rest.
+//
+
+void getRootData(vector<string>& rootdata, Array<int>& roots,
+      HumdrumFile& infile) {
+   char buffer[64] = {0};
+   rootdata.resize(infile.getNumLines());
+   fill(rootdata.begin(), rootdata.end(), ".");
+   for (int i=0; i<infile.getNumLines(); i++) {
+      if (!infile[i].isData()) {
+         continue;
+      }
+      if (roots[i] < 0) {
+         rootdata[i] = "r";
+      } else {
+         rootdata[i] = Convert::base40ToKern(buffer, 64, roots[i] % 40 + 3*40);
+      }
    }
+}
 
-   printAnalysis(rootanalysis, romananalysis, infile);
 
-   // delete temporary files
-   if (harmonyQ) {
-      commandbuffer = "rm -f " + tmpname;
-      if (system(commandbuffer.c_str()) == -1) {
-         exit(-1);
-      }
-      commandbuffer = "rm -f " + tmpname2;
-      if (system(commandbuffer.c_str()) == -1) {
-         exit(-1);
+
+//////////////////////////////
+//
+// getRomanData -- generate roman numerals for each change of root, using
+//     the Krumhansl-Schmuckler key of each section of the music.  A new
+//     section starts at each section label (*>name) and at each key
+//     interpretation in the input data.  The key interpretation of a
+//     section is stored at its first data line if the key differs from
+//     the previous section.
+//
+
+void getRomanData(vector<string>& romandata, vector<string>& keydata,
+      Array<int>& roots, HumdrumFile& infile) {
+   romandata.resize(infile.getNumLines());
+   fill(romandata.begin(), romandata.end(), ".");
+   keydata.resize(infile.getNumLines());
+   fill(keydata.begin(), keydata.end(), "");
+
+   vector<int> sections;
+   getSections(sections, infile);
+
+   // base-40 spellings for the base-12 keys returned by analyzeKeyKS
+   int majortonics[12] = {2, 7, 8, 13, 14, 19, 20, 25, 30, 31, 36, 37};
+   int minortonics[12] = {2, 3, 8, 13, 14, 19, 20, 25, 26, 31, 36, 37};
+
+   Array<double> scores;
+   char buffer[64] = {0};
+   vector<int> notes;
+   string keyname;
+   string lastkey;
+   int key;
+   int minorQ;
+   int tonic;
+   int lastroot;
+   int keyQ;
+   int startline;
+   int stopline;
+   int i, s;
+   for (s=0; s<(int)sections.size(); s++) {
+      startline = sections[s];
+      if (s < (int)sections.size() - 1) {
+         stopline = sections[s+1] - 1;
+      } else {
+         stopline = infile.getNumLines() - 1;
       }
-      commandbuffer = "rm -f " + harmonytmpname;
-      if (system(commandbuffer.c_str()) == -1) {
-         exit(-1);
+      key = infile.analyzeKeyKS(scores, startline, stopline);
+      if (key < 0) {
+         continue;
       }
-      commandbuffer = "rm -f " + parametertmpname;
-      if (system(commandbuffer.c_str()) == -1) {
-         exit(-1);
+      minorQ = key >= 12;
+      tonic  = minorQ ? minortonics[key % 12] : majortonics[key % 12];
+
+      Convert::base40ToKern(buffer, 64, tonic + (minorQ ? 4 : 3) * 40);
+      keyname = "*";
+      keyname += buffer;
+      keyname += ":";
+      if (verboseQ) {
+         cerr << "Lines " << startline + 1 << " to " << stopline + 1
+              << ": key " << keyname << endl;
       }
-   } else {
-      commandbuffer = "rm -f " + tmpname;
-      if (system(commandbuffer.c_str()) == -1) {
-         exit(-1);
+
+      // print the key at the start of the section only if it changed
+      keyQ = (keyname == lastkey);
+      lastkey = keyname;
+      lastroot = -1;
+      for (i=startline; i<=stopline; i++) {
+         if (!infile[i].isData()) {
+            continue;
+         }
+         if (!keyQ) {
+            keydata[i] = keyname;
+            keyQ = 1;
+         }
+         if ((roots[i] < 0) || (roots[i] == lastroot)) {
+            lastroot = roots[i];
+            continue;
+         }
+         lastroot = roots[i];
+         infile.getNoteList(notes, i, NL_FILL | NL_SORT | NL_UNIQ);
+         romandata[i] = getRomanNumeral(roots[i], tonic, minorQ, notes);
       }
    }
 }
@@ -299,202 +362,278 @@ void processFile(const string& filename, HumdrumFile& infile) {
 
 //////////////////////////////
 //
-// createParameterFile --
+// getSections -- return the starting line of each section of the music
+//     for the key analysis.  The first section starts at the top of the
+//     file, and others start at section labels (*>name) and at key
+//     interpretations (such as *F: or *a:) in the input data.
 //
 
-void createParameterFile(const string& parametertmpname) {
-   ofstream pfile(parametertmpname);
-
-   if (!pfile.is_open()) {
-      cout << "Error: cannot write parameter file\n";
-      exit(1);
+void getSections(vector<int>& sections, HumdrumFile& infile) {
+   sections.clear();
+   sections.push_back(0);
+   int datafoundQ = 0;   // don't split sections before the first data line
+   int len;
+   int i, j;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (infile[i].isData()) {
+         datafoundQ = 1;
+         continue;
+      }
+      if (!datafoundQ || !infile[i].isInterpretation()) {
+         continue;
+      }
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         if (strncmp(infile[i][j], "*>", 2) == 0) {
+            if (strchr(infile[i][j], '[') == NULL) {
+               break;
+            }
+            continue;
+         }
+         len = (int)strlen(infile[i][j]);
+         if ((len > 2) && (infile[i][j][len-1] == ':') &&
+               (strchr("ABCDEFGabcdefg", infile[i][j][1]) != NULL)) {
+            break;
+         }
+      }
+      if ((j < infile[i].getFieldCount()) && (sections.back() != i)) {
+         sections.push_back(i);
+      }
    }
+}
+
 
-   pfile <<
-      "verbosity=2\n"
-      "default_profile_value = 1.5\n"
-      "npc_or_tpc_profile=1\n"
-      "scoring_mode = 1\n"
-      "segment_beat_level=3\n"
-      "beat_printout_level=2\n"
-      "romnums=1\n"
-      "romnum_type=0\n"
-      "running=0\n"
-   ;
-   pfile.close();
 
+//////////////////////////////
+//
+// getRomanNumeral -- return the roman numeral for a root in the given
+//     key.  The case of the numeral is determined by the third above
+//     the root in the notes of the line (or by the scale if there is
+//     no third), "7" is added if a minor seventh above the root is
+//     present, and an inversion letter is added if the lowest note
+//     is not the root.
+//
+
+string getRomanNumeral(int root, int tonic, int minorQ, vector<int>& notes) {
+   static const char* upper[7] = {"I", "II", "III", "IV", "V", "VI", "VII"};
+   static const char* lower[7] = {"i", "ii", "iii", "iv", "v", "vi", "vii"};
+   // base-40 intervals of the scale degrees above the tonic:
+   int majorscale[7] = {0, 6, 12, 17, 23, 29, 35};
+   int minorscale[7] = {0, 6, 11, 17, 23, 28, 35};
+   // triad quality of each scale degree: 1 = major, 0 = minor/diminished
+   int majortriads[7] = {1, 0, 0, 1, 1, 0, 0};
+   int minortriads[7] = {0, 0, 1, 0, 1, 1, 0};
+
+   int degree = (Convert::base40ToDiatonic(root + 4*40) -
+                 Convert::base40ToDiatonic(tonic + 4*40) + 70) % 7;
+   int interval = (root - tonic + 400) % 40;
+   int alteration = interval - (minorQ ? minorscale[degree] :
+         majorscale[degree]);
+
+   int thirdQ   = 0;   // 1 = major third, -1 = minor third
+   int fifthQ   = 0;   // -1 = diminished fifth
+   int seventhQ = 0;
+   int bass     = -1;
+   int pc;
+   for (int i=0; i<(int)notes.size(); i++) {
+      if (notes[i] < 0) {
+         continue;
+      }
+      if (bass < 0) {
+         bass = notes[i];
+      }
+      pc = (notes[i] - root + 400) % 40;
+      if (pc == 12) {
+         thirdQ = 1;
+      } else if (pc == 11) {
+         thirdQ = -1;
+      } else if (pc == 22) {
+         fifthQ = -1;
+      } else if (pc == 34) {
+         seventhQ = 1;
+      }
+   }
+   if (thirdQ == 0) {
+      thirdQ = (minorQ ? minortriads[degree] : majortriads[degree]) ? 1 : -1;
+   }
+
+   string output;
+   while (alteration < 0) {
+      output += "-";
+      alteration++;
+   }
+   while (alteration > 0) {
+      output += "#";
+      alteration--;
+   }
+   output += thirdQ > 0 ? upper[degree] : lower[degree];
+   if ((thirdQ < 0) && (fifthQ < 0)) {
+      output += "o";
+   }
+   if (seventhQ) {
+      output += "7";
+   }
+   if (bass >= 0) {
+      switch ((bass - root + 400) % 40) {
+         case 11: case 12: output += "b"; break;
+         case 22: case 23: output += "c"; break;
+         case 34: case 35: output += "d"; break;
+      }
+   }
+   return output;
 }
 
 
 
 //////////////////////////////
 //
-// printAnalysis --  match Melismla Music Analyzer output back to Humdrum data.
+// printAnalysis --  print the root analysis along with the Humdrum data.
 //
 
-void printAnalysis(HumdrumFile& rootanalysis, HumdrumFile& romananalysis,
-      HumdrumFile& infile) {
+void printAnalysis(ostream& out, HumdrumFile& infile, vector<string>& rootdata,
+      vector<string>& romandata, vector<string>& keydata) {
    string romandatum = ".";
-   vector<int> analysistimes;
-   getAnalysisTimes (analysistimes, rootanalysis);
-   vector<int> linetimes;
-   getDataLineTimings(linetimes, infile);
-
-   vector<int> romantimes;
-   vector<int> romanlines;
-   if (harmonyQ) {
-      getRomanAnalysisTimes(romantimes, romananalysis);
-      getRomanAnalysisLines(romanlines, romantimes, linetimes, romananalysis);
-   }
-
    string matchroot;
-   int matchline;
    int i;
    for (i=0; i<infile.getNumLines(); i++) {
       switch (infile[i].getType()) {
          case E_humrec_data_comment:
 
             if (prependQ) {
-               if (harmonyQ) cout << "!\t";
-               cout << "!\t";
+               if (harmonyQ) out << "!\t";
+               out << "!\t";
             }
             if (prependQ || appendQ) {
-               cout << infile[i];
+               out << infile[i];
             }
             if (appendQ) {
-               if (harmonyQ) cout << "\t!";
-               cout << "\t!";
+               if (harmonyQ) out << "\t!";
+               out << "\t!";
             }
-            cout << endl;
+            out << "\n";
 
             break;
          case E_humrec_data_kern_measure:
 
             if (prependQ) {
-               if (harmonyQ) cout << infile[i][0] << "\t";
-               cout << infile[i][0] << "\t";
+               if (harmonyQ) out << infile[i][0] << "\t";
+               out << infile[i][0] << "\t";
             }
             if (prependQ || appendQ) {
-               cout << infile[i];
+               out << infile[i];
             } else {
-               cout << infile[i][0];
+               out << infile[i][0];
                if (harmonyQ) {
-                  cout << "\t" << infile[i][0];
+                  out << "\t" << infile[i][0];
                }
             }
             if (appendQ) {
-               if (harmonyQ) cout << "\t" << infile[i][0];
-               cout << "\t" << infile[i][0];
+               if (harmonyQ) out << "\t" << infile[i][0];
+               out << "\t" << infile[i][0];
             }
-            cout << endl;
+            out << "\n";
 
             break;
          case E_humrec_interpretation:
 
             if (prependQ) {
                if (strcmp(infile[i][0], "*-") == 0) {
-                  if (harmonyQ) cout << "*-\t";
-                  cout << "*-\t";
+                  if (harmonyQ) out << "*-\t";
+                  out << "*-\t";
                } else if (strncmp(infile[i][0], "**", 2) == 0) {
-                  if (harmonyQ) cout << "**tshrm\t";
-                  cout << "**tsroot\t";
+                  if (harmonyQ) out << "**tsharm\t";
+                  out << "**tsroot\t";
                } else if (infile[i].equalFieldsQ()) {
 
                   if ((!infile[i].isSpineManipulator(0)) &&
                         (strchr(infile[i][0], ':') == NULL) ) {
-                     if (harmonyQ) cout << infile[i][0] << "\t";
-                     cout << infile[i][0] << "\t";
+                     if (harmonyQ) out << infile[i][0] << "\t";
+                     out << infile[i][0] << "\t";
                   } else {
-                     if (harmonyQ) cout << "*\t";
-                     cout << "*\t";
+                     if (harmonyQ) out << "*\t";
+                     out << "*\t";
                   }
 
                } else {
-                  if (harmonyQ) cout << "*\t";
-                  cout << "*\t";
+                  if (harmonyQ) out << "*\t";
+                  out << "*\t";
                }
             }
             if (prependQ || appendQ) {
-               cout << infile[i];
+               out << infile[i];
             } else {
                if (strncmp(infile[i][0], "**", 2) == 0) {
                   if (harmonyQ) {
-                     cout << "**tsharm\t";
+                     out << "**tsharm\t";
                   }
-                  cout << "**tsroot";
+                  out << "**tsroot";
                 } else if (strcmp(infile[i][0], "*-") == 0) {
                    if (harmonyQ) {
-                      cout << "*-\t";
+                      out << "*-\t";
                    }
-                   cout << "*-";
+                   out << "*-";
                 } else if (infile[i].equalFieldsQ()) {
                    if (!infile[i].isSpineManipulator(0)) {
-                      if (harmonyQ) cout << infile[i][0] << "\t";
-                      cout << infile[i][0];
+                      if (harmonyQ) out << infile[i][0] << "\t";
+                      out << infile[i][0];
                    } else {
-                      if (harmonyQ) cout << "*\t";
-                      cout << "*";
+                      if (harmonyQ) out << "*\t";
+                      out << "*";
                    }
                 } else {
-                      if (harmonyQ) cout << "*\t";
-                      cout << "*";
+                      if (harmonyQ) out << "*\t";
+                      out << "*";
                 }
             }
             if (appendQ) {
                if (strcmp(infile[i][0], "*-") == 0) {
-                  if (harmonyQ) cout << "\t*-";
-                  cout << "\t*-";
+                  if (harmonyQ) out << "\t*-";
+                  out << "\t*-";
                } else if (strncmp(infile[i][0], "**", 2) == 0) {
-                  if (harmonyQ) cout << "**tshrm\t";
-                  cout << "**tsroot\t";
+                  if (harmonyQ) out << "\t**tsharm";
+                  out << "\t**tsroot";
                } else if (infile[i].equalFieldsQ()) {
                   if ((!infile[i].isSpineManipulator(0)) &&
                         (strchr(infile[i][0], ':') == NULL) ) {
-                     if (harmonyQ) cout << "\t" << infile[i][0];
-                     cout << "\t" << infile[i][0];
+                     if (harmonyQ) out << "\t" << infile[i][0];
+                     out << "\t" << infile[i][0];
                   } else {
-                     if (harmonyQ) cout << "\t*";
-                     cout << "\t*";
+                     if (harmonyQ) out << "\t*";
+                     out << "\t*";
                   }
                } else {
-                  if (harmonyQ) cout << "\t*";
-                  cout << "\t*";
+                  if (harmonyQ) out << "\t*";
+                  out << "\t*";
                }
             }
-            cout << endl;
+            out << "\n";
 
             break;
          case E_humrec_data:
             if (harmonyQ) {
-               printRomanKey(romananalysis, romanlines, i, infile[i]);
+               printRomanKey(out, keydata[i], infile[i]);
             }
-            // matchline = linetimes[i];
-// temporary fix for 12/8 meter analysis problem:
-//            matchline = getClosestRootLine(analysistimes, linetimes[i]*2);
-
-            matchline = getClosestRootLine(analysistimes, linetimes[i]);
-            matchroot = getMatchRoot(matchline, rootanalysis);
+            matchroot = rootdata[i];
             if (harmonyQ) {
-               romandatum = getRomanData(romananalysis, romanlines, i);
+               romandatum = romandata[i];
             }
 
             if (prependQ) {
-               if (harmonyQ) cout << romandatum << "\t";
-               cout << matchroot;
-               cout << "\t";
+               if (harmonyQ) out << romandatum << "\t";
+               out << matchroot;
+               out << "\t";
             }
             if (prependQ || appendQ) {
-               cout << infile[i];
+               out << infile[i];
             } else {
-               if (harmonyQ) cout << romandatum << "\t";
-               cout << matchroot;
+               if (harmonyQ) out << romandatum << "\t";
+               out << matchroot;
             }
             if (appendQ) {
-               if (harmonyQ) cout << "\t" << romandatum;
-               cout << "\t";
-               cout << matchroot;
+               if (harmonyQ) out << "\t" << romandatum;
+               out << "\t";
+               out << matchroot;
             }
-            cout << endl;
+            out << "\n";
 
             break;
          case E_humrec_none:
@@ -502,322 +641,50 @@ void printAnalysis(HumdrumFile& rootanalysis, HumdrumFile& romananalysis,
          case E_humrec_global_comment:
          case E_humrec_bibliography:
          default:
-            cout << infile[i] << endl;
-      }
-   }
-
-
-   if (harmonyQ && debugQ) {
-      cout << romananalysis;
-      cout << endl;
-   }
-
-}
-
-
-
-//////////////////////////////
-//
-// printRomanKey --
-//
-
-void printRomanKey(HumdrumFile& romananalysis, vector<int>& romanlines,
-   int target, HumdrumRecord& aRecord) {
-
-   int i;
-   int j;
-   for (i=0; i<(int)romanlines.size(); i++) {
-      if (romananalysis[i].getType() != E_humrec_interpretation) {
-         continue;
-      }
-      if (target < romanlines[i]) {
-         return;
-      }
-      if (target > romanlines[i]) {
-         continue;
-      }
-
-      // target == romanlines[i]: assume first column contains data
-
-      if (strchr(romananalysis[i][0], ':') == NULL) {
-         continue;
-      }
-
-      // found a key interpretation which should be printed
-
-      if (prependQ) {
-         cout << romananalysis[i][0] << "\t";
-         cout << romananalysis[i][0] << "\t";
-      }
-
-      if (prependQ || appendQ) {
-         for (j=0; j<aRecord.getFieldCount(); j++) {
-            cout << "*";
-            if (j < aRecord.getFieldCount() - 1) {
-               cout << "\t";
-            }
-         }
-      } else {
-         if (harmonyQ) {
-            cout << romananalysis[i][0] << "\t";
-         }
-         cout << romananalysis[i][0];
-
-      }
-
-      if (appendQ) {
-         cout << "\t" << romananalysis[i][0];
-         cout << "\t" << romananalysis[i][0];
+            out << infile[i] << "\n";
       }
-
-      cout << "\n";
-
-      romanlines[i] = -1;  // make sure the that key will not be printed again
-
-      break;
    }
-
 }
 
-//////////////////////////////
-//
-// getRomanData --
-//
-
-string getRomanData(HumdrumFile& romananalysis, vector<int>& romanlines,
-   int target) {
-
-   int i;
-   for (i=0; i<(int)romanlines.size(); i++) {
-      if (romananalysis[i].getType() != E_humrec_data) {
-         continue;
-      }
-      if (target < romanlines[i]) {
-         return ".";
-      }
-      if (target > romanlines[i]) {
-         continue;
-      }
-
-      // target == romanlines[i]: assume first column contains data
-
-      if (strcmp(romananalysis[i][0], "|") == 0) {
-         continue;
-      }
-
-      return romananalysis[i][0];
-
-   }
-
-   // most likely some sort of error if got to here
-   return ".";
-}
-
-
 
 
 //////////////////////////////
 //
-// getRomanAnalysisLines --
+// printRomanKey -- print a key interpretation line for the roman
+//     numeral analysis before a data line.
 //
 
-void getRomanAnalysisLines(vector<int>& romanlines, vector<int>& romantimes,
-   vector<int>& linetimes, HumdrumFile& romananalysis) {
-
-   romanlines.resize(romantimes.size());
-   fill(romanlines.begin(), romanlines.end(), -1);
-
-   for (int i=0; i<(int)romantimes.size(); i++) {
-      romanlines[i] = getClosestRootLine(linetimes, romantimes[i]);
+void printRomanKey(ostream& out, const string& key, HumdrumRecord& aRecord) {
+   if (key.empty()) {
+      return;
    }
 
-   if (debugQ) {
-      for (int i=0; i<romananalysis.getNumLines(); i++) {
-         cout << romananalysis[i] << "\t" << romantimes[i]
-                                  << "\t" << romanlines[i] << "\n";
-      }
-   }
-}
-
-
-
-//////////////////////////////
-//
-// getRomanAnalysisTimes --
-//
-
-void getRomanAnalysisTimes(vector<int>& romantimes, HumdrumFile& romananalysis) {
-
-   romantimes.resize(romananalysis.getNumLines());
-   fill(romantimes.begin(), romantimes.end(), -1);
-   int i, j;
-   long timeval;
-   for (i=0; i<romananalysis.getNumLines(); i++) {
-      if (romananalysis[i].getType() != E_humrec_data) {
-         continue;
-      }
-      for (j=0; j<romananalysis[i].getFieldCount(); j++) {
-         if (strcmp(romananalysis[i].getExInterp(j), "**time") != 0) {
-            continue;
-         }
-         if (strcmp(romananalysis[i][j], ".") == 0) {
-            romantimes[i] = -100;
-         } else {
-            timeval = strtol(romananalysis[i][j], (char**)NULL, 10);
-            romantimes[i] = timeval;
-         }
-      }
+   int j;
+   if (prependQ) {
+      out << key << "\t";
+      out << key << "\t";
    }
 
-   int k;
-   int count = 0;
-   // int countother = 0;
-   int endingtime = 0;
-   double increment = 0.0;
-   for (i=0; i<(int)romantimes.size(); i++) {
-      if (romantimes[i] >= 0) {
-         count = 0;
-         // countother = 0;
-         endingtime = -1;
-         j = i+1;
-         while (j < (int)romantimes.size()) {
-            if (romantimes[j] < -10) {
-               count++;
-            } else if (romantimes[j] < 0) {
-               // countother++;
-            } else {
-               endingtime = romantimes[j];
-               break;
-            }
-            j++;
-         }
-         if (count > 0) {
-            increment = 1.0*(endingtime - romantimes[i])/count;
-         } else {
-            increment = 0.0;
-         }
-
-         count = 0;
-         k = i+1;
-         while (k < (int)romantimes.size()) {
-            if (romantimes[k] < -10) {
-               romantimes[k] = (int)(romantimes[i] + increment * count + 0.5);
-               count++;
-            } else if (romantimes[k] >= 0) {
-               break;
-            }
-            k++;
+   if (prependQ || appendQ) {
+      for (j=0; j<aRecord.getFieldCount(); j++) {
+         out << "*";
+         if (j < aRecord.getFieldCount() - 1) {
+            out << "\t";
          }
-         i = j-1;
-      }
-   }
-
-   for (i=(int)romantimes.size()-2; i>=0; i--) {
-      if (romantimes[i] == -1) {
-         romantimes[i] = romantimes[i+1];
-      }
-   }
-
-   for (i=1; i<(int)romantimes.size(); i++) {
-      if (romantimes[i] == -1) {
-         romantimes[i] = romantimes[i-1];
       }
-   }
-
-   // for (i=0; i<romananalysis.getNumLines(); i++) {
-   //    cout << romananalysis[i] << "\t" << romantimes[i] << "\n";
-   // }
-
-}
-
-
-
-//////////////////////////////
-//
-// getMatchRoot -- return the **tsroot spine info on the given line;
-//
-
-string getMatchRoot(int matchline, HumdrumFile& hfile) {
-   int i;
-
-   if (hfile.getNumLines() <= matchline) {
-      return "X";
-   } else if (matchline < 0) {
-      return "r";
-   } else if (hfile[matchline].getType() != E_humrec_data) {
-      return "Z";
-   }
-
-   for (i=0; i<hfile[i].getFieldCount(); i++) {
-      if (strcmp(hfile[matchline].getExInterp(i) ,"**tsroot") == 0) {
-         return hfile[matchline][i];
-      }
-   }
-
-   // **tsroot data not found
-   return "W";
-}
-
-
-
-//////////////////////////////
-//
-// getClosestRootLine -- get the nearst root analysis line number
-//    given the input time (which is rounded to the nearest 5 ms).
-//    Returns -1 if there is no nearest time value.
-//
-
-int getClosestRootLine(vector<int>& analysistimes, int targettime) {
-   int i;
-   int diff = 0;
-   int mindiff = 100000;
-   int mindiffline = -1;
-   for (i=0; i<(int)analysistimes.size(); i++) {
-      diff = targettime - analysistimes[i];
-      if (diff < 0) {
-         diff = -diff;
-      }
-      if (diff < 5) {
-         return i;
-      }
-      if (diff < mindiff) {
-         mindiff = diff;
-         mindiffline = i;
+   } else {
+      if (harmonyQ) {
+         out << key << "\t";
       }
+      out << key;
    }
 
-   if (mindiff < 20) {
-      return mindiffline;
-   } else {
-      return -mindiff;
+   if (appendQ) {
+      out << "\t" << key;
+      out << "\t" << key;
    }
 
-}
-
-
-
-//////////////////////////////
-//
-// getAnalysisTimes -- get the analysis times from the data
-//
-
-void getAnalysisTimes(vector<int>& analysistimes, HumdrumFile& rootanalysis) {
-   int i;
-   analysistimes.resize(rootanalysis.getNumLines());
-   fill(analysistimes.begin(), analysistimes.end(), -10000);
-   int j;
-   int datavalue = 0;
-   for (i=0; i<rootanalysis.getNumLines(); i++) {
-      if (rootanalysis[i].getType() == E_humrec_data) {
-         for (j=0; j<rootanalysis[i].getFieldCount(); j++) {
-            if (strcmp(rootanalysis[i].getExInterp(j), "**time") == 0) {
-               // found a **time data record on the line, so store the data
-               datavalue = atoi(rootanalysis[i][j]);
-               analysistimes[i] = datavalue;
-            }
-         }
-      }
-   }
+   out << "\n";
 }
 
 
@@ -829,12 +696,17 @@ void getAnalysisTimes(vector<int>& analysistimes, HumdrumFile& rootanalysis) {
 
 void checkOptions(Options& opts, int argc, char* argv[]) {
    opts.define("r|roman=b",     "add roman numeral analysis as well");
-   opts.define("v|verbose=b",   "display intermediate command");
+   opts.define("v|verbose=b",   "display the key of each section");
    opts.define("a|append=b",    "append analysis to right side of input data");
    opts.define("p|prepend=b",   "prepend analysis to left side of input data");
-   opts.define("tmpdir=s:/tmp", "temporary directory for intermediate output");
-   opts.define("meldir=s:/usr/ccarh/melisma/bin", "melisma command dir.");
-   opts.define("midir=s:/var/www/websites/museinfo/bin", "museinfo command dir.");
+   opts.define("c|change=d:1.0", "penalty weight for changes of root");
+   opts.define("j|threads=i:1", "number of files to analyze at once (0=all cores)");
+   opts.define("w|window=d:0.0", "root of notes attacked in last given quarter notes");
+   // The Melisma programs are no longer run, so these options are
+   // accepted for compatibility with old scripts and ignored:
+   opts.define("tmpdir=s:/tmp", "temporary directory (ignored)");
+   opts.define("meldir=s:/usr/ccarh/melisma/bin", "melisma command dir. (ignored)");
+   opts.define("midir=s:/var/www/websites/museinfo/bin", "museinfo command dir. (ignored)");
    opts.define("debug=b");           // determine bad input line num
    opts.define("author=b");          // author of program
    opts.define("version=b");         // compilation info
@@ -861,9 +733,10 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    }
 
    debugQ   = opts.getBoolean("debug");
-   tmpdir   = opts.getString("tmpdir").c_str();
-   meldir   = opts.getString("meldir").c_str();
-   midir    = opts.getString("midir").c_str();
+   verboseQ = opts.getBoolean("verbose");
+   changeweight = opts.getDouble("change");
+   threads  = opts.getInteger("threads");
+   window   = opts.getDouble("window");
    appendQ  = opts.getBoolean("append");
    prependQ = opts.getBoolean("prepend");
    harmonyQ = opts.getBoolean("roman");
@@ -901,81 +774,3 @@ void usage(const string& command) {
 
 
 
-//////////////////////////////
-//
-// analyzeTiming -- determing the absolute time position of each
-//     line in the file. (Borrowed from the addtime program).
-//
-
-void analyzeTiming(HumdrumFile& infile, vector<double>& timings,
-      vector<double>& tempo) {
-
-   infile.analyzeRhythm();
-   timings.resize(infile.getNumLines());
-   fill(timings.begin(), timings.end(), 0.0);
-   tempo.resize(infile.getNumLines());
-   fill(tempo.begin(), tempo.end(), dtempo);
-   double currtempo = dtempo;
-   double input = 0.0;
-   int count;
-
-   int i;
-   for (i=1; i<infile.getNumLines(); i++) {
-      // check for new tempo...
-      if (strncmp(infile[i][0], "*MM", 3) == 0) {
-         count = sscanf(infile[i][0], "*MM%lf", &input);
-         if (count == 1) {
-            currtempo = input;
-            if (i > 0) {
-               tempo[i-1] = currtempo;
-            }
-            tempo[i] = currtempo;
-         }
-      }
-
-      tempo[i] = currtempo;
-      timings[i] = timings[i-1] + (infile[i].getAbsBeat() -
-            infile[i-1].getAbsBeat()) * 60.0/currtempo;
-
-   }
-
-}
-
-
-
-//////////////////////////////
-//
-// getDataLineTimings --  borrowed and modified from addtime program.
-//
-
-void getDataLineTimings(vector<int>& linetimes, HumdrumFile& infile) {
-   vector<double>  timings;
-   vector<double>  tempo;
-   analyzeTiming(infile, timings, tempo);
-
-
-   linetimes.resize(infile.getNumLines());
-   fill(linetimes.begin(), linetimes.end(), -5000);
-
-   int offset = 0;
-   for (int i=0; i<infile.getNumLines(); i++) {
-      switch (infile[i].getType()) {
-         case E_humrec_data:
-            linetimes[i]  = (int)((timings[i] + offset + 0.0005) * 1000);
-            break;
-         case E_humrec_global_comment:
-         case E_humrec_bibliography:
-         case E_humrec_none:
-         case E_humrec_empty:
-         case E_humrec_data_comment:
-         case E_humrec_data_measure:
-         case E_humrec_data_interpretation:
-         default:
-            break;
-      }
-
-   }
-}
-
-
-
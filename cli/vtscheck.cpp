@@ -0,0 +1,419 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 17:12:42 PDT 2026
+// Last Modified: Sun Oct 18 17:12:42 PDT 2026
+// Filename:      ...sig/examples/all/vtscheck.cpp
+// Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/vtscheck.cpp
+// Syntax:        C++; museinfo
+//
+// Description:   Verify the !!!VTS: and !!!VTS-data: records of a large
+//                number of Humdrum files.
+//
+// The checksums are calculated from the raw bytes of each file (without
+// parsing the file into a HumdrumFile), giving the same values as
+// HumdrumFileBasic::makeVts() and HumdrumFileBasic::makeVtsData().
+// Runs of lines which are used unchanged in the checksum are added to
+// the CRC in a single piece.  Multiple files can be checked at once with
+// the -j option, and the list of files can be read from a file with
+// the -l option.
+//
+
+#include "humdrum.h"
+#include "CheckSum.h"
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+class VtsInfo {
+	public:
+		unsigned long vts;          // calculated !!!VTS: checksum
+		unsigned long vtsdata;      // calculated !!!VTS-data: checksum
+		unsigned long filevts;      // value in !!!VTS: record
+		unsigned long filevtsdata;  // value in !!!VTS-data: record
+		int           vtsQ;         // file has a !!!VTS: record
+		int           vtsdataQ;     // file has a !!!VTS-data: record
+		int           readQ;        // file could be read
+
+		VtsInfo(void) { clear(); }
+		void clear(void) {
+			vts = vtsdata = filevts = filevtsdata = 0;
+			vtsQ = vtsdataQ = readQ = 0;
+		}
+};
+
+///////////////////////////////////////////////////////////////////////////
+
+
+// function declarations
+void      checkOptions       (Options& opts, int argc, char* argv[]);
+void      example            (void);
+void      usage              (const string& command);
+void      getFileList        (vector<string>& filelist, Options& opts);
+int       readFileContents   (vector<char>& contents, const string& filename);
+void      calculateVts       (VtsInfo& info, const char* data, size_t size);
+int       printResult        (ostream& out, const string& filename,
+                              VtsInfo& info, int filecount);
+
+// global variables
+Options   options;            // database for command-line arguments
+int       calculateQ = 0;     // used with -c option
+int       quietQ     = 0;     // used with -q option
+int       threads    = 1;     // used with -j option
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[]) {
+	checkOptions(options, argc, argv);
+
+	vector<string> filelist;
+	getFileList(filelist, options);
+	int filecount = (int)filelist.size();
+	if (filecount < 1) {
+		cerr << "Error: you must supply at least one input file" << endl;
+		exit(1);
+	}
+
+	int tcount = threads;
+	if (tcount <= 0) {
+		tcount = thread::hardware_concurrency();
+	}
+	if (tcount > filecount) {
+		tcount = filecount;
+	}
+	if (tcount < 1) {
+		tcount = 1;
+	}
+
+	// Files are checked in batches so that the results can be printed
+	// in the order of the input list without storing all of them.
+	int batchsize = tcount * 64;
+	vector<VtsInfo> results(batchsize);
+	int errors = 0;
+	int start;
+	int count;
+	int i;
+
+	for (start=0; start<filecount; start+=batchsize) {
+		count = filecount - start;
+		if (count > batchsize) {
+			count = batchsize;
+		}
+
+		atomic<int> next(0);
+		auto worker = [&](void) {
+			vector<char> contents;
+			int index;
+			while ((index = next++) < count) {
+				VtsInfo& info = results[index];
+				info.clear();
+				if (readFileContents(contents, filelist[start+index])) {
+					info.readQ = 1;
+					calculateVts(info, contents.data(), contents.size());
+				}
+			}
+		};
+
+		if (tcount == 1) {
+			worker();
+		} else {
+			vector<thread> workers;
+			for (i=0; i<tcount; i++) {
+				workers.emplace_back(worker);
+			}
+			for (i=0; i<(int)workers.size(); i++) {
+				workers[i].join();
+			}
+		}
+
+		for (i=0; i<count; i++) {
+			errors += printResult(cout, filelist[start+i], results[i],
+					filecount);
+		}
+	}
+
+	return errors ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// calculateVts -- Calculate the !!!VTS: and !!!VTS-data: checksums
+//    of the file contents, and also store the values found in any
+//    !!!VTS: and !!!VTS-data: records.  Lines are treated in the same
+//    way as HumdrumFileBasic::read(): a final newline does not create
+//    an empty record, and a carriage return at the end of a line is
+//    removed.
+//
+
+void calculateVts(VtsInfo& info, const char* data, size_t size) {
+	CRC32_CTX allcrc;
+	CRC32_CTX datacrc;
+	CheckSum::crc32Init(&allcrc);
+	CheckSum::crc32Init(&datacrc);
+
+	const char* end     = data + size;
+	const char* p       = data;
+	const char* allspan = data;  // start of lines not yet in allcrc
+	const char* dataspan = data; // start of data lines not yet in datacrc
+	const char* newline;
+	const char* next;
+	size_t length;
+	int crQ;
+	int vtsQ;
+	int dataQ;
+
+	while (p < end) {
+		newline = (const char*)memchr(p, '\n', end - p);
+		if (newline == NULL) {
+			length = end - p;
+			next = end;
+		} else {
+			length = newline - p;
+			next = newline + 1;
+		}
+		crQ = (length > 0) && (p[length-1] == '\r');
+		if (crQ) {
+			length--;
+		}
+		vtsQ  = (length >= 6) && (strncmp(p, "!!!VTS", 6) == 0);
+		dataQ = (length > 0) && (p[0] != '!') && (p[0] != '*') &&
+				(p[0] != '=');
+
+		if (vtsQ) {
+			if (strncmp(p, "!!!VTS:", 7) == 0) {
+				info.filevts = strtoul(p+7, NULL, 10);
+				info.vtsQ = 1;
+			} else if (strncmp(p, "!!!VTS-data:", 12) == 0) {
+				info.filevtsdata = strtoul(p+12, NULL, 10);
+				info.vtsdataQ = 1;
+			}
+		}
+
+		// The line can stay in the current span if it is added to the
+		// checksum exactly as it is in the file.
+		if (vtsQ || crQ || (newline == NULL)) {
+			CheckSum::crc32Update(&allcrc, allspan, p - allspan);
+			if (!vtsQ) {
+				CheckSum::crc32Update(&allcrc, p, length);
+				CheckSum::crc32Update(&allcrc, "\n", 1);
+			}
+			allspan = next;
+		}
+		if (!dataQ || crQ || (newline == NULL)) {
+			CheckSum::crc32Update(&datacrc, dataspan, p - dataspan);
+			if (dataQ) {
+				CheckSum::crc32Update(&datacrc, p, length);
+				CheckSum::crc32Update(&datacrc, "\n", 1);
+			}
+			dataspan = next;
+		}
+
+		p = next;
+	}
+
+	CheckSum::crc32Update(&allcrc, allspan, end - allspan);
+	CheckSum::crc32Update(&datacrc, dataspan, end - dataspan);
+	info.vts     = CheckSum::crc32Final(&allcrc);
+	info.vtsdata = CheckSum::crc32Final(&datacrc);
+}
+
+
+
+//////////////////////////////
+//
+// printResult -- Print the calculated checksums (-c option) or the
+//    verification status of a file.  Returns 1 if the file could not
+//    be verified.
+//
+
+int printResult(ostream& out, const string& filename, VtsInfo& info,
+		int filecount) {
+	if (!info.readQ) {
+		cerr << "Error: cannot read file " << filename << endl;
+		return 1;
+	}
+
+	if (calculateQ) {
+		if (filecount > 1) {
+			out << "!!!!SEGMENT: " << filename << "\n";
+		}
+		out << "!!!VTS: " << info.vts << "\n";
+		out << "!!!VTS-data: " << info.vtsdata << "\n";
+		return 0;
+	}
+
+	int status = 0;
+	const char* message = "OK";
+	if (!info.vtsQ && !info.vtsdataQ) {
+		message = "NO VTS";
+		status = 1;
+	} else if (info.vtsQ && (info.vts != info.filevts)) {
+		message = "FAILED";
+		status = 1;
+	} else if (info.vtsdataQ && (info.vtsdata != info.filevtsdata)) {
+		message = "FAILED DATA";
+		status = 1;
+	}
+
+	if (status || !quietQ) {
+		out << filename << ": " << message << "\n";
+	}
+	return status;
+}
+
+
+
+//////////////////////////////
+//
+// readFileContents -- Read an entire file into the buffer (which is
+//    reused between files).  Returns 0 if the file cannot be read.
+//
+
+int readFileContents(vector<char>& contents, const string& filename) {
+	FILE* input = fopen(filename.c_str(), "rb");
+	if (input == NULL) {
+		return 0;
+	}
+	contents.resize(0);
+	size_t count;
+	size_t oldsize;
+	while (1) {
+		oldsize = contents.size();
+		contents.resize(oldsize + 65536);
+		count = fread(contents.data() + oldsize, 1, 65536, input);
+		contents.resize(oldsize + count);
+		if (count < 65536) {
+			break;
+		}
+	}
+	int status = !ferror(input);
+	fclose(input);
+	return status;
+}
+
+
+
+//////////////////////////////
+//
+// getFileList -- Files to check come from the command-line arguments
+//    and from the file given with the -l option ("-" for standard input),
+//    which contains one filename per line.
+//
+
+void getFileList(vector<string>& filelist, Options& opts) {
+	filelist.clear();
+	int i;
+	for (i=1; i<=opts.getArgCount(); i++) {
+		filelist.push_back(opts.getArg(i));
+	}
+
+	if (!opts.getBoolean("list")) {
+		return;
+	}
+
+	string listname = opts.getString("list");
+	ifstream listfile;
+	istream* input = &cin;
+	if (listname != "-") {
+		listfile.open(listname.c_str());
+		if (!listfile.is_open()) {
+			cerr << "Error: cannot read file list " << listname << endl;
+			exit(1);
+		}
+		input = &listfile;
+	}
+
+	string line;
+	while (getline(*input, line)) {
+		if (!line.empty() && (line.back() == '\r')) {
+			line.resize(line.size() - 1);
+		}
+		if (!line.empty()) {
+			filelist.push_back(line);
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// checkOptions -- validate and process command-line options.
+//
+
+void checkOptions(Options& opts, int argc, char* argv[]) {
+	opts.define("c|calculate=b", "print the VTS records instead of verifying");
+	opts.define("l|list=s:-",    "file containing a list of files to check");
+	opts.define("q|quiet=b",     "only print files which do not verify");
+	opts.define("j|threads=i:1", "number of files to check at once (0=all cores)");
+	opts.define("author=b");          // author of program
+	opts.define("version=b");         // compilation info
+	opts.define("example=b");         // example usages
+	opts.define("h|help=b");          // short description
+	opts.process(argc, argv);
+
+	// handle basic options:
+	if (opts.getBoolean("author")) {
+		cout << "Written by Craig Stuart Sapp, "
+		     << "craig@ccrma.stanford.edu, Oct 2026" << endl;
+		exit(0);
+	} else if (opts.getBoolean("version")) {
+		cout << argv[0] << ", version: 18 Oct 2026" << endl;
+		cout << "compiled: " << __DATE__ << endl;
+		cout << MUSEINFO_VERSION << endl;
+		exit(0);
+	} else if (opts.getBoolean("help")) {
+		usage(opts.getCommand().c_str());
+		exit(0);
+	} else if (opts.getBoolean("example")) {
+		example();
+		exit(0);
+	}
+
+	calculateQ = opts.getBoolean("calculate");
+	quietQ     = opts.getBoolean("quiet");
+	threads    = opts.getInteger("threads");
+}
+
+
+
+//////////////////////////////
+//
+// example -- example usage of the program
+//
+
+void example(void) {
+	cout <<
+	"# Verify all Humdrum files in a directory tree, printing only failures:\n"
+	"   find . -name '*.krn' | vtscheck -q -j 0 -l -                          \n"
+	<< endl;
+}
+
+
+
+//////////////////////////////
+//
+// usage -- gives the usage statement for the program
+//
+
+void usage(const string& command) {
+	cout <<
+	"Usage: " << command << " [-c][-q][-j threads][-l list] files           \n"
+	<< endl;
+}
+
+
+
@@ -6,6 +6,7 @@
 // Last Modified: Thu Jun  3 18:01:43 PDT 2004 added -p option
 // Last Modified: Sat Jun 26 16:49:06 PDT 2010 added middle syllable markers
 // Last Modified: Thu Mar  5 21:19:58 PST 2015 Added --split option
+// Last Modified: Sun Oct 18 15:59:53 PDT 2026 Added --threads option
 // Filename:      ...sig/examples/all/xml2hum.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/xml2hum.cpp
 // Syntax:        C++; museinfo
@@ -34,6 +35,7 @@ int         mfixQ    = 1;    // used with -M option
 int         printQ   = 0;    // used with -p option
 int         textQ    = 1;    // used with -T option
 int         splitQ   = 0;    // used with --parts
+int         threads  = 1;    // used with -j option
 const char* SplitBase= "s";  // used with --parts
 
 // function declarations:
@@ -49,7 +51,9 @@ void      printHumdrumPart  (HumdrumFile& hfile, const char* filebase,
 int main(int argc, char* argv[]) {
    checkOptions(options, argc, argv);
 
-   MusicXmlFile xmlfile(options.getArg(1).c_str());
+   MusicXmlFile xmlfile;
+   xmlfile.setOption("threads", threads);    // parts to process at once
+   xmlfile.read(options.getArg(1).c_str());
 
    if (printQ) {
       xmlfile.print();
@@ -242,6 +246,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    opts.define("M|no-measure-number-fix=b", "do not renumber measures");
    opts.define("T|no-text=b", "do not convert lyrics to humdrum spines");
    opts.define("parts|part=s:p", "Extract parts into files based on pattern");
+   opts.define("j|threads=i:1", "number of parts to convert at once (0=all cores)");
 
    opts.define("author=b",  "author of program");
    opts.define("version=b", "compilation info");
@@ -283,6 +288,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    textQ     = !opts.getBoolean("no-text");
    splitQ    =  opts.getBoolean("parts");
    SplitBase =  opts.getString("parts").c_str();
+   threads   =  opts.getInteger("threads");
    if (opts.getBoolean("no-notation")) {
       stemQ     = 0;
       beamQ     = 0;
@@ -0,0 +1 @@
+/root/repo/external/pcre2-10.42/src/pcre2_chartables.c.dist
\ No newline at end of file
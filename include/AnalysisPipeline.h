@@ -0,0 +1,95 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 18:40:54 PDT 2026
+// Last Modified: Sun Oct 18 18:40:54 PDT 2026
+// Filename:      ...sig/include/sigInfo/AnalysisPipeline.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/AnalysisPipeline.h
+// Syntax:        C++
+//
+// Description:   Calculates several line-by-line analyses of a HumdrumFile
+//                (tempo, meter, beat duration, metric level, sonority
+//                quality and attack accentuation) in a single pass through
+//                the lines of the file.  The results are the same as the
+//                corresponding HumdrumFile::analyze functions, which each
+//                make a separate pass through the file.
+//
+
+#ifndef _ANALYSISPIPELINE_H_INCLUDED
+#define _ANALYSISPIPELINE_H_INCLUDED
+
+#include "HumdrumFile.h"
+#include "ChordQuality.h"
+#include "Array.h"
+
+#include <iostream>
+
+using namespace std;
+
+
+// analyses which can be requested (listed in the order of calculation):
+#define ANALYSIS_RHYTHM         (1<<0)  /* HumdrumFile::analyzeRhythm()   */
+#define ANALYSIS_TEMPO          (1<<1)  /* like analyzeTempoMarkings()    */
+#define ANALYSIS_METER          (1<<2)  /* like analyzeMeter()            */
+#define ANALYSIS_BEATDURATION   (1<<3)  /* like analyzeBeatDuration()     */
+#define ANALYSIS_METRICLEVEL    (1<<4)  /* like analyzeMetricLevel()      */
+#define ANALYSIS_SONORITY       (1<<5)  /* like analyzeSonorityQuality()  */
+#define ANALYSIS_ACCENTUATION   (1<<6)  /* like analyzeAttackAccentuation() */
+#define ANALYSIS_COUNT          7
+
+
+class AnalysisPipeline {
+   public:
+                      AnalysisPipeline   (void);
+                     ~AnalysisPipeline   ();
+
+      void            clear              (void);
+      void            request            (int analyses);
+      void            disable            (int analyses);
+      int             getActive          (void);
+      void            setDefaultTempo    (double tempo);
+      void            setTiming          (int state = 1);
+
+      void            run                (HumdrumFile& infile);
+
+      Array<double>&        getTempo           (void);
+      Array<double>&        getMeterTop        (void);
+      Array<double>&        getMeterBottom     (void);
+      Array<double>&        getBeatDuration    (void);
+      Array<int>&           getMetricLevels    (void);
+      Array<ChordQuality>&  getSonorities      (void);
+      Array<int>&           getAccentuation    (void);
+
+      double          getTime            (int analysis);
+      int             getRunCount        (void);
+      void            printTiming        (ostream& out);
+
+      static const char* getName         (int analysis);
+
+   protected:
+      int             requested;        // analyses asked for by request()
+      int             disabled;         // analyses turned off by disable()
+      double          defaulttempo;     // tempo before first *MM marker
+      int             timingQ;          // measure the time of each analysis
+      int             runcount;         // number of files analyzed
+      double          times[ANALYSIS_COUNT];  // total milliseconds
+
+      Array<double>        tempo;       // tempo of each line
+      Array<double>        metertop;    // meter numerator of each line
+      Array<double>        meterbottom; // beats per quarter note
+      Array<double>        beatdur;     // beat duration (compound meters)
+      Array<int>           metlev;      // metric level of each line
+      Array<ChordQuality>  sonorities;  // chord quality of each line
+      Array<int>           accentuation; // attacks minus sustains
+
+      static int      getIndex           (int analysis);
+      static int      getDependencies    (int analysis);
+      static int      getDependents      (int analysis);
+      void            addTime            (int analysis, double start);
+      static double   getCurrentTime     (void);
+};
+
+
+#endif /* _ANALYSISPIPELINE_H_INCLUDED */
+
+
+
@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Feb 14 07:40:03 PST 2011
 // Last Modified: Mon Feb 14 07:40:09 PST 2011
+// Last Modified: Sun Oct 18 17:12:42 PDT 2026 incremental crc32
 // Filename:      ...sig/maint/code/base/CheckSum/CheckSum.h
 // Web Address:   http://sig.sapp.org/include/sigBase/CheckSum.h
 // Syntax:        C++
@@ -32,6 +33,13 @@
 
 #include "Array.h"
 
+#include <cstddef>
+
+struct CRC32_CTX {            // cksum CRC32 context
+   unsigned long      crc;    // CRC of data so far
+   unsigned long long length; // number of bytes added so far
+};
+
 struct MD5_CTX {              // MD5 context
    unsigned long state[4];    // state (ABCD)
    unsigned long count[2];    // number of bits, modulo 2^64 (lsb first)
@@ -46,6 +54,12 @@ class CheckSum {
       // equivalent to the checksum output by "cksum" command:
       static unsigned long crc32     (const char* buf, int length);
 
+      // incremental version of crc32() for data in several pieces:
+      static void          crc32Init   (CRC32_CTX* context);
+      static void          crc32Update (CRC32_CTX* context, const char* buf,
+                                        size_t length);
+      static unsigned long crc32Final  (CRC32_CTX* context);
+
       // equivalent to the md5sum output by "md5sum" command:
       static void          getMD5Sum (Array<char>& md5sum, Array<char>& data);
       static void          getMD5Sum (string& md5sum, string& data);
@@ -13,6 +13,7 @@
 // Last Modified: Sat May 22 11:02:12 PDT 2010 (added RationalNumber)
 // Last Modified: Sun Dec 26 04:54:46 PST 2010 (added kernClefToBaseline)
 // Last Modified: Sat Jan 22 17:13:36 PST 2011 (added kernToDurationNoDots)
+// Last Modified: Sun Oct 18 19:35:04 PDT 2026 (added transposeKern())
 // Filename:      ...sig/include/sigInfo/Convert.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/Convert.h
 // Syntax:        C++
@@ -112,6 +113,9 @@ class Convert {
 		                           const string& doubleflat = "bb",
 		                           const string& doublesharp = "x");
       static int       kernNoteToBase40           (const string& name);
+      static int       transposeKern              (string& output,
+                                                   const char* kerntoken,
+                                                   int transval);
       static SigCollection<int> keyToScaleDegrees (int aKey, int aMode);
       static int       museToBase40               (const string& pitchString);
       static int       base40ToScoreVPos          (int pitch, int clef);
@@ -179,6 +183,7 @@ class Convert {
                                                int root);
       static int     checkChord               (const SigCollection<int>& aSet);
       static int     intcompare               (const void* a, const void* b);
+      static const string& getKernSpelling    (int base40);
       static void    rotatechord              (SigCollection<int>& aChord);
       static void    addCombinations          (Array<Array<int> >& combinations,
                                                Array<int>& input,
@@ -0,0 +1,81 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 18:32:36 PDT 2026
+// Last Modified: Sun Oct 18 18:32:36 PDT 2026
+// Filename:      ...sig/include/sigInfo/CorpusWalker.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/CorpusWalker.h
+// Syntax:        C++
+//
+// Description:   Collects the files of a corpus from file and directory
+//                names (optionally recursing into subdirectories and
+//                filtering by filename extension or mask) in a sorted
+//                order, and processes them with a pool of worker
+//                processes.  The standard output of each file is
+//                collected and printed in the order of the file list,
+//                so the output is the same as when processing the files
+//                one at a time.  The file list can also be given to
+//                HumdrumStream for reading the files serially.
+//
+
+#ifndef _CORPUSWALKER_H_INCLUDED
+#define _CORPUSWALKER_H_INCLUDED
+
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// function called for each file in the corpus (output goes to cout):
+typedef void (*CorpusFunction)(int index, const string& filename,
+                               void* userdata);
+
+
+class CorpusWalker {
+   public:
+                      CorpusWalker       (void);
+                     ~CorpusWalker       ();
+
+      void            clear              (void);
+      void            setRecursive       (int state = 1);
+      void            setHidden          (int state = 1);
+      void            addExtension       (const string& extension);
+      void            setMask            (const string& mask);
+
+      int             addPath            (const string& path);
+      void            addFile            (const string& filename);
+
+      int             getFileCount       (void);
+      const string&   getFile            (int index);
+      const vector<string>& getFileList  (void);
+
+      void            run                (CorpusFunction function,
+                                          void* userdata = NULL,
+                                          int jobs = 1);
+
+      static int      getProcessorCount  (void);
+      static int      isFile             (const string& path);
+      static int      isDirectory        (const string& path);
+
+   protected:
+      vector<string>  files;            // list of files to process
+      vector<string>  extensions;       // allowed filename endings
+      string          mask;             // required filename substring
+      int             recursiveQ;       // descend into subdirectories
+      int             hiddenQ;          // include files starting with "."
+
+      int             isValidName        (const string& name);
+      void            addDirectory       (const string& path);
+      void            runParallel        (CorpusFunction function,
+                                          void* userdata, int jobs);
+      void            stopJobs           (vector<pid_t>& pids,
+                                          vector<int>& pipes, int start,
+                                          int end);
+};
+
+
+#endif /* _CORPUSWALKER_H_INCLUDED */
+
+
+
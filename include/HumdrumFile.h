@@ -19,6 +19,15 @@
 // Last Modified: Sat Sep  5 22:03:28 PDT 2009 ArrayInt to Array<int>
 // Last Modified: Sun Jun 20 13:42:12 PDT 2010 Added rhythm list)
 // Last Modified: Mon Sep 16 20:26:17 PDT 2013 Added getMeasureNumber()
+// Last Modified: Sun Oct 18 16:29:47 PDT 2026 Added Melisma-style functions
+// Last Modified: Sun Oct 18 16:35:54 PDT 2026 Added analyzeTies()
+// Last Modified: Sun Oct 18 16:42:18 PDT 2026 Added integer tick timeline
+// Last Modified: Sun Oct 18 17:33:17 PDT 2026 Hashed analyzeCliche() windows
+// Last Modified: Sun Oct 18 17:38:39 PDT 2026 Added analyzeNotes()
+// Last Modified: Sun Oct 18 17:40:58 PDT 2026 Added sonority snapshots
+// Last Modified: Sun Oct 18 17:44:07 PDT 2026 Stored metric levels
+// Last Modified: Sun Oct 18 18:40:54 PDT 2026 Added calculateMetricLevel()
+// Last Modified: Sun Oct 18 20:29:20 PDT 2026 Redo note analysis after edits
 // Filename:      ...sig/include/sigInfo/HumdrumFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumFile.h
 // Syntax:        C++
@@ -61,6 +70,28 @@ using namespace std;
 #define  NL_TIED     (0<<6)  /* don't remove tied notes */
 #define  NL_NOTIED   (1<<6)  /* remove tied notes */
 
+
+//////////////////////////////
+//
+// HumdrumFile::analyzeTies states
+//
+
+#define  TIE_NONE    0       /* note is not tied */
+#define  TIE_START   1       /* note starts a tie: [ */
+#define  TIE_MIDDLE  2       /* tie continuation: _ */
+#define  TIE_END     3       /* tie ending: ] */
+
+
+//////////////////////////////
+//
+// HumdrumFile::getSonorityNotes flags
+//
+
+#define  SON_SUSTAIN   (1<<0)  /* note is sustained from a null token */
+#define  SON_TIED      (1<<1)  /* note is a tie continuation: _ or ] */
+#define  SON_RESTFIELD (1<<2)  /* token containing the note has a rest */
+
+
 //
 // HumdrumFile analysis* flag settings
 //
@@ -132,6 +163,10 @@ class HumdrumFile : public HumdrumFileBasic {
                                                    int flag);
       int                    getNoteList      (vector<int>& notes, int line,
                                                    int flag);
+      int                    getSonorityNotes (Array<int>& base40,
+                                               Array<int>& flags, int line);
+      int                    getSonorityMask  (int line);
+      int                    getSonorityBass  (int line);
       void                   getNoteArray     (Array<double>& absbeat,
                                                Array<int>& pitches,
                                                Array<double>& durations,
@@ -162,6 +197,14 @@ class HumdrumFile : public HumdrumFileBasic {
                                                  int token = 0);
       double                 getTotalDuration (void);
       RationalNumber         getTotalDurationR(void);
+      long long              getTicksPerQuarter(void);
+      long long              getAbsTicks      (int index);
+      long long              getBeatTicks     (int index);
+      long long              getDurationTicks (int index);
+      long long              getTotalTicks    (void);
+      RationalNumber         ticksToBeatR     (long long ticks);
+      long long              beatToTicks      (RationalNumber beat,
+                                                 int roundup = 0);
       HumdrumFile&           operator=        (const HumdrumFile& aFile);
       void                   read             (const char* filename);
       void                   read             (const string& filename);
@@ -170,6 +213,12 @@ class HumdrumFile : public HumdrumFileBasic {
       // analyses that generate internal data
       void                   analyzeRhythm    (const char* base = "",
                                                  int debug = 0);
+      void                   analyzeTies      (void);
+      void                   analyzeTicks     (void);
+      void                   analyzeNotes     (void);
+      void                   analyzeDots      (void);
+      void                   changeField      (HumdrumFileAddress& add,
+                                               const char* newField);
       void                   spaceEmptyLines  (void);
       int                    getMinTimeBase   (void);
       RationalNumber         getMinTimeBaseR  (void);
@@ -225,6 +274,8 @@ class HumdrumFile : public HumdrumFileBasic {
       void analyzeAttackAccentuation(Array<int>& atakcent);
       void analyzeMetricLevel(Array<int>& metlev);
       void analyzeMetricLevel(vector<int>& metlev);
+      static int calculateMetricLevel(double beat, double top,
+            double bottom, int compound);
 
       // sonority harmonic analyses
       void analyzeSonorityQuality(Array<ChordQuality>& cq);
@@ -246,12 +297,63 @@ class HumdrumFile : public HumdrumFileBasic {
       Array<RationalNumber> localrhythms;  // used with rhythmanalysis
       RationalNumber pickupdur; // duration of a pickup measure
 
+      // tie-chain index (see analyzeTies):
+      int                   tiecheck;    // 1 = tie analysis has been done
+      Array<Array<int> >    tieindex;    // first subtoken index of fields
+      Array<int>            tiehead;     // index of the start of the tie
+      Array<int>            tiestate;    // TIE_NONE, TIE_START, etc.
+      Array<int>            tieline;     // line of each subtoken
+      Array<int>            tiefield;    // field of each subtoken
+      Array<int>            tietoken;    // subtoken number in field
+      Array<RationalNumber> tietotal;    // total duration of tie group
+
+      // integer timeline (see analyzeTicks):
+      int                   tickcheck;   // 1 = tick analysis has been done
+      long long             tickspq;     // ticks per quarter note
+      Array<long long>      tickabs;     // absolute start time of lines
+      Array<long long>      tickbeat;    // metric position of lines
+      Array<long long>      tickdur;     // duration of lines
+
+      // metric levels of lines (see getMetricLevels):
+      int                   levelcheck;  // 1 = metric levels are stored
+      Array<int>            levelcache;  // metric level of each line
+
+      // decoded notes of the filled-token table (see analyzeNotes):
+      int                   notecheck;   // 1 = note analysis has been done
+      unsigned int          notechanges; // file edit count at analysis
+      Array<int>            noteoffset;  // first note of each table cell
+      Array<int>            notecount;   // number of notes in each cell
+      Array<int>            notebase40;  // base-40 pitch of each note
+      Array<int>            notemidi;    // MIDI key number of each note
+      Array<char>           notetied;    // 1 = note is a tie continuation
+
+      // per-line sonority snapshots (see getSonorityNotes):
+      int                   soncheck;    // 1 = snapshot storage is ready
+      Array<int>            sonoffset;   // first note of line, -1 = not made
+      Array<int>            soncount;    // number of notes on each line
+      Array<int>            sonmask;     // pitch classes sounding on line
+      Array<int>            sonbass;     // lowest base-40 pitch on line
+      Array<int>            sonbase40;   // base-40 pitch of each note
+      Array<int>            sonmidi;     // MIDI key number of each note
+      Array<char>           sonflags;    // SON_SUSTAIN, SON_TIED, etc.
+
    private:
       int            ispoweroftwo            (int value);
       RationalNumber getMinimumRationalRhythm(Array<RationalNumber>& rhythms);
       static int intcompare(const void* a, const void* b);
       void   convertKernStringToArray(Array<int>& array, const char* string);
 
+      Array<int>& getMetricLevels (void);
+
+      // sonority snapshot functions:
+      int        getSonorityIndex (int line);
+
+      // tie analysis functions:
+      int        getTieIndex      (int linenum, int field, int token);
+      static int getTieState      (const char* token);
+      static void removeOpenTie   (Array<int>& opentie, Array<int>& openpitch,
+                                   int index);
+
       // spine analysis functions:
       void       privateSpineAnalysis(void);
       int        predictNewSpineCount(HumdrumRecord& aRecord);
@@ -290,6 +392,7 @@ class HumdrumFile : public HumdrumFileBasic {
                          SigCollection<RationalNumber>& runningstatus,
                          HumdrumRecord& currRecord);
       int        GCD      (int a, int b);
+      static long long tickGCD(long long a, long long b);
       int        findlcm  (Array<int>& rhythms);
 
       // determining the meaning of dots (null records)
@@ -303,9 +406,13 @@ class HumdrumFile : public HumdrumFileBasic {
       static ostream& printConstantTokenFields(ostream& out,
                        HumdrumRecord& aRecord, const char* token);
 
-      // private function for analyzeCliche:
-      int attemptMatch(Array<Array<int> >& allnotes, Array<int>& di, int
-         starti, int i, int j, double duration);
+      // private functions for analyzeCliche:
+      void getClicheSonorityIds(Array<int>& ids, Array<int>& di, int starti,
+         int endi);
+      void getClicheWindows(Array<int>& lengths,
+         Array<unsigned long long>& hashes, Array<int>& ids, Array<int>& di,
+         int starti, int endi, double duration);
+      int attemptMatch(Array<int>& ids, Array<int>& lengths, int i, int j);
 
 
    ///////////////////////////////////////////////////////////////////////
@@ -356,6 +463,23 @@ class HumdrumFile : public HumdrumFileBasic {
                                        int startLinst, int endLine);
 
 
+   ///////////////////////////////////////////////////////////////////////
+   //
+   // functions defined in HumdrumFile-melisma.cpp
+   //
+
+   public:
+      ostream& printMelismaNotes      (ostream& out, double tdefault = 60.0,
+                                       int classQ = 0);
+      int      analyzeMelismaRoots    (Array<int>& roots,
+                                       double changeweight = 1.0,
+                                       int debug = 0);
+
+   private:
+      void     printMelismaInfo       (ostream& out, HumdrumRecord& record);
+      static int validRootQ           (int base40);
+
+
    // old functions which should not be used:
 
    int analyzeChordProbabilityDurNorm(Array<double>& coef,
@@ -9,6 +9,9 @@
 // Last Modified: Tue Apr 24 16:54:50 PDT 2012 added readFromJrpURI()
 // Last Modified: Tue Dec 11 17:23:04 PST 2012 added fileName, segmentLevel
 // Last Modified: Sat Apr 27 13:36:16 PDT 2013 added changeField()
+// Last Modified: Sun Oct 18 17:12:42 PDT 2026 added getVtsChecksum()
+// Last Modified: Sun Oct 18 17:38:39 PDT 2026 added filled-token table
+// Last Modified: Sun Oct 18 21:12:02 PDT 2026 added getEditCount()
 // Filename:      ...sig/include/sigInfo/HumdrumFileBasic.h
 // Web Address:   http://museinfo.sapp.org/include/sigInfo/HumdrumFileBasic.h
 // Syntax:        C++
@@ -92,7 +95,39 @@ class HumdrumFileAddress {
 
 ///////////////////////////////////////////////////////////////////////////
 
+class HumdrumFileBasic;
+
+// HumdrumFilledIterator -- iterate through the fields of a data line,
+//    returning the token which each null token (".") refers to.
+
+class HumdrumFilledIterator {
+   public:
+                   HumdrumFilledIterator (HumdrumFileBasic& aFile, int aLine);
+                  ~HumdrumFilledIterator ();
+
+      int          isValid               (void);
+      void         next                  (void);
+      int          getField              (void);
+      int          getCell               (void);
+      int          getSourceLine         (void);
+      int          getSourceField        (void);
+      int          isNull                (void);
+      const char*  getToken              (void);
+
+   protected:
+      HumdrumFileBasic* file;     // file being iterated
+      int               line;     // line being iterated
+      int               field;    // current field on the line
+      int               count;    // number of fields on the line
+      int               cell;     // filled-table cell of current field
+      int*              sources;  // source line/field pairs in the table
+};
+
+///////////////////////////////////////////////////////////////////////////
+
 class HumdrumFileBasic {
+   friend class HumdrumFilledIterator;
+
    public:
                              HumdrumFileBasic (void);
                              HumdrumFileBasic (const HumdrumFileBasic&
@@ -119,6 +154,12 @@ class HumdrumFileBasic {
       HumdrumFileBasic       extract          (int aField);
       void                   getNonNullAddress(HumdrumFileAddress& add);
       const char*            getDotValue      (int index, int spinei);
+      unsigned int           getEditCount     (void);
+      int                    getFilledCell    (int index, int spinei);
+      int                    getFilledCellCount(void);
+      int                    getFilledLine    (int index, int spinei);
+      int                    getFilledField   (int index, int spinei);
+      const char*            getFilledToken   (int index, int spinei);
       const char*            getLine          (int index);
       const char*            getBibValue      (char* buffer, const char* key);
       int                    getNumLines      (void);
@@ -144,6 +185,8 @@ class HumdrumFileBasic {
       void                   makeVtsData      (string& vtsstring);
       static void            makeVtsData      (string& vtsstring,
                                                HumdrumFileBasic& infile);
+      static unsigned long   getVtsChecksum   (HumdrumFileBasic& infile,
+                                               int dataQ = 0);
       HumdrumFileBasic&      operator=        (const HumdrumFileBasic& aFile);
       void                   read             (const char* filename);
       void                   read             (const string& filename);
@@ -165,9 +208,14 @@ class HumdrumFileBasic {
       int            segmentLevel;  // storage for input file's segment level
       SigCollection  <HumdrumRecord*>  records;
       int            maxtracks;           // max exclusive interpretation count
+      unsigned int   editcount;     // number of changes made to the records
       vector<string> trackexinterp;
       static char    empty[1];
 
+      // dense null-token resolution table (see privateDotAnalysis):
+      Array<int>     dotoffset;     // first cell of each line (size lines+1)
+      Array<int>     dotsource;     // source line and field of each cell
+
    private:
       static int intcompare(const void* a, const void* b);
 
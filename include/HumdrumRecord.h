@@ -13,6 +13,8 @@
 // Last Modified: Tue Jun 26 09:51:28 PDT 2012 Added interpretation type funcs.
 // Last Modified: Mon Dec 10 10:14:08 PST 2012 Added Array<char> getToken
 // Last Modified: Sat Apr 20 12:15:42 PDT 2013 Added isNulToken()
+// Last Modified: Sun Oct 18 16:49:47 PDT 2026 Copy-on-write record text
+// Last Modified: Sun Oct 18 21:12:02 PDT 2026 Added setEditCounter
 // Filename:      ...sig/include/sigInfo/HumdrumRecord.h
 // Webpage:       http://sig.sapp.org/include/sigInfo/HumdrumRecord.h
 // Syntax:        C++
@@ -30,9 +32,39 @@
 #include "Enum_humdrumRecord.h"
 #include "RationalNumber.h"
 
+#include <atomic>
 #include <vector>
 #include <iostream>
 
+
+//////////////////////////////
+//
+// HumdrumRecordData -- the text and spine information of a
+//    HumdrumRecord.  Copies of a record share the same data until
+//    one of them is modified.
+//
+
+class HumdrumRecordData {
+   public:
+                           HumdrumRecordData  (void);
+                           HumdrumRecordData  (const HumdrumRecordData& aData);
+                          ~HumdrumRecordData  ();
+
+      atomic<int>          refcount;       // number of records using data
+      int                  type;           // category of humdrum record
+      int                  spinewidth;     // for size of spines in comments
+      char*                recordString;   // record string
+      int                  modifiedQ;      // boolen for if need to make Rstring
+      SigCollection<char*> recordFields;   // data for humdrum text record
+      vector<string>       spineids;       // spine tracing ids
+      Array<int>           interpretation; // exclusive interpretation of data
+
+      Array<int>           dotline;        // for resolving meaning of "."'s
+      Array<int>           dotspine;       // for resolving meaning of "."'s
+};
+
+
+
 class HumdrumRecord {
    public:
                         HumdrumRecord      (void);
@@ -213,6 +245,7 @@ class HumdrumRecord {
       int               isAllSysStaffNumber   (void);
 
       int               isNull                (void);
+      int               isShared              (void) const;
 
       void              insertField        (int index, const char* aField,
                                               int anInterp = E_unknown,
@@ -252,20 +285,13 @@ class HumdrumRecord {
       void              setLineNum         (int aLine);
       void              setSpineID         (int index, const char* anID);
       void              setSpineWidth      (int aSize);
+      void              setEditCounter     (unsigned int* counter);
 
 
    protected:
       int                  lineno;         // line number of record in a file
-      int                  type;           // category of humdrum record
-      int                  spinewidth;     // for size of spines in comments
-      char*                recordString;   // record string
-      int                  modifiedQ;      // boolen for if need to make Rstring
-      SigCollection<char*> recordFields;   // data for humdrum text record
-      vector<string>       spineids;       // spine tracing ids
-      Array<int>           interpretation; // exclusive interpretation of data
-
-      Array<int>           dotline;        // for resolving meaning of "."'s
-      Array<int>           dotspine;       // for resolving meaning of "."'s
+      HumdrumRecordData*   shared;         // text data (shared by copies)
+      unsigned int*        editcount;      // edit count of owning file
 
 
       // data storage for rhythmic analysis in relation to entire Humdrum File.
@@ -283,6 +309,9 @@ class HumdrumRecord {
       void              storeRecordFields  (void);
       int               isParticularType   (const char* regexp,
                                             const char* exinterp);
+      void              unshare            (void);
+      void              release            (void);
+      void              markEdited         (void);
 };
 
 
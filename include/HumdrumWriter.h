@@ -0,0 +1,76 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 19:28:24 PDT 2026
+// Last Modified: Sun Oct 18 19:28:24 PDT 2026
+// Last Modified: Sun Oct 18 21:35:59 PDT 2026 Reuse the buffer in each thread
+// Filename:      ...sig/include/sigInfo/HumdrumWriter.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumWriter.h
+// Syntax:        C++
+//
+// Description:   Buffered output of Humdrum data.  Text, records and files
+//                are copied into a large byte buffer which is written to
+//                the output stream in big blocks, rather than passing each
+//                token and line through the formatting of the stream.
+//                Records which have not been modified since they were read
+//                are copied from their original input text.  Any other
+//                output to the same stream must wait until the writer is
+//                flushed (or destroyed), otherwise lines will be printed
+//                out of order.  Each thread keeps one buffer which
+//                is reused by its writers, so that a writer can be
+//                created for every file (as in cout << infile) without
+//                allocating a new buffer each time.
+//
+
+#ifndef _HUMDRUMWRITER_H_INCLUDED
+#define _HUMDRUMWRITER_H_INCLUDED
+
+#include "HumdrumRecord.h"
+#include "HumdrumFileBasic.h"
+
+#include <iostream>
+
+using namespace std;
+
+#define HUMDRUMWRITER_SIZE  (256 * 1024)  /* default size of buffer */
+
+
+class HumdrumWriter {
+   public:
+                      HumdrumWriter      (ostream& out,
+                                          int bufferSize = HUMDRUMWRITER_SIZE);
+                     ~HumdrumWriter      ();
+
+      void            write              (const char* text, int length);
+      void            write              (const char* text);
+      void            write              (char character);
+      void            write              (int value);
+      void            writeLine          (HumdrumRecord& record);
+      void            writeFile          (HumdrumFileBasic& infile);
+      void            flush              (void);
+      long long       getByteCount       (void);
+
+      HumdrumWriter&  operator<<         (const char* text);
+      HumdrumWriter&  operator<<         (const string& text);
+      HumdrumWriter&  operator<<         (char character);
+      HumdrumWriter&  operator<<         (int value);
+      HumdrumWriter&  operator<<         (HumdrumRecord& record);
+      HumdrumWriter&  operator<<         (HumdrumFileBasic& infile);
+
+   protected:
+      ostream*        output;         // stream where the buffer is written
+      char*           buffer;         // text waiting to be written
+      int             capacity;       // allocated size of buffer
+      int             used;           // number of bytes in buffer
+      long long       bytecount;      // total number of bytes written
+      int             sharedQ;        // buffer is the thread's shared one
+
+   private:
+                      HumdrumWriter      (const HumdrumWriter& aWriter);
+      HumdrumWriter&  operator=          (const HumdrumWriter& aWriter);
+};
+
+
+#endif /* _HUMDRUMWRITER_H_INCLUDED */
+
+
+
@@ -3,6 +3,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed Mar 10 07:49:40 PST 2004
 // Last Modified: Sun Apr  4 23:17:36 PDT 2004
+// Last Modified: Sun Oct 18 15:59:53 PDT 2026 added parallel part parsing
 // Filename:      ...sig/include/sigInfo/MusicXmlFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/MusicXmlFile.h
 // Syntax:        C++
@@ -204,6 +205,7 @@ class MusicXmlFile {
       void       fixMidiAccidentals       (void);
       void       humdrumPart              (HumdrumFile& hfile, int staffno,
                                            int debugQ = 0);
+      void       humdrumPartText          (SSTREAM& out, int staffno);
       HumdrumFile& createHumdrumFile      (HumdrumFile& hfile);
       void      setOption                 (const char* key, int value);
       int       getOption                 (const char* key);
@@ -233,6 +235,10 @@ class MusicXmlFile {
       // parsing functions
       void      parse                     (void);
       void      traverse                  (CSL::XML::CXMLObject* entry);
+      void      parsePartsInParallel      (void);
+      void      preparePartState          (int partnum);
+      static int getLastDivisions         (CSL::XML::CXMLObject* part,
+                                           int divisions);
       void      process                   (CSL::XML::CXMLObject* entry);
       int       parseElement              (CSL::XML::CXMLObject* entry);
       void      parsePart                 (CSL::XML::CXMLObject* entry,
@@ -322,14 +328,17 @@ class MusicXmlFile {
       Array<int>                   partstaves; // list of staves in each part
       Array<int>                   partoffset; // starting staff of each part
       Array<Array<_MusicXmlItem> > partdata;   // part data by staff
-      int parsedivisions;     // used for global divisions in parsing input.
-      int parseserialnum;     // used for sorting items in parts.
-      int partvoiceticktime2; // used for adding null tokens to second
-                              // voice in spine.
-      int partvoiceticktime1; // used for adding interpreted rests in spine 1.
-      CSL::XML::CXMLObject* lastchordhead;
+      int parsedivisions;     // divisions carried from part to part.
+      Array<int> partdivisions; // current divisions while parsing each part.
+      Array<int> partserialnum; // used for sorting items in each part.
+      Array<CSL::XML::CXMLObject*> partchordhead; // last chord head in part
+      Array<CSL::XML::CXMLObject*> partjobs;  // <part> elements to parse
+      Array<int> partjobnum;                  // part numbers for partjobs
+      Array<int> partvoiceticktime2; // used for adding null tokens to second
+                                     // voice in spine (by staff).
+      Array<int> partvoiceticktime1; // used for adding interpreted rests in
+                                     // spine 1 (by staff).
       Array<int> partdynamics;  // used to identify if a part contains dynamics
-      int humline;              // used to print lyrics
 
       CSL::XML::XMLString getAttributeValue(CSL::XML::CXMLObject* object,
                       const char* name);
@@ -339,6 +348,7 @@ class MusicXmlFile {
       int humdrumBeam;      // 0 = don't encode beams, 1 = encode beams
       int humdrumDynamics;  // 0 = don't encode **dynam spines, 1 = do
       int humdrumLyrics;    // 0 = don't encode **text spines,  1 = do
+      int humdrumThreads;   // number of parts to convert at the same time
 };
 
 
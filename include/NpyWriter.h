@@ -0,0 +1,69 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 18:21:55 PDT 2026
+// Last Modified: Sun Oct 18 20:36:30 PDT 2026 Keep input paths in --npy-dir
+// Filename:      ...sig/include/sigInfo/NpyWriter.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/NpyWriter.h
+// Syntax:        C++
+//
+// Description:   Collects a two-dimensional numeric array one row at a
+//                time and writes it as a NumPy .npy file (version 1.0,
+//                little-endian, C order).  The data is stored in its
+//                binary form as it is added, so writing the array is a
+//                single bulk write after the header.
+//
+
+#ifndef _NPYWRITER_H_INCLUDED
+#define _NPYWRITER_H_INCLUDED
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define NPY_UINT8    1
+#define NPY_INT32    4
+#define NPY_FLOAT64  8
+
+
+class NpyWriter {
+   public:
+                      NpyWriter          (void);
+                      NpyWriter          (int type);
+                     ~NpyWriter          ();
+
+      void            clear              (void);
+      void            setType            (int type);
+      int             getType            (void);
+      int             getRowCount        (void);
+      int             getColumnCount     (void);
+
+      void            append             (int value);
+      void            append             (double value);
+      int             endRow             (void);
+
+      int             write              (ostream& out);
+      int             write              (const string& filename);
+
+      static string   makeFilename       (const string& directory,
+                                          const string& inputname,
+                                          int index);
+
+   protected:
+      int             datatype;         // NPY_UINT8, NPY_INT32, NPY_FLOAT64
+      vector<char>    data;             // array contents in .npy byte order
+      int             rows;             // number of completed rows
+      int             columns;          // length of each row
+      int             current;          // values in the current row
+      int             ragged;           // rows had different lengths
+
+      void            writeHeader        (ostream& out);
+      static void     makeDirectories    (const string& filename);
+};
+
+
+#endif /* _NPYWRITER_H_INCLUDED */
+
+
+
@@ -2,6 +2,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue May 11 21:54:37 PDT 2010
 // Last Modified: Tue May 11 21:54:41 PDT 2010
+// Last Modified: Sun Oct 18 16:06:58 PDT 2026 buffered parsing, FlateDecode
+// Last Modified: Sun Oct 18 21:45:19 PDT 2026 xref and object streams
 // Filename:      ...sig/include/sigInfo/PDFFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/PDFFile.h
 // Syntax:        C++
@@ -16,6 +18,8 @@
 
 #ifndef OLDCPP
    #include <iostream>
+   #include <map>
+   #include <string>
    #define SSTREAM stringstream
    #define CSTRING str().c_str()
    using namespace std;
@@ -47,8 +51,10 @@ class PDFFile {
       int        getRootIndex            (void);
       int        getXrefCount            (void);
       int        getXrefOffset           (int index);
+      int        hasXrefStream           (void);
       void       process                 (ifstream& file);
       void       process                 (istream& file);
+      void       process                 (const char* filename);
       void       print                   (ostream& out);
       int        getEmbeddedFileCount    (void);
       int        getEmbeddedFileObject   (int index);
@@ -57,11 +63,12 @@ class PDFFile {
       int        getObjectDictionary     (int objectindex, Array<char>& out);
       void       getEmbeddedFileContents (int embedindex, ostream& out);
       void       getEmbeddedFileContents (int embedindex, Array<char>& out);
+      int        getEmbeddedHumdrumFiles (ostream& out);
       void       getStreamData           (int streamobject, ostream& out);
       int        isEmbeddedHumdrumFile   (int index);
 
    private:
-      istream*           pdfdatastream;
+      Array<char>        pdfdata;         // contents of the PDF file
       Array<Array<int> > indirectobjectoffset;
       Array<Array<int> > indirectobjectversions;
       int                pdfdatasize;     // number of bytes in the file
@@ -69,15 +76,31 @@ class PDFFile {
       Array<int>         xref;            // list of xref table offsets
                                           // from most recent to oldest
       Array<int>         embedFile;       // list of embedded files
+      int                xrefstreamQ;     // true if xref streams are used
+      map<int, string>   objectstreams;   // uncompressed /ObjStm contents
 
    protected:
+      void       readData                (istream& file);
       void       initializeXrefTable     (void);
-      static int getXrefOffset           (istream& file);
-      void       buildIndirectObjectIndex(istream& file, int xrefoffset);
-      static int getPreviousOffset       (istream& file);
-      void       processXrefList         (istream& file, char firstdigit);
-      void       getOriginalTrailer      (SSTREAM& trailer, int filesize,
-                                          int xref, istream& file);
+      int        findStartXref           (void);
+      void       buildIndirectObjectIndex(int xrefoffset);
+      int        getPreviousOffset       (int trailerindex);
+      int        processXrefList         (int index);
+      void       processXrefStream       (int offset, int hybridQ = 0);
+      void       getStreamAt             (int offset, ostream& out);
+      int        getCompressedObject     (int objectindex, string& out);
+      void       getTrailerAt            (int xrefoffset, Array<char>& tstring);
+      int        getDictionaryEnd        (int offset, int& startindex);
+      static int findDictionaryEnd       (const char* data, int size,
+                                          int offset, int& startindex);
+      static void undoPredictor          (string& data, int columns);
+      int        findString              (const char* target, int startindex,
+                                          int endindex);
+      int        getIntegerObject        (int objectindex);
+      int        getEmbeddedStreamObject (const char* filedict);
+      static int isHumdrumDescription    (const char* filedict);
+      static void inflateData            (const char* data, int size,
+                                          ostream& out);
       void       expandObjectListing     (int newsize);
       void       makeEmbeddedFileList    (void);
 
@@ -0,0 +1,79 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 18:55:16 PDT 2026
+// Last Modified: Sun Oct 18 18:55:16 PDT 2026
+// Filename:      ...sig/include/sigInfo/Profiler.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/Profiler.h
+// Syntax:        C++
+//
+// Description:   Timers and counters for the phases of the library (file
+//                parsing, spine analysis, rhythm analysis, regular
+//                expressions, token conversions, array growth).  The
+//                PROFILE_SCOPE and PROFILE_COUNT macros are empty unless
+//                the library and programs are compiled with
+//                -DHUMEXTRA_PROFILE (make PROFILE=1).  The results are
+//                printed when a program exits if it was given the
+//                --profile option (handled by the Options class).
+//
+
+#ifndef _PROFILER_H_INCLUDED
+#define _PROFILER_H_INCLUDED
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+#define PROFILE_MAX  256     /* maximum number of timers and counters */
+
+
+class Profiler {
+   public:
+      static int      getId              (const char* name);
+      static void     addTime            (int id, long long nanoseconds);
+      static void     addCount           (int id, long long amount = 1);
+      static void     enter              (int id);
+      static int      leave              (int id);
+      static void     clear              (void);
+      static void     enableReport       (void);
+      static int      isCompiled         (void);
+      static ostream& printReport        (ostream& out);
+
+   protected:
+      static void     printReportAtExit  (void);
+};
+
+
+class ProfileTimer {
+   public:
+                      ProfileTimer       (int anId);
+                     ~ProfileTimer       ();
+
+   protected:
+      int                                id;
+      chrono::steady_clock::time_point   start;
+};
+
+
+#ifdef HUMEXTRA_PROFILE
+   #define PROFILE_JOIN2(a, b)  a##b
+   #define PROFILE_JOIN(a, b)   PROFILE_JOIN2(a, b)
+   // time the rest of the enclosing block:
+   #define PROFILE_SCOPE(name) \
+      static int PROFILE_JOIN(profile_id_, __LINE__) = Profiler::getId(name); \
+      ProfileTimer PROFILE_JOIN(profile_timer_, __LINE__)( \
+            PROFILE_JOIN(profile_id_, __LINE__))
+   // count an event:
+   #define PROFILE_COUNT(name) \
+      { static int profile_count_id_ = Profiler::getId(name); \
+        Profiler::addCount(profile_count_id_); }
+#else
+   #define PROFILE_SCOPE(name)
+   #define PROFILE_COUNT(name)
+#endif
+
+
+#endif /* _PROFILER_H_INCLUDED */
+
+
+
@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Dec 24 18:20:23 PST 2002
 // Last Modified: Mon Feb 10 17:08:20 PST 2003 (added voice-leading)
+// Last Modified: Sun Oct 18 16:29:47 PDT 2026 (added note-array calculate)
+// Last Modified: Sun Oct 18 17:44:07 PDT 2026 (added pitch-class histogram)
 // Filename:      ...sig/include/sigInfo/RootSpectrum.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/RootSpectrum.h
 // Syntax:        C++
@@ -95,6 +97,22 @@ class RootSpectrum {
       int         calculate        (IntervalWeight& distances,
                                     HumdrumFile& infile, int startline,
                                     int stopline, int debugQ = 0);
+      int         calculate        (IntervalWeight& distances,
+                                    Array<int>& pitches,
+                                    Array<double>& durations,
+                                    Array<double>& levels);
+
+      // functions for incremental (sliding-window) root scores
+      void        clearNotes       (void);
+      void        addNote          (int pitch, double duration,
+                                    double level);
+      void        removeNote       (int pitch, double duration,
+                                    double level);
+      int         getNoteCount     (void);
+      int         calculate        (IntervalWeight& distances);
+      static void scoreRoots       (double* scores, double* histogram,
+                                    double* weights, int offset = 0);
+
    private:
       Array <double> values;        // scores for each root.
       double         power;         // for scaling inverse scores
@@ -109,6 +127,8 @@ class RootSpectrum {
       double         durationBias;  // for duration log offset
       double         meterBias;     // for metric log offset
       double         nonresolutionscaling; // for non-harmonic penalty
+      Array <double> histogram;     // note weights for each pitch class
+      int            notecount;     // number of notes in histogram
 
       static int     minfloat       (const void* a, const void* b);
       double         durationscaling(double duration);
@@ -4,6 +4,8 @@
 // Creation Date: Thu Feb 14 23:40:51 PST 2002
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 Renamed SigCollection class
 // Last Modified: Sat Aug 25 18:20:06 PDT 2012 Renovated
+// Last Modified: Sun Oct 18 16:13:30 PDT 2026 Block reading, keyed sorting
+// Last Modified: Sun Oct 18 21:23:18 PDT 2026 Removed readFiles
 // Filename:      ...sig/src/sigInfo/ScorePageBase.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScorePageBase.h
 // Syntax:        C++
@@ -19,6 +21,7 @@
 #include "ScoreRecord.h"
 
 #include <iostream>
+#include <string>
 #include <vector>
 
 using namespace std;
@@ -97,12 +100,8 @@ class ScorePageBase {
       int            getItemIndexByPrintOrder   (int index);
 
    protected:
-      void           sortByHpos           (Array<int>& items);
-      void           quickSortByDataIndex (Array<int>& indexes, int starti,
-                                           int endi);
-
-      int            isGreater           (int a, int b);
-      int            isLess              (int a, int b);
+      static bool    isStaffKeyLess       (const ScoreSortKey& a,
+                                           const ScoreSortKey& b);
 
       //////////////////////////////
       //
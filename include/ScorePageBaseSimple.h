@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Thu Feb 14 23:40:51 PST 2002
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 (renamed SigCollection class)
+// Last Modified: Sun Oct 18 16:13:30 PDT 2026 (block reading, keyed sorting)
+// Last Modified: Sun Oct 18 21:23:18 PDT 2026 (added readFiles)
 // Filename:      ...sig/src/sigInfo/ScorePageBaseSimple.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScorePageBaseSimple.h
 // Syntax:        C++
@@ -16,6 +18,7 @@
 #include "ScoreRecord.h"
 
 #include <iostream>
+#include <string>
 #include <vector>
 
 using namespace std;
@@ -57,6 +60,9 @@ class ScorePageBaseSimple {
       void           readAscii         (const char* filename, int verboseQ = 0);
       void           readBinary        (const char* filename, int verboseQ = 0);
       void           readFile          (const char* filename, int verboseQ = 0);
+      static void    readFiles         (std::vector<ScorePageBaseSimple*>& pages,
+                                        const std::vector<std::string>& filenames,
+                                        int threads = 1, int verboseQ = 0);
       void           writeBinary       (const char* filename);
       void           writeBinary2Byte  (const char* filename);
       void           writeBinary4Byte  (const char* filename);
@@ -93,12 +99,13 @@ class ScorePageBaseSimple {
       float          readLittleFloat   (std::istream& instream);
       int            readLittleShort   (std::istream& input);
       static int     staffsearch       (const void* A, const void* B);
+      static bool    isStaffKeyLess    (const ScoreSortKey& a,
+                                        const ScoreSortKey& b);
       void           shrinkParameters  (void);
       void           initializeTrailer (long serial = 0x50504153);
       void           readAsciiScoreLine(std::istream& infile, ScoreRecord& record,
                                         int verboseQ = 0);
    public:
-      static int     compareStaff      (const void* A, const void* B);
       static int     compareSystem     (const void* A, const void* B);
 };
 
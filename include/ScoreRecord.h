@@ -5,6 +5,7 @@
 // Last Modified: Tue Feb 26 17:29:02 PST 2002
 // Last Modified: Tue Mar 26 09:56:28 PST 2002 Added parameter enums
 // Last Modified: Fri Aug 24 09:52:39 PDT 2012 Renovated
+// Last Modified: Sun Oct 18 16:13:30 PDT 2026 Added reading from memory
 // Filename:      ...sig/src/sigInfo/ScoreRecord.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScoreRecord.h
 // Syntax:        C++
@@ -61,6 +62,20 @@ typedef enum {
 } PARAM;
 
 
+// ScoreSortKey is used to sort SCORE items without touching the
+// items themselves: the sort parameters are copied into a compact
+// array of keys, the keys are sorted, and then the index of each
+// key gives the position of the item in the page data.
+class ScoreSortKey {
+   public:
+      int    staff;       // P2: staff number of item
+      double hpos;        // P3: horizontal position of item
+      int    type;        // P1: item code
+      double vpos;        // P4: vertical position of item
+      int    index;       // index of item in page data
+};
+
+
 class ScoreRecord : public ScoreParameters {
    public:
                      ScoreRecord           (void);
@@ -75,6 +90,8 @@ class ScoreRecord : public ScoreParameters {
       // Printing functions:
       int            writeBinary       (ostream& out);
       void           readBinary        (istream& instream, int pcount);
+      void           readBinary        (const float* data, const char* bytes,
+                                        int pcount);
       void           printAscii        (ostream& out, int roundQ = 1,
 		                        int verboseQ = 0,
                                         const char* indent = "");
@@ -288,6 +305,8 @@ class ScoreRecord : public ScoreParameters {
       static int     getMiddleCVpos    (ScoreRecord& arecord);
       static Array<char>& convertScoreTextToHtmlText(Array<char>& astring);
       static Array<char>& convertScoreTextToPlainText(Array<char>& astring);
+      static void    decodeLittleFloats(const char* bytes, float* output,
+                                        int count);
 
 
    protected:
@@ -6,6 +6,7 @@
 // Last Modified: Wed Mar 30 14:00:16 PST 2005 Fixed for compiling in GCC 3.4
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 renamed SigCollection class
 // Last Modified: Fri Aug 10 09:17:03 PDT 2012 added reverse()
+// Last Modified: Sun Oct 18 18:55:16 PDT 2026 added growth counter
 // Filename:      ...sig/maint/code/base/SigCollection/SigCollection.cpp
 // Web Address:   http://sig.sapp.org/src/sigBase/SigCollection.cpp
 // vim:           ts=3:nowrap
@@ -21,6 +22,7 @@
 #define _SIGCOLLECTION_CPP_INCLUDED
 
 #include "SigCollection.h"
+#include "Profiler.h"
 
 #include <cstdlib>
 #include <iostream>
@@ -198,6 +200,7 @@ void SigCollection<type>::append(type *element) {
 
 template<class type>
 void SigCollection<type>::grow(long growamt) {
+	PROFILE_COUNT("SigCollection::grow");
 	if (growamt <= 0) {
 		growamt = this->m_growthAmount;
 	}
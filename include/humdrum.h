@@ -5,6 +5,7 @@
 // Last Modified: Mon May 31 16:18:36 PDT 1999
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 Renamed SigCollection class
 // Last Modified: Fri Mar 29 23:28:32 PDT 2013 Added HumdrumFileSet.h
+// Last Modified: Sun Oct 18 19:28:24 PDT 2026 Added HumdrumWriter.h
 // Filename:      ...sig/include/sigInfo/humdrum.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/humdrum.h
 // Syntax:        C++
@@ -26,6 +27,7 @@
    #include "HumdrumFileSet.h"
    #include "humdrumfileextras.h"
    #include "HumdrumFileBasic.h"
+   #include "HumdrumWriter.h"
    #include "EnumerationData.h"
    #include "Enumeration.h"
    #include "Convert.h"
@@ -0,0 +1,541 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 18:40:54 PDT 2026
+// Last Modified: Sun Oct 18 18:40:54 PDT 2026
+// Filename:      ...sig/src/sigInfo/AnalysisPipeline.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/AnalysisPipeline.cpp
+// Syntax:        C++
+//
+// Description:   Calculates several line-by-line analyses of a HumdrumFile
+//                in a single pass through the lines of the file.
+//
+
+#include "AnalysisPipeline.h"
+#include "Convert.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+
+using namespace std;
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::AnalysisPipeline --
+//
+
+AnalysisPipeline::AnalysisPipeline(void) {
+	requested    = 0;
+	disabled     = 0;
+	defaulttempo = 60.0;
+	timingQ      = 0;
+	clear();
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::~AnalysisPipeline --
+//
+
+AnalysisPipeline::~AnalysisPipeline() {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::clear -- remove the requested analyses, the results
+//    and the timing counters.
+//
+
+void AnalysisPipeline::clear(void) {
+	requested = 0;
+	disabled  = 0;
+	runcount  = 0;
+	for (int i=0; i<ANALYSIS_COUNT; i++) {
+		times[i] = 0.0;
+	}
+	tempo.setSize(0);
+	metertop.setSize(0);
+	meterbottom.setSize(0);
+	beatdur.setSize(0);
+	metlev.setSize(0);
+	sonorities.setSize(0);
+	accentuation.setSize(0);
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::request -- add analyses (a combination of the
+//    ANALYSIS_* bits) to calculate.  Analyses which they depend on are
+//    also calculated.
+//
+
+void AnalysisPipeline::request(int analyses) {
+	requested |= analyses;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::disable -- do not calculate the given analyses,
+//    even if they were requested.  Analyses which depend on them are
+//    also disabled.
+//
+
+void AnalysisPipeline::disable(int analyses) {
+	disabled |= analyses;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getActive -- return the analyses which will be
+//    calculated by run(): the requested analyses and the analyses which
+//    they depend on, without the disabled analyses and the analyses
+//    which depend on them.
+//
+
+int AnalysisPipeline::getActive(void) {
+	int active = requested;
+	int i;
+	for (i=0; i<ANALYSIS_COUNT; i++) {
+		if (active & (1<<i)) {
+			active |= getDependencies(1<<i);
+		}
+	}
+	for (i=0; i<ANALYSIS_COUNT; i++) {
+		if (disabled & (1<<i)) {
+			active &= ~((1<<i) | getDependents(1<<i));
+		}
+	}
+	return active;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::setDefaultTempo -- the tempo to use before the first
+//    tempo marking (default 60.0, as in analyzeTempoMarkings()).
+//
+
+void AnalysisPipeline::setDefaultTempo(double atempo) {
+	defaulttempo = atempo;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::setTiming -- measure the time spent on each analysis.
+//    This slows down the analysis a little, so it is off by default.
+//
+
+void AnalysisPipeline::setTiming(int state) {
+	timingQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::run -- calculate the active analyses for a file.
+//    The rhythm analysis is done first if needed (and not already done
+//    for the file), then all other analyses are calculated one line at
+//    a time, with the analyses for each line in dependency order (meter
+//    before metric level).  Interpretation lines are searched once for
+//    both tempo and meter markings, and the sonority and accentuation
+//    analyses share the note list of each line.
+//
+
+void AnalysisPipeline::run(HumdrumFile& infile) {
+	int active = getActive();
+	int lines  = infile.getNumLines();
+	double start = 0.0;
+	runcount++;
+
+	if ((active & ANALYSIS_RHYTHM) && !infile.rhythmQ()) {
+		if (timingQ) { start = getCurrentTime(); }
+		infile.analyzeRhythm();
+		if (timingQ) { addTime(ANALYSIS_RHYTHM, start); }
+	}
+
+	int tempoQ   = active & ANALYSIS_TEMPO;
+	int meterQ   = active & (ANALYSIS_METER | ANALYSIS_BEATDURATION |
+			ANALYSIS_METRICLEVEL);
+	int levelQ   = active & ANALYSIS_METRICLEVEL;
+	int sonorityQ = active & ANALYSIS_SONORITY;
+	int accentQ  = active & ANALYSIS_ACCENTUATION;
+
+	tempo.setSize(tempoQ ? lines : 0);
+	metertop.setSize(meterQ ? lines : 0);
+	meterbottom.setSize(meterQ ? lines : 0);
+	beatdur.setSize(meterQ ? lines : 0);
+	metlev.setSize(levelQ ? lines : 0);
+	sonorities.setSize(sonorityQ ? lines : 0);
+	accentuation.setSize(accentQ ? lines : 0);
+	if (levelQ) {
+		metlev.setAll(0);
+	}
+
+	double lasttempo   = defaulttempo;
+	double goodtop     = -1.0;     // meter without compound adjustment
+	double goodbottom  = -1.0;
+	double compoundbottom = -1.0;  // beat duration for compound meters
+	int    testtop     = -1;
+	int    testbottom  = -1;
+	int    tempodone;
+	int    meterdone;
+	int    compound;
+	int    mval;
+	int    allnotes;
+	int    attacknotes;
+	Array<int> notes;
+	Array<int> attacks;
+	notes.setSize(32);
+	notes.setGrowth(32);
+	notes.setSize(0);
+	const char* token;
+
+	int line, j;
+	for (line=0; line<lines; line++) {
+		HumdrumRecord& record = infile[line];
+		int type = record.getType();
+
+		// tempo and meter markings
+		if ((tempoQ || meterQ) && (type == E_humrec_interpretation)) {
+			if (timingQ) { start = getCurrentTime(); }
+			tempodone = !tempoQ;
+			meterdone = !meterQ;
+			for (j=0; j<record.getFieldCount(); j++) {
+				if (tempodone && meterdone) {
+					break;
+				}
+				if (record.getExInterpNum(j) != E_KERN_EXINT) {
+					continue;
+				}
+				token = record[j];
+				if (token[0] != '*' || token[1] != 'M') {
+					continue;
+				}
+				if (!tempodone && (token[2] == 'M') &&
+						std::isdigit(token[3])) {
+					sscanf(token, "*MM%lf", &lasttempo);
+					tempodone = 1;
+				} else if (!meterdone && std::isdigit(token[2]) &&
+						(strchr(token, '/') != NULL)) {
+					if (sscanf(token, "*M%d/%d", &testtop, &testbottom) != 2) {
+						continue;
+					}
+					goodtop    = testtop;
+					goodbottom = 4.0/testbottom;
+					if ((testtop % 3 == 0) && (testtop != 3)) {
+						compoundbottom = 4.0/testbottom * 3.0;
+					} else {
+						compoundbottom = 4.0/testbottom;
+					}
+					meterdone = 1;
+				}
+			}
+			// the shared search is counted as tempo time if both are active
+			if (timingQ) { addTime(tempoQ ? ANALYSIS_TEMPO : ANALYSIS_METER,
+					start); }
+		}
+		if (tempoQ) {
+			tempo[line] = lasttempo;
+		}
+		if (meterQ) {
+			metertop[line]    = goodtop;
+			meterbottom[line] = goodbottom;
+			beatdur[line]     = compoundbottom;
+		}
+
+		// metric level of data lines
+		if (levelQ && (type == E_humrec_data)) {
+			if (timingQ) { start = getCurrentTime(); }
+			mval = (int)(goodtop * goodbottom + 0.45);
+			compound = (mval % 3) == 0 ? 1 : 0;
+			metlev[line] = HumdrumFile::calculateMetricLevel(record.getBeat(),
+					goodtop, goodbottom, compound);
+			if (timingQ) { addTime(ANALYSIS_METRICLEVEL, start); }
+		}
+
+		// sonority quality and attack accentuation
+		if (sonorityQ || (accentQ && (type == E_humrec_data))) {
+			if (timingQ) { start = getCurrentTime(); }
+			infile.getNoteList(notes, line, NL_NOPC | NL_FILL | NL_NOSORT |
+					NL_NOUNIQ | NL_NORESTS);
+			if (sonorityQ) {
+				Convert::noteSetToChordQuality(sonorities[line], notes);
+			}
+			// the shared note list is counted as sonority time if both are active
+			if (timingQ) { addTime(sonorityQ ? ANALYSIS_SONORITY :
+					ANALYSIS_ACCENTUATION, start); }
+		}
+		if (accentQ) {
+			if (type != E_humrec_data) {
+				accentuation[line] = 0;
+			} else {
+				if (timingQ) { start = getCurrentTime(); }
+				allnotes = notes.getSize();
+				infile.getNoteList(attacks, line, NL_NOPC | NL_NOFILL |
+						NL_NOSORT | NL_NOUNIQ | NL_NOTIED | NL_NORESTS);
+				attacknotes = attacks.getSize();
+				accentuation[line] = attacknotes - (allnotes - attacknotes);
+				if (timingQ) { addTime(ANALYSIS_ACCENTUATION, start); }
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getTempo -- tempo markings (like
+//     HumdrumFile::analyzeTempoMarkings()).
+//
+
+Array<double>& AnalysisPipeline::getTempo(void) {
+	return tempo;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getMeterTop -- top of the time signature (like
+//     the first array of HumdrumFile::analyzeMeter()).
+//
+
+Array<double>& AnalysisPipeline::getMeterTop(void) {
+	return metertop;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getMeterBottom -- duration of the time signature
+//     bottom in quarter notes (like the second array of
+//     HumdrumFile::analyzeMeter()).
+//
+
+Array<double>& AnalysisPipeline::getMeterBottom(void) {
+	return meterbottom;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getBeatDuration -- duration of the beat in quarter
+//     notes, with compound meters having dotted beats (like
+//     HumdrumFile::analyzeBeatDuration()).
+//
+
+Array<double>& AnalysisPipeline::getBeatDuration(void) {
+	return beatdur;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getMetricLevels -- metric levels of data lines (like
+//     HumdrumFile::analyzeMetricLevel()).
+//
+
+Array<int>& AnalysisPipeline::getMetricLevels(void) {
+	return metlev;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getSonorities -- chord quality of each line (like
+//     HumdrumFile::analyzeSonorityQuality()).
+//
+
+Array<ChordQuality>& AnalysisPipeline::getSonorities(void) {
+	return sonorities;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getAccentuation -- attack accentuation of each line
+//     (like HumdrumFile::analyzeAttackAccentuation()).
+//
+
+Array<int>& AnalysisPipeline::getAccentuation(void) {
+	return accentuation;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getTime -- return the total time in milliseconds
+//     spent on an analysis (one of the ANALYSIS_* bits) by run() since
+//     the last clear().  Only measured after setTiming() is turned on.
+//
+
+double AnalysisPipeline::getTime(int analysis) {
+	int index = getIndex(analysis);
+	if (index < 0) {
+		return 0.0;
+	}
+	return times[index];
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getRunCount -- return the number of times that run()
+//     was called since the last clear().
+//
+
+int AnalysisPipeline::getRunCount(void) {
+	return runcount;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::printTiming -- print the time spent on each active
+//     analysis as Humdrum global comments.
+//
+
+void AnalysisPipeline::printTiming(ostream& out) {
+	int active = getActive();
+	out << "!! analysis files:\t" << runcount << "\n";
+	for (int i=0; i<ANALYSIS_COUNT; i++) {
+		if (!(active & (1<<i))) {
+			continue;
+		}
+		out << "!! analysis time (ms) " << getName(1<<i) << ":\t"
+		    << times[i] << "\n";
+	}
+	out << flush;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getName -- return the name of an analysis.
+//
+
+const char* AnalysisPipeline::getName(int analysis) {
+	switch (analysis) {
+		case ANALYSIS_RHYTHM:       return "rhythm";
+		case ANALYSIS_TEMPO:        return "tempo";
+		case ANALYSIS_METER:        return "meter";
+		case ANALYSIS_BEATDURATION: return "beat-duration";
+		case ANALYSIS_METRICLEVEL:  return "metric-level";
+		case ANALYSIS_SONORITY:     return "sonority";
+		case ANALYSIS_ACCENTUATION: return "accentuation";
+	}
+	return "unknown";
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// AnalysisPipeline::getIndex -- return the index of an ANALYSIS_* bit,
+//     or -1 if not a single analysis.
+//
+
+int AnalysisPipeline::getIndex(int analysis) {
+	for (int i=0; i<ANALYSIS_COUNT; i++) {
+		if (analysis == (1<<i)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getDependencies -- return the analyses which must
+//     be done before the given analysis.
+//
+
+int AnalysisPipeline::getDependencies(int analysis) {
+	switch (analysis) {
+		case ANALYSIS_BEATDURATION: return ANALYSIS_METER;
+		case ANALYSIS_METRICLEVEL:  return ANALYSIS_METER | ANALYSIS_RHYTHM;
+	}
+	return 0;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getDependents -- return the analyses which cannot be
+//     done without the given analysis.
+//
+
+int AnalysisPipeline::getDependents(int analysis) {
+	int output = 0;
+	for (int i=0; i<ANALYSIS_COUNT; i++) {
+		if (getDependencies(1<<i) & analysis) {
+			output |= (1<<i);
+		}
+	}
+	return output;
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::addTime -- add the time since start to the
+//     timing counter of an analysis.
+//
+
+void AnalysisPipeline::addTime(int analysis, double start) {
+	int index = getIndex(analysis);
+	if (index >= 0) {
+		times[index] += getCurrentTime() - start;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// AnalysisPipeline::getCurrentTime -- return a time in milliseconds.
+//
+
+double AnalysisPipeline::getCurrentTime(void) {
+	chrono::duration<double, milli> now =
+			chrono::steady_clock::now().time_since_epoch();
+	return now.count();
+}
+
+
+
@@ -20,6 +20,8 @@
 // Last Modified: Sat Jan 22 17:13:36 PST 2011 (added kernToDurationNoDots)
 // Last Modified: Thu Jan 26 18:10:29 PST 2012 (fixed kotoToDurationR)
 // Last Modified: Sun Apr 29 10:01:44 PDT 2018 (convert const char* to strings)
+// Last Modified: Sun Oct 18 18:55:16 PDT 2026 (added profiling counters)
+// Last Modified: Sun Oct 18 19:35:04 PDT 2026 (added transposeKern())
 // Filename:      ...sig/src/sigInfo/Convert.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/Convert.cpp
 // Syntax:        C++
@@ -32,6 +34,7 @@
 #include "Convert.h"
 #include "HumdrumEnumerations.h"
 #include "PerlRegularExpression.h"
+#include "Profiler.h"
 
 #include <cctype>
 #include <cmath>
@@ -71,6 +74,7 @@ EnumerationInterval   Convert::intervalNames;
 //
 
 int Convert::kernToMidiNoteNumber(const string& aKernString) {
+	PROFILE_COUNT("Convert::kernToMidiNoteNumber");
 	int base40 = Convert::kernToBase40(aKernString);
 	if (base40 < 0 || base40 == E_unknown) {
 		return -1;
@@ -145,6 +149,7 @@ int Convert::kernToMidiNoteNumber(const string& aKernString) {
 string Convert::kernToScientificNotation(const string& kernfield,
 		const string& flat, const string& sharp, const string& doubleflat,
 		const string& doublesharp) {
+	PROFILE_COUNT("Convert::kernToScientificNotation");
 	int  ucount = 0;
 	int  lcount = 0;
 	int  scount = 0;
@@ -403,6 +408,7 @@ char* Convert::durationToKernRhythm(char* output, int outputMaxSize, double inpu
 //
 
 double Convert::kernToDurationNoDots(const string& aKernString) {
+	PROFILE_COUNT("Convert::kernToDurationNoDots");
 	RationalNumber value = Convert::kernToDurationNoDotsR(aKernString);
 	return value.getFloat();
 }
@@ -415,6 +421,7 @@ double Convert::kernToDurationNoDots(const string& aKernString) {
 //
 
 RationalNumber Convert::kernToDurationNoDotsR (const string& aKernString) {
+	PROFILE_COUNT("Convert::kernToDurationNoDotsR");
 	int dotcount = 0;
 	for (int i=0; i<(int)aKernString.size(); i++) {
 		if (aKernString[i] == '.') {
@@ -441,12 +448,14 @@ RationalNumber Convert::kernToDurationNoDotsR (const string& aKernString) {
 //
 
 double Convert::kernToDuration(const string& aKernString) {
+	PROFILE_COUNT("Convert::kernToDuration");
 	RationalNumber value = Convert::kernToDurationR(aKernString);
 	return value.getFloat();
 }
 
 
 RationalNumber Convert::kernToDurationR(const string& aKernString) {
+	PROFILE_COUNT("Convert::kernToDurationR");
 	RationalNumber zero(0,1);
 
 	PerlRegularExpression pre;
@@ -564,6 +573,7 @@ RationalNumber Convert::kernToDurationR(const string& aKernString) {
 //
 
 int Convert::kernToOctave(const string& buffer) {
+	PROFILE_COUNT("Convert::kernToOctave");
 	int upper = 0;
 	int lower = 0;
 	for (int i=0; i<(int)buffer.size(); i++) {
@@ -595,6 +605,7 @@ int Convert::kernToOctave(const string& buffer) {
 //
 
 int Convert::kernToDiatonicPitch(const string& buffer) {
+	PROFILE_COUNT("Convert::kernToDiatonicPitch");
 	return Convert::base40ToDiatonic(Convert::kernToBase40(buffer));
 }
 
@@ -606,6 +617,7 @@ int Convert::kernToDiatonicPitch(const string& buffer) {
 //
 
 int Convert::kernToDiatonicAlteration(const string& buffer) {
+	PROFILE_COUNT("Convert::kernToDiatonicAlteration");
 	int output = 0;
 	for (int i=0; i<(int)buffer.size(); i++) {
 		if (buffer[i] == 'n') {
@@ -707,6 +719,7 @@ int Convert::base40IntervalToDiatonic(int base40interval) {
 //
 
 int Convert::kernToDiatonicPitchClass(const string& buffer) {
+	PROFILE_COUNT("Convert::kernToDiatonicPitchClass");
 	int character;
 	for (int i=0; i<(int)buffer.size(); i++) {
 		character = tolower(buffer[i]);
@@ -740,6 +753,7 @@ int Convert::kernToDiatonicPitchClass(const string& buffer) {
 //
 
 int Convert::kernToDiatonicPitchClassNumeric(const string& buffer) {
+	PROFILE_COUNT("Convert::kernToDiatonicPitchClassNumeric");
 	int charval =  Convert::kernToDiatonicPitchClass(buffer);
 	switch (charval) {
 		case 'a': return  5;
@@ -1991,6 +2005,7 @@ int Convert::base40ToMidiNoteNumber(int base40value) {
 //
 
 int Convert::kernToBase40(const string& kernfield) {
+	PROFILE_COUNT("Convert::kernToBase40");
 	if (kernfield.empty()) {
 		return -1;
 	}
@@ -2029,6 +2044,7 @@ finishup:
 //
 
 int Convert::kernToBase40Class(const string& kernfield) {
+	PROFILE_COUNT("Convert::kernToBase40Class");
 	int absolute = kernToBase40(kernfield);
 	if (absolute >= 0) {
 		return absolute % 40;
@@ -2114,6 +2130,138 @@ int Convert::kernNoteToBase40(const string& name) {
 
 
 
+//////////////////////////////
+//
+// Convert::transposeKern -- transpose the pitches of a **kern token by
+//     a base-40 interval, storing the new token in output (which can be
+//     reused for each token to avoid reallocating it).  Each note of a
+//     chord is transposed.  Only the pitch name and its accidentals are
+//     rewritten; all other characters of the token are copied unchanged,
+//     as are rests and null tokens.  Returns 0 if a note contains more
+//     than one pitch name or is too low to be a pitch, otherwise 1.
+//
+
+int Convert::transposeKern(string& output, const char* kerntoken,
+		int transval) {
+	PROFILE_COUNT("Convert::transposeKern");
+	output.clear();
+	const char* ptr = kerntoken;
+	const char* start;
+	const char* pitch;
+	const char* end;
+	const char* p;
+	int restQ;
+	int base40;
+	int count;
+
+	while (1) {
+		// find the extent of the next note and the start of its pitch
+		start = ptr;
+		pitch = NULL;
+		restQ = 0;
+		while ((*ptr != '\0') && (*ptr != ' ')) {
+			if (*ptr == 'r') {
+				restQ = 1;
+			} else if ((pitch == NULL) && (strchr("ABCDEFGabcdefg", *ptr) != NULL)) {
+				pitch = ptr;
+			}
+			ptr++;
+		}
+
+		if (restQ || (pitch == NULL)) {
+			output.append(start, ptr - start);
+		} else {
+			// calculate the pitch in the same way as kernNoteToBase40()
+			switch (*pitch) {
+				case 'a': case 'A': base40 = E_root_a; break;
+				case 'b': case 'B': base40 = E_root_b; break;
+				case 'c': case 'C': base40 = E_root_c; break;
+				case 'd': case 'D': base40 = E_root_d; break;
+				case 'e': case 'E': base40 = E_root_e; break;
+				case 'f': case 'F': base40 = E_root_f; break;
+				default:            base40 = E_root_g; break;
+			}
+			count = 1;
+			while ((pitch + count < ptr) && (pitch[count] == pitch[0])) {
+				count++;
+			}
+			if (islower(*pitch)) {
+				base40 += (3 + count) * 40;
+			} else {
+				base40 += (4 - count) * 40;
+			}
+			for (p=pitch+count; (p < ptr) && (p < pitch+count+2); p++) {
+				if (*p == '-') {
+					base40--;
+				} else if (*p == '#') {
+					base40++;
+				}
+			}
+			if (base40 < 0) {
+				return 0;
+			}
+
+			// the pitch name is replaced along with any accidentals after it
+			end = pitch;
+			while ((end < ptr) && (strchr("ABCDEFGabcdefg#-n", *end) != NULL)) {
+				end++;
+			}
+			for (p=end; p<ptr; p++) {
+				if (strchr("ABCDEFGabcdefg", *p) != NULL) {
+					return 0;
+				}
+			}
+
+			output.append(start, pitch - start);
+			output.append(getKernSpelling(base40 + transval));
+			output.append(end, ptr - end);
+		}
+
+		if (*ptr == '\0') {
+			break;
+		}
+		output += ' ';
+		ptr++;
+	}
+
+	return 1;
+}
+
+
+
+//////////////////////////////
+//
+// Convert::getKernSpelling -- return the **kern spelling of a base-40
+//     pitch.  The spellings for the usual range of pitches are calculated
+//     once by base40ToKern() and then looked up.
+//
+
+static vector<string> makeKernSpellings(void) {
+	vector<string> spellings(40 * 16);
+	char buffer[1024] = {0};
+	for (int i=0; i<(int)spellings.size(); i++) {
+		spellings[i] = Convert::base40ToKern(buffer, 1024, i);
+	}
+	return spellings;
+}
+
+
+const string& Convert::getKernSpelling(int base40) {
+	static const vector<string> spellings = makeKernSpellings();
+
+	if ((base40 >= 0) && (base40 < (int)spellings.size())) {
+		return spellings[base40];
+	}
+
+	// outside of the table (or an invalid pitch):
+	static thread_local string other;
+	char buffer[1024] = {0};
+	other = base40ToKern(buffer, 1024, base40);
+	return other;
+}
+
+
+
 //////////////////////////////
 //
 // Convert::transToBase40 -- convert the Humdrum Toolkit program
@@ -0,0 +1,515 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 18:32:36 PDT 2026
+// Last Modified: Sun Oct 18 18:32:36 PDT 2026
+// Filename:      ...sig/src/sigInfo/CorpusWalker.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/CorpusWalker.cpp
+// Syntax:        C++
+//
+// Description:   Collects the files of a corpus and processes them with
+//                a pool of worker processes, printing the output of each
+//                file in the order of the file list.
+//
+
+#include "CorpusWalker.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+
+//////////////////////////////
+//
+// CorpusWalker::CorpusWalker --
+//
+
+CorpusWalker::CorpusWalker(void) {
+	recursiveQ = 0;
+	hiddenQ    = 0;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::~CorpusWalker --
+//
+
+CorpusWalker::~CorpusWalker() {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::clear -- remove the file list and the filters.
+//
+
+void CorpusWalker::clear(void) {
+	files.clear();
+	extensions.clear();
+	mask.clear();
+	recursiveQ = 0;
+	hiddenQ    = 0;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::setRecursive -- process subdirectories of directories
+//    given to addPath().  The default is to read only the files in the
+//    directory.
+//
+
+void CorpusWalker::setRecursive(int state) {
+	recursiveQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::setHidden -- include files and subdirectories which
+//    start with "." when reading directories.  The default is to skip them.
+//
+
+void CorpusWalker::setHidden(int state) {
+	hiddenQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::addExtension -- only accept files which end with the
+//    given string (such as ".krn").  Can be called more than once to
+//    accept several endings.  The comparison is case-sensitive.
+//
+
+void CorpusWalker::addExtension(const string& extension) {
+	extensions.push_back(extension);
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::setMask -- only accept files which contain the given
+//    string in their names.
+//
+
+void CorpusWalker::setMask(const string& amask) {
+	mask = amask;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::addPath -- add a file or the contents of a directory to
+//    the file list.  Directory contents are sorted by name.  Returns the
+//    number of files which were added.
+//
+
+int CorpusWalker::addPath(const string& path) {
+	int oldcount = (int)files.size();
+	if (isDirectory(path)) {
+		addDirectory(path);
+	} else if (isFile(path)) {
+		if (isValidName(path)) {
+			files.push_back(path);
+		}
+	}
+	return (int)files.size() - oldcount;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::addFile -- add a file to the list without checking it
+//    or its name.
+//
+
+void CorpusWalker::addFile(const string& filename) {
+	files.push_back(filename);
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::getFileCount --
+//
+
+int CorpusWalker::getFileCount(void) {
+	return (int)files.size();
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::getFile --
+//
+
+const string& CorpusWalker::getFile(int index) {
+	return files[index];
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::getFileList --
+//
+
+const vector<string>& CorpusWalker::getFileList(void) {
+	return files;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::run -- call the function for each file in the list.
+//    If jobs is larger than one, up to that many files are processed at
+//    the same time, each one in a separate process.  A value of 0 or less
+//    will use one job per processor.  Since the files are processed in
+//    separate processes, the function cannot store results in variables
+//    of the calling program, and it should print its results to standard
+//    output, which is then printed in the order of the file list.  If the
+//    function exits the program while processing a file, the remaining
+//    files are stopped and the program exits with the same status after
+//    printing the output of the files before it, just as when the files
+//    are processed one at a time (although a few of the files after it
+//    may have already been processed).
+//
+
+void CorpusWalker::run(CorpusFunction function, void* userdata, int jobs) {
+	if (jobs <= 0) {
+		jobs = getProcessorCount();
+	}
+	if (jobs > (int)files.size()) {
+		jobs = (int)files.size();
+	}
+	if (jobs <= 1) {
+		for (int i=0; i<(int)files.size(); i++) {
+			function(i, files[i], userdata);
+		}
+		return;
+	}
+	runParallel(function, userdata, jobs);
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::getProcessorCount -- return the number of online
+//     processors.
+//
+
+int CorpusWalker::getProcessorCount(void) {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count < 1) {
+		return 1;
+	}
+	return (int)count;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::isFile -- returns true if the path is a regular file.
+//
+
+int CorpusWalker::isFile(const string& path) {
+	struct stat filestat;
+	if (stat(path.c_str(), &filestat)) {
+		return 0;
+	}
+	return S_ISREG(filestat.st_mode);
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::isDirectory -- returns true if the path is a directory.
+//
+
+int CorpusWalker::isDirectory(const string& path) {
+	struct stat filestat;
+	if (stat(path.c_str(), &filestat)) {
+		return 0;
+	}
+	return S_ISDIR(filestat.st_mode);
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// CorpusWalker::isValidName -- returns true if the filename matches
+//     the extension and mask filters.
+//
+
+int CorpusWalker::isValidName(const string& name) {
+	string base = name;
+	size_t pos = base.rfind('/');
+	if (pos != string::npos) {
+		base = base.substr(pos+1);
+	}
+
+	if (!mask.empty() && (base.find(mask) == string::npos)) {
+		return 0;
+	}
+	if (extensions.empty()) {
+		return 1;
+	}
+	for (int i=0; i<(int)extensions.size(); i++) {
+		if (base.size() < extensions[i].size()) {
+			continue;
+		}
+		if (base.compare(base.size() - extensions[i].size(),
+				extensions[i].size(), extensions[i]) == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::addDirectory -- add the files in a directory in sorted
+//     order, descending into subdirectories if recursive.
+//
+
+void CorpusWalker::addDirectory(const string& path) {
+	DIR* dir = opendir(path.c_str());
+	if (dir == NULL) {
+		return;
+	}
+	vector<string> names;
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		if ((strcmp(entry->d_name, ".") == 0) ||
+				(strcmp(entry->d_name, "..") == 0)) {
+			continue;
+		}
+		if (!hiddenQ && (entry->d_name[0] == '.')) {
+			continue;
+		}
+		names.push_back(entry->d_name);
+	}
+	closedir(dir);
+
+	sort(names.begin(), names.end());
+
+	string prefix = path;
+	if (prefix.empty() || (prefix[prefix.size()-1] != '/')) {
+		prefix += '/';
+	}
+	string fullname;
+	for (int i=0; i<(int)names.size(); i++) {
+		fullname = prefix + names[i];
+		if (isDirectory(fullname)) {
+			if (recursiveQ) {
+				addDirectory(fullname);
+			}
+		} else if (isFile(fullname) && isValidName(names[i])) {
+			files.push_back(fullname);
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::runParallel -- process each file in a child process
+//     which writes its standard output into a pipe.  The output of the
+//     first unfinished file is printed as it arrives, and the output of
+//     later files is stored until all of the files before it are done.
+//
+
+void CorpusWalker::runParallel(CorpusFunction function, void* userdata,
+		int jobs) {
+
+	int count = (int)files.size();
+	vector<pid_t>  pids(count, -1);
+	vector<int>    pipes(count, -1);
+	vector<int>    done(count, 0);
+	vector<int>    statuses(count, 0);
+	vector<string> outputs(count);
+	vector<struct pollfd> polls;
+	vector<int>    pollindex;
+	char buffer[0x10000];
+
+	int next     = 0;    // next file to start
+	int head     = 0;    // next file to print
+	int running  = 0;
+	int i, status;
+	ssize_t length;
+	int fds[2];
+
+	while (head < count) {
+		// limit how far ahead of the printed output the jobs can run,
+		// since the output of later files is stored in memory
+		while ((running < jobs) && (next < count) &&
+				(next - head < jobs * 4)) {
+			// flush so that children do not print the parent's buffers
+			cout.flush();
+			fflush(NULL);
+			if (pipe(fds) != 0) {
+				cerr << "Error: cannot create pipe for " << files[next] << endl;
+				exit(1);
+			}
+			pid_t pid = fork();
+			if (pid < 0) {
+				cerr << "Error: cannot create process for " << files[next] << endl;
+				exit(1);
+			}
+			if (pid == 0) {
+				close(fds[0]);
+				for (i=head; i<next; i++) {
+					if (pipes[i] >= 0) {
+						close(pipes[i]);
+					}
+				}
+				dup2(fds[1], STDOUT_FILENO);
+				close(fds[1]);
+				function(next, files[next], userdata);
+				cout.flush();
+				fflush(NULL);
+				_exit(0);
+			}
+			close(fds[1]);
+			pids[next]  = pid;
+			pipes[next] = fds[0];
+			running++;
+			next++;
+		}
+
+		polls.resize(0);
+		pollindex.resize(0);
+		for (i=head; i<next; i++) {
+			if (pipes[i] < 0) {
+				continue;
+			}
+			struct pollfd item;
+			item.fd      = pipes[i];
+			item.events  = POLLIN;
+			item.revents = 0;
+			polls.push_back(item);
+			pollindex.push_back(i);
+		}
+		if (polls.empty()) {
+			break;
+		}
+		if (poll(polls.data(), polls.size(), -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			cerr << "Error: poll failed while processing files" << endl;
+			exit(1);
+		}
+
+		for (int p=0; p<(int)polls.size(); p++) {
+			if (polls[p].revents == 0) {
+				continue;
+			}
+			i = pollindex[p];
+			length = read(pipes[i], buffer, sizeof(buffer));
+			if (length > 0) {
+				if (i == head) {
+					cout.write(buffer, length);
+				} else {
+					outputs[i].append(buffer, length);
+				}
+				continue;
+			}
+			if ((length < 0) && (errno == EINTR)) {
+				continue;
+			}
+			// end of output: collect the child process
+			close(pipes[i]);
+			pipes[i] = -1;
+			status = 0;
+			while ((waitpid(pids[i], &status, 0) < 0) && (errno == EINTR)) {
+				// try again
+			}
+			if (!WIFEXITED(status)) {
+				statuses[i] = 1;
+			} else {
+				statuses[i] = WEXITSTATUS(status);
+			}
+			done[i] = 1;
+			running--;
+		}
+
+		// print stored output of files which can now be printed
+		while ((head < count) && done[head]) {
+			if (statuses[head] != 0) {
+				stopJobs(pids, pipes, head+1, next);
+				cout.flush();
+				exit(statuses[head]);
+			}
+			head++;
+			if (head < next) {
+				cout.write(outputs[head].data(), outputs[head].size());
+				outputs[head].clear();
+			}
+		}
+		cout.flush();
+	}
+}
+
+
+
+//////////////////////////////
+//
+// CorpusWalker::stopJobs -- stop the child processes of the files
+//     from start to end-1 which are still running.
+//
+
+void CorpusWalker::stopJobs(vector<pid_t>& pids, vector<int>& pipes,
+		int start, int end) {
+	for (int i=start; i<end; i++) {
+		if (pipes[i] < 0) {
+			continue;
+		}
+		kill(pids[i], SIGTERM);
+		close(pipes[i]);
+		pipes[i] = -1;
+		while ((waitpid(pids[i], NULL, 0) < 0) && (errno == EINTR)) {
+			// try again
+		}
+	}
+}
+
+
+
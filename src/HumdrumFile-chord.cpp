@@ -4,6 +4,7 @@
 // Creation Date: Mon May 14 12:26:45 PDT 2001
 // Last Modified: Tue May 15 11:23:21 PDT 2001
 // Last Modified: Sun Mar 24 12:10:00 PST 2002 (small changes for visual c++)
+// Last Modified: Sun Oct 18 17:44:07 PDT 2026 (pitch-class histogram scoring)
 // Filename:      ...sig/src/sigInfo/HumdrumFile-chord.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFile.cpp
 // Syntax:        C++
@@ -12,6 +13,7 @@
 //
 
 #include "HumdrumFile.h"
+#include "RootSpectrum.h"
 #include "humdrumfileextras.h"
 #include "Convert.h"
 
@@ -119,25 +121,33 @@ int HumdrumFile::measureChordRoot1(Array<double>& scores,
 	scores.setSize(40);
 	scores.zero();
 
-	int i, j;
-	int p;
+	int i;
 	int count = notelist.getSize();
-	double asum, bsum;
-	double I;
 	int max = 0;
 
-// cout << "Notelist size is: " << notelist.getSize() << endl;
-// cout << "Scores size is: " << scores.getSize() << endl;
+	// The interval distances depend only on the interval between the
+	// root and the note, and the duration and metric level weights
+	// depend only on the note, so sum the note weights for each pitch
+	// class and then score all roots from the pitch-class sums.
+	double I[40];
+	for (i=0; i<40; i++) {
+		I[i] = sqrt(alpha * alpha * vx[i] * vx[i] + vy[i] * vy[i]);
+	}
+	double durhist[40] = {0.0};
+	double levhist[40] = {0.0};
+	int pc;
+	for (i=0; i<count; i++) {
+		pc = notelist[i].getPitch() % 40;
+		durhist[pc] += delta + log2(notelist[i].getDur());
+		levhist[pc] += lambda + log2(notelist[i].getLevel());
+	}
+	double asum[40] = {0.0};
+	double bsum[40] = {0.0};
+	RootSpectrum::scoreRoots(asum, durhist, I, 2);
+	RootSpectrum::scoreRoots(bsum, levhist, I, 2);
 
 	for (i=0; i<40; i++) {
-		asum = bsum = 0.0;
-		for (j=0; j<count; j++) {
-			p = (notelist[j].getPitch() - i - 2 + 40) % 40;
-			I = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
-			asum += I * (delta + log(notelist[j].getDur())/log(2.0));
-			bsum += I * (lambda + log(notelist[j].getLevel())/log(2.0));
-		}
-		scores[i] = sqrt(asum * asum + bsum * bsum)/count;
+		scores[i] = sqrt(asum[i] * asum[i] + bsum[i] * bsum[i])/count;
 		if (scores[i] < scores[max]) {
 			max = i;
 		}
@@ -195,38 +205,42 @@ int HumdrumFile::measureChordRoot2(Array<double>& scores,
 	scores.setSize(40);
 	scores.zero();
 
-	int i, j;
-	int p;
+	int i;
 	int count = notelist.getSize();
-	double asum, bsum;
-	double I;
 	int max = 0;
 
+	// log-scale duration and metric level of each note:
+	Array<double> logdur(count);
+	Array<double> loglev(count);
 	double offset = 0.0;
-	double testv;
-	for (i=0; i<notelist.getSize(); i++) {
-		testv = -log(notelist[i].getDur())/log(2.0);
-		if (testv > offset) {
-			offset = testv;
+	for (i=0; i<count; i++) {
+		logdur[i] = log2(notelist[i].getDur());
+		loglev[i] = log2(notelist[i].getLevel());
+		if (-logdur[i] > offset) {
+			offset = -logdur[i];
 		}
-		testv = -log(notelist[i].getLevel())/log(2.0);
-		if (testv > offset) {
-			offset = testv;
+		if (-loglev[i] > offset) {
+			offset = -loglev[i];
 		}
 	}
 	offset = offset * 2;
 
-// cout << "Notelist size is: " << notelist.getSize() << endl;
-// cout << "Scores size is: " << scores.getSize() << endl;
+	// sum the note weights for each pitch class, then score all roots
+	// from the pitch-class sums (see measureChordRoot1).
+	double I[40];
 	for (i=0; i<40; i++) {
-		asum = bsum = 0.0;
-		for (j=0; j<count; j++) {
-			p = (notelist[j].getPitch() - 2 - i + 40) % 40;
-			I = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
-			asum += I * delta * (offset + log(notelist[j].getDur())/log(2.0));
-			bsum += I * lambda * (offset + log(notelist[j].getLevel())/log(2.0));
-		}
-		scores[i] = (asum + bsum)/count;
+		I[i] = sqrt(alpha * alpha * vx[i] * vx[i] + vy[i] * vy[i]);
+	}
+	double histogram[40] = {0.0};
+	for (i=0; i<count; i++) {
+		histogram[notelist[i].getPitch() % 40] +=
+				delta * (offset + logdur[i]) + lambda * (offset + loglev[i]);
+	}
+	double sum[40] = {0.0};
+	RootSpectrum::scoreRoots(sum, histogram, I, 2);
+
+	for (i=0; i<40; i++) {
+		scores[i] = sum[i]/count;
 		if (scores[i] < scores[max]) {
 			max = i;
 		}
@@ -360,17 +374,17 @@ void HumdrumFile::generateNoteList(NoteListArray& notelist,
 		startLine = temp;
 	}
 
-	// estimate the largest amount necessary:
-	notelist.setSize(score.getNumLines() * score.getMaxTracks() * 10);
-	notelist.setGrowth(score.getNumLines());
+	// estimate the largest amount necessary for the region:
+	int linecount = endLine - startLine + 1;
+	notelist.setSize(linecount * score.getMaxTracks() * 4 + 32);
+	notelist.setGrowth(linecount + 32);
 	notelist.setSize(0);
 	notelist.allowGrowth(1);
 
 	NoteList currentlist;
 	currentlist.clear();
 
-	Array<int> scorelevels;
-	score.analyzeMetricLevel(scorelevels);
+	Array<int>& scorelevels = getMetricLevels();
 
 	int firsttime = 1;
 	int i, j, k;
@@ -0,0 +1,500 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 16:29:47 PDT 2026
+// Last Modified: Sun Oct 18 16:29:47 PDT 2026
+// Filename:      ...sig/src/sigInfo/HumdrumFile-melisma.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFile-melisma.cpp
+// Syntax:        C++
+// Reference:     http://bobo.link.cs.cmu.edu/music-analysis
+//
+// Description:   Melisma Music Analyzer style functions for the
+//                HumdrumFile class: conversion of **kern data into
+//                Melisma note lists (formerly done only in the
+//                kern2melisma program), and a beat-segmented chord-root
+//                analysis which replaces the external meter/harmony
+//                programs used by tsroot.
+//
+
+#include "HumdrumFile.h"
+#include "RootSpectrum.h"
+#include "IntervalWeight.h"
+#include "Convert.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+
+using namespace std;
+
+
+//////////////////////////////
+//
+// HumdrumFile::printMelismaNotes -- print the **kern data in the file
+//   as a Melisma note list (one "Note <on-ms> <off-ms> <key>" line for
+//   each note attack), along with Comment, Reference and Info lines
+//   for global comments, bibliographic records, key signatures, keys
+//   and tempo markings.  One small bug: the durations of notes are
+//   calculated under constant tempo, so a tempo change during a tied
+//   note will not give the correct ending point of the note.
+//     default value: tdefault = 60.0;
+//     default value: classQ = 0;
+//
+
+ostream& HumdrumFile::printMelismaNotes(ostream& out, double tdefault,
+		int classQ) {
+	HumdrumFile& hfile = *this;
+	if (!rhythmQ()) {
+		analyzeRhythm("4");
+	}
+
+	Array<double> tempo;
+	hfile.analyzeTempoMarkings(tempo, tdefault);
+
+	double currentmillisecond = 0.0;
+	double lastduration = 0.0;
+	double endmillisecond;
+
+	int i, j, k;
+	char buffer[1024] = {0};
+	double duration;
+	for (i=0; i<hfile.getNumLines(); i++) {
+		currentmillisecond = currentmillisecond +
+				lastduration * 60000.0 / tempo[i];
+		lastduration = hfile[i].getDuration();
+
+		if (hfile[i].getType() == E_humrec_global_comment) {
+			out << "Comment\t" << &(hfile[i].getLine()[3]) << endl;
+		}
+
+		if (hfile[i].getType() == E_humrec_bibliography) {
+			out << "Reference " << &(hfile[i].getLine()[3]) << endl;
+		}
+
+		if (hfile[i].getType() == E_humrec_interpretation) {
+			printMelismaInfo(out, hfile[i]);
+		}
+
+		if (hfile[i].getType() != E_humrec_data) {
+			continue;
+		}
+
+		for (j=0; j<hfile[i].getFieldCount(); j++) {
+			if (hfile[i].getExInterpNum(j) != E_KERN_EXINT) {
+				continue;
+			}
+			if (strcmp(hfile[i][j], ".") == 0) {
+				continue;
+			}
+
+			for (k=0; k<hfile[i].getTokenCount(j); k++) {
+				hfile[i].getToken(buffer, j, k, 1024);
+				if (strchr(buffer, '_') != NULL) {
+					// ignore notes which are tied
+					continue;
+				}
+				if (strchr(buffer, ']') != NULL) {
+					// ignore notes which are tied
+					continue;
+				}
+
+				int note = Convert::kernToMidiNoteNumber(buffer);
+				if (note < 0) {
+					// don't display rests.
+					continue;
+				}
+				if (classQ) {
+					note = note % 12;
+				}
+				duration = hfile.getTiedDuration(i, j, k);
+
+				out << "Note\t";
+				out << (int)(currentmillisecond+0.5) << "\t";
+
+				endmillisecond = currentmillisecond + duration * 60000 / tempo[i];
+				if (int(endmillisecond+0.5) == int(currentmillisecond+0.5)) {
+					// give grace notes 1 millisecond duration...
+					out << (int)(endmillisecond+0.5)+1 << "\t";
+				} else {
+					out << (int)(endmillisecond+0.5) << "\t";
+				}
+
+				out << note;
+				out << "\n";
+			}
+		}
+	}
+
+	return out;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::printMelismaInfo -- print the Info lines for key
+//    signatures, keys and tempo markings in an interpretation record.
+//
+
+void HumdrumFile::printMelismaInfo(ostream& out, HumdrumRecord& record) {
+	int j;
+
+	// look for key signatures
+	for (j=0; j<record.getFieldCount(); j++) {
+		if (record.getExInterpNum(j) != E_KERN_EXINT) {
+			continue;
+		}
+		if (strncmp(record[j], "*k[", 3) != 0) {
+			continue;
+		}
+		int direction = 0;
+		if (strchr(record[j], '-') != NULL) {
+			direction = -1;
+		} else if (strchr(record[j], '#') != NULL) {
+			direction = 1;
+		}
+		int acount = ((int)strlen(record[j]) - 4)/2;
+		if (direction == 0) {
+			out << "Info keysig no accidentals" << endl;
+		} else {
+			out << "Info keysig " << acount;
+			if (acount < 0) {
+				out << " flat";
+			} else {
+				out << " sharp";
+			}
+			if (acount > 1) {
+				out << "s";
+			}
+			out << endl;
+		}
+		break;
+	}
+
+	// look for key interpretations
+	for (j=0; j<record.getFieldCount(); j++) {
+		if (record.getExInterpNum(j) != E_KERN_EXINT) {
+			continue;
+		}
+		int length = strlen(record[j]);
+		if (length < 3 || length > 4) {
+			continue;
+		}
+		if (record[j][length-1] != ':') {
+			continue;
+		}
+		out << "Info key ";
+		out << (char)toupper(record[j][1]);
+		if (record[j][2] == '-') {
+			out << "-flat";
+		}
+		if (record[j][2] == '#') {
+			out << "-sharp";
+		}
+		if (islower(record[j][1])) {
+			out << " Minor";
+		} else {
+			out << " Major";
+		}
+		out << endl;
+		break;
+	}
+
+	// look for tempo markings
+	for (j=0; j<record.getFieldCount(); j++) {
+		if (record.getExInterpNum(j) != E_KERN_EXINT) {
+			continue;
+		}
+		double tempomark = 0.0;
+		if (strncmp(record[j], "*MM", 3) == 0 && isdigit(record[j][3])) {
+			sscanf(record[j], "*MM%lf", &tempomark);
+			out << "Info Tempo " << tempomark << " MM per quarter note"
+			    << endl;
+			break;
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::analyzeMelismaRoots -- chord-root analysis in the
+//    manner of the Temperley/Sleator harmony program.  The music is
+//    divided into beat-length segments (the meter analysis), and each
+//    segment is given a root score for all 40 base-40 roots using
+//    RootSpectrum.  Notes which are sustained into a segment are
+//    included with the portion of their duration which falls in the
+//    segment.  The roots of the segments are then chosen together so
+//    that the sum of the segment scores plus a penalty for each change
+//    of root is minimized.  The change penalty is scaled by
+//    changeweight and is halved for each metric level above the beat,
+//    so that root changes are preferred on strong beats.
+//
+//    The roots array is filled with one base-40 pitch class per line
+//    of the file, or -1 for lines which are not data or which are in a
+//    segment with no sounding notes.  Returns the number of segments.
+//    The file is not modified (other than rhythm analysis), so separate
+//    HumdrumFiles can be analyzed in separate threads.
+//       default value: changeweight = 1.0
+//       default value: debug = 0
+//
+
+int HumdrumFile::analyzeMelismaRoots(Array<int>& roots, double changeweight,
+		int debug) {
+	HumdrumFile& infile = *this;
+	if (!rhythmQ()) {
+		analyzeRhythm("4");
+	}
+
+	roots.setSize(infile.getNumLines());
+	roots.setAll(-1);
+
+	Array<int> metlev;
+	infile.analyzeMetricLevel(metlev);
+
+	int i, j, k, s;
+
+	// (1) find the beat segments: each data line which is on the beat
+	// (or at a stronger metric position) starts a new segment.
+	Array<int>    segline;
+	Array<double> segbeat;
+	Array<int>    linesegment(infile.getNumLines());
+	segline.setSize(0);
+	segline.setGrowth(1000);
+	segbeat.setSize(0);
+	segbeat.setGrowth(1000);
+	linesegment.setAll(-1);
+	double absbeat;
+	for (i=0; i<infile.getNumLines(); i++) {
+		if (!infile[i].isData()) {
+			continue;
+		}
+		absbeat = infile[i].getAbsBeat();
+		if ((segline.getSize() == 0) || ((metlev[i] <= 0) &&
+				(absbeat > segbeat[segbeat.getSize()-1] + 0.0001))) {
+			segline.append(i);
+			segbeat.append(absbeat);
+		}
+		linesegment[i] = segline.getSize() - 1;
+	}
+	int segcount = segline.getSize();
+	if (segcount == 0) {
+		return 0;
+	}
+	Array<double> segend(segcount);
+	for (s=0; s<segcount-1; s++) {
+		segend[s] = segbeat[s+1];
+	}
+	segend[segcount-1] = infile.getTotalDuration();
+
+	// (2) distribute the notes into the segments which they sound in.
+	Array<Array<int> >    pitches(segcount);
+	Array<Array<double> > durations(segcount);
+	Array<Array<double> > levels(segcount);
+	for (s=0; s<segcount; s++) {
+		pitches[s].setSize(0);
+		durations[s].setSize(0);
+		levels[s].setSize(0);
+	}
+
+	char buffer[128] = {0};
+	int pitch;
+	double duration;
+	double starttime;
+	double endtime;
+	double overlap;
+	double level;
+	for (i=0; i<infile.getNumLines(); i++) {
+		if (!infile[i].isData()) {
+			continue;
+		}
+		absbeat = infile[i].getAbsBeat();
+		for (j=0; j<infile[i].getFieldCount(); j++) {
+			if (infile[i].getExInterpNum(j) != E_KERN_EXINT) {
+				continue;
+			}
+			if (strcmp(infile[i][j], ".") == 0) {
+				continue;
+			}
+			int tcount = infile[i].getTokenCount(j);
+			for (k=0; k<tcount; k++) {
+				infile[i].getToken(buffer, j, k, 128);
+				if (strchr(buffer, 'r') != NULL) {
+					continue;
+				}
+				if ((strchr(buffer, '_') != NULL) || (strchr(buffer, ']') != NULL)) {
+					// only count tied notes at the start of the tie
+					continue;
+				}
+				pitch = Convert::kernToBase40(buffer);
+				if (pitch < 0) {
+					continue;
+				}
+				duration = infile.getTiedDuration(i, j, k);
+				if (duration <= 0.0) {
+					// ignore grace notes
+					continue;
+				}
+				endtime = absbeat + duration;
+				for (s=linesegment[i]; s<segcount; s++) {
+					if (segbeat[s] >= endtime - 0.0001) {
+						break;
+					}
+					starttime = absbeat > segbeat[s] ? absbeat : segbeat[s];
+					overlap = (endtime < segend[s] ? endtime : segend[s]) - starttime;
+					if (overlap <= 0.0) {
+						continue;
+					}
+					if (s == linesegment[i]) {
+						level = 1.0/pow(2.0, metlev[i]);
+					} else {
+						level = 1.0/pow(2.0, metlev[segline[s]]);
+					}
+					pitches[s].append(pitch);
+					durations[s].append(overlap);
+					levels[s].append(level);
+				}
+			}
+		}
+	}
+
+	// (3) calculate the root scores for each segment, normalized so that
+	// the average over the valid roots is 1.0.
+	IntervalWeight distances;
+	distances.setChromatic1(10.0);
+	RootSpectrum spectrum;
+	spectrum.melodyOff();
+
+	Array<Array<double> > cost(segcount);
+	Array<int> emptyseg(segcount);
+	emptyseg.setAll(0);
+	int r;
+	int validcount;
+	double sum;
+	for (s=0; s<segcount; s++) {
+		cost[s].setSize(40);
+		cost[s].setAll(0.0);
+		if (spectrum.calculate(distances, pitches[s], durations[s],
+				levels[s]) < 0) {
+			emptyseg[s] = 1;
+			continue;
+		}
+		sum = 0.0;
+		validcount = 0;
+		for (r=0; r<40; r++) {
+			if (!validRootQ(r)) {
+				continue;
+			}
+			sum += spectrum[r];
+			validcount++;
+		}
+		for (r=0; r<40; r++) {
+			if (validRootQ(r) && (sum > 0.0)) {
+				cost[s][r] = spectrum[r] * validcount / sum;
+			} else {
+				cost[s][r] = 100000.0;
+			}
+		}
+	}
+
+	// (4) choose the sequence of roots with the lowest total cost,
+	// where each change of root costs a metrically weighted penalty.
+	Array<Array<double> > total(segcount);
+	Array<Array<int> >    back(segcount);
+	double penalty;
+	double value;
+	int last;
+	for (s=0; s<segcount; s++) {
+		total[s].setSize(40);
+		back[s].setSize(40);
+		back[s].setAll(-1);
+		if (s == 0) {
+			for (r=0; r<40; r++) {
+				total[s][r] = cost[s][r];
+			}
+			continue;
+		}
+		penalty = 0.5 * changeweight * pow(2.0, metlev[segline[s]]);
+		if (emptyseg[s]) {
+			// no change of root in a segment without notes
+			penalty = 100000.0;
+		}
+		for (r=0; r<40; r++) {
+			total[s][r] = total[s-1][r];
+			back[s][r]  = r;
+			for (last=0; last<40; last++) {
+				if (last == r) {
+					continue;
+				}
+				value = total[s-1][last] + penalty;
+				if (value < total[s][r]) {
+					total[s][r] = value;
+					back[s][r]  = last;
+				}
+			}
+			total[s][r] += cost[s][r];
+		}
+	}
+
+	Array<int> segroot(segcount);
+	int best = 0;
+	for (r=1; r<40; r++) {
+		if (total[segcount-1][r] < total[segcount-1][best]) {
+			best = r;
+		}
+	}
+	for (s=segcount-1; s>=0; s--) {
+		segroot[s] = best;
+		best = back[s][best];
+	}
+
+	if (debug) {
+		for (s=0; s<segcount; s++) {
+			cout << "!! segment " << s << "\tline " << segline[s] + 1
+			     << "\tbeat " << segbeat[s] << "\tnotes "
+			     << pitches[s].getSize() << "\troot "
+			     << Convert::base40ToKern(buffer, 128, segroot[s] + 3*40)
+			     << endl;
+		}
+	}
+
+	for (i=0; i<infile.getNumLines(); i++) {
+		if (linesegment[i] < 0) {
+			continue;
+		}
+		if (emptyseg[linesegment[i]]) {
+			continue;
+		}
+		roots[i] = segroot[linesegment[i]];
+	}
+
+	return segcount;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::validRootQ -- returns true if the base-40 pitch class
+//     is a note name with no more than one sharp or flat.
+//
+
+int HumdrumFile::validRootQ(int base40) {
+	int pc = base40 % 40;
+	switch (pc) {
+		case 1:  case 2:  case 3:	// C-, C, C#
+		case 7:  case 8:  case 9:	// D-, D, D#
+		case 13: case 14: case 15:	// E-, E, E#
+		case 18: case 19: case 20:	// F-, F, F#
+		case 24: case 25: case 26:	// G-, G, G#
+		case 30: case 31: case 32:	// A-, A, A#
+		case 36: case 37: case 38:	// B-, B, B#
+			return 1;
+	}
+	return 0;
+}
+
+
+
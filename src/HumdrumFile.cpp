@@ -45,6 +45,20 @@
 // Last Modified: Wed Feb  2 17:51:57 PST 2011 Partial fix for breve beat
 // Last Modified: Tue Apr 16 23:18:16 PDT 2013 Added attackQ to gBase12PchLst
 // Last Modified: Mon Sep 16 20:26:17 PDT 2013 Added getMeasureNumber()
+// Last Modified: Sun Oct 18 16:29:47 PDT 2026 Removed static note buffers
+// Last Modified: Sun Oct 18 16:35:54 PDT 2026 Added tie-chain index
+// Last Modified: Sun Oct 18 16:49:47 PDT 2026 Copies keep rhythm analysis
+// Last Modified: Sun Oct 18 17:33:17 PDT 2026 Hashed analyzeCliche() windows
+// Last Modified: Sun Oct 18 17:38:39 PDT 2026 Cached notes for getNoteList()
+// Last Modified: Sun Oct 18 17:40:58 PDT 2026 Added sonority snapshots
+// Last Modified: Sun Oct 18 17:44:07 PDT 2026 Stored metric levels
+// Last Modified: Sun Oct 18 18:40:54 PDT 2026 Added calculateMetricLevel()
+// Last Modified: Sun Oct 18 18:55:16 PDT 2026 Added profiling timers
+// Last Modified: Sun Oct 18 19:08:55 PDT 2026 Fixed duplicate records in combine
+// Last Modified: Sun Oct 18 19:08:55 PDT 2026 Grow note snapshots in large steps
+// Last Modified: Sun Oct 18 20:29:20 PDT 2026 Redo note analysis after edits
+// Last Modified: Sun Oct 18 21:15:05 PDT 2026 Fixed stop beat in analyzeCliche()
+// Last Modified: Sun Oct 18 21:30:14 PDT 2026 Range check in ticksToBeatR()
 // Filename:      ...sig/src/sigInfo/HumdrumFile.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFile.cpp
 // Syntax:        C++
@@ -58,8 +72,10 @@
 #include "humdrumfileextras.h"
 #include "Convert.h"
 #include "PerlRegularExpression.h"
+#include "Profiler.h"
 
 #include <cctype>
+#include <climits>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -67,6 +83,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <unordered_map>
 
 using namespace std;
 
@@ -82,6 +99,13 @@ using namespace std;
 
 HumdrumFile::HumdrumFile(void) : HumdrumFileBasic() {
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
+	tickspq = 1;
 	minrhythm = 0;
 	minrhythmR = 0;
 	pickupdur = -1;
@@ -90,17 +114,32 @@ HumdrumFile::HumdrumFile(void) : HumdrumFileBasic() {
 
 
 HumdrumFile::HumdrumFile(const HumdrumFile& aHumdrumFile) :
-	HumdrumFileBasic(aHumdrumFile) {
+	HumdrumFileBasic() {
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
+	tickspq = 1;
 	minrhythm = 0;
 	minrhythmR = 0;
 	pickupdur = -1;
 	localrhythms.setSize(0);
+	*this = aHumdrumFile;
 }
 
 HumdrumFile::HumdrumFile(const HumdrumFileBasic& aHumdrumFile) :
 	HumdrumFileBasic(aHumdrumFile) {
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
+	tickspq = 1;
 	minrhythm = 0;
 	minrhythmR = 0;
 	pickupdur = -1;
@@ -110,6 +149,13 @@ HumdrumFile::HumdrumFile(const HumdrumFileBasic& aHumdrumFile) :
 
 HumdrumFile::HumdrumFile(const char* filename) : HumdrumFileBasic(filename) {
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
+	tickspq = 1;
 	minrhythm = 0;
 	minrhythmR = 0;
 	pickupdur = -1;
@@ -138,6 +184,9 @@ HumdrumFile::~HumdrumFile() {
 void HumdrumFile::analyzeRhythm(const char* base, int debug) {
 	privateRhythmAnalysis(base, debug);
 	rhythmcheck = 1;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
 }
 
 
@@ -221,18 +270,22 @@ int HumdrumFile::getStartIndex(double startbeat) {
 
 int HumdrumFile::getStartIndex(RationalNumber startbeat) {
 	HumdrumFile& score = *this;
+	// compare startbeat * den against line ticks * den in integers
+	long long den = startbeat.getDenominator();
+	long long target = (long long)startbeat.getNumerator() *
+			getTicksPerQuarter();
 	int index = 1;
 	while (index < score.getNumLines() - 1) {
-		if (score[index+1].getAbsBeatR() == score[index].getAbsBeatR()) {
+		if (tickabs[index+1] == tickabs[index]) {
 			index++;
 			continue;
 		}
-		if ((startbeat < score[index].getAbsBeatR()) &&
-			 (startbeat > score[index-1].getAbsBeatR() ) ) {
+		if ((target < tickabs[index] * den) &&
+			 (target > tickabs[index-1] * den)) {
 			return index;
 		}
-		if ((startbeat > score[index].getAbsBeatR()) &&
-			 (startbeat < score[index+1].getAbsBeatR() ) ) {
+		if ((target > tickabs[index] * den) &&
+			 (target < tickabs[index+1] * den)) {
 			return index;
 		}
 		index++;
@@ -272,14 +325,18 @@ int HumdrumFile::getStopIndex(double stopbeat) {
 
 int HumdrumFile::getStopIndex(RationalNumber stopbeat) {
 	HumdrumFile& score = *this;
+	long long den = stopbeat.getDenominator();
+	long long target = (long long)stopbeat.getNumerator() *
+			getTicksPerQuarter();
 	int index = 1;
 	while (index < score.getNumLines()) {
-		if ((stopbeat <= score[index].getAbsBeatR() ) &&
-			 (stopbeat > score[index-1].getAbsBeatR() ) ) {
+		if ((target <= tickabs[index] * den) &&
+			 (target > tickabs[index-1] * den)) {
 			return index;
 		}
-		if ((stopbeat > score[index].getAbsBeatR() ) &&
-			 (stopbeat < score[index+1].getAbsBeatR() ) ) {
+		if ((index+1 < score.getNumLines()) &&
+			 (target > tickabs[index] * den) &&
+			 (target < tickabs[index+1] * den)) {
 			return index;
 		}
 		index++;
@@ -298,12 +355,24 @@ int HumdrumFile::getStopIndex(RationalNumber stopbeat) {
 void HumdrumFile::appendLine(const char* aLine) {
 	HumdrumFileBasic::appendLine(aLine);
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
 }
 
 
 void HumdrumFile::appendLine(HumdrumRecord& aRecord) {
 	HumdrumFileBasic::appendLine(aRecord);
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
 }
 
 
@@ -502,15 +571,21 @@ int HumdrumFile::processLinesForCombine(HumdrumFile& output, HumdrumFile& A,
 		}
 
 		if (A[a].getType() == E_humrec_bibliography) {
+			int foundQ = 0;
 			for (i=0; i<B.getNumLines(); i++) {
 				if ((B[i].getType() == E_humrec_bibliography) &&
 					 (strcmp(A[a][0], B[i][0]) == 0)) {
-					if (debug) {
-						sout << "!!CASE BBBc" << "\n";
-					}
-					a++;
-					continue;
+					foundQ = 1;
+					break;
+				}
+			}
+			if (foundQ) {
+				// duplicate record: it will be printed from B
+				if (debug) {
+					sout << "!!CASE BBBc" << "\n";
 				}
+				a++;
+				continue;
 			}
 			// Bibliographic record was not found in B.
 			if (debug) { sout << "!!CASE CCC" << "\n"; }
@@ -1374,6 +1449,12 @@ int HumdrumFile::processLinesForCombine(HumdrumFile& output, HumdrumFile& A,
 void HumdrumFile::clear(void) {
 	HumdrumFileBasic::clear();
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
 	pickupdur = -1;
 	localrhythms.setSize(0);
 }
@@ -1717,9 +1798,45 @@ int HumdrumFile::getNoteList(Array<int>& notes, int line, int flag) {
 		return 0;
 	}
 
+	int fieldcount = score[line].getFieldCount();
+	int index = getSonorityIndex(line);
+	if (index >= 0) {
+		// read the notes from the sonority snapshot of the line:
+		int stop = index + soncount[line];
+		char flags;
+		for (i=index; i<stop; i++) {
+			flags = sonflags[i];
+			if ((flags & SON_SUSTAIN) && !expandQ) {
+				continue;
+			}
+			if ((!tieQ) && (flags & SON_TIED)) {
+				continue;
+			}
+			if (midiQ) {
+				note = sonmidi[i];
+				if (pcQ && note >= 0) {
+					note = note % 12;
+				}
+			} else {
+				note = sonbase40[i];
+				if (pcQ && note != E_base40_rest) {
+					note = note % 40;
+				}
+			}
+			if (note == E_base40_rest) {
+				if (restQ) {
+					rawnotes.append(note);
+				}
+			} else {
+				rawnotes.append(note);
+			}
+		}
+		fieldcount = 0;   // skip the token parsing below
+	}
+
 	// store notes found on current line:
 	int tokencount = 0;
-	for (i=0; i<score[line].getFieldCount(); i++) {
+	for (i=0; i<fieldcount; i++) {
 		if (score[line].getExInterpNum(i) != E_KERN_EXINT) {
 			continue;
 		}
@@ -1845,6 +1962,288 @@ int HumdrumFile::getNoteList(Array<int>& notes, int line, int flag) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::analyzeNotes -- decode the pitches of all **kern tokens
+//    into the cells of the filled-token table (see analyzeDots()).
+//    Null-token cells share the notes of the token which they refer to.
+//    This analysis is done automatically the first time getNoteList()
+//    is called, and again when the records of the file have been edited
+//    since the last analysis (see HumdrumFileBasic::getEditCount()).
+//
+
+void HumdrumFile::analyzeNotes(void) {
+	HumdrumFile& score = *this;
+	notechanges = getEditCount();
+	int cells = getFilledCellCount();
+	noteoffset.setSize(cells);
+	notecount.setSize(cells);
+	notebase40.setSize(cells);
+	notebase40.setSize(0);
+	notebase40.setGrowth(cells);
+	notebase40.allowGrowth();
+	notemidi.setSize(cells);
+	notemidi.setSize(0);
+	notemidi.setGrowth(cells);
+	notemidi.allowGrowth();
+	notetied.setSize(cells);
+	notetied.setSize(0);
+	notetied.setGrowth(cells);
+	notetied.allowGrowth();
+
+	int* source = dotsource.getBase();
+	char tokenbuffer[128] = {0};
+	int i, j, k;
+	int cell, scell;
+	int tokencount;
+	int base40;
+	int midi;
+	char tied;
+	for (i=0; i<score.getNumLines(); i++) {
+		cell = getFilledCell(i, 0);
+		if (cell < 0) {
+			continue;
+		}
+		for (j=0; j<dotoffset[i+1]-dotoffset[i]; j++, cell++) {
+			noteoffset[cell] = notebase40.getSize();
+			notecount[cell]  = 0;
+			if (source[2*cell] != i) {
+				// null token: use the notes of the source token, which
+				// is always on an earlier line.
+				scell = getFilledCell(source[2*cell], source[2*cell+1]);
+				if (scell >= 0) {
+					noteoffset[cell] = noteoffset[scell];
+					notecount[cell]  = notecount[scell];
+				}
+				continue;
+			}
+			if (score[i].getExInterpNum(j) != E_KERN_EXINT) {
+				continue;
+			}
+			tokencount = score[i].getTokenCount(j);
+			for (k=0; k<tokencount; k++) {
+				score[i].getToken(tokenbuffer, j, k);
+				base40 = Convert::kernToBase40(tokenbuffer);
+				midi   = Convert::kernToMidiNoteNumber(tokenbuffer);
+				tied   = (strchr(tokenbuffer, '_') != NULL) ||
+				         (strchr(tokenbuffer, ']') != NULL);
+				notebase40.append(base40);
+				notemidi.append(midi);
+				notetied.append(tied);
+			}
+			notecount[cell] = tokencount;
+		}
+	}
+
+	notecheck = 1;
+	soncheck = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::analyzeDots -- redo the null-token analysis, which
+//    also clears the note analysis.
+//
+
+void HumdrumFile::analyzeDots(void) {
+	HumdrumFileBasic::analyzeDots();
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::changeField -- Change the contents of a token in the
+//    Humdrum file.  The note analysis and sonority snapshots are
+//    cleared and will be remade when next needed.
+//
+
+void HumdrumFile::changeField(HumdrumFileAddress& add, const char* newField) {
+	HumdrumFileBasic::changeField(add, newField);
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getSonorityNotes -- returns the notes sounding in **kern
+//    spines on the given line, in field order.  Notes which are sustained
+//    from null tokens are included, and the flags array marks them with
+//    SON_SUSTAIN.  Tie continuations are marked with SON_TIED, and notes
+//    of tokens which contain rests are marked with SON_RESTFIELD.  A note
+//    is attacked on the line if it has neither SON_SUSTAIN nor SON_TIED.
+//    Returns the number of notes.
+//
+
+int HumdrumFile::getSonorityNotes(Array<int>& base40, Array<int>& flags,
+		int line) {
+	int index = getSonorityIndex(line);
+	if (index < 0) {
+		base40.setSize(0);
+		flags.setSize(0);
+		return 0;
+	}
+	int count = soncount[line];
+	base40.setSize(count);
+	flags.setSize(count);
+	for (int i=0; i<count; i++) {
+		base40[i] = sonbase40[index+i];
+		flags[i]  = sonflags[index+i];
+	}
+	return count;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getSonorityMask -- returns the pitch classes sounding
+//    on the line (including sustained notes) as a 12-bit mask, with
+//    C in the lowest bit.
+//
+
+int HumdrumFile::getSonorityMask(int line) {
+	if (getSonorityIndex(line) < 0) {
+		return 0;
+	}
+	return sonmask[line];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getSonorityBass -- returns the lowest base-40 pitch
+//    sounding on the line (including sustained notes), or -1 if
+//    there are no notes on the line.
+//
+
+int HumdrumFile::getSonorityBass(int line) {
+	if (getSonorityIndex(line) < 0) {
+		return -1;
+	}
+	return sonbass[line];
+}
+
+
+
+//////////////////////////////
+//
+// private: HumdrumFile::getSonorityIndex -- returns the index of the first
+//    note of the sonority snapshot for the given line, making the snapshot
+//    if it does not yet exist.  All snapshots are remade if a record of
+//    the file was edited after they were made.  Returns -1 if the line is
+//    not a data line in the filled-token table.
+//
+
+int HumdrumFile::getSonorityIndex(int line) {
+	if (notecheck && (notechanges != getEditCount())) {
+		// records were edited after the analysis: null tokens may now
+		// refer to other tokens, so redo the dot analysis as well.
+		analyzeDots();
+	}
+	if (!notecheck) {
+		analyzeNotes();
+	}
+	if (!soncheck) {
+		int lines = getNumLines();
+		sonoffset.setSize(lines);
+		sonoffset.setAll(-1);
+		soncount.setSize(lines);
+		soncount.setAll(0);
+		sonmask.setSize(lines);
+		sonmask.setAll(0);
+		sonbass.setSize(lines);
+		sonbass.setAll(-1);
+		// grow in large steps, since snapshots are added one at a time:
+		int cells = getFilledCellCount();
+		sonbase40.setSize(0);
+		sonbase40.setGrowth(cells);
+		sonbase40.allowGrowth();
+		sonmidi.setSize(0);
+		sonmidi.setGrowth(cells);
+		sonmidi.allowGrowth();
+		sonflags.setSize(0);
+		sonflags.setGrowth(cells);
+		sonflags.allowGrowth();
+		soncheck = 1;
+	}
+	if ((line < 0) || (line >= sonoffset.getSize())) {
+		return -1;
+	}
+	if (sonoffset[line] >= 0) {
+		return sonoffset[line];
+	}
+
+	HumdrumRecord& arecord = (*this)[line];
+	int fieldcount = arecord.getFieldCount();
+	int cell = getFilledCell(line, 0);
+	if ((cell < 0) || (dotoffset[line+1] - cell != fieldcount)) {
+		return -1;
+	}
+
+	int* source = dotsource.getBase();
+	int index = sonbase40.getSize();
+	int mask = 0;
+	int bass = -1;
+	int sline, sfield;
+	int base40, midi;
+	char flag, flags;
+	int j, k, stop;
+	for (j=0; j<fieldcount; j++, cell++) {
+		if (arecord.getExInterpNum(j) != E_KERN_EXINT) {
+			continue;
+		}
+		sline  = source[2*cell];
+		sfield = source[2*cell+1];
+		if ((sline < 0) || (sfield < 0)) {
+			continue;
+		}
+		flag = 0;
+		if (sline != line) {
+			flag |= SON_SUSTAIN;
+		}
+		if (strchr((*this)[sline][sfield], 'r') != NULL) {
+			flag |= SON_RESTFIELD;
+		}
+		stop = noteoffset[cell] + notecount[cell];
+		for (k=noteoffset[cell]; k<stop; k++) {
+			base40 = notebase40[k];
+			midi   = notemidi[k];
+			flags  = flag;
+			if (notetied[k]) {
+				flags |= SON_TIED;
+			}
+			sonbase40.append(base40);
+			sonmidi.append(midi);
+			sonflags.append(flags);
+			if ((flags & SON_RESTFIELD) || (base40 < 0) || (midi < 0)) {
+				continue;
+			}
+			mask |= 1 << (midi % 12);
+			if ((bass < 0) || (base40 < bass)) {
+				bass = base40;
+			}
+		}
+	}
+
+	sonoffset[line] = index;
+	soncount[line]  = sonbase40.getSize() - index;
+	sonmask[line]   = mask;
+	sonbass[line]   = bass;
+	return index;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::getNoteArray --
@@ -1893,14 +2292,13 @@ void HumdrumFile::getNoteArray(Array<double>& absbeat,
 	durations.allowGrowth(1);
 	levels.allowGrowth(1);
 
-	Array<int> scorelevels;
-	score.analyzeMetricLevel(scorelevels);
+	Array<int>& scorelevels = getMetricLevels();
 
 	int firsttime = 1;
 	int i, j, k;
 	int ii, jj;
 	int ccount;
-	static char buffer[1024] = {0};
+	char buffer[1024] = {0};
 	int pitch;
 	double beatvalue;
 	double duration;
@@ -2055,14 +2453,13 @@ void HumdrumFile::getNoteArray2(Array<double>& absbeat,
 	templastpitches.setSize(0);
 	tempnextpitches.setSize(0);
 
-	Array<int> scorelevels;
-	score.analyzeMetricLevel(scorelevels);
+	Array<int>& scorelevels = getMetricLevels();
 
 	int firsttime = 1;
 	int i, j, k;
 	int ii, jj;
 	int ccount;
-	static char buffer[1024] = {0};
+	char buffer[1024] = {0};
 	int pitch;
 	double beatvalue;
 	double duration;
@@ -2221,62 +2618,13 @@ double HumdrumFile::getTiedDuration(int linenum, int field, int token) {
 
 RationalNumber HumdrumFile::getTiedDurationR(int linenum, int field,
 		int token) {
-	HumdrumFile& file = *this;
-	int length = file.getNumLines();
 	char buffer[128] = {0};
-	RationalNumber duration(0,1); // total duration of tied notes.
-	int done = 0;                 // true when end of tied note is found
-	int startpitch = 0;           // starting pitch of the tie
-	int matchpitch = 0;           // current matching pitch of the tie
-
-	file[linenum].getToken(buffer, field, token);
-	if (strchr(buffer, '[')) {
-		duration = Convert::kernToDurationR(buffer);
-		// allow for enharmonic ties:
-		startpitch = Convert::kernToMidiNoteNumber(buffer);
-	} else {
-		return Convert::kernToDurationR(buffer);
+	int index = getTieIndex(linenum, field, token);
+	if ((index >= 0) && (tiestate[index] == TIE_START)) {
+		return tietotal[index];
 	}
-
-// not quite perfect: if two primary tracks with common ties, will have prob:
-
-	int m;
-	int ptrack = file[linenum].getPrimaryTrack(field);
-	int currentLine = linenum + 1;
-	while (!done && currentLine < length) {
-		if (file[currentLine].getType() != E_humrec_data) {
-			currentLine++;
-			continue;
-		}
-
-		for (m=0; m<file[currentLine].getFieldCount(); m++) {
-			if (ptrack != file[currentLine].getPrimaryTrack(m)) {
-				continue;
-			}
-
-			if (strchr(file[currentLine][m], '_')) {
-				matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-				if (startpitch == matchpitch) {
-					duration += Convert::kernToDurationR(file[currentLine][m]);
-				} else {
-					done = 1;
-				}
-				break;
-			} else if (strchr(file[currentLine][m], ']')) {
-				matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-				if (startpitch == matchpitch) {
-					duration += Convert::kernToDurationR(file[currentLine][m]);
-					done = 1;
-				} else {
-					done = 1;
-				}
-				break;
-			}
-		}
-		currentLine++;
-	}
-
-	return duration;
+	(*this)[linenum].getToken(buffer, field, token, 128);
+	return Convert::kernToDurationR(buffer);
 }
 
 
@@ -2285,114 +2633,50 @@ RationalNumber HumdrumFile::getTiedDurationR(int linenum, int field,
 //
 // HumdrumFile::getTotalTiedDuration -- return the duration of a tied
 // group of notes, even if the the current note is not the first
-// note in the tied group (i.e., go fine the first note in the
-// group and then run the getTiedDurationR() function
+// note in the tied group.
 //
 
 RationalNumber HumdrumFile::getTotalTiedDurationR(int linenum, int field,
 		int token) {
-	char buffer[128] = {0};
-	(*this)[linenum].getToken(buffer, field, token);
-
-	if ((strchr(buffer, '_') != NULL) || (strchr(buffer, ']') != NULL)) {
-		int tline;
-		int tcol;
-		int ttok;
-		getTiedStartLocation(linenum, field, token, tline, tcol, ttok);
-		if ((tline < 0) || (tcol < 0) || (ttok < 0)) {
-			return getTiedDurationR(linenum, field, token);
-		} else{
-			return getTiedDurationR(tline, tcol, ttok);
-		}
-	} else {
-		return getTiedDurationR(linenum, field, token);
+	int index = getTieIndex(linenum, field, token);
+	if ((index >= 0) && (tiestate[index] != TIE_NONE)) {
+		return tietotal[tiehead[index]];
 	}
+	return getTiedDurationR(linenum, field, token);
 }
 
 
 
 //////////////////////////////
 //
-// HumdrumFile::getTiedStartLocation --  Need to generalize to chords.
+// HumdrumFile::getTiedStartLocation -- return the line, field and
+//     subtoken of the note which starts the tie group containing the
+//     given note.  If the note is not tied, or is the start of the
+//     tie, then the input location is returned.
 //
 
 void HumdrumFile::getTiedStartLocation(int linenum, int field, int token,
 		int& tline, int& tcol, int& ttok) {
-
-	RationalNumber startbeat = -1;
-	HumdrumFile& file = *this;
-	char buffer[128] = {0};
-	RationalNumber duration = 0;   // total duration of tied notes.
-	int done = 0;                  // true when end of tied note is found
-	int startpitch = 0;            // starting pitch of the tie
-	int matchpitch = 0;            // current matching pitch of the tie
-
-	file[linenum].getToken(buffer, field, token);
-	if ((strchr(buffer, ']') != NULL) || (strchr(buffer, '_') != NULL)) {
-		duration = Convert::kernToDurationR(buffer);
-		// allow for enharmonic ties:
-		startpitch = Convert::kernToMidiNoteNumber(buffer);
-	} else {
-		// nothing to do, at start of tie group or no tie
-		tline = linenum;
-		tcol = field;
-		ttok = token;
+	tline = linenum;
+	tcol  = field;
+	ttok  = token;
+	int index = getTieIndex(linenum, field, token);
+	if (index < 0) {
 		return;
 	}
-
-	// search back through the music for the starting point of the tie.
-	int m = field;
-	int ptrack = file[linenum].getPrimaryTrack(field);
-	int currentLine = linenum - 1;
-	while (!done && currentLine >= 0) {
-		if (file[currentLine].getType() != E_humrec_data) {
-			currentLine--;
-			continue;
-		}
-
-		for (m=0; m<file[currentLine].getFieldCount(); m++) {
-			if (ptrack != file[currentLine].getPrimaryTrack(m)) {
-				continue;
-			}
-
-			if (strchr(file[currentLine][m], '_') != NULL) {
-				matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-				if (startpitch == matchpitch) {
-					break;
-					// continue searching backwards in file
-				} else {
-					done = 1;
-				}
-				break;
-			} else if (strchr(file[currentLine][m], ']') != NULL) {
-				matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-				if (startpitch == matchpitch) {
-					break;
-					// continue searching backwards in file
-				} else {
-					done = 1;
-				}
-				break;
-			} else if (strchr(file[currentLine][m], '[') != NULL) {
-				tline = currentLine;
-				tcol = m;
-				ttok = 0;  // not bothering with chords yet...
-				return;
-			}
-		}
-		currentLine--;
-	}
-
-	tline = currentLine;
-	tcol = m;
-	ttok = 0;   // not bothering with chords yet...
+	int head = tiehead[index];
+	tline = tieline[head];
+	tcol  = tiefield[head];
+	ttok  = tietoken[head];
 }
 
 
 
 //////////////////////////////
 //
-// HumdrumFile::getTiedStartBeat --
+// HumdrumFile::getTiedStartBeat -- return the absolute beat position
+//     of the start of the tie group which contains the given note,
+//     or the beat position of the note if it is not tied.
 //     default value: token = 0;
 //
 
@@ -2406,63 +2690,218 @@ double HumdrumFile::getTiedStartBeat(int linenum, int field, int token) {
 
 RationalNumber HumdrumFile::getTiedStartBeatR(int linenum, int field,
 		int token) {
-	RationalNumber startbeat = -1;
+	int tline;
+	int tcol;
+	int ttok;
+	getTiedStartLocation(linenum, field, token, tline, tcol, ttok);
+	return (*this)[tline].getAbsBeatR();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::analyzeTies -- link each tied note in the **kern spines
+//     to the note which starts its tie group, and store the total
+//     duration of each group, in one pass through the file.  Tie
+//     continuations are matched to open ties in the same primary
+//     track (so spine splits are allowed) by MIDI note number (so
+//     that enharmonic ties are allowed).  Tie continuations which do
+//     not match an open tie are treated as the start of their own
+//     group.  This function is called automatically by the tie query
+//     functions, but should be called again if the tie markers in the
+//     data are changed after a query.
+//
+
+void HumdrumFile::analyzeTies(void) {
 	HumdrumFile& file = *this;
-	int length = file.getNumLines();
 	char buffer[128] = {0};
-	RationalNumber duration = 0;   // total duration of tied notes.
-	int done = 0;                  // true when end of tied note is found
-	int startpitch = 0;            // starting pitch of the tie
-	int matchpitch = 0;            // current matching pitch of the tie
-
-	file[linenum].getToken(buffer, field, token);
-	// should be == NULL and not != NULL? [20110218]
-	if (strchr(buffer, '[') == NULL) {
-		duration = Convert::kernToDurationR(buffer);
-		// allow for enharmonic ties:
-		startpitch = Convert::kernToMidiNoteNumber(buffer);
-	} else {
-		startbeat = file[linenum].getAbsBeatR();
-		return startbeat;
-	}
+	int i, j, k;
 
-	int m;
-	int ptrack = file[linenum].getPrimaryTrack(field);
-	int currentLine = linenum + 1;
-	while (!done && currentLine < length) {
-		if (file[currentLine].getType() != E_humrec_data) {
-			currentLine++;
+	// (1) assign an index to each subtoken in the **kern spines
+	int count = 0;
+	tieindex.setSize(file.getNumLines());
+	for (i=0; i<file.getNumLines(); i++) {
+		if (file[i].getType() != E_humrec_data) {
+			tieindex[i].setSize(0);
 			continue;
 		}
+		tieindex[i].setSize(file[i].getFieldCount() + 1);
+		for (j=0; j<file[i].getFieldCount(); j++) {
+			tieindex[i][j] = count;
+			if (file[i].getExInterpNum(j) == E_KERN_EXINT) {
+				count += file[i].getTokenCount(j);
+			}
+		}
+		tieindex[i][j] = count;
+	}
+
+	tiehead.setSize(count);
+	tiestate.setSize(count);
+	tieline.setSize(count);
+	tiefield.setSize(count);
+	tietoken.setSize(count);
+	tietotal.setSize(count);
+	tiestate.setAll(TIE_NONE);
 
-		for (m=0; m<file[currentLine].getFieldCount(); m++) {
-			if (ptrack != file[currentLine].getPrimaryTrack(m)) {
+	// (2) link tie continuations to the starts of their tie groups
+	Array<Array<int> > opentie(file.getMaxTracks() + 1);
+	Array<Array<int> > openpitch(file.getMaxTracks() + 1);
+	for (i=0; i<opentie.getSize(); i++) {
+		opentie[i].setSize(0);
+		opentie[i].setGrowth(16);
+		openpitch[i].setSize(0);
+		openpitch[i].setGrowth(16);
+	}
+
+	int index;
+	int ptrack;
+	int pitch;
+	int state;
+	int head;
+	int m;
+	RationalNumber duration;
+	for (i=0; i<file.getNumLines(); i++) {
+		for (j=0; j<tieindex[i].getSize()-1; j++) {
+			index = tieindex[i][j];
+			for (k=0; k<tieindex[i][j+1] - index; k++) {
+				tiehead[index+k]  = index + k;
+				tieline[index+k]  = i;
+				tiefield[index+k] = j;
+				tietoken[index+k] = k;
+			}
+			if (tieindex[i][j+1] == index) {
 				continue;
 			}
-
-			if (strchr(file[currentLine][m], '_')) {
-				matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-				if (startpitch == matchpitch) {
-					duration += Convert::kernToDurationR(file[currentLine][m]);
-				} else {
-					done = 1;
+			if (strpbrk(file[i][j], "[_]") == NULL) {
+				// no ties in this field
+				continue;
+			}
+			ptrack = file[i].getPrimaryTrack(j);
+			for (k=0; k<tieindex[i][j+1] - index; k++) {
+				file[i].getToken(buffer, j, k, 128);
+				state = getTieState(buffer);
+				if (state == TIE_NONE) {
+					continue;
 				}
-				break;
-			} else if (strchr(file[currentLine][m], ']')) {
-				matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-				if (startpitch == matchpitch) {
-					duration += Convert::kernToDurationR(file[currentLine][m]);
-					done = 1;
+				pitch = Convert::kernToMidiNoteNumber(buffer);
+				if (pitch < 0) {
+					continue;
+				}
+				duration = Convert::kernToDurationR(buffer);
+				head = -1;
+				for (m=opentie[ptrack].getSize()-1; m>=0; m--) {
+					if (openpitch[ptrack][m] == pitch) {
+						break;
+					}
+				}
+				if ((m >= 0) && (state == TIE_START)) {
+					// unterminated tie group at this pitch, so close it
+					removeOpenTie(opentie[ptrack], openpitch[ptrack], m);
+				} else if (m >= 0) {
+					head = opentie[ptrack][m];
+					if (state == TIE_END) {
+						removeOpenTie(opentie[ptrack], openpitch[ptrack], m);
+					}
+				}
+
+				tiestate[index+k] = state;
+				if (head < 0) {
+					// start of a new tie group (or an unmatched continuation)
+					tietotal[index+k] = duration;
+					if (state != TIE_END) {
+						head = index + k;
+						opentie[ptrack].append(head);
+						openpitch[ptrack].append(pitch);
+					}
 				} else {
-					done = 1;
+					tiehead[index+k] = head;
+					tietotal[head] += duration;
 				}
-				break;
 			}
 		}
-		currentLine++;
 	}
 
-	return startbeat;
+	tiecheck = 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::removeOpenTie -- remove an entry from the list of tie
+//     groups which have not yet ended (used in analyzeTies).
+//
+
+void HumdrumFile::removeOpenTie(Array<int>& opentie, Array<int>& openpitch,
+		int index) {
+	int i;
+	for (i=index; i<opentie.getSize()-1; i++) {
+		opentie[i]   = opentie[i+1];
+		openpitch[i] = openpitch[i+1];
+	}
+	opentie.setSize(opentie.getSize()-1);
+	openpitch.setSize(openpitch.getSize()-1);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getTieState -- return TIE_START for a note which
+//     starts a tie, TIE_MIDDLE for a tie continuation, TIE_END for
+//     the end of a tie, and TIE_NONE otherwise.
+//
+
+int HumdrumFile::getTieState(const char* token) {
+	if (strchr(token, '[') != NULL) {
+		return TIE_START;
+	} else if (strchr(token, '_') != NULL) {
+		return TIE_MIDDLE;
+	} else if (strchr(token, ']') != NULL) {
+		return TIE_END;
+	}
+	return TIE_NONE;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getTieIndex -- return the index of a subtoken in the
+//     tie analysis, running the tie analysis if it has not been done
+//     (or if the note at the given location no longer matches it).
+//     Returns -1 if the location is not a **kern note.
+//
+
+int HumdrumFile::getTieIndex(int linenum, int field, int token) {
+	HumdrumFile& file = *this;
+	if ((linenum < 0) || (linenum >= file.getNumLines())) {
+		return -1;
+	}
+	if (!tiecheck || (linenum >= tieindex.getSize()) ||
+			((file[linenum].getType() == E_humrec_data) &&
+			(tieindex[linenum].getSize() != file[linenum].getFieldCount() + 1))) {
+		analyzeTies();
+	}
+	if ((field < 0) || (field >= tieindex[linenum].getSize() - 1)) {
+		return -1;
+	}
+	int index = tieindex[linenum][field] + token;
+	if ((token < 0) || (index >= tieindex[linenum][field+1])) {
+		return -1;
+	}
+
+	// check that the tie marker for the note has not been changed
+	char buffer[128] = {0};
+	file[linenum].getToken(buffer, field, token, 128);
+	int state = getTieState(buffer);
+	if ((state != tiestate[index]) && ((state == TIE_NONE) ||
+			(Convert::kernToMidiNoteNumber(buffer) >= 0))) {
+		analyzeTies();
+	}
+
+	return index;
 }
 
 
@@ -2499,27 +2938,68 @@ HumdrumFile& HumdrumFile::operator=(const HumdrumFile& aFile) {
 		return *this;
 	}
 
-	// delete any current contents
-	int i;
-	for (i=0; i<records.getSize(); i++) {
-		delete records[i];
-		records[i] = NULL;
+	// the records share their text with the records of aFile until
+	// they are modified (see HumdrumRecord::unshare()).
+	HumdrumFileBasic::operator=(aFile);
+
+	// The rhythmic analysis is stored in the records, so keep the
+	// file-level results of the analyses along with them.
+	rhythmcheck  = aFile.rhythmcheck;
+	minrhythm    = aFile.minrhythm;
+	minrhythmR   = aFile.minrhythmR;
+	pickupdur    = aFile.pickupdur;
+	localrhythms = aFile.localrhythms;
+
+	tiecheck = aFile.tiecheck;
+	if (tiecheck) {
+		tieindex = aFile.tieindex;
+		tiehead  = aFile.tiehead;
+		tiestate = aFile.tiestate;
+		tieline  = aFile.tieline;
+		tiefield = aFile.tiefield;
+		tietoken = aFile.tietoken;
+		tietotal = aFile.tietotal;
 	}
 
-	records.setSize(aFile.records.getSize());
-	for (i=0; i<aFile.records.getSize(); i++) {
-		records[i] = new HumdrumRecord;
-		*(records[i]) = *(aFile.records[i]);
+	tickcheck = aFile.tickcheck;
+	if (tickcheck) {
+		tickspq  = aFile.tickspq;
+		tickabs  = aFile.tickabs;
+		tickbeat = aFile.tickbeat;
+		tickdur  = aFile.tickdur;
 	}
 
-	rhythmcheck = aFile.rhythmcheck;
-	maxtracks = aFile.maxtracks;
-	localrhythms = aFile.localrhythms;
+	levelcheck = aFile.levelcheck;
+	if (levelcheck) {
+		levelcache = aFile.levelcache;
+	}
+
+	notecheck = aFile.notecheck;
+	notechanges = aFile.notechanges;
+	if (notecheck) {
+		noteoffset = aFile.noteoffset;
+		notecount  = aFile.notecount;
+		notebase40 = aFile.notebase40;
+		notemidi   = aFile.notemidi;
+		notetied   = aFile.notetied;
+	}
+
+	soncheck = aFile.soncheck;
+	if (soncheck) {
+		sonoffset = aFile.sonoffset;
+		soncount  = aFile.soncount;
+		sonmask   = aFile.sonmask;
+		sonbass   = aFile.sonbass;
+		sonbase40 = aFile.sonbase40;
+		sonmidi   = aFile.sonmidi;
+		sonflags  = aFile.sonflags;
+	}
 
 	// Store the filename. Also should store the segment number
 	// and maybe other stuff (see HumdrumFileBasic.h for newer
 	// data fields which need to also be copied [20130807]
 	fileName = aFile.fileName;
+	segmentLevel = aFile.segmentLevel;
 
 	return *this;
 }
@@ -2540,12 +3020,24 @@ void HumdrumFile::read(const string& filename) {
 void HumdrumFile::read(const char* filename) {
 	HumdrumFileBasic::read(filename);
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
 }
 
 
 void HumdrumFile::read(istream& inStream) {
 	HumdrumFileBasic::read(inStream);
 	rhythmcheck = 0;
+	levelcheck = 0;
+	tiecheck = 0;
+	tickcheck = 0;
+	notecheck = 0;
+	notechanges = 0;
+	soncheck = 0;
 }
 
 
@@ -2576,6 +3068,7 @@ int HumdrumFile::rhythmQ(void) {
 //
 
 void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
+	PROFILE_SCOPE("HumdrumFile::analyzeRhythm");
 	int init = 0;                   // marker indicating when the data starts
 	int datainit = 0;               // marker indicating when the data starts
 
@@ -2959,6 +3452,209 @@ RationalNumber HumdrumFile::getMinimumRationalRhythm(
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::analyzeTicks -- store the rhythm analysis of each line
+//     as 64-bit integer tick counts so that timeline queries and
+//     comparisons do not need RationalNumber arithmetic.  The tick
+//     resolution is derived from the minimum time base of the file,
+//     extended to include any other fractions found in the rhythm
+//     analysis (such as from *rscale or spaceEmptyLines()).  If the
+//     rhythm values of the records are changed by hand after the
+//     analysis, call this function again to update the ticks.
+//
+
+void HumdrumFile::analyzeTicks(void) {
+	HumdrumFile& file = *this;
+	if (!rhythmcheck) {
+		analyzeRhythm();
+	}
+
+	int i;
+	long long den;
+	long long timebase = getMinTimeBase();
+	tickspq = 1;
+	if (timebase > 0) {
+		tickspq = timebase / tickGCD(timebase, 4);
+	}
+	RationalNumber value;
+	for (i=0; i<file.getNumLines(); i++) {
+		value = file[i].getAbsBeatR();
+		den = value.getNumerator() == 0 ? 1 : value.getDenominator();
+		tickspq = tickspq / tickGCD(tickspq, den) * den;
+		value = file[i].getBeatR();
+		den = value.getNumerator() == 0 ? 1 : value.getDenominator();
+		tickspq = tickspq / tickGCD(tickspq, den) * den;
+		value = file[i].getDurationR();
+		den = value.getNumerator() == 0 ? 1 : value.getDenominator();
+		tickspq = tickspq / tickGCD(tickspq, den) * den;
+	}
+
+	tickabs.setSize(file.getNumLines());
+	tickbeat.setSize(file.getNumLines());
+	tickdur.setSize(file.getNumLines());
+	for (i=0; i<file.getNumLines(); i++) {
+		value = file[i].getAbsBeatR();
+		tickabs[i]  = (long long)value.getNumerator() *
+				(tickspq / value.getDenominator());
+		value = file[i].getBeatR();
+		tickbeat[i] = (long long)value.getNumerator() *
+				(tickspq / value.getDenominator());
+		value = file[i].getDurationR();
+		tickdur[i]  = (long long)value.getNumerator() *
+				(tickspq / value.getDenominator());
+	}
+
+	tickcheck = 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getTicksPerQuarter -- return the resolution of the
+//     integer timeline created by analyzeTicks().
+//
+
+long long HumdrumFile::getTicksPerQuarter(void) {
+	if (!tickcheck) {
+		analyzeTicks();
+	}
+	return tickspq;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getAbsTicks -- return the absolute starting time of
+//     a line in ticks (see getTicksPerQuarter()).
+//
+
+long long HumdrumFile::getAbsTicks(int index) {
+	if (!tickcheck) {
+		analyzeTicks();
+	}
+	return tickabs[index];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getBeatTicks -- return the metric position of a line
+//     in ticks.  For barlines, this is the duration of the measure
+//     which follows (negative for pickup measures).
+//
+
+long long HumdrumFile::getBeatTicks(int index) {
+	if (!tickcheck) {
+		analyzeTicks();
+	}
+	return tickbeat[index];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getDurationTicks -- return the duration of a line
+//     in ticks.
+//
+
+long long HumdrumFile::getDurationTicks(int index) {
+	if (!tickcheck) {
+		analyzeTicks();
+	}
+	return tickdur[index];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getTotalTicks -- return the total duration of the
+//     file in ticks.
+//
+
+long long HumdrumFile::getTotalTicks(void) {
+	if (getNumLines() == 0) {
+		return 0;
+	}
+	return getAbsTicks(getNumLines()-1);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::ticksToBeatR -- convert a tick count into quarter notes.
+//     RationalNumber stores int values, so it is an error if the reduced
+//     fraction does not fit into them.
+//
+
+RationalNumber HumdrumFile::ticksToBeatR(long long ticks) {
+	long long tpq = getTicksPerQuarter();
+	long long gcd = tickGCD(ticks < 0 ? -ticks : ticks, tpq);
+	if (gcd == 0) {
+		gcd = 1;
+	}
+	long long num = ticks / gcd;
+	long long den = tpq / gcd;
+	if ((num > INT_MAX) || (num < -INT_MAX) || (den > INT_MAX)) {
+		cerr << "Error: " << ticks << " ticks at " << tpq
+		     << " ticks per quarter note is too large for a rational beat"
+		     << endl;
+		exit(1);
+	}
+	return RationalNumber((int)num, (int)den);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::beatToTicks -- convert a duration in quarter notes
+//     into ticks.  If the duration does not fall on a tick, then
+//     the tick before it is returned, or the one after it if
+//     roundup is true.
+//     default value: roundup = 0
+//
+
+long long HumdrumFile::beatToTicks(RationalNumber beat, int roundup) {
+	long long scaled = (long long)beat.getNumerator() * getTicksPerQuarter();
+	long long den = beat.getDenominator();
+	long long output = scaled / den;
+	if (output * den != scaled) {
+		if (scaled < 0) {
+			output--;
+		}
+		if (roundup) {
+			output++;
+		}
+	}
+	return output;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::tickGCD -- greatest common divisor for tick values.
+//
+
+long long HumdrumFile::tickGCD(long long a, long long b) {
+	long long z;
+	while (b != 0) {
+		z = a % b;
+		a = b;
+		b = z;
+	}
+	return a;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::spaceEmptyLines -- if a line has zero duration,
@@ -3079,6 +3775,8 @@ void HumdrumFile::spaceEmptyLines(void) {
 		}
 
 	}
+
+	tickcheck = 0;
 }
 
 
@@ -3743,7 +4441,7 @@ RationalNumber HumdrumFile::determineDurationR(HumdrumRecord& aRecord,
 	int q;
 	int count = 0;
 	int stype = 0;
-	static char rbuff[32] = {0};
+	char rbuff[32] = {0};
 	for (i=0; i<aRecord.getFieldCount(); i++) {
 		if (ignore[aRecord.getPrimaryTrack(i)-1] != 0) {
 			stype = 0;
@@ -3941,44 +4639,68 @@ void HumdrumFile::analyzeDataIndex(Array<int>& indices, int segment) {
 //////////////////////////////
 //
 // HumdrumFile::analyzeCliche -- returns the count of cliches found
-//    in the score.
+//    in the score.  A cliche is a sequence of sonorities (lasting at
+//    least the given duration in quarter notes) which occurs again
+//    later in the score at least minimumcount times.  The starting line
+//    of each cliche is marked with -N in the cliche array and the
+//    starting lines of its repetitions are marked with N.
 //     Default values: start = -1, stop = -1;
 //
+//    Each sonority (sorted list of pitches plus duration) is reduced to
+//    an integer ID, and the sequence of IDs in each window is given a
+//    rolling hash.  Only windows with the same hash are compared.
+//
 
 int HumdrumFile::analyzeCliche(Array<int>& cliche, double duration,
 		int minimumcount, double start, double stop) {
 	HumdrumFile& score = *this;
-	int  nlflag = NL_SORT | NL_UNIQ;
-	// later flags to add: NL_PC; NL_FILL;
 
 	cliche.setSize(score.getNumLines());
 	cliche.zero();
 
 	Array<int> di;  // data index list for score data lines
 	score.analyzeDataIndex(di);
+	if (di.getSize() == 0) {
+		return 0;
+	}
 
-	Array<Array<int> > pitchset;
 	int starti = 0;
-// cout << "di get size = " << di.getSize() << endl;
-
 	if (start > 0) {
-		while (score[di[starti]].getAbsBeat() < start && starti < di.getSize()) {
+		while ((starti < di.getSize()) &&
+				(score[di[starti]].getAbsBeat() < start)) {
 			starti++;
 		}
 	}
 
 	int endi = di.getSize() - 1;
 	if (stop > 0) {
-		while (score[di[endi]].getAbsBeat() < stop && endi > 1) {
+		while ((endi > 0) && (score[di[endi]].getAbsBeat() > stop)) {
 			endi--;
 		}
 	}
+	if (starti >= endi) {
+		return 0;
+	}
 
-	int i, j;
-	Array<Array<int> > allnotes;
-	allnotes.setSize(endi-starti+1);
-	for (i=0; i<endi-starti+1; i++) {
-		score.getNoteList(allnotes[i], di[i], nlflag);
+	Array<int> ids;
+	getClicheSonorityIds(ids, di, starti, endi);
+
+	Array<int> lengths;
+	Array<unsigned long long> hashes;
+	getClicheWindows(lengths, hashes, ids, di, starti, endi, duration);
+
+	// group the starting positions by window hash:
+	unordered_map<unsigned long long, vector<int> > buckets;
+	Array<int> bucketindex(endi+1);
+	bucketindex.setAll(-1);
+	int i, j, k;
+	for (i=starti; i<=endi; i++) {
+		if (lengths[i] < 0) {
+			continue;
+		}
+		vector<int>& bucket = buckets[hashes[i]];
+		bucketindex[i] = (int)bucket.size();
+		bucket.push_back(i);
 	}
 
 	int match = 0;
@@ -3989,13 +4711,16 @@ int HumdrumFile::analyzeCliche(Array<int>& cliche, double duration,
 		if (cliche[di[i]] != 0) {
 			continue;
 		}
+		if (lengths[i] < 0) {
+			continue;
+		}
+		vector<int>& bucket = buckets[hashes[i]];
 		found = 0;
 		match = 0;
 		tcount = 0;
-		for (j=i+1; j<=endi; j++) {
-// cout << "Matching line " << di[i] << " to " << di[j] << " : "
-//      << score[di[i]][0] << " \t" << score[di[j]][0] << endl;
-			match = attemptMatch(allnotes, di, starti, i, j, duration);
+		for (k=bucketindex[i]+1; k<(int)bucket.size(); k++) {
+			j = bucket[k];
+			match = attemptMatch(ids, lengths, i, j);
 			if (match && !found) {
 				count++;
 				cliche[di[i]] = -count;
@@ -4006,8 +4731,12 @@ int HumdrumFile::analyzeCliche(Array<int>& cliche, double duration,
 				tcount++;
 			}
 		}
+		if (!found) {
+			continue;
+		}
 		if (tcount < minimumcount) {
-			for (j=i+1; j<=endi; j++) {
+			for (k=bucketindex[i]+1; k<(int)bucket.size(); k++) {
+				j = bucket[k];
 				if (cliche[di[j]] == -cliche[di[i]]) {
 					cliche[di[j]] = 0;
 				}
@@ -4024,37 +4753,122 @@ int HumdrumFile::analyzeCliche(Array<int>& cliche, double duration,
 
 //////////////////////////////
 //
-// private: HumdrumFile::attemptMatch -- for use with analyzeCliche
+// private: HumdrumFile::getClicheSonorityIds -- for use with
+//    analyzeCliche.  Give each data line in the range an integer ID
+//    so that lines with the same duration and the same set of pitches
+//    have the same ID.  The ids array is indexed by data line index.
 //
 
-int HumdrumFile::attemptMatch(Array<Array<int> >& allnotes, Array<int>& di,
-		int starti, int i, int j, double duration) {
+void HumdrumFile::getClicheSonorityIds(Array<int>& ids, Array<int>& di,
+		int starti, int endi) {
 	HumdrumFile& score = *this;
+	int nlflag = NL_SORT | NL_UNIQ;
 
-	double sumduration = 0.0;
+	ids.setSize(endi+1);
+	ids.setAll(-1);
 
-	int delta = 0;
-	int k;
-	while (sumduration < duration) {
-		if (score[di[i+delta]].getDuration() !=
-				score[di[j+delta]].getDuration()) {
-			return 0;
+	unordered_map<string, int> idmap;
+	Array<int> notes;
+	string key;
+	long long dur;
+	int i;
+	for (i=starti; i<=endi; i++) {
+		score.getNoteList(notes, di[i], nlflag);
+		dur = score.getDurationTicks(di[i]);
+		key.assign((const char*)&dur, sizeof(dur));
+		key.append((const char*)notes.getBase(), notes.getSize() * sizeof(int));
+		auto it = idmap.find(key);
+		if (it == idmap.end()) {
+			ids[i] = (int)idmap.size();
+			idmap[key] = ids[i];
 		} else {
-			sumduration += duration;
+			ids[i] = it->second;
 		}
+	}
+}
 
-		if (allnotes[i+delta].getSize() != allnotes[j+delta].getSize()) {
-			return 0;
-		}
 
-		for (k=0; k<allnotes[i+delta].getSize(); k++) {
-			if (allnotes[i+delta][k] != allnotes[j+delta][k]) {
-				return 0;
-			}
+
+//////////////////////////////
+//
+// private: HumdrumFile::getClicheWindows -- for use with analyzeCliche.
+//    Calculate the number of data lines which are needed from each
+//    starting line for the sonorities to last the given duration, and
+//    a hash of the sonority IDs in that window.  The length is -1 if
+//    the window would extend past the end of the search range.
+//
+
+void HumdrumFile::getClicheWindows(Array<int>& lengths,
+		Array<unsigned long long>& hashes, Array<int>& ids, Array<int>& di,
+		int starti, int endi, double duration) {
+	HumdrumFile& score = *this;
+	const unsigned long long base = 1000003ULL;
+	int size = endi - starti + 1;
+
+	lengths.setSize(endi+1);
+	lengths.setAll(-1);
+	hashes.setSize(endi+1);
+	hashes.setAll(0);
+
+	// prefix[k] is the hash of the first k sonorities in the range,
+	// and power[k] is base^k (both modulo 2^64).
+	Array<unsigned long long> prefix(size+1);
+	Array<unsigned long long> power(size+1);
+	prefix[0] = 0;
+	power[0] = 1;
+	int i;
+	for (i=0; i<size; i++) {
+		prefix[i+1] = prefix[i] * base + (unsigned long long)ids[starti+i] + 1;
+		power[i+1] = power[i] * base;
+	}
+
+	// Window durations are summed on the integer tick timeline so that
+	// there is no rounding error.  Durations are never negative, so the
+	// end of the window only moves forward as the start moves forward.
+	long long target = (long long)ceil(duration * getTicksPerQuarter() - 1e-6);
+	int stopi = starti;     // first line after the window
+	long long sum = 0;      // duration of lines i..stopi-1
+	int length;
+	for (i=starti; i<=endi; i++) {
+		while ((sum < target) && (stopi <= endi)) {
+			sum += score.getDurationTicks(di[stopi]);
+			stopi++;
+		}
+		if (sum >= target) {
+			length = stopi - i;
+			lengths[i] = length;
+			hashes[i] = prefix[stopi-starti] -
+					prefix[i-starti] * power[length];
+			// also separate windows of different lengths:
+			hashes[i] = hashes[i] * base + length;
+		}
+		if (stopi > i) {
+			sum -= score.getDurationTicks(di[i]);
+		} else {
+			stopi = i + 1;
 		}
-		delta++;
 	}
+}
+
 
+
+//////////////////////////////
+//
+// private: HumdrumFile::attemptMatch -- for use with analyzeCliche.
+//    Returns true if the windows of sonorities starting at data lines
+//    i and j are the same.
+//
+
+int HumdrumFile::attemptMatch(Array<int>& ids, Array<int>& lengths,
+		int i, int j) {
+	if (lengths[i] != lengths[j]) {
+		return 0;
+	}
+	for (int k=0; k<lengths[i]; k++) {
+		if (ids[i+k] != ids[j+k]) {
+			return 0;
+		}
+	}
 	return 1;
 }
 
@@ -4222,6 +5036,25 @@ void HumdrumFile::analyzeAttackAccentuation(Array<int>& atakcent) {
 
 
 
+//////////////////////////////
+//
+// private: HumdrumFile::getMetricLevels -- returns the metric levels of
+//    the lines in the file as calculated by analyzeMetricLevel().  The
+//    levels are stored until the rhythm analysis changes so that the
+//    windowed note extraction functions (such as getNoteArray()) do not
+//    redo the meter analysis for every window.
+//
+
+Array<int>& HumdrumFile::getMetricLevels(void) {
+	if (!levelcheck || (levelcache.getSize() != getNumLines())) {
+		analyzeMetricLevel(levelcache);
+		levelcheck = 1;
+	}
+	return levelcache;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::analyzeMetricLevel -- determine the metric level of
@@ -4273,90 +5106,97 @@ void HumdrumFile::analyzeMetricLevel(Array<int>& metlev) {
 		score.analyzeRhythm();
 	}
 
+	for (i=0; i<score.getNumLines(); i++) {
+		if (!score[i].isData()) {
+			continue;
+		}
+		metlev[i] = calculateMetricLevel(score[i].getBeat(), msigtop[i],
+				msigbottom[i], iscompound[i]);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::calculateMetricLevel -- return the metric level of a
+//    position in a measure (1.0 = first beat) for the given time signature
+//    values from analyzeMeter().  Level 0 is the beat, negative levels are
+//    groupings of beats and positive levels are subdivisions of the beat.
+//
+
+int HumdrumFile::calculateMetricLevel(double beat, double top,
+		double bottom, int compound) {
 	int level = 0;
 	double metloc;
 	double fraction;
 	double testtriplet;
 	double testhigher;
 	double highertriplet;
-	for (i=0; i<score.getNumLines(); i++) {
-		if (!score[i].isData()) {
-			continue;
-		}
-		level = 0;
-		metloc = score[i].getBeat() - 1.0;   // put beat 1 at 0
-		if (iscompound[i]) {  // adjust metric position for compound meters
-			metloc = metloc / 3.0;
-		}
-		fraction = metloc - (int)metloc;
-		if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
-			// check for higher levels of metrical grouping
-			if (metloc == 0.0) {
-				if (iscompound[i]) {
-					metlev[i] = (int)(-1.0*log10(msigtop[i]*msigbottom[i]*2.0/3.0)/log10(2.0));
-				} else {
-					metlev[i] = (int)(-1.0 * log10(msigtop[i]*msigbottom[i])/log10(2.0));
-				}
 
-				continue;
+	metloc = beat - 1.0;   // put beat 1 at 0
+	if (compound) {  // adjust metric position for compound meters
+		metloc = metloc / 3.0;
+	}
+	fraction = metloc - (int)metloc;
+	if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
+		// check for higher levels of metrical grouping
+		if (metloc == 0.0) {
+			if (compound) {
+				return (int)(-1.0*log10(top*bottom*2.0/3.0)/log10(2.0));
+			} else {
+				return (int)(-1.0 * log10(top*bottom)/log10(2.0));
 			}
+		}
 
-			testhigher = metloc;
-			while (level > -5) {
-				testhigher = testhigher / 2.0;
-				level--;
-				fraction = testhigher - (int)testhigher;
+		testhigher = metloc;
+		while (level > -5) {
+			testhigher = testhigher / 2.0;
+			level--;
+			fraction = testhigher - (int)testhigher;
+			if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
+				return level;
+			}
+			if (compound) {
+				highertriplet = metloc * 2.0/3.0; // check for triplets on level
+				fraction = highertriplet - (int)highertriplet;
 				if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
-					metlev[i] = level;
-					break;
-				}
-				if (iscompound[i]) {
-					highertriplet = metloc * 2.0/3.0; // check for triplets on level
-					fraction = highertriplet - (int)highertriplet;
-					if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
-						metlev[i] = level;
-						break;
-					}
+					return level;
 				}
 			}
-
-			continue;
 		}
 
-		// inside of subdivision of a beat if getting to this point
-		level = 0;
-		while (level < 10) {
-			if (iscompound[i]) {
-				metloc = metloc * 2.0; // just base 2 checking for now
-				level++;
+		return 0;
+	}
+
+	// inside of subdivision of a beat if getting to this point
+	level = 0;
+	while (level < 10) {
+		if (compound) {
+			metloc = metloc * 2.0; // just base 2 checking for now
+			level++;
+			testtriplet = metloc * 3.0/2.0; // check for triplets on level
+			fraction = testtriplet - (int)testtriplet;
+			if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
+				return level;
+			}
+		} else {
+			metloc = metloc * 2.0; // just base 2 checking for now
+			level++;
+			fraction = metloc - (int)metloc;
+			if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
+				return level;
+			} else {
 				testtriplet = metloc * 3.0/2.0; // check for triplets on level
 				fraction = testtriplet - (int)testtriplet;
 				if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
-					metlev[i] = level;
-					break;
-				}
-			} else {
-				metloc = metloc * 2.0; // just base 2 checking for now
-				level++;
-				fraction = metloc - (int)metloc;
-				if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
-					metlev[i] = level;
-					break;
-				} else {
-					testtriplet = metloc * 3.0/2.0; // check for triplets on level
-					fraction = testtriplet - (int)testtriplet;
-					if (fraction < ROUNDERR || fraction > (1-ROUNDERR)) {
-						metlev[i] = level;
-						break;
-					}
+					return level;
 				}
 			}
-
-		}
-		if (level >= 10) {
-			metlev[i] = level;
 		}
 	}
+
+	return level;
 }
 
 
@@ -4534,6 +5374,22 @@ void HumdrumFile::getBase12PitchList(Array<int>& list, int line, int attackQ) {
 	HumdrumRecord& arecord = (*this)[line];
 	list.setSize(arecord.getFieldCount());
 	list.setSize(0);
+
+	int index = getSonorityIndex(line);
+	if (index >= 0) {
+		int stop = index + soncount[line];
+		for (int i=index; i<stop; i++) {
+			if (sonflags[i] & SON_RESTFIELD) {
+				continue;
+			}
+			if (attackQ && (sonflags[i] & (SON_SUSTAIN | SON_TIED))) {
+				continue;
+			}
+			list.append(sonmidi[i]);
+		}
+		return;
+	}
+
 	int j, k;
 	int ii, jj;
 	int tcount;
@@ -4678,37 +5534,7 @@ string HumdrumFile::getForteSetNameString(int line) {
 const char* HumdrumFile::getForteSetName(int line) {
 	Array<int> iv;
 	Array<int> base12;
-	HumdrumRecord& arecord = (*this)[line];
-	base12.setSize(arecord.getFieldCount());
-	base12.setSize(0);
-	int j, k;
-	int ii, jj;
-	int tcount;
-	char buffer[128] = {0};
-	int value;
-	for (j=0; j<arecord.getFieldCount(); j++) {
-		if (!arecord.isExInterp(j, "**kern")) {
-			continue;
-		}
-		ii = line;
-		jj = j;
-		if (strcmp(arecord[j], ".") == 0) {
-			ii = arecord.getDotLine(j);
-			jj = arecord.getDotSpine(j);
-			if (ii < 0 || jj < 0) {
-				continue;
-			}
-		}
-		if (strchr((*this)[ii][jj], 'r') != NULL) {
-			continue;
-		}
-		tcount = (*this)[ii].getTokenCount(jj);
-		for (k=0; k<tcount; k++) {
-			(*this)[ii].getToken(buffer, jj, k);
-			value = Convert::kernToMidiNoteNumber(buffer);
-			base12.append(value);
-		}
-	}
+	getBase12PitchList(base12, line, 0);
 
 	if (base12.getSize() == 0) {
 		return "0-0";
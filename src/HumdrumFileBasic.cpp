@@ -18,6 +18,13 @@
 // Last Modified: Tue Apr 24 16:37:34 PDT 2012 added jrp:// URI
 // Last Modified: Tue Dec 11 17:23:04 PST 2012 added fileName, segmentLevel
 // Last Modified: Mon Apr  1 16:44:32 PDT 2013 added printNonemptySegmentLevel
+// Last Modified: Sun Oct 18 16:49:47 PDT 2026 share records in copies
+// Last Modified: Sun Oct 18 17:12:42 PDT 2026 streaming VTS checksums
+// Last Modified: Sun Oct 18 17:38:39 PDT 2026 added filled-token table
+// Last Modified: Sun Oct 18 18:55:16 PDT 2026 added profiling timers
+// Last Modified: Sun Oct 18 19:08:55 PDT 2026 analyze spines of extract()
+// Last Modified: Sun Oct 18 19:28:24 PDT 2026 buffered output of write()
+// Last Modified: Sun Oct 18 21:12:02 PDT 2026 added getEditCount()
 // Filename:      ...sig/src/sigInfo/HumdrumFileBasic.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFileBasic.cpp
 // Syntax:        C++
@@ -31,6 +38,8 @@
 #include "HumdrumFileBasic.h"
 #include "PDFFile.h"
 #include "CheckSum.h"
+#include "Profiler.h"
+#include "HumdrumWriter.h"
 
 #include <cctype>
 #include <cstdio>
@@ -187,6 +196,157 @@ void HumdrumFileAddress::setLineField(int aLine, int aField) {
 
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// HumdrumFilledIterator class
+//
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::HumdrumFilledIterator --
+//
+
+HumdrumFilledIterator::HumdrumFilledIterator(HumdrumFileBasic& aFile,
+		int aLine) {
+	file  = &aFile;
+	line  = aLine;
+	field = 0;
+	cell  = aFile.getFilledCell(aLine, 0);
+	if (cell >= 0) {
+		count   = aFile.dotoffset[aLine+1] - aFile.dotoffset[aLine];
+		sources = aFile.dotsource.getBase();
+	} else {
+		// line is not in the table, so look up each field separately
+		count   = aFile[aLine].getFieldCount();
+		sources = NULL;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::~HumdrumFilledIterator --
+//
+
+HumdrumFilledIterator::~HumdrumFilledIterator() {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::isValid -- returns true if the iterator has
+//     not gone past the last field on the line.
+//
+
+int HumdrumFilledIterator::isValid(void) {
+	return field < count;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::next -- move to the next field on the line.
+//
+
+void HumdrumFilledIterator::next(void) {
+	field++;
+	cell++;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::getField -- returns the current field on the line.
+//
+
+int HumdrumFilledIterator::getField(void) {
+	return field;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::getCell -- returns the index of the current
+//     field in the filled-token table, or -1 if the line is not in the table.
+//
+
+int HumdrumFilledIterator::getCell(void) {
+	if (sources == NULL) {
+		return -1;
+	}
+	return cell;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::getSourceLine -- returns the line of the token
+//     which the current field refers to, or -1 if a null token has
+//     no previous token.
+//
+
+int HumdrumFilledIterator::getSourceLine(void) {
+	if (sources == NULL) {
+		return file->getFilledLine(line, field);
+	}
+	return sources[2*cell];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::getSourceField -- returns the field of the token
+//     which the current field refers to, or -1 if a null token has
+//     no previous token.
+//
+
+int HumdrumFilledIterator::getSourceField(void) {
+	if (sources == NULL) {
+		return file->getFilledField(line, field);
+	}
+	return sources[2*cell+1];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::isNull -- returns true if the current field
+//     is a null token.
+//
+
+int HumdrumFilledIterator::isNull(void) {
+	return getSourceLine() != line;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFilledIterator::getToken -- returns the token which the current
+//     field refers to, or an empty string if a null token has no
+//     previous token.
+//
+
+const char* HumdrumFilledIterator::getToken(void) {
+	int sline  = getSourceLine();
+	int sfield = getSourceField();
+	if ((sline < 0) || (sfield < 0)) {
+		return HumdrumFileBasic::empty;
+	}
+	return (*file)[sline][sfield];
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // HumdrumFileBasic class
@@ -204,6 +364,7 @@ HumdrumFileBasic::HumdrumFileBasic(void) {
 	records.setGrowth(1000000);      // grow in increments of 1000000 lines
 	maxtracks = 0;
 	segmentLevel = 0;
+	editcount = 0;
 }
 
 
@@ -214,6 +375,7 @@ HumdrumFileBasic::HumdrumFileBasic(const HumdrumFileBasic& aHumdrumFileBasic) {
 	records.setGrowth(1000000);      // grow in increments of 1000000 lines
 	maxtracks = 0;
 	segmentLevel = 0;
+	editcount = 0;
 
 	*this = aHumdrumFileBasic;
 }
@@ -226,6 +388,7 @@ HumdrumFileBasic::HumdrumFileBasic(const char* filename) {
 	records.setAllocSize(1000000);    // grow in increments of 1000000 lines
 	maxtracks = 0;
 	segmentLevel = 0;
+	editcount = 0;
 
 	ifstream infile(filename, ios::in);
 
@@ -259,6 +422,7 @@ HumdrumFileBasic::HumdrumFileBasic(const string& filename) {
 	records.setAllocSize(1000000);    // grow in increments of 1000000 lines
 	maxtracks = 0;
 	segmentLevel = 0;
+	editcount = 0;
 
 	ifstream infile(filename.data(), ios::in);
 
@@ -349,15 +513,18 @@ void HumdrumFileBasic::appendLine(const char* aLine) {
 	HumdrumRecord* aRecord;
 	aRecord = new HumdrumRecord;
 	aRecord->setLine(aLine);
+	aRecord->setEditCounter(&editcount);
 	records[records.getSize()] = aRecord;
+	editcount++;
 }
 
 
 void HumdrumFileBasic::appendLine(HumdrumRecord& aRecord) {
 	HumdrumRecord *tempRecord;
-	tempRecord = new HumdrumRecord;
-	*tempRecord = aRecord;
+	tempRecord = new HumdrumRecord(aRecord);
+	tempRecord->setEditCounter(&editcount);
 	records[records.getSize()] = tempRecord;
+	editcount++;
 }
 
 
@@ -384,7 +551,10 @@ void HumdrumFileBasic::clear(void) {
 	records.setSize(0);
 	maxtracks = 0;
 	segmentLevel = 0;
+	editcount++;
 	trackexinterp.clear();
+	dotoffset.setSize(0);
+	dotsource.setSize(0);
 }
 
 
@@ -525,6 +695,8 @@ HumdrumFileBasic HumdrumFileBasic::extract(int aField) {
 		}
 	}
 
+	output.analyzeSpines();
+	output.analyzeDots();
 	return output;
 }
 
@@ -540,22 +712,50 @@ void HumdrumFileBasic::getNonNullAddress(HumdrumFileAddress& add) {
 	if (strcmp(afile[add], ".") != 0) {
 		return;
 	}
-	int i = afile[add.line()].getDotLine(add.field());
-	int j = afile[add.line()].getDotField(add.field());
+	int i = getFilledLine(add.line(), add.field());
+	int j = getFilledField(add.line(), add.field());
 	add.line() = i;
 	add.field() = j;
 }
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBasic::getEditCount -- returns the number of times that
+//     lines were added to the file or its records were changed.  Stored
+//     analyses of the file can compare this value with the one at the
+//     time of the analysis to tell if they are out of date.
+//
+
+unsigned int HumdrumFileBasic::getEditCount(void) {
+	return editcount;
+}
+
+
+
 ///////////////////////////////
 //
-// HumdrumFileBasic::getDotValue --
+// HumdrumFileBasic::getDotValue -- returns the token which a null
+//     token refers to.  Returns an empty string if the token is not
+//     a null token.
 //
 
 const char* HumdrumFileBasic::getDotValue(int index, int spinei) {
-	int line  = (*this)[index].getDotLine(spinei);
-	int spine = (*this)[index].getDotSpine(spinei);
+	int line;
+	int spine;
+	int cell = getFilledCell(index, spinei);
+	if (cell >= 0) {
+		line  = dotsource[2*cell];
+		spine = dotsource[2*cell+1];
+		if (line == index) {
+			// not a null token
+			return HumdrumFileBasic::empty;
+		}
+	} else {
+		line  = (*this)[index].getDotLine(spinei);
+		spine = (*this)[index].getDotSpine(spinei);
+	}
 
 	if (line < 0 || spine < 0) {
 		return HumdrumFileBasic::empty;
@@ -566,6 +766,101 @@ const char* HumdrumFileBasic::getDotValue(int index, int spinei) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBasic::getFilledCell -- returns the index of a field in the
+//     filled-token table which is created by analyzeDots().  Cells of
+//     the same data line are stored one after another, and data lines are
+//     stored in order.  Returns -1 if the field is not in the table
+//     (such as fields on non-data lines).
+//
+
+int HumdrumFileBasic::getFilledCell(int index, int spinei) {
+	if ((index < 0) || (index >= dotoffset.getSize() - 1) || (spinei < 0)) {
+		return -1;
+	}
+	int cell = dotoffset[index] + spinei;
+	if (cell >= dotoffset[index+1]) {
+		return -1;
+	}
+	return cell;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::getFilledCellCount -- returns the number of cells
+//     in the filled-token table.
+//
+
+int HumdrumFileBasic::getFilledCellCount(void) {
+	return dotsource.getSize() / 2;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::getFilledLine -- returns the line of the token which
+//     a field refers to.  This is the line itself for fields which are
+//     not null tokens, and the line of the previous non-null token in the
+//     spine for null tokens (or -1 if there is no previous token).
+//
+
+int HumdrumFileBasic::getFilledLine(int index, int spinei) {
+	int cell = getFilledCell(index, spinei);
+	if (cell >= 0) {
+		return dotsource[2*cell];
+	}
+	if (((*this)[index].getType() == E_humrec_data) &&
+			(strcmp((*this)[index][spinei], ".") == 0)) {
+		return (*this)[index].getDotLine(spinei);
+	}
+	return index;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::getFilledField -- returns the field of the token which
+//     a field refers to (see getFilledLine()).
+//
+
+int HumdrumFileBasic::getFilledField(int index, int spinei) {
+	int cell = getFilledCell(index, spinei);
+	if (cell >= 0) {
+		return dotsource[2*cell+1];
+	}
+	if (((*this)[index].getType() == E_humrec_data) &&
+			(strcmp((*this)[index][spinei], ".") == 0)) {
+		return (*this)[index].getDotSpine(spinei);
+	}
+	return spinei;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::getFilledToken -- returns the token which a field
+//     refers to: the token itself if it is not a null token, or else the
+//     previous non-null token in the spine.  Returns an empty string for
+//     null tokens which have no previous token.
+//
+
+const char* HumdrumFileBasic::getFilledToken(int index, int spinei) {
+	int line  = getFilledLine(index, spinei);
+	int spine = getFilledField(index, spinei);
+	if (line < 0 || spine < 0) {
+		return HumdrumFileBasic::empty;
+	}
+	return (*this)[line][spine];
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileBasic::getMaxTracks --
@@ -788,11 +1083,13 @@ HumdrumFileBasic& HumdrumFileBasic::operator=(const HumdrumFileBasic& aFile) {
 		records[i] = NULL;
 	}
 
+	// copies of the records share their text until modified
 	records.setSize(aFile.records.getSize());
 	for (i=0; i<aFile.records.getSize(); i++) {
-		records[i] = new HumdrumRecord;
-		*(records[i]) = *(aFile.records[i]);
+		records[i] = new HumdrumRecord(*(aFile.records[i]));
+		records[i]->setEditCounter(&editcount);
 	}
+	editcount = aFile.editcount;
 
 	maxtracks = aFile.maxtracks;
 
@@ -801,6 +1098,9 @@ HumdrumFileBasic& HumdrumFileBasic::operator=(const HumdrumFileBasic& aFile) {
 	for (i=0; i<(int)aFile.trackexinterp.size(); i++) {
 		trackexinterp[i] = aFile.trackexinterp[i];
 	}
+
+	dotoffset = aFile.dotoffset;
+	dotsource = aFile.dotsource;
 	return *this;
 }
 
@@ -817,6 +1117,7 @@ void HumdrumFileBasic::read(const string& filename) {
 
 
 void HumdrumFileBasic::read(const char* filename) {
+	PROFILE_SCOPE("HumdrumFileBasic::read");
 #ifdef USING_URI
 	if (strstr(filename, "://") != NULL) {
 		if (strncmp(filename, "http://", strlen("http://")) == 0) {
@@ -884,6 +1185,7 @@ void HumdrumFileBasic::read(const char* filename) {
 
 
 void HumdrumFileBasic::read(istream& inStream) {
+	PROFILE_SCOPE("HumdrumFileBasic::read");
 	char* templine;
 	templine = new char[4096];
 	int linecount = 0;
@@ -1009,16 +1311,16 @@ void HumdrumFileBasic::write(const char* filename) {
 		exit(1);
 	}
 
-	for (int i=0; i<records.getSize(); i++) {
-		outfile << records[i]->getLine() << endl;
-	}
+	HumdrumWriter writer(outfile);
+	writer.writeFile(*this);
 }
 
 
 void HumdrumFileBasic::write(ostream& outStream) {
-	for (int i=0; i<records.getSize(); i++) {
-		outStream << records[i]->getLine() << endl;
-	}
+	HumdrumWriter writer(outStream);
+	writer.writeFile(*this);
+	writer.flush();
+	outStream.flush();
 }
 
 
@@ -1034,9 +1336,8 @@ void HumdrumFileBasic::write(ostream& outStream) {
 
 ostream& operator<<(ostream& out, HumdrumFileBasic& aHumdrumFileBasic) {
 	aHumdrumFileBasic.printNonemptySegmentLabel(out);
-	for (int i=0; i<aHumdrumFileBasic.getNumLines(); i++) {
-		out << aHumdrumFileBasic[i].getLine() << '\n';
-	}
+	HumdrumWriter writer(out);
+	writer.writeFile(aHumdrumFileBasic);
 	return out;
 }
 
@@ -1055,6 +1356,7 @@ ostream& operator<<(ostream& out, HumdrumFileBasic& aHumdrumFileBasic) {
 //
 
 void HumdrumFileBasic::privateSpineAnalysis(void) {
+	PROFILE_SCOPE("HumdrumFileBasic::analyzeSpines");
 	int init    = 0;
 	int spineid = 0;
 	vector<string> spineinfo;
@@ -1516,6 +1818,7 @@ int HumdrumFileBasic::predictNewSpineCount(HumdrumRecord& aRecord) {
 //
 
 void HumdrumFileBasic::privateDotAnalysis(void) {
+	PROFILE_SCOPE("HumdrumFileBasic::analyzeDots");
 	Array<int> lastline;
 	Array<int> lastspine;
 
@@ -1523,6 +1826,21 @@ void HumdrumFileBasic::privateDotAnalysis(void) {
 	int count = 0;
 	int newcount = 0;
 	int length = (*this).getNumLines();
+
+	// The filled-token table stores the source line and field of every
+	// field on data lines in one contiguous array.
+	int cellcount = 0;
+	dotoffset.setSize(length+1);
+	for (i=0; i<length; i++) {
+		dotoffset[i] = cellcount;
+		if ((*this)[i].getType() == E_humrec_data) {
+			cellcount += (*this)[i].getFieldCount();
+		}
+	}
+	dotoffset[length] = cellcount;
+	dotsource.setSize(cellcount * 2);
+	int* source = dotsource.getBase();
+
 	for (i=0; i<length; i++) {
 		if (strncmp((*this)[i][0], "**", 2) == 0) {
 			count = (*this)[i].getFieldCount();
@@ -1561,6 +1879,8 @@ void HumdrumFileBasic::privateDotAnalysis(void) {
 					lastline[j] = i;
 					lastspine[j] = j;
 				}
+				source[2*(dotoffset[i]+j)]   = lastline[j];
+				source[2*(dotoffset[i]+j)+1] = lastspine[j];
 			}
 		}
 	}
@@ -1685,13 +2005,7 @@ void HumdrumFileBasic::extractEmbeddedDataFromPdf(ostream& outputData,
 		istream& inputData) {
 	PDFFile pdffile;
 	pdffile.process(inputData);
-	int filecount = pdffile.getEmbeddedFileCount();
-	int i;
-	for (i=0; i<filecount; i++) {
-		if (pdffile.isEmbeddedHumdrumFile(i)) {
-			pdffile.getEmbeddedFileContents(i, outputData);
-		}
-	}
+	pdffile.getEmbeddedHumdrumFiles(outputData);
 }
 
 
@@ -2269,17 +2583,7 @@ void HumdrumFileBasic::makeVts(string& vtsstring) {
 
 void HumdrumFileBasic::makeVts(Array<char>& vtsstring,
 		HumdrumFileBasic& infile) {
-	int i;
-	stringstream tstream;
-	for (i=0; i<infile.getNumLines(); i++) {
-		if (strncmp(infile[i][0], "!!!VTS", 6) == 0) {
-			continue;
-		}
-		tstream << infile[i] << (char)0x0a;
-	}
-	tstream << ends;
-	int len = strlen(tstream.str().c_str());
-	unsigned long checksum = CheckSum::crc32(tstream.str().c_str(), len);
+	unsigned long checksum = HumdrumFileBasic::getVtsChecksum(infile, 0);
 	char buffer[128] = {0};
 	snprintf(buffer, 128, "!!!VTS: %lu", checksum);
 	vtsstring.setSize(strlen(buffer) + 1);
@@ -2288,15 +2592,7 @@ void HumdrumFileBasic::makeVts(Array<char>& vtsstring,
 
 void HumdrumFileBasic::makeVts(string& vtsstring,
 		HumdrumFileBasic& infile) {
-	stringstream tstream;
-	for (int i=0; i<infile.getNumLines(); i++) {
-		if (strncmp(infile[i][0], "!!!VTS", 6) == 0) {
-			continue;
-		}
-		tstream << infile[i] << (char)0x0a;
-	}
-	string tempstr = tstream.str();
-	unsigned long checksum = CheckSum::crc32(tempstr.c_str(), tempstr.size());
+	unsigned long checksum = HumdrumFileBasic::getVtsChecksum(infile, 0);
 	char buffer[128] = {0};
 	snprintf(buffer, 128, "!!!VTS: %lu", checksum);
 	vtsstring = buffer;
@@ -2320,17 +2616,7 @@ void HumdrumFileBasic::makeVtsData(string& vtsstring) {
 
 void HumdrumFileBasic::makeVtsData(Array<char>& vtsstring,
 		HumdrumFileBasic& infile) {
-	int i;
-	stringstream tstream;
-	for (i=0; i<infile.getNumLines(); i++) {
-		if (!infile[i].isData()) {
-			continue;
-		}
-		tstream << infile[i] << (char)0x0a;
-	}
-	tstream << ends;
-	int len = strlen(tstream.str().c_str());
-	unsigned long checksum = CheckSum::crc32(tstream.str().c_str(), len);
+	unsigned long checksum = HumdrumFileBasic::getVtsChecksum(infile, 1);
 	char buffer[128] = {0};
 	snprintf(buffer, 128, "!!!VTS-data: %lu", checksum);
 	vtsstring.setSize(strlen(buffer) + 1);
@@ -2339,18 +2625,40 @@ void HumdrumFileBasic::makeVtsData(Array<char>& vtsstring,
 
 void HumdrumFileBasic::makeVtsData(string& vtsstring,
 		HumdrumFileBasic& infile) {
-	stringstream tstream;
+	unsigned long checksum = HumdrumFileBasic::getVtsChecksum(infile, 1);
+	char buffer[128] = {0};
+	snprintf(buffer, 128, "!!!VTS-data: %lu", checksum);
+	vtsstring = buffer;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::getVtsChecksum -- Return the CRC32 checksum used in
+//     !!!VTS: records (or in !!!VTS-data: records if dataQ is true).
+//     Each record is added to the checksum directly (followed by 0x0a)
+//     rather than first printing the whole file into a string.
+//
+
+unsigned long HumdrumFileBasic::getVtsChecksum(HumdrumFileBasic& infile,
+		int dataQ) {
+	CRC32_CTX context;
+	CheckSum::crc32Init(&context);
+	const char* line;
 	for (int i=0; i<infile.getNumLines(); i++) {
-		if (!infile[i].isData()) {
+		if (dataQ) {
+			if (!infile[i].isData()) {
+				continue;
+			}
+		} else if (strncmp(infile[i][0], "!!!VTS", 6) == 0) {
 			continue;
 		}
-		tstream << infile[i] << (char)0x0a;
+		line = infile[i].getLine();
+		CheckSum::crc32Update(&context, line, strlen(line));
+		CheckSum::crc32Update(&context, "\n", 1);
 	}
-	string tempstring = tstream.str();
-	unsigned long checksum = CheckSum::crc32(tempstring.c_str(), tempstring.size());
-	char buffer[128] = {0};
-	snprintf(buffer, 128, "!!!VTS-data: %lu", checksum);
-	vtsstring = buffer;
+	return CheckSum::crc32Final(&context);
 }
 
 
@@ -22,6 +22,10 @@
 // Last Modified: Sun Dec 26 12:18:34 PST 2010 added setToken
 // Last Modified: Mon Jul 30 16:10:45 PDT 2012 added setSize and setAllFields
 // Last Modified: Mon Dec 10 10:14:08 PST 2012 added Array<char> getToken
+// Last Modified: Sun Oct 18 16:29:47 PDT 2026 reentrant getToken
+// Last Modified: Sun Oct 18 16:49:47 PDT 2026 copy-on-write record text
+// Last Modified: Sun Oct 18 19:28:24 PDT 2026 makeRecordString without streams
+// Last Modified: Sun Oct 18 21:12:02 PDT 2026 edit count of owning file
 // Filename:      ...sig/src/sigInfo/HumdrumRecord.cpp
 // Webpage:       http://sig.sapp.org/src/sigInfo/HumdrumRecord.cpp
 // Syntax:        C++
@@ -45,23 +49,16 @@ using namespace std;
 
 //////////////////////////////
 //
-// HumdrumRecord::HumdrumRecord --
+// HumdrumRecordData::HumdrumRecordData --
 //
 
-HumdrumRecord::HumdrumRecord(void) {
-	duration = 0.0;
-	durationR.zero();
-	meterloc = 0.0;
-	meterlocR.zero();
-	absloc   = 0.0;
-	abslocR.zero();
-	spinewidth = 0;
-
+HumdrumRecordData::HumdrumRecordData(void) {
+	refcount = 1;
 	type = E_unknown;
+	spinewidth = 0;
 	recordString = new char[1];
 	recordString[0] = '\0';
 	modifiedQ = 0;
-	lineno = -1;
 
 	recordFields.allowGrowth(1);
 	recordFields.setSize(32);
@@ -75,49 +72,94 @@ HumdrumRecord::HumdrumRecord(void) {
 
 	spineids.reserve(32);
 
+	dotline.allowGrowth(1);
 	dotline.setSize(32);
 	dotline.setGrowth(132);
 	dotline.setSize(0);
 
+	dotspine.allowGrowth(1);
 	dotspine.setSize(32);
 	dotspine.setGrowth(132);
 	dotspine.setSize(0);
 }
 
 
-HumdrumRecord::HumdrumRecord(const char* aLine, int aLineNum) {
+HumdrumRecordData::HumdrumRecordData(const HumdrumRecordData& aData) {
+	refcount = 1;
+	type = aData.type;
+	spinewidth = aData.spinewidth;
+	recordString = new char[strlen(aData.recordString)+1];
+	strcpy(recordString, aData.recordString);
+	modifiedQ = aData.modifiedQ;
+
+	recordFields.allowGrowth(1);
+	recordFields.setSize(aData.recordFields.getSize());
+	int i;
+	for (i=0; i<aData.recordFields.getSize(); i++) {
+		recordFields[i] = new char[strlen(aData.recordFields[i]) + 1];
+		strcpy(recordFields[i], aData.recordFields[i]);
+	}
+	spineids = aData.spineids;
+	interpretation.allowGrowth(1);
+	interpretation = aData.interpretation;
+	dotline.allowGrowth(1);
+	dotline = aData.dotline;
+	dotspine.allowGrowth(1);
+	dotspine = aData.dotspine;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecordData::~HumdrumRecordData --
+//
+
+HumdrumRecordData::~HumdrumRecordData() {
+	if (recordString != NULL) {
+		delete [] recordString;
+		recordString = NULL;
+	}
+	int i;
+	for (i=0; i<recordFields.getSize(); i++) {
+		if (recordFields[i] != NULL) {
+			delete [] recordFields[i];
+			recordFields[i] = NULL;
+		}
+	}
+	recordFields.setSize(0);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::HumdrumRecord --
+//
+
+HumdrumRecord::HumdrumRecord(void) {
 	duration = 0.0;
 	durationR.zero();
 	meterloc = 0.0;
 	meterlocR.zero();
 	absloc   = 0.0;
 	abslocR.zero();
-	spinewidth = 0;
-
-	lineno = aLineNum;
-	type = determineType(aLine);
-	recordString = new char[1];
-	recordString[0] = '\0';
-	modifiedQ = 0;
-	interpretation.allowGrowth(1);
-	interpretation.setSize(32);
-	interpretation.setGrowth(132);
-	interpretation.setSize(0);
-	recordFields.allowGrowth(1);
-	recordFields.setSize(32);
-	recordFields.setGrowth(132);
-	recordFields.setSize(0);
+	lineno = -1;
+	editcount = NULL;
+	shared = new HumdrumRecordData;
+}
 
-	spineids.reserve(32);
 
-	dotline.allowGrowth(1);
-	dotline.setSize(0);
-	dotline.setSize(32);
-	dotline.setGrowth(132);
-	dotspine.allowGrowth(1);
-	dotspine.setSize(32);
-	dotspine.setGrowth(132);
-	dotspine.setSize(0);
+HumdrumRecord::HumdrumRecord(const char* aLine, int aLineNum) {
+	duration = 0.0;
+	durationR.zero();
+	meterloc = 0.0;
+	meterlocR.zero();
+	absloc   = 0.0;
+	abslocR.zero();
+	lineno = aLineNum;
+	editcount = NULL;
+	shared = new HumdrumRecordData;
 	setLine(aLine);
 }
 
@@ -129,29 +171,10 @@ HumdrumRecord::HumdrumRecord(const HumdrumRecord& aRecord) {
 	meterlocR= aRecord.meterlocR;
 	absloc   = aRecord.absloc;
 	abslocR  = aRecord.abslocR;
-	spinewidth = aRecord.spinewidth;
-	type = aRecord.type;
 	lineno = aRecord.lineno;
-	recordString = new char[strlen(aRecord.recordString)+1];
-	strcpy(recordString, aRecord.recordString);
-	modifiedQ = aRecord.modifiedQ;
-	interpretation.allowGrowth();
-	interpretation.setSize(aRecord.interpretation.getSize());
-	recordFields.allowGrowth();
-	recordFields.setSize(aRecord.recordFields.getSize());
-	spineids.resize(aRecord.spineids.size());
-	dotline.setSize(aRecord.dotline.getSize());
-	dotspine.setSize(aRecord.dotspine.getSize());
-
-	int i;
-	for (i=0; i<aRecord.recordFields.getSize(); i++) {
-		interpretation[i] = aRecord.interpretation[i];
-		recordFields[i] = new char[strlen(aRecord.recordFields[i]) + 1];
-		strcpy(recordFields[i], aRecord.recordFields[i]);
-		spineids[i] = aRecord.spineids[i];
-		dotline[i]  = aRecord.dotline[i];
-		dotspine[i] = aRecord.dotspine[i];
-	}
+	editcount = NULL;
+	shared = aRecord.shared;
+	shared->refcount++;
 }
 
 
@@ -162,26 +185,85 @@ HumdrumRecord::HumdrumRecord(const HumdrumRecord& aRecord) {
 //
 
 HumdrumRecord::~HumdrumRecord() {
-	if (recordString != NULL) {
-		delete [] recordString;
-		recordString = NULL;
+	release();
+	lineno = -1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::isShared -- returns true if the text of the record
+//     is shared with a copy of the record.
+//
+
+int HumdrumRecord::isShared(void) const {
+	return shared->refcount > 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::setEditCounter -- set the edit count of the file
+//     which holds the record.  The counter is incremented each time the
+//     contents of the record are changed, so that analyses stored for
+//     the file can tell if its records were edited since then.
+//     Copies of a record do not share the counter.
+//
+
+void HumdrumRecord::setEditCounter(unsigned int* counter) {
+	editcount = counter;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::markEdited -- increment the edit count of the file
+//     which holds the record, if any.
+//
+
+void HumdrumRecord::markEdited(void) {
+	if (editcount != NULL) {
+		(*editcount)++;
 	}
-	int i;
-	for (i=0; i<recordFields.getSize(); i++) {
-		if (recordFields[i] != NULL) {
-			delete [] recordFields[i];
-			recordFields[i] = NULL;
-		}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::unshare -- make a private copy of the text of the
+//     record before it is modified, if it is shared with other copies
+//     of the record.
+//
+
+void HumdrumRecord::unshare(void) {
+	if (shared->refcount <= 1) {
+		return;
 	}
-	recordFields.setSize(0);
+	HumdrumRecordData* newdata = new HumdrumRecordData(*shared);
+	release();
+	shared = newdata;
+}
 
-	spineids.clear();
 
-	dotline.setSize(0);
-	dotspine.setSize(0);
 
-	lineno = -1;
-	spinewidth = 0;
+//////////////////////////////
+//
+// HumdrumRecord::release -- stop using the current text of the record,
+//     deleting it if no other copy of the record is using it.
+//
+
+void HumdrumRecord::release(void) {
+	if (shared == NULL) {
+		return;
+	}
+	if (--shared->refcount == 0) {
+		delete shared;
+	}
+	shared = NULL;
 }
 
 
@@ -219,19 +301,21 @@ void HumdrumRecord::appendFieldEI(const char* aField, const char* anInterp,
 //
 
 void HumdrumRecord::changeField(int aField, const char* aString) {
+	unshare();
+	markEdited();
 	// don't change self
-	if (aString == recordFields[aField]) {
+	if (aString == shared->recordFields[aField]) {
 		return;
 	}
 
-	if (recordFields[aField] != NULL) {
-		delete [] recordFields[aField];
-		recordFields[aField] = NULL;
+	if (shared->recordFields[aField] != NULL) {
+		delete [] shared->recordFields[aField];
+		shared->recordFields[aField] = NULL;
 	}
-	recordFields[aField] = new char[strlen(aString) + 1];
-	strcpy(recordFields[aField], aString);
+	shared->recordFields[aField] = new char[strlen(aString) + 1];
+	strcpy(shared->recordFields[aField], aString);
 
-	modifiedQ = 1;
+	shared->modifiedQ = 1;
 }
 
 
@@ -243,6 +327,7 @@ void HumdrumRecord::changeField(int aField, const char* aString) {
 //
 
 void HumdrumRecord::copySpineInfo(vector<string>& info, int line) {
+	unshare();
 	int size = (int)info.size();
 	if (size != getFieldCount()) {
 		cout << "Error: new spine information is not the right size" << endl;
@@ -262,13 +347,13 @@ void HumdrumRecord::copySpineInfo(vector<string>& info, int line) {
 
 	// replace the old spine info
 	for (int i=0; i<size; i++) {
-		spineids[i] = info[i];
+		shared->spineids[i] = info[i];
 	}
 }
 
 
 void HumdrumRecord::copySpineInfo(HumdrumRecord& aRecord, int line) {
-	copySpineInfo(aRecord.spineids, line);
+	copySpineInfo(aRecord.shared->spineids, line);
 }
 
 
@@ -282,7 +367,7 @@ void HumdrumRecord::copySpineInfo(HumdrumRecord& aRecord, int line) {
 int HumdrumRecord::equalDataQ(const char* aValue) {
 	int output = 1;
 	for (int i=0; i<getFieldCount(); i++) {
-		if (strcmp(recordFields[i], aValue) != 0) {
+		if (strcmp(shared->recordFields[i], aValue) != 0) {
 			output = 0;
 			break;
 		}
@@ -303,7 +388,7 @@ int HumdrumRecord::equalDataQ(const char* aValue) {
 int HumdrumRecord::equalFieldsQ(void) {
 	int output = 1;
 	for (int i=1; i<getFieldCount(); i++) {
-		if (strcmp(recordFields[i], recordFields[0]) != 0) {
+		if (strcmp(shared->recordFields[i], shared->recordFields[0]) != 0) {
 			output = 0;
 			break;
 		}
@@ -326,7 +411,7 @@ int HumdrumRecord::equalFieldsQ(int anInterp) {
 	}
 	for (int i=index+1; i<getFieldCount(); i++) {
 		if (getExInterpNum(i) == anInterp) {
-			if (strcmp(recordFields[index], recordFields[i]) != 0) {
+			if (strcmp(shared->recordFields[index], shared->recordFields[i]) != 0) {
 				output = 0;
 				break;
 			}
@@ -346,7 +431,7 @@ int HumdrumRecord::equalFieldsQ(int anInterp, const char* compareString) {
 	int output = 1;
 	for (int i=0; i<getFieldCount(); i++) {
 		if (getExInterpNum(i) == anInterp) {
-			if (strcmp(recordFields[i], compareString) != 0) {
+			if (strcmp(shared->recordFields[i], compareString) != 0) {
 				output = 0;
 				break;
 			}
@@ -376,9 +461,9 @@ char* HumdrumRecord::getBibKey(char* buffer, int maxsize) {
 	}
 
 	if (maxsize > 0) {
-		strncpy(buffer, recordFields[0]+3, maxsize);
+		strncpy(buffer, shared->recordFields[0]+3, maxsize);
 	} else {
-		strcpy(buffer, recordFields[0]+3);
+		strcpy(buffer, shared->recordFields[0]+3);
 	}
 	int i;
 	int length = strlen(buffer);
@@ -405,7 +490,7 @@ char* HumdrumRecord::getBibKey(Array<char>& buffer) {
 	  return buffer.getBase();
 	}
 
-	int length = strlen(recordFields[0]+3);
+	int length = strlen(shared->recordFields[0]+3);
 
 	buffer.setSize(length+1);
 
@@ -454,23 +539,23 @@ char* HumdrumRecord::getBibValue(char* buffer, int maxsize) {
 	}
 
 	PerlRegularExpression pre;
-	if (pre.search(recordString, "^!!![^:]+:\\s*(.*)\\s*$", "")) {
+	if (pre.search(shared->recordString, "^!!![^:]+:\\s*(.*)\\s*$", "")) {
 		strcpy(buffer, pre.getSubmatch(1));
 		return buffer;
 	}
 
 /*
-	int length = strlen(recordString);
+	int length = strlen(shared->recordString);
 	int i;
 	int j;
 
 	for (i=3; i<length; i++) {
-		if (recordString[i] == ':') {
+		if (shared->recordString[i] == ':') {
 			i++;
-			while ((i < length) && (std::isspace(recordString[i]))) {
+			while ((i < length) && (std::isspace(shared->recordString[i]))) {
 				i++;
 			}
-			strncpy(buffer, recordString + i, maxsize);
+			strncpy(buffer, shared->recordString + i, maxsize);
 			length = strlen(buffer);
 			for (j=length-1; j>=0; j++) {
 				if (std::isspace(buffer[j])) {
@@ -502,7 +587,7 @@ char* HumdrumRecord::getBibValue(Array<char>& buffer) {
 
 	PerlRegularExpression pre;
 	int length;
-	if (pre.search(recordString, "^!!![^:]+:\\s*(.*)\\s*$", "")) {
+	if (pre.search(shared->recordString, "^!!![^:]+:\\s*(.*)\\s*$", "")) {
 		length = strlen(pre.getSubmatch(1));
 		buffer.setSize(length+1);
 		strcpy(buffer.getBase(), pre.getSubmatch());
@@ -525,7 +610,7 @@ string HumdrumRecord::getBibValue(const string& buffer) {
 	}
 
 	PerlRegularExpression pre;
-	if (pre.search(recordString, "^!!![^:]+:\\s*(.*)\\s*$", "")) {
+	if (pre.search(shared->recordString, "^!!![^:]+:\\s*(.*)\\s*$", "")) {
 		return pre.getSubmatch(1);
 	}
 
@@ -561,7 +646,7 @@ RationalNumber HumdrumRecord::getAbsBeatR(void) const {
 //
 
 int HumdrumRecord::getDotLine(int index) {
-	return dotline[index];
+	return shared->dotline[index];
 }
 
 
@@ -573,7 +658,7 @@ int HumdrumRecord::getDotLine(int index) {
 //
 
 int HumdrumRecord::getDotSpine(int index) {
-	return dotspine[index];
+	return shared->dotspine[index];
 }
 
 
@@ -649,13 +734,13 @@ RationalNumber HumdrumRecord::getDurationR(void) const {
 //
 
 int HumdrumRecord::getExInterpNum(int index) const {
-	if (index >= interpretation.getSize()) {
+	if (index >= shared->interpretation.getSize()) {
 		cout << "Error: accessing too large a spine field number A: " << index
 			  << endl;
 		exit(1);
 	}
 
-	return interpretation[index];
+	return shared->interpretation[index];
 }
 
 
@@ -668,25 +753,25 @@ int HumdrumRecord::getExInterpNum(int index) const {
 //
 
 const char* HumdrumRecord::getExInterp(int index) const {
-	if (index >= interpretation.getSize()) {
-		if(interpretation.getSize() == 0) {
+	if (index >= shared->interpretation.getSize()) {
+		if(shared->interpretation.getSize() == 0) {
 			// return "" for lines such as Global Comments which are
 			// not spine specific.
 			return "";
 		} else {
 			cout << "Error: accessing too large a spine field number B: " << index
 	      << endl;;
-			cout << "Size of interpretation list: " << interpretation.getSize()
+			cout << "Size of interpretation list: " << shared->interpretation.getSize()
 	      << endl;
 			cout << "But you tried to access index: " << index << endl;
-			if (recordString != NULL) {
-				cout << "Line is: " << recordString << endl;
+			if (shared->recordString != NULL) {
+				cout << "Line is: " << shared->recordString << endl;
 			}
 			exit(1);
 		}
 	}
 
-	return Convert::exint.getName(interpretation[index]);
+	return Convert::exint.getName(shared->interpretation[index]);
 }
 
 
@@ -698,7 +783,7 @@ const char* HumdrumRecord::getExInterp(int index) const {
 //
 
 int HumdrumRecord::getFieldCount(void) const {
-	return recordFields.getSize();
+	return shared->recordFields.getSize();
 }
 
 
@@ -710,7 +795,7 @@ int HumdrumRecord::getFieldCount(const char* exinterp) const {
 int HumdrumRecord::getFieldCount(int exinterp) const {
 	int i;
 	int count = 0;
-	for (i=0; i<recordFields.getSize(); i++) {
+	for (i=0; i<shared->recordFields.getSize(); i++) {
 		if (getExInterpNum(i) == exinterp) {
 			count++;
 		}
@@ -773,11 +858,11 @@ int HumdrumRecord::getTracksByExInterp(Array<int>& tracks, const char* exinterp)
 //
 
 const char* HumdrumRecord::getLine(void) {
-	if (modifiedQ == 0) {
-		return recordString;
+	if (shared->modifiedQ == 0) {
+		return shared->recordString;
 	} else {
 		makeRecordString();
-		return recordString;
+		return shared->recordString;
 	}
 }
 
@@ -916,7 +1001,7 @@ int HumdrumRecord::getPrimaryTrack(int spineNumber) {
 //
 
 const string& HumdrumRecord::getSpineInfo(int index) const {
-	return spineids[index];
+	return shared->spineids[index];
 }
 
 
@@ -930,7 +1015,7 @@ const string& HumdrumRecord::getSpineInfo(int index) const {
 //
 
 int HumdrumRecord::getSpineWidth(void) {
-	return spinewidth;
+	return shared->spinewidth;
 }
 
 
@@ -942,6 +1027,8 @@ int HumdrumRecord::getSpineWidth(void) {
 
 void HumdrumRecord::changeToken(int spineIndex, int tokenIndex,
 		const char* newtoken, char separator) {
+	unshare();
+	markEdited();
 	HumdrumRecord& record = *this;
 	char separatorstr[2] = {0};
 	separatorstr[0] = separator;
@@ -965,9 +1052,9 @@ void HumdrumRecord::changeToken(int spineIndex, int tokenIndex,
 		}
 	}
 
-	delete [] recordFields[spineIndex];
-	recordFields[spineIndex] = buff;
-	modifiedQ = 1;
+	delete [] shared->recordFields[spineIndex];
+	shared->recordFields[spineIndex] = buff;
+	shared->modifiedQ = 1;
 }
 
 
@@ -1017,28 +1104,34 @@ char* HumdrumRecord::getToken(char* buffer, int fieldIndex, int tokenIndex,
 		buffersize = 0x7fffffff;
 	}
 
-	char sepstring[2];
-	sepstring[0] = separator;
-	sepstring[1] = '\0';
-
+	// Scan the field in place rather than with strtok() on a static
+	// copy, so that separate HumdrumFiles can be processed in
+	// separate threads.  Adjacent separators are skipped as with strtok().
 	int location = 0;
 	const char* string = (*this)[fieldIndex];
-	// char temp[strlen(string) + 1];  // can't do in MS Visual C++ 6.0
-	static char temp[1024] = {0};      // doing this instead
-	strcpy(temp, string);
-	char *current = NULL;
-	current = strtok(temp, sepstring);
-	while (current != NULL && location < tokenIndex) {
-		current = strtok(NULL, sepstring);
+	const char* current = string;
+	while (*current == separator) {
+		current++;
+	}
+	while (*current != '\0' && location < tokenIndex) {
+		while (*current != '\0' && *current != separator) {
+			current++;
+		}
+		while (*current == separator) {
+			current++;
+		}
 		location++;
 	}
 
-	if (current == NULL) {
+	if (*current == '\0') {
 		buffer[0] = '\0';
 		return buffer;
 	}
 
-	int length = strlen(current);
+	int length = 0;
+	while (current[length] != '\0' && current[length] != separator) {
+		length++;
+	}
 	if (length > buffersize) {
 		length = buffersize - 1;
 	}
@@ -1120,7 +1213,7 @@ void HumdrumRecord::getTokens(vector<string>& tokens, int fieldIndex,
 //
 
 int HumdrumRecord::getType(void) const {
-	return type;
+	return shared->type;
 }
 
 
@@ -1160,23 +1253,23 @@ int HumdrumRecord::isTandem(void) const {
 
 	int i;
 	for (i=0; i<getFieldCount(); i++) {
-		if (strcmp(recordFields[i], "*^") == 0) {
+		if (strcmp(shared->recordFields[i], "*^") == 0) {
 			return 0;
 		}
-		if (strcmp(recordFields[i], "*v") == 0) {
+		if (strcmp(shared->recordFields[i], "*v") == 0) {
 			return 0;
 		}
-		if (strcmp(recordFields[i], "*x") == 0) {
+		if (strcmp(shared->recordFields[i], "*x") == 0) {
 			return 0;
 		}
-		if (strncmp(recordFields[i], "**", 2) == 0) {
+		if (strncmp(shared->recordFields[i], "**", 2) == 0) {
 			return 0;
 		}
-		if (strcmp(recordFields[i], "*-") == 0) {
+		if (strcmp(shared->recordFields[i], "*-") == 0) {
 			// spine terminator operator
 			return 0;
 		}
-		if (strcmp(recordFields[i], "*+") == 0) {
+		if (strcmp(shared->recordFields[i], "*+") == 0) {
 			// spine addition operator
 			return 0;
 		}
@@ -1906,7 +1999,7 @@ int HumdrumRecord::hasExclusiveQ(void) const {
 	int output = 0;
 	int i;
 	for (i=0; i<getFieldCount(); i++) {
-		if (strncmp("**", recordFields[i], 2) == 0) {
+		if (strncmp("**", shared->recordFields[i], 2) == 0) {
 			output = 1;
 			break;
 		}
@@ -1930,19 +2023,19 @@ int HumdrumRecord::hasPathQ(void) const {
 	int output = 0;
 	int i;
 	for (i=0; i<getFieldCount(); i++) {
-		if (strcmp("*-", recordFields[i]) == 0) {
+		if (strcmp("*-", shared->recordFields[i]) == 0) {
 			output = 1;
 			break;
-		} else if (strcmp("*+", recordFields[i]) == 0) {
+		} else if (strcmp("*+", shared->recordFields[i]) == 0) {
 			output = 1;
 			break;
-		} else if (strcmp("*x", recordFields[i]) == 0) {
+		} else if (strcmp("*x", shared->recordFields[i]) == 0) {
 			output = 1;
 			break;
-		} else if (strcmp("*v", recordFields[i]) == 0) {
+		} else if (strcmp("*v", shared->recordFields[i]) == 0) {
 			output = 1;
 			break;
-		} else if (strcmp("*^", recordFields[i]) == 0) {
+		} else if (strcmp("*^", shared->recordFields[i]) == 0) {
 			output = 1;
 			break;
 		}
@@ -1961,49 +2054,52 @@ int HumdrumRecord::hasPathQ(void) const {
 
 void HumdrumRecord::insertField(int index, const char* aField, int anInterp,
 		const char* spinetrace) {
+	unshare();
+	markEdited();
 	if (index < 0) {
 		index = getFieldCount();
 	}
-	recordFields[recordFields.getSize()] = NULL;
-	spineids.resize(spineids.size()+1);
+	shared->recordFields[shared->recordFields.getSize()] = NULL;
+	shared->spineids.resize(shared->spineids.size()+1);
 	// spineids[spineids.getSize()] = NULL;
 
-	interpretation.setSize(interpretation.getSize()+1);
-	interpretation[interpretation.getSize()-1] = E_unknown;
+	shared->interpretation.setSize(shared->interpretation.getSize()+1);
+	shared->interpretation[shared->interpretation.getSize()-1] = E_unknown;
 
 	for (int i=getFieldCount()-2; i>=0; i--) {
 		if (i >= index) {
-			recordFields[i+1]   = recordFields[i];
-			spineids[i+1]       = spineids[i];
-			interpretation[i+1] = interpretation[i];
+			shared->recordFields[i+1]   = shared->recordFields[i];
+			shared->spineids[i+1]       = shared->spineids[i];
+			shared->interpretation[i+1] = shared->interpretation[i];
 		} else {
 			break;
 		}
 	}
 
 	// add the field
-	interpretation[index] = anInterp;
-	recordFields[index]   = new char[strlen(aField)+1];
-	strcpy(recordFields[index], aField);
-	spineids[index] = spinetrace;
+	shared->interpretation[index] = anInterp;
+	shared->recordFields[index]   = new char[strlen(aField)+1];
+	strcpy(shared->recordFields[index], aField);
+	shared->spineids[index] = spinetrace;
 
 	int dummy = -1;
-	dotline.append(dummy);
-	dotspine.append(dummy);
+	shared->dotline.append(dummy);
+	shared->dotspine.append(dummy);
 
-	modifiedQ = 1;
+	shared->modifiedQ = 1;
 }
 
 
 void HumdrumRecord::insertField(int index, const char* aField,
 		const char* anInterp, const char* spinetrace) {
+	unshare();
 
 	int interptype = Convert::exint.getValue(anInterp);
 	if (interptype == E_unknown || interptype == E_UNKNOWN_EXINT) {
 		Convert::exint.add(anInterp);
 	}
 
-	interpretation[index] = Convert::exint.getValue(anInterp);
+	shared->interpretation[index] = Convert::exint.getValue(anInterp);
 
 	insertField(index, aField, interptype, spinetrace);
 }
@@ -2028,42 +2124,11 @@ HumdrumRecord& HumdrumRecord::operator=(const HumdrumRecord& aRecord) {
 	absloc   = aRecord.absloc;
 	abslocR  = aRecord.abslocR;
 
-	int i;
-	type = aRecord.type;
-	if (recordString != NULL) {
-		delete [] recordString;
-		recordString = NULL;
-	}
-	if (aRecord.recordString != NULL) {
-		recordString = new char[strlen(aRecord.recordString)+1];
-		strcpy(recordString, aRecord.recordString);
-	}
-	modifiedQ = aRecord.modifiedQ;
-	interpretation.setSize(aRecord.interpretation.getSize());
-
-	for (i=0; i<recordFields.getSize(); i++) {
-		if (recordFields[i] != NULL) {
-			delete [] recordFields[i];
-			recordFields[i] = NULL;
-		}
-	}
-
-	recordFields.setSize(aRecord.recordFields.getSize());
-	spineids.clear();
-	spineids.resize(aRecord.spineids.size());
-
-	int allocSize = 0;
-	for (i=0; i<aRecord.getFieldCount(); i++) {
-		if (interpretation.getSize() > 0) {
-			 interpretation[i] = aRecord.interpretation[i];
-		}
-		allocSize = strlen(aRecord.recordFields[i]) + 1;
-
-		recordFields[i] = new char[allocSize];
-		strcpy(recordFields[i], aRecord.recordFields[i]);
-
-		spineids[i] = aRecord.spineids[i];
-	}
+	// share the text of the record until one of the copies is changed
+	aRecord.shared->refcount++;
+	release();
+	shared = aRecord.shared;
+	markEdited();
 
 	return *this;
 }
@@ -2099,7 +2164,7 @@ const char* HumdrumRecord::operator[](int index) const {
 		exit(1);
 	}
 
-	return recordFields[index];
+	return shared->recordFields[index];
 }
 
 
@@ -2177,7 +2242,8 @@ void HumdrumRecord::setBeatR(const RationalNumber& aValue) {
 //
 
 void HumdrumRecord::setDotLine(int index, int value) {
-	dotline[index] = value;
+	unshare();
+	shared->dotline[index] = value;
 }
 
 
@@ -2188,7 +2254,8 @@ void HumdrumRecord::setDotLine(int index, int value) {
 //
 
 void HumdrumRecord::setDotSpine(int index, int value) {
-	dotspine[index] = value;
+	unshare();
+	shared->dotspine[index] = value;
 }
 
 
@@ -2231,24 +2298,28 @@ void HumdrumRecord::setDurationR(RationalNumber aValue) {
 //
 
 void HumdrumRecord::setExInterp(int index, int anInterpretation) {
-	if (index >= interpretation.getSize()) {
+	unshare();
+	markEdited();
+	if (index >= shared->interpretation.getSize()) {
 		cout << "Error: accessing too large a field number A: " << index
 			  << " in line: " << getLine() << endl;
 		cout << "Size of record: " << getFieldCount() << endl;
 		cout << "Size of interpretation array: "
-			  << interpretation.getSize() << endl;
+			  << shared->interpretation.getSize() << endl;
 		exit(1);
 	}
 
-	interpretation[index] = anInterpretation;
+	shared->interpretation[index] = anInterpretation;
 }
 
 
 void HumdrumRecord::setExInterp(int index, const char* interpString) {
-	if (index >= interpretation.getSize()) {
+	unshare();
+	markEdited();
+	if (index >= shared->interpretation.getSize()) {
 		cout << "Error: accessing too large a field number B: " << index
 			  << " in line: " << getLine() << endl;
-		cout << "Size of interpretation list: " << interpretation.getSize()
+		cout << "Size of interpretation list: " << shared->interpretation.getSize()
 	   << endl;
 		cout << "But you tried to access index: " << index << endl;
 		exit(1);
@@ -2260,7 +2331,7 @@ void HumdrumRecord::setExInterp(int index, const char* interpString) {
 		Convert::exint.add(interpString);
 	}
 
-	interpretation[index] = Convert::exint.getValue(interpString);
+	shared->interpretation[index] = Convert::exint.getValue(interpString);
 }
 
 
@@ -2271,11 +2342,13 @@ void HumdrumRecord::setExInterp(int index, const char* interpString) {
 //
 
 void HumdrumRecord::setToken(int index, const char* aString) {
-	delete [] recordFields[index];
+	unshare();
+	markEdited();
+	delete [] shared->recordFields[index];
 	int len = strlen(aString);
-	recordFields[index] = new char[len+1];
-	strcpy(recordFields[index], aString);
-	modifiedQ = 1;
+	shared->recordFields[index] = new char[len+1];
+	strcpy(shared->recordFields[index], aString);
+	shared->modifiedQ = 1;
 }
 
 
@@ -2291,42 +2364,44 @@ void HumdrumRecord::setToken(int index, const string& aString) {
 //
 
 void HumdrumRecord::setLine(const char* aLine) {
-	if (recordString != NULL) {
-		delete [] recordString;
-		recordString = NULL;
+	unshare();
+	markEdited();
+	if (shared->recordString != NULL) {
+		delete [] shared->recordString;
+		shared->recordString = NULL;
 	}
 	int length = strlen(aLine);
-	recordString = new char[length+1];
-	strcpy(recordString, aLine);
-	if (recordString[length-1] == 0x0d || recordString[length-1] == 0x0a) {
-		recordString[length-1] = '\0';
+	shared->recordString = new char[length+1];
+	strcpy(shared->recordString, aLine);
+	if (shared->recordString[length-1] == 0x0d || shared->recordString[length-1] == 0x0a) {
+		shared->recordString[length-1] = '\0';
 	}
-	modifiedQ = 0;
+	shared->modifiedQ = 0;
 	int i;
 
-	if (recordFields.getSize() != 0) {
-		for (i=0; i<recordFields.getSize(); i++) {
-			if (recordFields[i] != NULL) {
-				delete recordFields[i];
-				recordFields[i] = NULL;
+	if (shared->recordFields.getSize() != 0) {
+		for (i=0; i<shared->recordFields.getSize(); i++) {
+			if (shared->recordFields[i] != NULL) {
+				delete [] shared->recordFields[i];
+				shared->recordFields[i] = NULL;
 			}
 		}
-		recordFields.setSize(0);
+		shared->recordFields.setSize(0);
 	}
 
-	spineids.clear();
+	shared->spineids.clear();
 
-	type = determineType(recordString);
-	int fieldCount = determineFieldCount(recordString);
+	shared->type = determineType(shared->recordString);
+	int fieldCount = determineFieldCount(shared->recordString);
 
 	// allow for null records
 	if (fieldCount == 0) {
 		fieldCount = 1;
 	}
 
-	interpretation.setSize(fieldCount);
+	shared->interpretation.setSize(fieldCount);
 	for (i=0; i<fieldCount; i++) {
-		interpretation[i] = E_unknown;
+		shared->interpretation[i] = E_unknown;
 	}
 
 	// chop up the input line into data fields to store in array.
@@ -2337,36 +2412,36 @@ void HumdrumRecord::setLine(const char* aLine) {
 	char* temp;
 	int index;
 	if (fieldCount == 1) {
-		temp = new char[strlen(recordString)+1];
-		strcpy(temp, recordString);
-		index = recordFields.getSize();
-		recordFields[index] = temp;
-		spineids.push_back("");
+		temp = new char[strlen(shared->recordString)+1];
+		strcpy(temp, shared->recordString);
+		index = shared->recordFields.getSize();
+		shared->recordFields[index] = temp;
+		shared->spineids.push_back("");
 	} else {
-		while (recordString[i] != '\0') {
-			if (recordString[i] != '\t') {
+		while (shared->recordString[i] != '\0') {
+			if (shared->recordString[i] != '\t') {
 				stop++;
 			} else {
 				temp = new char[stop-start+1];
-				strncpy(temp, &recordString[start], stop-start);
+				strncpy(temp, &shared->recordString[start], stop-start);
 				temp[stop-start] = '\0';
-				index = recordFields.getSize();
-				recordFields[index] = temp;
-				spineids.push_back("");
+				index = shared->recordFields.getSize();
+				shared->recordFields[index] = temp;
+				shared->spineids.push_back("");
 				start = stop = i+1;
 			}
 			i++;
 		}
 		temp = new char[stop-start+1];
-		strncpy(temp, &recordString[start], stop-start);
+		strncpy(temp, &shared->recordString[start], stop-start);
 		temp[stop-start] = '\0';
-		index = recordFields.getSize();
-		recordFields[index] = temp;
-		spineids.push_back("");
+		index = shared->recordFields.getSize();
+		shared->recordFields[index] = temp;
+		shared->spineids.push_back("");
 	}
 
-	dotline.setSize(fieldCount);
-	dotspine.setSize(fieldCount);
+	shared->dotline.setSize(fieldCount);
+	shared->dotspine.setSize(fieldCount);
 	for (i=0; i<fieldCount; i++) {
 		setDotLine(i, -1);
 		setDotSpine(i, -1);
@@ -2392,7 +2467,8 @@ void HumdrumRecord::setLineNum(int aNumber) {
 //
 
 void HumdrumRecord::setSpineID(int index, const char* anID) {
-	spineids[index] = anID;
+	unshare();
+	shared->spineids[index] = anID;
 }
 
 
@@ -2404,14 +2480,15 @@ void HumdrumRecord::setSpineID(int index, const char* anID) {
 //
 
 void HumdrumRecord::setSpineWidth(int aSize) {
+	unshare();
 	if (aSize >= 0) {
-		int oldsize = spinewidth;
-		spinewidth = aSize;
-		interpretation.setSize(spinewidth);
+		int oldsize = shared->spinewidth;
+		shared->spinewidth = aSize;
+		shared->interpretation.setSize(shared->spinewidth);
 		int i;
-		if (oldsize > spinewidth) {
-			for (i=oldsize; i<spinewidth; i++) {
-				interpretation[i] = E_UNKNOWN_EXINT;
+		if (oldsize > shared->spinewidth) {
+			for (i=oldsize; i<shared->spinewidth; i++) {
+				shared->interpretation[i] = E_UNKNOWN_EXINT;
 			}
 		}
 	}
@@ -4314,24 +4391,41 @@ const char* HumdrumRecord::getBibLangIso639_2(const char* string) {
 
 //////////////////////////////
 //
-// HumdrumRecord::makeRecordString --
+// HumdrumRecord::makeRecordString -- rebuild the text of the record
+//     from its fields.  This is done on a private copy of the text,
+//     since other copies of the record may be reading the shared text
+//     at the same time.
 //
 
 void HumdrumRecord::makeRecordString(void) {
-	stringstream temp;
-	char tab = '\t';
-	for (int i=0; i<recordFields.getSize()-1; i++) {
-		temp << recordFields[i] << tab;
+	unshare();
+	SigCollection<char*>& fields = shared->recordFields;
+	int count = fields.getSize();
+	int i;
+
+	// join the fields with tabs directly into the new string
+	int length = 0;
+	for (i=0; i<count; i++) {
+		length += strlen(fields[i]) + 1;
+	}
+	char* line = new char[length > 0 ? length : 1];
+	char* end = line;
+	int size;
+	for (i=0; i<count; i++) {
+		if (i > 0) {
+			*end++ = '\t';
+		}
+		size = strlen(fields[i]);
+		memcpy(end, fields[i], size);
+		end += size;
 	}
-	temp << recordFields[recordFields.getSize()-1] << ends;
+	*end = '\0';
 
-	if (recordString != NULL) {
-		delete [] recordString;
-		recordString = NULL;
+	if (shared->recordString != NULL) {
+		delete [] shared->recordString;
 	}
-	recordString = new char[strlen(temp.str().c_str()) + 1];
-	strcpy(recordString, temp.str().c_str());
-	modifiedQ = 0;
+	shared->recordString = line;
+	shared->modifiedQ = 0;
 }
 
 
@@ -4423,40 +4517,42 @@ int HumdrumRecord::determineFieldCount(const char* aLine) const {
 //
 
 void HumdrumRecord::setSize(int asize) {
+	unshare();
+	markEdited();
 
-	recordFields.allowGrowth(1);
-	recordFields.setSize(asize*4);
-	recordFields.setGrowth(132);
-	recordFields.setSize(asize);
+	shared->recordFields.allowGrowth(1);
+	shared->recordFields.setSize(asize*4);
+	shared->recordFields.setGrowth(132);
+	shared->recordFields.setSize(asize);
 
-	spineids.resize(asize);
+	shared->spineids.resize(asize);
 
-	interpretation.allowGrowth(1);
-	interpretation.setSize(asize*4);
-	interpretation.setGrowth(132);
-	interpretation.setSize(asize);
+	shared->interpretation.allowGrowth(1);
+	shared->interpretation.setSize(asize*4);
+	shared->interpretation.setGrowth(132);
+	shared->interpretation.setSize(asize);
 
-	dotline.setSize(asize*4);
-	dotline.setGrowth(132);
-	dotline.setSize(asize);
+	shared->dotline.setSize(asize*4);
+	shared->dotline.setGrowth(132);
+	shared->dotline.setSize(asize);
 
-	dotspine.setSize(asize*4);
-	dotspine.setGrowth(132);
-	dotspine.setSize(asize);
+	shared->dotspine.setSize(asize*4);
+	shared->dotspine.setGrowth(132);
+	shared->dotspine.setSize(asize);
 
 
 	char buffer[32] = {0};
 	int i;
-	for (i=0; i<recordFields.getSize(); i++) {
-		recordFields[i] = new char[2];
-		strcpy(recordFields[i], ".");
+	for (i=0; i<shared->recordFields.getSize(); i++) {
+		shared->recordFields[i] = new char[2];
+		strcpy(shared->recordFields[i], ".");
 		snprintf(buffer, 32, "%d", i+1);
-		spineids[i] = buffer;
+		shared->spineids[i] = buffer;
 	}
 
-	dotline.setAll(-1);
-	dotspine.setAll(-1);
-	interpretation.setAll(-1); // or 0?
+	shared->dotline.setAll(-1);
+	shared->dotspine.setAll(-1);
+	shared->interpretation.setAll(-1); // or 0?
 }
 
 
@@ -0,0 +1,213 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 19:28:24 PDT 2026
+// Last Modified: Sun Oct 18 19:28:24 PDT 2026
+// Last Modified: Sun Oct 18 21:35:59 PDT 2026 Reuse the buffer in each thread
+// Filename:      ...sig/src/sigInfo/HumdrumWriter.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumWriter.cpp
+// Syntax:        C++
+//
+// Description:   Buffered output of Humdrum data.
+//
+
+#include "HumdrumWriter.h"
+
+#include <cstring>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+
+// buffer reused by the writers of the current thread.  A writer which
+// is created while another one is using it gets a buffer of its own:
+static thread_local vector<char> sharedBuffer;
+static thread_local int          sharedInUse = 0;
+
+
+//////////////////////////////
+//
+// HumdrumWriter::HumdrumWriter --
+//     default value: bufferSize = HUMDRUMWRITER_SIZE
+//
+
+HumdrumWriter::HumdrumWriter(ostream& out, int bufferSize) {
+	output    = &out;
+	capacity  = bufferSize < 1024 ? 1024 : bufferSize;
+	used      = 0;
+	bytecount = 0;
+	if (sharedInUse) {
+		buffer  = new char[capacity];
+		sharedQ = 0;
+	} else {
+		if ((int)sharedBuffer.size() < capacity) {
+			sharedBuffer.resize(capacity);
+		}
+		buffer      = sharedBuffer.data();
+		sharedQ     = 1;
+		sharedInUse = 1;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumWriter::~HumdrumWriter -- write any remaining text.
+//
+
+HumdrumWriter::~HumdrumWriter() {
+	flush();
+	if (sharedQ) {
+		sharedInUse = 0;
+	} else {
+		delete [] buffer;
+	}
+	buffer = NULL;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumWriter::write -- add text to the output.  Text which is larger
+//     than the buffer is written directly to the output stream.
+//
+
+void HumdrumWriter::write(const char* text, int length) {
+	if (length <= 0) {
+		return;
+	}
+	bytecount += length;
+	if (used + length > capacity) {
+		flush();
+		if (length >= capacity) {
+			output->write(text, length);
+			return;
+		}
+	}
+	memcpy(buffer + used, text, length);
+	used += length;
+}
+
+
+void HumdrumWriter::write(const char* text) {
+	write(text, strlen(text));
+}
+
+
+void HumdrumWriter::write(char character) {
+	if (used >= capacity) {
+		flush();
+	}
+	buffer[used++] = character;
+	bytecount++;
+}
+
+
+void HumdrumWriter::write(int value) {
+	char number[32];
+	int length = snprintf(number, sizeof(number), "%d", value);
+	write(number, length);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumWriter::writeLine -- add a record and a newline to the output.
+//     An unmodified record is copied from the text which was read for it;
+//     a modified record is rebuilt from its fields first.
+//
+
+void HumdrumWriter::writeLine(HumdrumRecord& record) {
+	write(record.getLine());
+	write('\n');
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumWriter::writeFile -- add all of the lines of a file to the
+//     output (without a segment label).
+//
+
+void HumdrumWriter::writeFile(HumdrumFileBasic& infile) {
+	int count = infile.getNumLines();
+	for (int i=0; i<count; i++) {
+		writeLine(infile[i]);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumWriter::flush -- write the contents of the buffer to the output
+//     stream.  The stream itself is not flushed.
+//
+
+void HumdrumWriter::flush(void) {
+	if (used > 0) {
+		output->write(buffer, used);
+		used = 0;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumWriter::getByteCount -- return the number of bytes given to the
+//     writer so far (including those still in the buffer).
+//
+
+long long HumdrumWriter::getByteCount(void) {
+	return bytecount;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumWriter::operator<< --
+//
+
+HumdrumWriter& HumdrumWriter::operator<<(const char* text) {
+	write(text);
+	return *this;
+}
+
+
+HumdrumWriter& HumdrumWriter::operator<<(const string& text) {
+	write(text.c_str(), (int)text.size());
+	return *this;
+}
+
+
+HumdrumWriter& HumdrumWriter::operator<<(char character) {
+	write(character);
+	return *this;
+}
+
+
+HumdrumWriter& HumdrumWriter::operator<<(int value) {
+	write(value);
+	return *this;
+}
+
+
+// A record is written without a newline, as with an ostream:
+HumdrumWriter& HumdrumWriter::operator<<(HumdrumRecord& record) {
+	write(record.getLine());
+	return *this;
+}
+
+
+HumdrumWriter& HumdrumWriter::operator<<(HumdrumFileBasic& infile) {
+	writeFile(infile);
+	return *this;
+}
+
+
+
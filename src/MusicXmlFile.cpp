@@ -21,6 +21,7 @@
 // Last Modified: Tue Jun 19 14:03:03 PDT 2012 added printing of text
 // Last Modified: Wed Jun 20 15:43:34 PDT 2012 various updates/enhancements
 // Last Modified: Mon Aug 19 20:30:28 PDT 2013 handle multi-syllable lyric
+// Last Modified: Sun Oct 18 15:59:53 PDT 2026 parse/convert parts in parallel
 //
 // Filename:      ...sig/include/sigInfo/MusicXmlFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/MusicXmlFile.h
@@ -71,9 +72,14 @@
 #include "Convert.h"
 #include "PerlRegularExpression.h"
 
+#include <atomic>
 #include <cctype>
 #include <cstdio>
 #include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 using namespace CSL::XML;
@@ -90,6 +96,44 @@ void printArray(const char* title, Array<int>& partoffset) {
 
 
 
+//////////////////////////////
+//
+// forEachInParallel -- Run job(0) through job(count-1) using up to
+//    the given number of threads.  Jobs are handed out in order, but
+//    may finish in any order.
+//
+
+static void forEachInParallel(int count, int threads,
+		const function<void(int)>& job) {
+	if (threads > count) {
+		threads = count;
+	}
+	if (threads <= 1) {
+		for (int i=0; i<count; i++) {
+			job(i);
+		}
+		return;
+	}
+
+	atomic<int> next(0);
+	auto worker = [&]() {
+		int i;
+		while ((i = next++) < count) {
+			job(i);
+		}
+	};
+	vector<thread> pool;
+	for (int i=0; i<threads-1; i++) {
+		pool.emplace_back(worker);
+	}
+	worker();
+	for (int i=0; i<(int)pool.size(); i++) {
+		pool[i].join();
+	}
+}
+
+
+
 //////////////////////////////
 //
 // MusicXmlFile::MusicXmlFile --
@@ -113,15 +157,12 @@ MusicXmlFile::MusicXmlFile(void) {
 	partdynamics.setGrowth(100);
 	partdynamics.setSize(0);
 	parsedivisions = 4;
-	parseserialnum = 1;
-	partvoiceticktime1 = -1;
-	partvoiceticktime2 = -1;
 	setOption("stem",    1);
 	setOption("beam",    1);
 	setOption("dynamic", 1);
 	setOption("lyric",   1);
 	setOption("renumber",1);
-	lastchordhead = NULL;
+	setOption("threads", 1);
 }
 
 
@@ -143,15 +184,12 @@ MusicXmlFile::MusicXmlFile(const char* aFile) {
 	partdynamics.setGrowth(100);
 	partdynamics.setSize(0);
 	parsedivisions = 4;
-	parseserialnum = 1;
-	partvoiceticktime1 = -1;
-	partvoiceticktime2 = -1;
 	setOption("stem",    1);
 	setOption("beam",    1);
 	setOption("dynamic", 1);
 	setOption("lyric",   1);
 	setOption("renumber",1);
-	lastchordhead = NULL;
+	setOption("threads", 1);
 
 	read(aFile);
 }
@@ -734,12 +772,11 @@ void MusicXmlFile::read(const char* aFile) {
 
 	parse();
 
-	int i;
-	for (i=0; i<getStaffCount(); i++) {
+	forEachInParallel(getStaffCount(), humdrumThreads, [this](int i) {
 		sortStaff(i);
-	}
+	});
 
-	int j;
+	int i, j;
 	for (i=0; i<partdynamics.getSize(); i++) {
 		partdynamics[i] = 0;
 		for (j=0; j<partdata[i].getSize(); j++) {
@@ -776,15 +813,108 @@ void MusicXmlFile::parse(void) {
 		return;
 	}
 
-	parseserialnum = 1;
-	lastchordhead  = NULL;
+	partjobs.setSize(0);
+	partjobnum.setSize(0);
 
 	traverse(xmldocument);
+	if (partjobs.getSize() > 0) {
+		parsePartsInParallel();
+	}
 	fixPickupBarline();
 }
 
 
 
+//////////////////////////////
+//
+// MusicXmlFile::parsePartsInParallel -- Parse the <part> elements which
+//    were collected by parseElement() when the "threads" option is greater
+//    than one.  Each part writes only into its own staves in partdata, so
+//    the parts can be converted independently.  The divisions value which
+//    would have been inherited from the previous part in a serial parse
+//    is found first by scanning the earlier parts.
+//
+
+void MusicXmlFile::parsePartsInParallel(void) {
+	int i;
+	int divisions = parsedivisions;
+	for (i=0; i<partjobs.getSize(); i++) {
+		preparePartState(partjobnum[i]);
+		partdivisions[partjobnum[i]] = divisions;
+		divisions = getLastDivisions(partjobs[i], divisions);
+	}
+	parsedivisions = divisions;
+
+	forEachInParallel(partjobs.getSize(), humdrumThreads, [this](int job) {
+		CXMLObject* element = partjobs[job];
+		XMLString idname = getAttributeValue(element, "id");
+		getInstrumentName(element, partjobnum[job], idname);
+		parsePart(element->Zoom(), partjobnum[job]);
+	});
+
+	partjobs.setSize(0);
+	partjobnum.setSize(0);
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::preparePartState -- Make sure that the parsing state
+//    for the given part exists, and reset it to the start of a part.
+//
+
+void MusicXmlFile::preparePartState(int partnum) {
+	if (partserialnum.getSize() <= partnum) {
+		partserialnum.setSize(partnum+1);
+		partdivisions.setSize(partnum+1);
+		partchordhead.setSize(partnum+1);
+	}
+	partserialnum[partnum] = 1;
+	partchordhead[partnum] = NULL;
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::getLastDivisions -- Return the last <divisions> value
+//    given in the attributes of a part, or the input divisions value if
+//    the part does not change the divisions.
+//
+
+int MusicXmlFile::getLastDivisions(CXMLObject* part, int divisions) {
+	CXMLObject* measure = part->Zoom();
+	CXMLObject* item;
+	CXMLObject* attribute;
+	while (measure != NULL) {
+		if ((measure->GetType() != xmlElement) ||
+				(((CXMLElement*)measure)->GetName() != "measure")) {
+			measure = measure->GetNext();
+			continue;
+		}
+		item = measure->Zoom();
+		while (item != NULL) {
+			if ((item->GetType() == xmlElement) &&
+					(((CXMLElement*)item)->GetName() == "attributes")) {
+				attribute = item->Zoom();
+				while (attribute != NULL) {
+					if ((attribute->GetType() == xmlElement) &&
+							(((CXMLElement*)attribute)->GetName() == "divisions")) {
+						divisions = getDivisions(attribute);
+					}
+					attribute = attribute->GetNext();
+				}
+			}
+			item = item->GetNext();
+		}
+		measure = measure->GetNext();
+	}
+	return divisions;
+}
+
+
+
 //////////////////////////////
 //
 // MusicXmlFile::fixMeasureNumbers -- generate a reasonable
@@ -995,7 +1125,6 @@ int MusicXmlFile::getTimeSignatureTicks(CXMLObject* obj, int tickinfo) {
 
 void MusicXmlFile::traverse(CXMLObject* entry) {
 	while (entry != NULL) {
-		lastchordhead = NULL;
 		process(entry);
 		entry = entry->GetNext();
 	}
@@ -1055,6 +1184,10 @@ void MusicXmlFile::addStaffData(void) {
 		partdata.setSize(partdata.getSize()+1);
 		partdynamics.setSize(partdynamics.getSize()+1);
 		partdynamics[partdynamics.getSize()-1] = 0;
+		partvoiceticktime1.setSize(partvoiceticktime1.getSize()+1);
+		partvoiceticktime1[partvoiceticktime1.getSize()-1] = -1;
+		partvoiceticktime2.setSize(partvoiceticktime2.getSize()+1);
+		partvoiceticktime2[partvoiceticktime2.getSize()-1] = -1;
 		partdata[partdata.getSize()-1].setSize(10000);
 		partdata[partdata.getSize()-1].setGrowth(10000);
 		partdata[partdata.getSize()-1].setSize(0);
@@ -1187,8 +1320,17 @@ int MusicXmlFile::parseElement(CXMLObject* entry) {
 				if (partnum < 0) {
 					return 1;
 				}
+				if (humdrumThreads > 1) {
+					// parse later in parsePartsInParallel()
+					partjobs.append(entry);
+					partjobnum.append(partnum);
+					return 0;
+				}
+				preparePartState(partnum);
+				partdivisions[partnum] = parsedivisions;
 				getInstrumentName(element, partnum, idname);
 				parsePart(element->Zoom(), partnum);
+				parsedivisions = partdivisions[partnum];
 				return 0;
 				break;
 			}
@@ -1341,8 +1483,8 @@ void MusicXmlFile::parseMeasure(CXMLObject* entry, int partnum,
 	tempitem.type     = MXI_measure;
 	tempitem.obj      = entry;
 	tempitem.measureno= getMeasureNumber(entry);
-	tempitem.serialnum= parseserialnum++;
-	tempitem.divisions = parsedivisions;
+	tempitem.serialnum= partserialnum[partnum]++;
+	tempitem.divisions = partdivisions[partnum];
 	appendAllPartStaves(partnum, tempitem);
 
 	// read the elements in the measure and store them for the part
@@ -1467,8 +1609,8 @@ void MusicXmlFile::parseDirectionType(CXMLObject* object, int partnum,
 					tempitem.type     = MXI_dynamic;
 					tempitem.obj      = element;
 					tempitem.ticktime = ticktime;
-					tempitem.serialnum= parseserialnum++;
-					tempitem.divisions = parsedivisions;
+					tempitem.serialnum= partserialnum[partnum]++;
+					tempitem.divisions = partdivisions[partnum];
 					partdata[partoffset[partnum]+staff].append(tempitem);
 					break;
 				}
@@ -1483,15 +1625,15 @@ void MusicXmlFile::parseDirectionType(CXMLObject* object, int partnum,
 						tempitem.type      = MXI_dynamic;
 						tempitem.obj       = element;
 						tempitem.ticktime  = ticktime;
-						tempitem.serialnum = parseserialnum++;
-						tempitem.divisions = parsedivisions;
+						tempitem.serialnum = partserialnum[partnum]++;
+						tempitem.divisions = partdivisions[partnum];
 						partdata[partoffset[partnum]+staff].append(tempitem);
 					} else if (element->GetAttributes().GetValue(i) == "crescendo") {
 						tempitem.type      = MXI_dynamic;
 						tempitem.obj       = element;
 						tempitem.ticktime  = ticktime;
-						tempitem.serialnum = parseserialnum++;
-						tempitem.divisions = parsedivisions;
+						tempitem.serialnum = partserialnum[partnum]++;
+						tempitem.divisions = partdivisions[partnum];
 						partdata[partoffset[partnum]+staff].append(tempitem);
 					}
 
@@ -1511,8 +1653,8 @@ void MusicXmlFile::parseDirectionType(CXMLObject* object, int partnum,
 						tempitem.type      = MXI_dynamic;
 						tempitem.obj       = element;
 						tempitem.ticktime  = ticktime;
-						tempitem.serialnum = parseserialnum++;
-						tempitem.divisions = parsedivisions;
+						tempitem.serialnum = partserialnum[partnum]++;
+						tempitem.divisions = partdivisions[partnum];
 						partdata[partoffset[partnum]+staff].append(tempitem);
 						break;  // need or should break?
 					} else {
@@ -1521,8 +1663,8 @@ void MusicXmlFile::parseDirectionType(CXMLObject* object, int partnum,
 						tempitem.type = MXI_text;
 						tempitem.obj = element;
 						tempitem.ticktime = ticktime;
-						tempitem.serialnum = parseserialnum++;
-						tempitem.divisions = parsedivisions;
+						tempitem.serialnum = partserialnum[partnum]++;
+						tempitem.divisions = partdivisions[partnum];
 						partdata[partoffset[partnum]+staff].append(tempitem);
 						break;  // need or should break?
 					}
@@ -1631,8 +1773,8 @@ void MusicXmlFile::parsePrint(CXMLObject* entry, int partnum, int ticktime) {
 	tempitem.type     = MXI_print;
 	tempitem.obj      = entry;
 	tempitem.ticktime = ticktime;
-	tempitem.serialnum= parseserialnum++;
-	tempitem.divisions = parsedivisions;
+	tempitem.serialnum= partserialnum[partnum]++;
+	tempitem.divisions = partdivisions[partnum];
 
 	appendAllPartStaves(partnum, tempitem);
 }
@@ -1661,8 +1803,8 @@ void MusicXmlFile::parseBarline(CXMLObject* entry, int partnum, int ticktime) {
 	tempitem.type     = MXI_barline;
 	tempitem.obj      = entry;
 	tempitem.ticktime = ticktime;
-	tempitem.serialnum= parseserialnum++;
-	tempitem.divisions = parsedivisions;
+	tempitem.serialnum= partserialnum[partnum]++;
+	tempitem.divisions = partdivisions[partnum];
 
 	appendAllPartStaves(partnum, tempitem);
 }
@@ -1726,8 +1868,8 @@ void MusicXmlFile::parseSound(CXMLObject* entry, int partnum, long& ticktime) {
 	tempitem.type     = type;
 	tempitem.obj      = entry;
 	tempitem.ticktime = ticktime;
-	tempitem.serialnum= parseserialnum++;
-	tempitem.divisions = parsedivisions;
+	tempitem.serialnum= partserialnum[partnum]++;
+	tempitem.divisions = partdivisions[partnum];
 	appendAllPartStaves(partnum, tempitem);
 
 }
@@ -1768,7 +1910,7 @@ void MusicXmlFile::parseNote(CXMLObject* entry, int partnum, long& ticktime) {
 	int chordQ = 0;  // 1 if <chord> tag is present
 
 	_MusicXmlItem tempitem;
-	tempitem.serialnum = parseserialnum++;
+	tempitem.serialnum = partserialnum[partnum]++;
 
 	XMLString string;
 	while (current != NULL) {
@@ -1843,8 +1985,8 @@ void MusicXmlFile::parseNote(CXMLObject* entry, int partnum, long& ticktime) {
 					templyric.obj         = entry;
 					templyric.ticktime    = ticktime;
 					templyric.tickdur     = duration;
-					templyric.divisions   = parsedivisions;
-					templyric.serialnum   = parseserialnum++;
+					templyric.divisions   = partdivisions[partnum];
+					templyric.serialnum   = partserialnum[partnum]++;
 					templyric.ownerserial = tempitem.serialnum;
 					templyric.lyricnum    = tempnum;
 					templyric.obj         = (CXMLObject*)element;
@@ -1858,9 +2000,9 @@ void MusicXmlFile::parseNote(CXMLObject* entry, int partnum, long& ticktime) {
 
 	ticktime = ticktime - chord;
 	if (chordQ) {
-		tempitem.chordhead = lastchordhead;
+		tempitem.chordhead = partchordhead[partnum];
 	} else {
-		lastchordhead = entry;
+		partchordhead[partnum] = entry;
 	}
 
 	tempitem.type      = MXI_note;
@@ -1873,7 +2015,7 @@ void MusicXmlFile::parseNote(CXMLObject* entry, int partnum, long& ticktime) {
 	tempitem.voice     = voice;
 	tempitem.pitch     = pitch;
 	tempitem.ficta     = hasFicta;   hasFicta = 0;
-	tempitem.divisions = parsedivisions;
+	tempitem.divisions = partdivisions[partnum];
 	partdata[partoffset[partnum]+staff].append(tempitem);
 
 	ticktime += duration;
@@ -2166,27 +2308,27 @@ void MusicXmlFile::parseAttributes(CXMLObject* entry, int partnum,
 			// cout << "Attributes Element Name = " << element->GetName() << endl;
 
 			tempitem.obj       = current;
-			tempitem.divisions = parsedivisions;
+			tempitem.divisions = partdivisions[partnum];
 			tempitem.ticktime  = ticktime;
 
 			if (element->GetName() == "divisions") {
 				tempitem.type = MXI_divisions;
-				parsedivisions = getDivisions(element);
-				tempitem.divisions = parsedivisions;
-				tempitem.serialnum = parseserialnum++;
-				tempitem.divisions = parsedivisions;
+				partdivisions[partnum] = getDivisions(element);
+				tempitem.divisions = partdivisions[partnum];
+				tempitem.serialnum = partserialnum[partnum]++;
+				tempitem.divisions = partdivisions[partnum];
 				appendAllPartStaves(partnum, tempitem);
 			} else if (element->GetName() == "clef") {
 				tempitem.type = MXI_clef;
 				staff = getStaffNumber(element) - 1;
 				checkPartStaff(partnum, staff+1);
-				tempitem.serialnum = parseserialnum++;
-				tempitem.divisions = parsedivisions;
+				tempitem.serialnum = partserialnum[partnum]++;
+				tempitem.divisions = partdivisions[partnum];
 				partdata[partoffset[partnum]+staff].append(tempitem);
 			} else if (element->GetName() == "key") {
 				tempitem.type = MXI_key;
-				tempitem.serialnum = parseserialnum++;
-				tempitem.divisions = parsedivisions;
+				tempitem.serialnum = partserialnum[partnum]++;
+				tempitem.divisions = partdivisions[partnum];
 				appendAllPartStaves(partnum, tempitem);
 			} else if (element->GetName() == "time") {
 				tempitem.obj  = element;
@@ -2195,15 +2337,15 @@ void MusicXmlFile::parseAttributes(CXMLObject* entry, int partnum,
 				for (i=0; i<element->GetAttributes().GetLength(); i++) {
 					if (element->GetAttributes().GetName(i) == "symbol") {
 						tempitem.type = MXI_timemet;
-						tempitem.serialnum = parseserialnum++;
-						tempitem.divisions = parsedivisions;
+						tempitem.serialnum = partserialnum[partnum]++;
+						tempitem.divisions = partdivisions[partnum];
 						appendAllPartStaves(partnum, tempitem);
 					}
 				}
 
 				tempitem.type = MXI_time;
-				tempitem.serialnum = parseserialnum++;
-				tempitem.divisions = parsedivisions;
+				tempitem.serialnum = partserialnum[partnum]++;
+				tempitem.divisions = partdivisions[partnum];
 				appendAllPartStaves(partnum, tempitem);
 			}
 
@@ -2364,15 +2506,37 @@ int MusicXmlFile::staffcompare(const void* A, const void* B) {
 
 void MusicXmlFile::humdrumPart(HumdrumFile& hfile, int staffno, int debugQ) {
 	hfile.clear();
-	humline = 0;   // reset humline to start of file
 
 	if ((staffno < 0) || (staffno >= getStaffCount())) {
 		return;
 	}
 
+	SSTREAM tempstream;
+	humdrumPartText(tempstream, staffno);
+	if (debugQ) {
+		cout << tempstream.CSTRING << endl;
+	}
+	hfile.read(tempstream);
+
+	if (getOption("lyric")) {
+		addLyrics(hfile, staffno);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::humdrumPartText -- Generate the Humdrum text for a
+//    single staff.  Only data for the given staff is modified, so
+//    different staves can be processed at the same time.
+//
+
+void MusicXmlFile::humdrumPartText(SSTREAM& out, int staffno) {
+	int humline = 0;   // line number in Humdrum output for lyrics
 	int status;
-	partvoiceticktime2 = -1;
-	partvoiceticktime1 = -1;
+	partvoiceticktime2[staffno] = -1;
+	partvoiceticktime1[staffno] = -1;
 
 	int newlineQ = 0;   // for printing dynamics and lyrics after notes.
 	SSTREAM* tempstream = new SSTREAM;
@@ -2447,7 +2611,7 @@ void MusicXmlFile::humdrumPart(HumdrumFile& hfile, int staffno, int debugQ) {
 				break;
 			case MXI_clef:
 				(*tempstream) << printKernClef(buffer, 1024, partdata[staffno][i].obj);
-				if (partvoiceticktime1 > partdata[staffno][i].ticktime) {
+				if (partvoiceticktime1[staffno] > partdata[staffno][i].ticktime) {
 					// this if statement is needed if there are two voices
 					// (or more) and the first part is being interrupted
 					// by the clef sign.  If it is being interrupted, then
@@ -2564,21 +2728,9 @@ void MusicXmlFile::humdrumPart(HumdrumFile& hfile, int staffno, int debugQ) {
 	}
 	(*tempstream) << ends;
 
-	SSTREAM* newtempstream = new SSTREAM;
-	processSpineChanges(*newtempstream, *tempstream, staffno);
+	processSpineChanges(out, *tempstream, staffno);
 	delete tempstream;
-	tempstream = newtempstream;
-	(*tempstream) << ends;
-	if (debugQ) {
-		cout << tempstream->CSTRING << endl;
-	}
-	hfile.read(*tempstream);
-	delete tempstream;
-
-	if (getOption("lyric")) {
-		addLyrics(hfile, staffno);
-	}
-
+	out << ends;
 }
 
 
@@ -4280,13 +4432,13 @@ int MusicXmlFile::printKernNote(ostream& out, int staffno, int index,
 			if (voice == 2) {
 				// print an interpreted rest as a place holder if
 				// the first voice is not sounding at this time
-				if (partdata[staffno][index].ticktime >= partvoiceticktime1) {
+				if (partdata[staffno][index].ticktime >= partvoiceticktime1[staffno]) {
 					interptick = getNextVoiceTime(staffno, index, 1) -
 							       partdata[staffno][index].ticktime;
 					interpextenttick = getInterpRestDuration(interpbuffer, 128,
 							              interptick,
 							              partdata[staffno][index].divisions);
-					partvoiceticktime1 = partdata[staffno][index].ticktime +
+					partvoiceticktime1[staffno] = partdata[staffno][index].ticktime +
 							               interpextenttick;
 					out << interpbuffer << "ryy";
 					interprestQ = 1;
@@ -4495,7 +4647,7 @@ int MusicXmlFile::printKernNote(ostream& out, int staffno, int index,
 	// second voice if it is currently active.
 	if (newlineQ) {
 		if (partdata[staffno][index].voice == 1) {
-			if (partdata[staffno][index].ticktime < partvoiceticktime2) {
+			if (partdata[staffno][index].ticktime < partvoiceticktime2[staffno]) {
 				out << "\t.";
 			}
 		}
@@ -4504,10 +4656,10 @@ int MusicXmlFile::printKernNote(ostream& out, int staffno, int index,
 	}
 
 	if (partdata[staffno][index].voice == 2) {
-		partvoiceticktime2 = partdata[staffno][index].ticktime +
+		partvoiceticktime2[staffno] = partdata[staffno][index].ticktime +
 							      partdata[staffno][index].tickdur;
 	} else if (partdata[staffno][index].voice == 1) {
-		partvoiceticktime1 = partdata[staffno][index].ticktime +
+		partvoiceticktime1[staffno] = partdata[staffno][index].ticktime +
 							      partdata[staffno][index].tickdur;
 	}
 
@@ -4670,8 +4822,26 @@ HumdrumFile& MusicXmlFile::createHumdrumFile(HumdrumFile& hfile) {
 	// in reverse order to follow the Humdrum convention of
 	// encoding the scores from lowest to hightest pitch ranges
 	// in the score.
-	for (i=0; i<count; i++) {
-		humdrumPart(partfiles[count-i-1], i);
+	if (humdrumThreads > 1) {
+		// Generate the text for each staff at the same time, then
+		// parse the staves into Humdrum files and attach the lyrics.
+		vector<string> parttext(count);
+		forEachInParallel(count, humdrumThreads, [this, &parttext](int staff) {
+			SSTREAM tempstream;
+			humdrumPartText(tempstream, staff);
+			parttext[staff] = tempstream.str();
+		});
+		for (i=0; i<count; i++) {
+			SSTREAM tempstream(parttext[i]);
+			partfiles[count-i-1].read(tempstream);
+			if (getOption("lyric")) {
+				addLyrics(partfiles[count-i-1], i);
+			}
+		}
+	} else {
+		for (i=0; i<count; i++) {
+			humdrumPart(partfiles[count-i-1], i);
+		}
 	}
 	HumdrumFile::assemble(hfile, count, partfiles);
 
@@ -4695,6 +4865,14 @@ void MusicXmlFile::setOption(const char* key, int value) {
 		humdrumDynamics = value;
 	} else if (strncmp(key, "lyric", 5) == 0) {
 		humdrumLyrics = value;
+	} else if (strncmp(key, "thread", 6) == 0) {
+		humdrumThreads = value;
+		if (humdrumThreads <= 0) {
+			humdrumThreads = thread::hardware_concurrency();
+		}
+		if (humdrumThreads <= 0) {
+			humdrumThreads = 1;
+		}
 	}
 }
 
@@ -4722,6 +4900,10 @@ int MusicXmlFile::getOption(const char* key) {
 		return humdrumLyrics;
 	}
 
+	if (strncmp(key, "thread", 6) == 0) {
+		return humdrumThreads;
+	}
+
 	return 0;
 }
 
@@ -0,0 +1,346 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 18:21:55 PDT 2026
+// Last Modified: Sun Oct 18 20:36:30 PDT 2026 Keep input paths in --npy-dir
+// Filename:      ...sig/src/sigInfo/NpyWriter.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/NpyWriter.cpp
+// Syntax:        C++
+//
+// Description:   Collects a two-dimensional numeric array one row at a
+//                time and writes it as a NumPy .npy file.
+//
+
+#include "NpyWriter.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+
+//////////////////////////////
+//
+// NpyWriter::NpyWriter --
+//
+
+NpyWriter::NpyWriter(void) {
+	datatype = NPY_FLOAT64;
+	clear();
+}
+
+NpyWriter::NpyWriter(int type) {
+	datatype = NPY_FLOAT64;
+	setType(type);
+	clear();
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::~NpyWriter --
+//
+
+NpyWriter::~NpyWriter() {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::clear -- remove all data from the array (but keep
+//    the data type).
+//
+
+void NpyWriter::clear(void) {
+	data.resize(0);
+	rows    = 0;
+	columns = -1;
+	current = 0;
+	ragged  = 0;
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::setType -- set the type of the array elements: NPY_UINT8,
+//    NPY_INT32 or NPY_FLOAT64.  Must be called before adding any data.
+//
+
+void NpyWriter::setType(int type) {
+	switch (type) {
+		case NPY_UINT8:
+		case NPY_INT32:
+		case NPY_FLOAT64:
+			datatype = type;
+			break;
+		default:
+			datatype = NPY_FLOAT64;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::getType --
+//
+
+int NpyWriter::getType(void) {
+	return datatype;
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::getRowCount -- return the number of completed rows.
+//
+
+int NpyWriter::getRowCount(void) {
+	return rows;
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::getColumnCount -- return the length of the rows, or 0
+//    if there are no rows yet.
+//
+
+int NpyWriter::getColumnCount(void) {
+	if (columns < 0) {
+		return 0;
+	}
+	return columns;
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::append -- add a value to the end of the current row.  The
+//    value is converted to the data type of the array.
+//
+
+void NpyWriter::append(int value) {
+	if (datatype == NPY_FLOAT64) {
+		append((double)value);
+		return;
+	}
+	if (datatype == NPY_UINT8) {
+		data.push_back((char)(value & 0xff));
+	} else {
+		unsigned int uvalue = (unsigned int)value;
+		data.push_back((char)(uvalue & 0xff));
+		data.push_back((char)((uvalue >> 8)  & 0xff));
+		data.push_back((char)((uvalue >> 16) & 0xff));
+		data.push_back((char)((uvalue >> 24) & 0xff));
+	}
+	current++;
+}
+
+
+void NpyWriter::append(double value) {
+	if (datatype != NPY_FLOAT64) {
+		if (value < 0.0) {
+			append((int)(value - 0.5));
+		} else {
+			append((int)(value + 0.5));
+		}
+		return;
+	}
+	unsigned long long bits;
+	memcpy(&bits, &value, sizeof(bits));
+	for (int i=0; i<8; i++) {
+		data.push_back((char)((bits >> (8*i)) & 0xff));
+	}
+	current++;
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::endRow -- finish the current row.  Returns false if the
+//    row is not the same length as the previous rows.
+//
+
+int NpyWriter::endRow(void) {
+	if (columns < 0) {
+		columns = current;
+	} else if (current != columns) {
+		ragged = 1;
+	}
+	current = 0;
+	rows++;
+	return !ragged;
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::write -- write the array in .npy format.  A row which was
+//    not finished with endRow() is ignored.  Returns false if the rows
+//    do not all have the same length (nothing is written in that case)
+//    or if the file could not be written.
+//
+
+int NpyWriter::write(ostream& out) {
+	if (ragged) {
+		return 0;
+	}
+	writeHeader(out);
+	// the array may be larger than 2 GB, so write it in blocks:
+	size_t bytes = (size_t)rows * (size_t)getColumnCount() * (size_t)datatype;
+	size_t block = 1 << 30;
+	const char* ptr = data.data();
+	while ((bytes > 0) && !out.fail()) {
+		if (block > bytes) {
+			block = bytes;
+		}
+		out.write(ptr, (streamsize)block);
+		ptr   += block;
+		bytes -= block;
+	}
+	out.flush();
+	return !out.fail();
+}
+
+
+int NpyWriter::write(const string& filename) {
+	if (ragged) {
+		return 0;
+	}
+	makeDirectories(filename);
+	ofstream outfile(filename.c_str(), ios::out | ios::binary);
+	if (!outfile.is_open()) {
+		return 0;
+	}
+	int status = write(outfile);
+	outfile.close();
+	return status;
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::makeFilename -- return the name of the .npy file in the
+//    given directory for an input file: the extension of the input
+//    filename is replaced, and the path of the input is kept below the
+//    directory so that inputs with the same name in different
+//    directories do not overwrite each other.  "." and ".." in the path
+//    are dropped.  An input without a name is called "input" followed
+//    by its index.
+//
+
+string NpyWriter::makeFilename(const string& directory,
+		const string& inputname, int index) {
+	string path;
+	string part;
+	size_t start = 0;
+	size_t pos;
+	while (start <= inputname.size()) {
+		pos = inputname.find('/', start);
+		if (pos == string::npos) {
+			pos = inputname.size();
+		}
+		part = inputname.substr(start, pos - start);
+		start = pos + 1;
+		if (part.empty() || (part == ".") || (part == "..")) {
+			continue;
+		}
+		if (!path.empty()) {
+			path += '/';
+		}
+		path += part;
+	}
+	pos = path.rfind('.');
+	size_t slash = path.rfind('/');
+	if ((pos != string::npos) && (pos > 0) &&
+			((slash == string::npos) || (pos > slash + 1))) {
+		path = path.substr(0, pos);
+	}
+	if (path.empty() || (path[path.size()-1] == '/')) {
+		stringstream name;
+		name << "input" << index;
+		path += name.str();
+	}
+	string output = directory;
+	if (output.empty()) {
+		output = ".";
+	}
+	if (output[output.size()-1] != '/') {
+		output += '/';
+	}
+	output += path;
+	output += ".npy";
+	return output;
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::makeDirectories -- create the directories in the path of
+//    a file which do not exist yet.
+//
+
+void NpyWriter::makeDirectories(const string& filename) {
+	size_t pos = filename.find('/', 1);
+	while (pos != string::npos) {
+		string dir = filename.substr(0, pos);
+		if (mkdir(dir.c_str(), 0755) && (errno != EEXIST)) {
+			return;
+		}
+		pos = filename.find('/', pos + 1);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// NpyWriter::writeHeader -- write the magic string, version and the
+//    array description.  The description is padded with spaces so that
+//    the data starts on a 64-byte boundary.
+//
+
+void NpyWriter::writeHeader(ostream& out) {
+	stringstream dict;
+	dict << "{'descr': '";
+	switch (datatype) {
+		case NPY_UINT8:  dict << "|u1"; break;
+		case NPY_INT32:  dict << "<i4"; break;
+		default:         dict << "<f8"; break;
+	}
+	dict << "', 'fortran_order': False, 'shape': (" << rows << ", "
+	     << getColumnCount() << "), }";
+	string header = dict.str();
+	// magic (6) + version (2) + header length (2) + header + newline
+	int total = 10 + (int)header.size() + 1;
+	int padding = (64 - total % 64) % 64;
+	header.append(padding, ' ');
+	header += '\n';
+
+	out.write("\x93NUMPY", 6);
+	out.put((char)1);
+	out.put((char)0);
+	int length = (int)header.size();
+	out.put((char)(length & 0xff));
+	out.put((char)((length >> 8) & 0xff));
+	out.write(header.data(), header.size());
+}
+
+
+
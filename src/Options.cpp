@@ -3,6 +3,7 @@
 // Creation Date: Sun Apr  5 13:07:18 PDT 1998
 // Last Modified: Sat Mar  1 09:31:01 PST 2014 Implemented with STL.
 // Last Modified: Fri Mar 11 21:26:59 PST 2016 remove command from getArgList
+// Last Modified: Sun Oct 18 18:55:16 PDT 2026 added --profile option
 // Filename:      Options.cpp
 // Web Address:   https://github.com/craigsapp/optionlib/blob/master/include/Options.h
 // Documentation: http://sig.sapp.org/doc/classes/Options
@@ -12,6 +13,7 @@
 //
 
 #include "Options.h"
+#include "Profiler.h"
 
 #include <algorithm>
 #include <cctype>
@@ -980,6 +982,11 @@ void Options::xverify(int error_check, int suppress) {
 		argument.resize(0);
 	}
 
+	// all programs accept --profile for printing the library timers
+	if (!isDefined("profile")) {
+		define("profile=b", "print time spent in library phases");
+	}
+
 	string* tempstr = new string(oargv[0]);
 	argument.push_back(tempstr);
 
@@ -1014,6 +1021,9 @@ void Options::xverify(int error_check, int suppress) {
 		gargp++;
 	}
 
+	if (getBoolean("profile")) {
+		Profiler::enableReport();
+	}
 }
 
 
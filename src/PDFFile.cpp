@@ -2,22 +2,34 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue May 11 21:51:09 PDT 2010
 // Last Modified: Tue May 11 21:51:24 PDT 2010
+// Last Modified: Sun Oct 18 16:06:58 PDT 2026 parse from memory buffer
+// Last Modified: Sun Oct 18 16:06:58 PDT 2026 added FlateDecode streams
+// Last Modified: Sun Oct 18 21:46:15 PDT 2026 added xref and object streams
 // Filename:      ...sig/src/sigInfo/PDFFile.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/PDFFile.cpp
 // Syntax:        C++
 //
-// Description:   Higher-level functions for processing Humdrum files.
-//                Inherits PDFFileBasic and adds rhythmic and other
-//                types of analyses to the PDFFile class.
+// Description:   Extract structural information and embedded files
+//                from a PDF file.  The entire PDF file is loaded into
+//                memory with a single read, and the xref tables,
+//                dictionaries and streams are located by offset into
+//                that buffer.
 //
 
 #include "PDFFile.h"
 #include "PerlRegularExpression.h"
 
+#include <cctype>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+   #include <zlib.h>
+#endif
 
 using namespace std;
 
@@ -28,13 +40,16 @@ using namespace std;
 //
 
 PDFFile::PDFFile(void) {
-	pdfdatastream = NULL;
 	pdfdatasize = 0;
 	rootobject = -1;
+	pdfdata.setSize(1);
+	pdfdata[0] = '\0';
 	xref.setSize(0);
 	embedFile.setSize(0);
 	indirectobjectoffset.setSize(0);
 	indirectobjectversions.setSize(0);
+	xrefstreamQ = 0;
+	objectstreams.clear();
 }
 
 PDFFile::PDFFile(istream& file) {
@@ -66,13 +81,16 @@ PDFFile::~PDFFile() {
 //
 
 void PDFFile::clear(void) {
-	pdfdatastream = NULL;
 	pdfdatasize = 0;
 	rootobject = -1;
+	pdfdata.setSize(1);
+	pdfdata[0] = '\0';
 	xref.setSize(0);
 	embedFile.setSize(0);
 	indirectobjectoffset.setSize(0);
 	indirectobjectversions.setSize(0);
+	xrefstreamQ = 0;
+	objectstreams.clear();
 }
 
 
@@ -95,11 +113,18 @@ int PDFFile::getObjectCount(void) {
 //    of the file to the start object number for the specified object number.
 //    Byte offset start at 0 for first byte in file.  First object is the
 //    null object which always has an offset of 0.  Return a value of
-//    -1 if there is no object at that index.
+//    -1 if there is no object at that index, or if the object is stored
+//    inside of an object stream (see getCompressedObject()).
 //
 
 int PDFFile::getObjectOffset(int index) {
+	if ((index < 0) || (index >= indirectobjectoffset.getSize())) {
+		return -1;
+	}
 	if (indirectobjectoffset[index].getSize() > 0) {
+		if (indirectobjectoffset[index][0] < 0) {
+			return -1;
+		}
 		return indirectobjectoffset[index][0];
 	} else {
 		return -1;
@@ -112,55 +137,43 @@ int PDFFile::getObjectOffset(int index) {
 //
 // PDFFile::getObjectDictionary -- get an object's dictionary contents.
 //      Return value is the byte offset from the start of the data file
-//      for the end of the object's dictionary.
+//      for the end of the object's dictionary (or -1 if the object
+//      does not have a dictionary).  For objects stored in an object
+//      stream, the offset is in the uncompressed text of the object.
 //
 
 int PDFFile::getObjectDictionary(int objectindex, Array<char>& out) {
-	stringstream tempstream;
-	int returnval = getObjectDictionary(objectindex, tempstream);
-	out.setSize(tempstream.str().length() + 1);
-	int i;
-	for (i=0; i<out.getSize()-1; i++) {
-		out.getBase()[i] = tempstream.str()[i];
+	string text;
+	const char* data = pdfdata.getBase();
+	int size = pdfdatasize;
+	int offset = getObjectOffset(objectindex);
+	if (getCompressedObject(objectindex, text)) {
+		data   = text.c_str();
+		size   = (int)text.size();
+		offset = 0;
+	}
+	int startindex = -1;
+	int endindex = findDictionaryEnd(data, size, offset, startindex);
+	if (endindex < 0) {
+		out.setSize(1);
+		out[0] = '\0';
+		return -1;
 	}
+	out.setSize(endindex - startindex + 1);
+	memcpy(out.getBase(), data + startindex, endindex - startindex);
 	out[out.getSize()-1] = '\0';
-	return returnval;
+	return endindex;
 }
 
 
 int PDFFile::getObjectDictionary(int objectindex, ostream& out) {
-	istream& file = *pdfdatastream;
-	int offset = getObjectOffset(objectindex);
-	int indictionary = 0;
-	int level  = 0;
-	int slevel = 0;
-	char ch;
-	file.seekg(offset, ios::beg);
-	while (!file.eof()) {
-		file.get(ch);
-		if (indictionary) {
-			out << ch;
-		}
-		if (!slevel) {
-			if (ch == '<') {
-				level++;
-				indictionary++;
-				out << ch;
-			} else if (ch == '>') {
-				level--;
-			}
-		}
-		if (ch == '(') {
-			slevel++;
-		} else if (ch == ')') {
-			slevel--;
-		}
-		if (indictionary && (level == 0)) {
-			break;
-		}
+	Array<char> dictionary;
+	int endindex = getObjectDictionary(objectindex, dictionary);
+	if (endindex < 0) {
+		return -1;
 	}
-
-	return file.tellg();
+	out.write(dictionary.getBase(), dictionary.getSize() - 1);
+	return endindex;
 }
 
 
@@ -200,13 +213,7 @@ int PDFFile::isEmbeddedHumdrumFile(int index) {
 	int fileheaderindex = getEmbeddedFileObject(index);
 	Array<char> filedict;
 	getObjectDictionary(fileheaderindex, filedict);
-	PerlRegularExpression pre;
-	if (pre.search(filedict.getBase(),
-		"/Desc\\s*\\(.*[Ee]mbedded\\s+[Hh]umdrum\\s+[Ff]ile.*\\)", "m")) {
-		return 1;
-	} else {
-		return 0;
-	}
+	return isHumdrumDescription(filedict.getBase());
 }
 
 
@@ -219,11 +226,9 @@ int PDFFile::isEmbeddedHumdrumFile(int index) {
 void PDFFile::getEmbeddedFileContents(int embedindex, Array<char>& out) {
 	stringstream tempstream;
 	getEmbeddedFileContents(embedindex, tempstream);
-	out.setSize(tempstream.str().length()+1);
-	int i;
-	for (i=0; i<out.getSize()-1; i++) {
-		out.getBase()[i] = tempstream.str()[i];
-	}
+	string contents = tempstream.str();
+	out.setSize(contents.length()+1);
+	memcpy(out.getBase(), contents.c_str(), contents.length());
 	out[out.getSize()-1] = '\0';
 }
 
@@ -232,11 +237,8 @@ void PDFFile::getEmbeddedFileContents(int embedindex, ostream& out) {
 	int fileheaderindex = getEmbeddedFileObject(embedindex);
 	Array<char> fileheaderdict;
 	getObjectDictionary(fileheaderindex, fileheaderdict);
-	PerlRegularExpression pre;
-	int streamobject;
-	if (pre.search(fileheaderdict.getBase(),
-			"/EF\\s*<<[^>]*/F\\s+(\\d+)\\s+(\\d+)\\s+R", "m")) {
-		streamobject = atol(pre.getSubmatch(1));
+	int streamobject = getEmbeddedStreamObject(fileheaderdict.getBase());
+	if (streamobject > 0) {
 		getStreamData(streamobject, out);
 	}
 }
@@ -245,15 +247,72 @@ void PDFFile::getEmbeddedFileContents(int embedindex, ostream& out) {
 
 //////////////////////////////
 //
-// PDFFile::getStreamData --
+// PDFFile::getEmbeddedHumdrumFiles -- Extract the contents of all
+//    embedded Humdrum files in one pass through the embedded file list,
+//    reading each file specification dictionary only once.  Returns
+//    the number of embedded Humdrum files which were found.
+//
+
+int PDFFile::getEmbeddedHumdrumFiles(ostream& out) {
+	Array<char> filedict;
+	int count = 0;
+	int streamobject;
+	int i;
+	for (i=0; i<embedFile.getSize(); i++) {
+		getObjectDictionary(embedFile[i], filedict);
+		if (!isHumdrumDescription(filedict.getBase())) {
+			continue;
+		}
+		streamobject = getEmbeddedStreamObject(filedict.getBase());
+		if (streamobject > 0) {
+			getStreamData(streamobject, out);
+			count++;
+		}
+	}
+	return count;
+}
+
+
+
+//////////////////////////////
+//
+// PDFFile::getStreamData -- Write the contents of a stream object.
+//    If the stream is compressed with /FlateDecode, then the data
+//    is uncompressed before it is written.
 //
 
 void PDFFile::getStreamData(int streamobject, ostream& out) {
-	Array<char> dictionary;
-	int dictend = getObjectDictionary(streamobject, dictionary);
+	int offset = getObjectOffset(streamobject);
+	if (offset < 0) {
+		// streams cannot be stored in object streams
+		return;
+	}
+	getStreamAt(offset, out);
+}
+
+
+
+//////////////////////////////
+//
+// PDFFile::getStreamAt -- Write the contents of the stream object which
+//    starts at the given byte offset.  A PNG /Predictor in the
+//    /DecodeParms of a /FlateDecode stream (as used in xref streams)
+//    is undone after the data is uncompressed.
+//
+
+void PDFFile::getStreamAt(int offset, ostream& out) {
+	int startindex = -1;
+	int dictend = getDictionaryEnd(offset, startindex);
+	if (dictend < 0) {
+		return;
+	}
+	string dictionary(pdfdata.getBase() + startindex, dictend - startindex);
 	PerlRegularExpression pre;
 	int ssize = -1;
-	if (pre.search(dictionary.getBase(), "/Length\\s+(\\d+)", "m")) {
+	if (pre.search(dictionary.c_str(),
+			"/Length\\s+(\\d+)\\s+(\\d+)\\s+R", "m")) {
+		ssize = getIntegerObject(atol(pre.getSubmatch(1)));
+	} else if (pre.search(dictionary.c_str(), "/Length\\s+(\\d+)", "m")) {
 		ssize = atol(pre.getSubmatch(1));
 	}
 
@@ -261,55 +320,129 @@ void PDFFile::getStreamData(int streamobject, ostream& out) {
 		return;
 	}
 
-	istream& file = *pdfdatastream;
-	char ch;
-	file.seekg(dictend+1);
-	file.get(ch);
-	while ((!file.eof()) && std::isspace(ch)) {
-		file.get(ch);
+	const char* data = pdfdata.getBase();
+	int i = dictend;
+	while ((i < pdfdatasize) && std::isspace(data[i])) {
+		i++;
 	}
-	if (ch != 's') {
+	if ((i + 6 > pdfdatasize) || (strncmp(data + i, "stream", 6) != 0)) {
 		cerr << "ERROR searching for start of 'stream'" << endl;
 		exit(1);
 	}
-	file.get(ch);
-	if (ch != 't') {
-		cerr << "ERROR searching for 't' of 'stream'" << endl;
-		exit(1);
+	i += 6;
+	// stream keyword is followed by CR LF or by LF alone:
+	if ((i < pdfdatasize) && (data[i] == 0x0d)) {
+		i++;
 	}
-	file.get(ch);
-	if (ch != 'r') {
-		cerr << "ERROR searching for 'r' of 'stream'" << endl;
-		exit(1);
+	if ((i < pdfdatasize) && (data[i] == 0x0a)) {
+		i++;
 	}
-	file.get(ch);
-	if (ch != 'e') {
-		cerr << "ERROR searching for 'e' of 'stream'" << endl;
-		exit(1);
+	if (i + ssize > pdfdatasize) {
+		ssize = pdfdatasize - i;
 	}
-	file.get(ch);
-	if (ch != 'a') {
-		cerr << "ERROR searching for 'a' of 'stream'" << endl;
-		exit(1);
+
+	if (!pre.search(dictionary.c_str(), "/Filter\\s*\\[?\\s*/FlateDecode",
+			"m")) {
+		out.write(data + i, ssize);
+		return;
 	}
-	file.get(ch);
-	if (ch != 'm') {
-		cerr << "ERROR searching for 'm' of 'stream'" << endl;
-		exit(1);
+	int predictor = 1;
+	if (pre.search(dictionary.c_str(), "/Predictor\\s+(\\d+)", "m")) {
+		predictor = atol(pre.getSubmatch(1));
+	}
+	if (predictor < 10) {
+		inflateData(data + i, ssize, out);
+		return;
+	}
+	int columns = 1;
+	if (pre.search(dictionary.c_str(), "/Columns\\s+(\\d+)", "m")) {
+		columns = atol(pre.getSubmatch(1));
+	}
+	stringstream inflated;
+	inflateData(data + i, ssize, inflated);
+	string rows = inflated.str();
+	undoPredictor(rows, columns);
+	out.write(rows.data(), rows.size());
+}
+
+
+
+//////////////////////////////
+//
+// PDFFile::getCompressedObject -- If the object is stored inside of an
+//    object stream (/ObjStm), then store its text in the output string
+//    and return true.  Otherwise return false.  Each object stream is
+//    uncompressed once and kept for later lookups.
+//
+//    An object stream starts with /N pairs of numbers: the object number
+//    and the offset of each object relative to the /First byte of the
+//    stream.  The objects follow without "obj" and "endobj" keywords.
+//
+
+int PDFFile::getCompressedObject(int objectindex, string& out) {
+	out.clear();
+	if ((objectindex < 0) || (objectindex >= indirectobjectoffset.getSize())) {
+		return 0;
 	}
+	if ((indirectobjectoffset[objectindex].getSize() == 0) ||
+			(indirectobjectoffset[objectindex][0] >= 0)) {
+		return 0;
+	}
+	int streamobject = -indirectobjectoffset[objectindex][0] - 1;
+	int position = indirectobjectversions[objectindex][0];
 
-	while ((!file.eof()) && (ch != 0x0a)) {
-		file.get(ch);
+	map<int, string>::iterator it = objectstreams.find(streamobject);
+	if (it == objectstreams.end()) {
+		stringstream contents;
+		getStreamData(streamobject, contents);
+		it = objectstreams.insert(make_pair(streamobject,
+				contents.str())).first;
 	}
+	const string& contents = it->second;
 
-	int i;
-	for (i=0; i<ssize; i++) {
-		file.get(ch);
-		if (file.eof()) {
-			break;
+	Array<char> dictionary;
+	getObjectDictionary(streamobject, dictionary);
+	PerlRegularExpression pre;
+	int count = -1;
+	int first = -1;
+	if (pre.search(dictionary.getBase(), "/N\\s+(\\d+)", "m")) {
+		count = atol(pre.getSubmatch(1));
+	}
+	if (pre.search(dictionary.getBase(), "/First\\s+(\\d+)", "m")) {
+		first = atol(pre.getSubmatch(1));
+	}
+	if ((position >= count) || (first < 0) ||
+			(first > (int)contents.size())) {
+		cerr << "ERROR: cannot find object " << objectindex
+			  << " in object stream " << streamobject << endl;
+		exit(1);
+	}
+
+	// read the offsets of this object and of the one after it:
+	const char* header = contents.c_str();
+	char* next = NULL;
+	long start = -1;
+	long stop  = (long)contents.size() - first;
+	int k;
+	for (k=0; (k<=position+1) && (k<count); k++) {
+		strtol(header, &next, 10);
+		header = next;
+		long value = strtol(header, &next, 10);
+		if (k == position) {
+			start = value;
+		} else if (k == position + 1) {
+			stop = value;
 		}
-		out << ch;
+		header = next;
+	}
+	if ((start < 0) || (stop < start) ||
+			(first + stop > (long)contents.size())) {
+		cerr << "ERROR: bad offset for object " << objectindex
+			  << " in object stream " << streamobject << endl;
+		exit(1);
 	}
+	out = contents.substr(first + start, stop - start);
+	return 1;
 }
 
 
@@ -364,24 +497,45 @@ int PDFFile::getXrefOffset(int index) {
 
 //////////////////////////////
 //
-// PDFFile::process -- link to an ifstream and build indirect object
-//     table.
+// PDFFile::hasXrefStream -- returns true if the file uses cross-reference
+//    streams (PDF 1.5 and later) rather than only xref tables.
+//
+
+int PDFFile::hasXrefStream(void) {
+	return xrefstreamQ;
+}
+
+
+
+//////////////////////////////
+//
+// PDFFile::process -- read the PDF data into memory and build the
+//     indirect object table.  The input stream is rewound to the
+//     start of the data when finished (if the stream can seek).
 //
 
 void PDFFile::process(ifstream& file) {
-	clear();
-	pdfdatastream = &file;
-	initializeXrefTable();
-	makeEmbeddedFileList();
+	process((istream&)file);
 }
 
 void PDFFile::process(istream& file) {
 	clear();
-	pdfdatastream = &file;
+	readData(file);
 	initializeXrefTable();
 	makeEmbeddedFileList();
 }
 
+void PDFFile::process(const char* filename) {
+	ifstream file;
+	file.open(filename, ios::in | ios::binary);
+	if (!file.is_open()) {
+		cerr << "ERROR: cannot open file: " << filename << endl;
+		exit(1);
+	}
+	process(file);
+	file.close();
+}
+
 
 
 //////////////////////////////
@@ -390,23 +544,7 @@ void PDFFile::process(istream& file) {
 //
 
 void PDFFile::print(ostream& out) {
-	istream& file = *pdfdatastream;
-
-	char chariot;
-	if (file.eof()) {
-		file.clear();
-	}
-	file.seekg(0, ios::beg);
-	file.get(chariot);
-	while (!file.eof()) {
-		cout << chariot;
-		file.get(chariot);
-	}
-
-	if (file.eof()) {
-		file.clear();
-	}
-	file.seekg(0, ios::beg);
+	out.write(pdfdata.getBase(), pdfdatasize);
 }
 
 
@@ -417,172 +555,92 @@ void PDFFile::print(ostream& out) {
 //
 
 void PDFFile::getTrailerString(int index, Array<char>& tstring) {
-	istream& file = *pdfdatastream;
-
-	tstring.setSize(1);
-	tstring[0] = '\0';
-
 	int xrefoffset = getXrefOffset(index);
 	if (xrefoffset <= 0) {
 		cerr << "ERROR in getTrailerString: xrefoffset " << xrefoffset
 			  << " is too small." << endl;
 		exit(1);
 	}
+	getTrailerAt(xrefoffset, tstring);
+}
 
-	stringstream trailer;
-	int filesize = getFileSize();
-	char ch;
 
-	int startindex = -1;
-	int i;
-	for (i=xrefoffset; i<filesize; i++) {
-		startindex = -1;
-		file.seekg(i, ios::beg);
-		file.get(ch);
-		if (ch != 't') { continue; } else { startindex = i; }
-		i++; file.get(ch); if (ch != 'r') { continue; }
-		i++; file.get(ch); if (ch != 'a') { continue; }
-		i++; file.get(ch); if (ch != 'i') { continue; }
-		i++; file.get(ch); if (ch != 'l') { continue; }
-		i++; file.get(ch); if (ch != 'e') { continue; }
-		i++; file.get(ch); if (ch != 'r') { continue; }
-		break;
-	}
 
-	if (startindex <= 5) {
-		cerr << "ERROR: Could not find the start of the trailer" << endl;
-		exit(1);
-	}
+///////////////////////////////////////////////////////////////////////////
 
-	int level = 0;
-	int indictionary = 0;
-	int slevel = 0;
+//////////////////////////////
+//
+// PDFFile::readData -- Store the contents of the input stream into
+//     memory.  Seekable streams are read with a single read() call;
+//     other streams (such as standard input) are read in large blocks.
+//
 
-	file.seekg(startindex, ios::beg);
-	while (!file.eof()) {
-		file.get(ch);
-		trailer << ch;
-		if (!slevel) {
-			if (ch == '<') {
-				level++;
-				indictionary++;
-			} else if (ch == '>') {
-				level--;
-			}
-		}
-		if (ch == '(') {
-			slevel++;
-		} else if (ch == ')') {
-			slevel--;
-		}
-		if (indictionary && (level == 0)) {
-			break;
-		}
+void PDFFile::readData(istream& file) {
+	if (file.eof()) {
+		file.clear();
 	}
+	file.seekg(0, ios::end);
+	streamoff filesize = file.tellg();
 
-
-	tstring.setSize(trailer.str().length()+1);
-	for (i=0; i<tstring.getSize()-1; i++) {
-		tstring.getBase()[i] = trailer.str()[i];
+	if ((filesize >= 0) && !file.fail()) {
+		file.seekg(0, ios::beg);
+		pdfdata.setSize((int)filesize + 1);
+		file.read(pdfdata.getBase(), filesize);
+		pdfdatasize = (int)file.gcount();
+	} else {
+		// collect the blocks first, then copy them into pdfdata once
+		file.clear();
+		vector<char> contents;
+		char buffer[65536];
+		while (file.read(buffer, sizeof(buffer)) || (file.gcount() > 0)) {
+			contents.insert(contents.end(), buffer, buffer + file.gcount());
+		}
+		pdfdatasize = (int)contents.size();
+		pdfdata.setSize(pdfdatasize + 1);
+		if (pdfdatasize > 0) {
+			memcpy(pdfdata.getBase(), contents.data(), pdfdatasize);
+		}
 	}
-	tstring[tstring.getSize()-1] = '\0';
+	pdfdata[pdfdatasize] = '\0';
 
+	// rewind the stream for callers which read from it afterwards:
+	file.clear();
+	file.seekg(0, ios::beg);
 }
 
 
 
-///////////////////////////////////////////////////////////////////////////
-
 //////////////////////////////
 //
-// PDFFile::getXrefOffset -- return the offset of the xref referred
-//      to in the trailer.
+// PDFFile::findStartXref -- return the offset of the xref referred
+//      to by the startxref entry at the end of the file.
 //
 
-int PDFFile::getXrefOffset(istream& file) {
-	if (file.eof()) {
-		file.clear();
-	}
-
-	int output = -1;
-	file.seekg(0, ios::end);
-	int filesize = (int)file.tellg();
-	int i = filesize - 4;  // skip over some of %%EOF string
-	char ch;
-	file.seekg(i, ios::beg);
-	file.get(ch);
-	while ((i > 0) && (ch != '%')) {
+int PDFFile::findStartXref(void) {
+	const char* data = pdfdata.getBase();
+	int i = pdfdatasize - 5;
+	while ((i >= 0) && (strncmp(data + i, "%%EOF", 5) != 0)) {
 		i--;
-		file.seekg(i, ios::beg);
-		file.get(ch);
 	}
 	if (i <= 0) {
 		cerr << "ERROR extracting xref offset in file " << endl;
 		exit(1);
 	}
-	file.seekg(i-1, ios::beg);
-	file.get(ch);
-	if (ch != '%') {
-		cerr << "ERROR1 extracting xref offset in file " << endl;
-		cerr << "Expected %, but found " << ch << endl;
-		exit(1);
-	}
-	file.seekg(i+1, ios::beg);
-	file.get(ch);
-	if (ch != 'E') {
-		cerr << "ERROR2 extracting xref offset in file " << endl;
-		cerr << "Expected E, but found " << ch << endl;
-		exit(1);
-	}
-	file.seekg(i+2, ios::beg);
-	file.get(ch);
-	if (ch != 'O') {
-		cerr << "ERROR3 extracting xref offset in file " << endl;
-		cerr << "Expected O, but found " << ch << endl;
-		exit(1);
-	}
-	file.seekg(i+3, ios::beg);
-	file.get(ch);
-	if (ch != 'F') {
-		cerr << "ERROR4 extracting xref offset in file " << endl;
-		cerr << "Expected F, but found " << ch << endl;
-		exit(1);
-	}
 
-	int bindex = 100;
-	char buffer[128] = {0};
-
-	i = i-2;
-	file.seekg(i, ios::beg);
-	file.get(ch);
-	while ((i>0) && (!std::isdigit(ch))) {
+	i--;
+	while ((i > 0) && !std::isdigit(data[i])) {
 		i--;
-		file.seekg(i, ios::beg);
-		file.get(ch);
 	}
-	if (!std::isdigit(ch)) {
+	if (!std::isdigit(data[i])) {
 		cerr << "ERROR5 extracting xref offset in file " << endl;
-		cerr << "Expected digit, but found " << ch << endl;
+		cerr << "Expected digit, but found " << data[i] << endl;
 		exit(1);
 	}
-	buffer[bindex--] = ch;
-	i--;
-	file.seekg(i, ios::beg);
-	file.get(ch);
-	while ((bindex > 0) && (i>0) && (std::isdigit(ch))) {
-		buffer[bindex--] = ch;
+	while ((i > 0) && std::isdigit(data[i-1])) {
 		i--;
-		file.seekg(i, ios::beg);
-		file.get(ch);
-	}
-	int status = sscanf(&buffer[bindex+1], "%d", &output);
-	if (status != 1) {
-		cerr << "ERROR6 reading number from string" << endl;
-		cerr << "string is " << &buffer[bindex+1] << endl;
-		exit(1);
 	}
 
-	return output;
+	return atol(data + i);
 }
 
 
@@ -593,42 +651,31 @@ int PDFFile::getXrefOffset(istream& file) {
 //
 
 void PDFFile::initializeXrefTable(void) {
-	if (pdfdatastream == NULL) {
+	if (pdfdatasize <= 0) {
 		return;
 	}
-	istream& file = *pdfdatastream;
-	int xrefoffset = getXrefOffset(*pdfdatastream);
+	int xrefoffset = findStartXref();
 
 	xref.setSize(100);
 	xref.setGrowth(1000);
 	xref.setSize(0);
-	xref.append(xrefoffset);
 
-	file.seekg(0, ios::end);
-	pdfdatasize = file.tellg();
-
-	int& filesize = pdfdatasize;
-
-	stringstream originaltrailer;
-	getOriginalTrailer(originaltrailer, filesize, xrefoffset, file);
-	originaltrailer << ends;
 	Array<char> trailerstring;
-	trailerstring.setSize(originaltrailer.str().length()+1);
-	strcpy(trailerstring.getBase(), originaltrailer.str().c_str());
+	getTrailerAt(xrefoffset, trailerstring);
 
 	int nextobject = -1;
 	PerlRegularExpression pre;
-	pre.search(originaltrailer.str().c_str(), "/Size\\s+(\\d+)", "");
-	if (!sscanf(pre.getSubmatch(1), "%d", &nextobject)) {
+	if (!pre.search(trailerstring.getBase(), "/Size\\s+(\\d+)", "")) {
 		cerr << "ERROR: cannot find object count in trailer" << endl;
 		exit(1);
 	}
+	nextobject = atol(pre.getSubmatch(1));
 
-	pre.search(originaltrailer.str().c_str(), "/Root\\s+(\\d+)", "");
-	if (!sscanf(pre.getSubmatch(1), "%d", &rootobject)) {
+	if (!pre.search(trailerstring.getBase(), "/Root\\s+(\\d+)", "")) {
 		cerr << "ERROR: cannot find root object number in trailer" << endl;
 		exit(1);
 	}
+	rootobject = atol(pre.getSubmatch(1));
 
 	if (nextobject < 0) {
 		return;
@@ -645,67 +692,7 @@ void PDFFile::initializeXrefTable(void) {
 		indirectobjectversions[i].setSize(0);
 	}
 
-	char ch;
-	file.seekg(xrefoffset, ios::beg);
-	file.get(ch);
-	if (ch != 'x') {
-		cerr << "ERROR: expected 'x' from xref, but found: " << ch << endl;
-		cerr << "int value is: " << (int)ch << endl;
-		cerr << "Position in file: " << file.tellg() << endl;
-		cerr << "xref offset is: " << xrefoffset << endl;
-		exit(1);
-	}
-	file.get(ch);
-	if (ch != 'r') {
-		cerr << "ERROR: expected 'r' from xref, but found: " << ch << endl;
-		exit(1);
-	}
-	file.get(ch);
-	if (ch != 'e') {
-		cerr << "ERROR: expected 'e' from xref, but found: " << ch << endl;
-		exit(1);
-	}
-	file.get(ch);
-	if (ch != 'f') {
-		cerr << "ERROR: expected 'f' from xref, but found: " << ch << endl;
-		exit(1);
-	}
-
-	while (!file.eof()) {
-		file.get(ch);
-		while (!file.eof() && !std::isdigit(ch) && (ch != 't')) {
-			file.get(ch);
-		}
-		if (file.eof() || (ch == 't')) {
-			break;
-		} else {
-			processXrefList(file, ch);
-		}
-	}
-
-	if (file.eof()) {
-		file.clear();
-		file.seekg(0, ios::beg);
-		return;
-	}
-
-	if (ch != 't') {
-		cerr << "ERROR: expecting trailer after xref, but find: " << ch << endl;
-		exit(1);
-	}
-
-	// Now search the trailer for an entry of the form:
-	//   /Prev 144425
-	// This is a byte offset of the previous xref entry, so call this
-	// function again with that offset value.  If no /Prev entry is
-	// found, before "%%EOF" string is found, then return to calling function.
-
-	int previous = getPreviousOffset(file);
-	if (previous >= 0) {
-		buildIndirectObjectIndex(file, previous);
-	} else{
-		return;
-	}
+	buildIndirectObjectIndex(xrefoffset);
 }
 
 
@@ -737,333 +724,648 @@ void PDFFile::initializeXrefTable(void) {
 // that the object is "free" (indirect object has been deleted from file),
 // "n" means that it is in use.
 //
+// The index is the position of the first digit of the starting object
+// number.  The return value is the position in the data after the list.
+//
 
-void PDFFile::processXrefList(istream& file, char firstdigit) {
-
-	if (file.eof()) {
-		file.clear();
-		return;
-	}
+int PDFFile::processXrefList(int index) {
+	const char* data = pdfdata.getBase();
+	int i = index;
 
-	char ch;
-	int startindex = firstdigit - '0';
-	file.get(ch);
-	while (!file.eof() && std::isdigit(ch)) {
-		startindex *= 10;
-		startindex += ch - '0';
-		file.get(ch);
+	int startindex = 0;
+	while ((i < pdfdatasize) && std::isdigit(data[i])) {
+		startindex = startindex * 10 + (data[i] - '0');
+		i++;
 	}
 
 	// now read the count of objects;
 	// previous character should be a space and is not a digit.
+	while ((i < pdfdatasize) && (data[i] == ' ')) {
+		i++;
+	}
 	int objectcount = 0;
-	file.get(ch);
-	while (!file.eof() && std::isdigit(ch)) {
-		objectcount *= 10;
-		objectcount += ch - '0';
-		file.get(ch);
+	while ((i < pdfdatasize) && std::isdigit(data[i])) {
+		objectcount = objectcount * 10 + (data[i] - '0');
+		i++;
 	}
 
-	int currentobject = startindex;
-	char buffer[128] = {0};
-	int offset = 0;
-	int tempval = 0;
-
 	// now read the list of objects:
-	int i;
-	while (!file.eof() && (std::isspace(ch))) {
-		file.get(ch);
+	while ((i < pdfdatasize) && std::isspace(data[i])) {
+		i++;
+	}
+	if ((objectcount > 0) && ((i >= pdfdatasize) || (data[i] != '0'))) {
+		cerr << "ERROR: funny error reading xref entry: " << data[i] << endl;
+		cerr << "hex value of character: 0x" << hex << (int)data[i]
+			  << dec << endl;
+		exit(1);
+	}
+
+	if (startindex + objectcount > indirectobjectoffset.getSize()) {
+		cerr << "Error in object count in xref entry." << endl;
+		cerr << "Index: " << startindex + objectcount - 1 << endl;
+		cerr << "Max Index " << indirectobjectoffset.getSize()-1 << endl;
+		exit(1);
+		// This might be useful to do instead:
+		// expandObjectListing(startindex + objectcount);
 	}
-	if (ch != '0') {
-		cerr << "ERROR: funny error reading xref entry: " << ch << endl;
-		cerr << "hex value of character: 0x" << hex << (int)ch << dec << endl;
+	if (i + objectcount * 20 > pdfdatasize) {
+		cerr << "ERROR: xref table extends past end of file" << endl;
 		exit(1);
 	}
-	tempval = file.tellg();
+
+	int offset;
 	int version;
-	tempval--;
-	file.seekg(tempval, ios::beg);
-	for (i=0; i<objectcount; i++) {
-		file.read(buffer, 20);
-		buffer[20] = '\0';
-		int j;
-		for (j=0; j<9; j++) {
-			if (buffer[j] != '0') {
-				break;
-			}
-		}
-		offset = 0;
-		offset = atol(&buffer[j]);
+	int j;
+	for (j=0; j<objectcount; j++) {
+		offset  = atol(data + i);
+		version = atol(data + i + 11);
+		indirectobjectoffset[startindex + j].append(offset);
+		indirectobjectversions[startindex + j].append(version);
+		i += 20;
+	}
+
+	return i;
+}
 
-		for (j=11; j<15; j++) {
-			if (buffer[j] != '0') {
-				break;
-			}
-		}
-		version = 0;
-		version = atol(&buffer[j]);
 
-		if (currentobject >= indirectobjectoffset.getSize()) {
-			cerr << "Error in object count in xref entry." << endl;
-			cerr << "Index: " << currentobject << endl;
-			cerr << "Max Index " << indirectobjectoffset.getSize()-1 << endl;
-			exit(1);
-			// This might be useful to do instead:
-			// expandObjectListing(currentobject+1);
-		}
 
-		indirectobjectoffset[currentobject].append(offset);
-		indirectobjectversions[currentobject].append(version);
+//////////////////////////////
+//
+// PDFFile::getPreviousOffset -- search through a trailer dictionary
+//   for a /Prev entry.  If there is a /Prev entry, then return
+//   the number following it, otherwise return -1.  The trailerindex is
+//   the position of the "trailer" keyword in the data.
+//
+
+int PDFFile::getPreviousOffset(int trailerindex) {
+	int startindex = -1;
+	int endindex = getDictionaryEnd(trailerindex, startindex);
+	if (endindex < 0) {
+		return -1;
+	}
+	int i = findString("/Prev", startindex, endindex);
+	if (i < 0) {
+		return -1;
+	}
 
-		currentobject++;
+	// skip any non-digit characters:
+	const char* data = pdfdata.getBase();
+	i += strlen("/Prev");
+	while ((i < endindex) && !std::isdigit(data[i])) {
+		if (!std::isspace(data[i])) {
+			cerr << "ERROR: found a strange character after /Prev in trailer: "
+				  << data[i] << endl;
+		}
+		i++;
 	}
+	if (i >= endindex) {
+		return -1;
+	}
+
+	return atol(data + i);
 }
 
 
 
 //////////////////////////////
 //
-// PDFFile::expandObjectListing --
+// PDFFile::buildIndirectObjectIndex -- make a list of all indirect objects
+//   found in the file (listed in the xref section(s)).  Each xref section
+//   may point to an older one with a /Prev entry in its trailer, and these
+//   are followed until the oldest xref section is reached.  A section can
+//   be an xref table or a cross-reference stream object.  A file which
+//   has both (a hybrid file) gives the offset of the cross-reference
+//   stream for an xref table in the /XRefStm entry of its trailer.
 //
 
-void PDFFile::expandObjectListing(int newsize) {
-	int oldsize = indirectobjectoffset.getSize();
+void PDFFile::buildIndirectObjectIndex(int xrefoffset) {
+	const char* data = pdfdata.getBase();
+	Array<char> trailer;
+	PerlRegularExpression pre;
+	int i;
+	int j;
 
-	if (newsize <= oldsize) {
-		return;
-	}
+	while (xrefoffset >= 0) {
+		for (j=0; j<xref.getSize(); j++) {
+			if (xref[j] == xrefoffset) {
+				cerr << "ERROR: circular /Prev entry in xref trailer" << endl;
+				exit(1);
+			}
+		}
+		xref.append(xrefoffset);
 
-	indirectobjectoffset.setSize(newsize);
-	indirectobjectversions.setSize(newsize);
-	int i;
-	for (i=oldsize; i<newsize; i++) {
-		indirectobjectoffset[i].setSize(0);
-		indirectobjectversions[i].setSize(0);
-	}
+		if ((xrefoffset + 4 > pdfdatasize) ||
+				(strncmp(data + xrefoffset, "xref", 4) != 0)) {
+			processXrefStream(xrefoffset);
+			xrefoffset = getPreviousOffset(xrefoffset);
+			continue;
+		}
+
+		// The entries in the stream of a hybrid file are read first, since
+		// the xref table lists the same objects as free.
+		getTrailerAt(xrefoffset, trailer);
+		if (pre.search(trailer.getBase(), "/XRefStm\\s+(\\d+)", "")) {
+			processXrefStream(atol(pre.getSubmatch(1)), 1);
+		}
+
+		i = xrefoffset + 4;
+		while (i < pdfdatasize) {
+			while ((i < pdfdatasize) && !std::isdigit(data[i]) &&
+					(data[i] != 't')) {
+				i++;
+			}
+			if ((i >= pdfdatasize) || (data[i] == 't')) {
+				break;
+			}
+			i = processXrefList(i);
+		}
+
+		if (i >= pdfdatasize) {
+			return;
+		}
 
+		// Now search the trailer for an entry of the form:
+		//   /Prev 144425
+		// This is a byte offset of the previous xref entry, so continue
+		// with that offset value.  If no /Prev entry is found, then the
+		// oldest xref section has been reached.
+		xrefoffset = getPreviousOffset(i);
+	}
 }
 
 
 
 //////////////////////////////
 //
-// PDFFile::getPreviousOffset -- search through a trailer until "%%EOF" is
-//   found, looking for a /Prev entry.  If there is a /Prev entry, then return
-//   the number following it.  The file is set to the first 'r' in "trailer"
-//   when this function is called.
+// PDFFile::processXrefStream -- read the entries of a cross-reference
+//   stream object which starts at the given byte offset.  The stream
+//   dictionary gives the byte widths of the three fields of each entry
+//   (/W), and the first object number and count of each subsection
+//   (/Index, default [0 /Size]).  The first field is the entry type:
+//      0 = free object (next free object number, generation)
+//      1 = object in file (byte offset, generation)
+//      2 = object in an object stream (stream object number, index)
+//   Objects in object streams are stored in the offset list as the
+//   negative of one more than the stream object number, and with the
+//   index in the object stream as the version.  For the /XRefStm stream
+//   of a hybrid file (hybridQ), free entries are skipped so that they do
+//   not hide the objects listed in the xref table.
 //
 
-int PDFFile::getPreviousOffset(istream& file) {
-
-	char ch;
-	if (file.eof()) {
-		cerr << "ERROR: file EOF while starting /Prev search" << endl;
+void PDFFile::processXrefStream(int offset, int hybridQ) {
+	xrefstreamQ = 1;
+	Array<char> dictionary;
+	getTrailerAt(offset, dictionary);
+	PerlRegularExpression pre;
+	if (!pre.search(dictionary.getBase(), "/Type\\s*/XRef\\b", "")) {
+		cerr << "ERROR: expected xref at byte offset " << offset << endl;
 		exit(1);
 	}
-	file.get(ch);
-	if (ch != 'r') {
-		cerr << "ERROR: unexpected character reading trailer: " << ch << endl;
+
+	int widths[3];
+	if (!pre.search(dictionary.getBase(),
+			"/W\\s*\\[\\s*(\\d+)\\s+(\\d+)\\s+(\\d+)\\s*\\]", "")) {
+		cerr << "ERROR: no /W entry in xref stream at byte offset " << offset
+			  << endl;
 		exit(1);
 	}
+	int j;
+	for (j=0; j<3; j++) {
+		widths[j] = atol(pre.getSubmatch(j+1));
+		if (widths[j] > 4) {
+			cerr << "ERROR: xref stream field is too wide: " << widths[j]
+				  << endl;
+			exit(1);
+		}
+	}
 
-	int level = 0;
-	int eofindex = 0;
-	int previndex = 0;
-	char eofstate[128] = {0};
-	char prevstate[128] = {0};
-	strcpy(eofstate, "%%EOF");
-	strcpy(prevstate, "/Prev");
-	int prevtarget = strlen(prevstate);
-	int eoftarget = strlen(eofstate);
-
-	file.get(ch);
-	while (!file.eof()) {
-		if (ch == '<') {
-			level++;
-		} else if (ch == '>') {
-			level--;
+	Array<int> subsections;
+	subsections.setSize(0);
+	subsections.setGrowth(100);
+	if (pre.search(dictionary.getBase(), "/Index\\s*\\[([\\d\\s]*)\\]", "")) {
+		string index = pre.getSubmatch(1);
+		const char* ptr = index.c_str();
+		char* next = NULL;
+		int value = (int)strtol(ptr, &next, 10);
+		while (next != ptr) {
+			subsections.append(value);
+			ptr = next;
+			value = (int)strtol(ptr, &next, 10);
+		}
+	} else if (pre.search(dictionary.getBase(), "/Size\\s+(\\d+)", "")) {
+		int value = 0;
+		subsections.append(value);
+		value = atol(pre.getSubmatch(1));
+		subsections.append(value);
+	}
+
+	stringstream contents;
+	getStreamAt(offset, contents);
+	string entries = contents.str();
+	const unsigned char* data = (const unsigned char*)entries.data();
+	int entrysize = widths[0] + widths[1] + widths[2];
+	int position = 0;
+	int fields[3];
+	int object;
+	int count;
+	int i, k;
+	for (i=0; i+1<subsections.getSize(); i+=2) {
+		object = subsections[i];
+		count  = subsections[i+1];
+		if (object + count > indirectobjectoffset.getSize()) {
+			cerr << "Error in object count in xref stream." << endl;
+			cerr << "Index: " << object + count - 1 << endl;
+			cerr << "Max Index " << indirectobjectoffset.getSize()-1 << endl;
+			exit(1);
 		}
-		if (level == 2) {
-			if (prevstate[previndex] == ch) {
-				previndex++;
-			} else {
-				previndex = 0;
+		for (j=0; j<count; j++) {
+			if (position + entrysize > (int)entries.size()) {
+				cerr << "ERROR: xref stream at byte offset " << offset
+					  << " is too short" << endl;
+				exit(1);
 			}
-			if (previndex == prevtarget) {
-				break;
+			for (k=0; k<3; k++) {
+				fields[k] = 0;
+				for (int b=0; b<widths[k]; b++) {
+					fields[k] = (fields[k] << 8) | data[position++];
+				}
 			}
-		} else if (level <= 0) {
-			if (eofstate[eofindex] == ch) {
-				eofindex++;
-			} else {
-				eofindex = 0;
+			if (widths[0] == 0) {
+				// the type defaults to an object in the file
+				fields[0] = 1;
 			}
-			if (eofindex == eoftarget) {
-				// found %%EOF, but did not find /Prev entry
-				return -1;
+			switch (fields[0]) {
+				case 0:
+					if (hybridQ) {
+						break;
+					}
+					// fall through
+				case 1:
+					indirectobjectoffset[object + j].append(fields[1]);
+					indirectobjectversions[object + j].append(fields[2]);
+					break;
+				case 2:
+					fields[1] = -fields[1] - 1;
+					indirectobjectoffset[object + j].append(fields[1]);
+					indirectobjectversions[object + j].append(fields[2]);
+					break;
+				// other types are to be ignored (as null objects)
 			}
 		}
-		file.get(ch);
 	}
+}
 
-	if (previndex != prevtarget) {
-		cerr << "ERROR: strange thing happened in getPreviousOffset()" << endl;
-		exit(1);
-	}
 
-	// skip any non-digit characters:
-	file.get(ch);
-	while (!file.eof() && !std::isdigit(ch)) {
-		if (!std::isspace(ch)) {
-			cerr << "ERROR: found a strange character after /Prev in trailer: "
-				  << ch << endl;
+
+//////////////////////////////
+//
+// PDFFile::getTrailerAt -- store the trailer dictionary which follows
+//    the xref section at the given offset.  For a cross-reference stream
+//    the stream dictionary is the trailer.
+//
+
+void PDFFile::getTrailerAt(int xrefoffset, Array<char>& tstring) {
+	tstring.setSize(1);
+	tstring[0] = '\0';
+
+	if ((xrefoffset >= 0) && ((xrefoffset + 4 > pdfdatasize) ||
+			(strncmp(pdfdata.getBase() + xrefoffset, "xref", 4) != 0))) {
+		int dictstart = -1;
+		int dictend = getDictionaryEnd(xrefoffset, dictstart);
+		if (dictend < 0) {
+			cerr << "ERROR: expected xref at byte offset " << xrefoffset
+				  << endl;
+			exit(1);
 		}
-		file.get(ch);
+		tstring.setSize(dictend - dictstart + 1);
+		memcpy(tstring.getBase(), pdfdata.getBase() + dictstart,
+				dictend - dictstart);
+		tstring[tstring.getSize()-1] = '\0';
+		return;
 	}
-	if (file.eof()) {
-		return -1;
+
+	int startindex = findString("trailer", xrefoffset, pdfdatasize);
+	if (startindex <= 5) {
+		cerr << "ERROR: Could not find the start of the trailer" << endl;
+		exit(1);
 	}
-	int value = ch - '0';
-	file.get(ch);
-	while (!file.eof() && std::isdigit(ch)) {
-		value *= 10;
-		value += ch - '0';
-		file.get(ch);
+
+	int dictstart = -1;
+	int endindex = getDictionaryEnd(startindex, dictstart);
+	if (endindex < 0) {
+		endindex = pdfdatasize;
 	}
 
-	return value;
+	tstring.setSize(endindex - startindex + 1);
+	memcpy(tstring.getBase(), pdfdata.getBase() + startindex,
+			endindex - startindex);
+	tstring[tstring.getSize()-1] = '\0';
 }
 
 
 
 //////////////////////////////
 //
-// PDFFile::buildIndirectObjectIndex -- make a list of all indirect objects
-//   found in the file (listed in the xref section(s)).
+// PDFFile::getDictionaryEnd -- Find the first dictionary at or after
+//    the given byte offset.  The startindex is set to the position of
+//    the opening "<<", and the return value is the position just after
+//    the matching ">>".  Returns -1 if an "endobj" is found before
+//    any dictionary starts, or if the dictionary is not terminated.
+//    Angle brackets inside of (strings) are ignored.
 //
 
-void PDFFile::buildIndirectObjectIndex(istream& file, int xrefoffset) {
+int PDFFile::getDictionaryEnd(int offset, int& startindex) {
+	return findDictionaryEnd(pdfdata.getBase(), pdfdatasize, offset,
+			startindex);
+}
 
-	xref.append(xrefoffset);
 
-	char ch;
-	file.seekg(xrefoffset, ios::beg);
-	file.get(ch);
-	if (ch != 'x') {
-		cerr << "ERROR: expected 'x' from xref, but found: " << ch << endl;
-		cerr << "int value is: " << (int)ch << endl;
-		cerr << "Position in file: " << file.tellg() << endl;
-		cerr << "xref offset is: " << xrefoffset << endl;
-		exit(1);
-	}
-	file.get(ch);
-	if (ch != 'r') {
-		cerr << "ERROR: expected 'r' from xref, but found: " << ch << endl;
-		exit(1);
-	}
-	file.get(ch);
-	if (ch != 'e') {
-		cerr << "ERROR: expected 'e' from xref, but found: " << ch << endl;
-		exit(1);
-	}
-	file.get(ch);
-	if (ch != 'f') {
-		cerr << "ERROR: expected 'f' from xref, but found: " << ch << endl;
-		exit(1);
+
+//////////////////////////////
+//
+// PDFFile::findDictionaryEnd -- Same as getDictionaryEnd(), but for any
+//    block of data, such as an object from an object stream.
+//
+
+int PDFFile::findDictionaryEnd(const char* data, int size, int offset,
+		int& startindex) {
+	startindex = -1;
+	if ((offset < 0) || (offset >= size)) {
+		return -1;
 	}
 
-	while (!file.eof()) {
-		file.get(ch);
-		while (!file.eof() && !std::isdigit(ch) && (ch != 't')) {
-			file.get(ch);
+	int level  = 0;
+	int slevel = 0;
+	int i;
+	for (i=offset; i<size; i++) {
+		if (slevel) {
+			if (data[i] == '\\') {
+				i++;
+			} else if (data[i] == '(') {
+				slevel++;
+			} else if (data[i] == ')') {
+				slevel--;
+			}
+			continue;
 		}
-		if (file.eof() || (ch == 't')) {
-			break;
-		} else {
-			processXrefList(file, ch);
+		switch (data[i]) {
+			case '(':
+				slevel++;
+				break;
+			case '<':
+				if (startindex < 0) {
+					startindex = i;
+				}
+				level++;
+				break;
+			case '>':
+				level--;
+				if ((startindex >= 0) && (level <= 0)) {
+					return i + 1;
+				}
+				break;
+			case 'e':
+				if ((startindex < 0) && (i + 6 <= size) &&
+						(strncmp(data + i, "endobj", 6) == 0)) {
+					return -1;
+				}
+				break;
 		}
 	}
 
-	if (file.eof()) {
+	return -1;
+}
+
+
+
+//////////////////////////////
+//
+// PDFFile::undoPredictor -- Undo the PNG predictor of uncompressed
+//    stream data (/Predictor 10 to 15 in /DecodeParms).  Each row of
+//    the data starts with a byte giving the PNG filter type of the row,
+//    followed by the given number of columns of one-byte values.
+//
+
+void PDFFile::undoPredictor(string& data, int columns) {
+	if (columns <= 0) {
 		return;
 	}
+	int rowsize = columns + 1;
+	int rows = (int)data.size() / rowsize;
+	string output(rows * columns, '\0');
+	vector<unsigned char> prior(columns, 0);
+	const unsigned char* input;
+	unsigned char* current;
+	int left;
+	int up;
+	int upleft;
+	int estimate;
+	int r, c;
+	for (r=0; r<rows; r++) {
+		input = (const unsigned char*)data.data() + r * rowsize;
+		current = (unsigned char*)&output[r * columns];
+		for (c=0; c<columns; c++) {
+			left   = c > 0 ? current[c-1] : 0;
+			up     = prior[c];
+			upleft = c > 0 ? prior[c-1] : 0;
+			switch (input[0]) {
+				case 1:  // Sub
+					current[c] = input[c+1] + left;
+					break;
+				case 2:  // Up
+					current[c] = input[c+1] + up;
+					break;
+				case 3:  // Average
+					current[c] = input[c+1] + (left + up) / 2;
+					break;
+				case 4:  // Paeth
+					estimate = left + up - upleft;
+					if ((abs(estimate - left) <= abs(estimate - up)) &&
+							(abs(estimate - left) <= abs(estimate - upleft))) {
+						current[c] = input[c+1] + left;
+					} else if (abs(estimate - up) <= abs(estimate - upleft)) {
+						current[c] = input[c+1] + up;
+					} else {
+						current[c] = input[c+1] + upleft;
+					}
+					break;
+				default: // None
+					current[c] = input[c+1];
+			}
+		}
+		memcpy(prior.data(), current, columns);
+	}
+	data = output;
+}
 
-	if (ch != 't') {
-		cerr << "ERROR: expecting trailer after xref, but find: " << ch << endl;
-		exit(1);
+
+
+//////////////////////////////
+//
+// PDFFile::findString -- return the position of the first occurrence
+//    of the target string in the data, starting at startindex and ending
+//    before endindex.  Returns -1 if not found.
+//
+
+int PDFFile::findString(const char* target, int startindex, int endindex) {
+	int length = strlen(target);
+	if (startindex < 0) {
+		startindex = 0;
+	}
+	if (endindex > pdfdatasize) {
+		endindex = pdfdatasize;
+	}
+	const char* data = pdfdata.getBase();
+	const char* ptr;
+	int i = startindex;
+	while (i + length <= endindex) {
+		ptr = (const char*)memchr(data + i, target[0], endindex - length + 1 - i);
+		if (ptr == NULL) {
+			return -1;
+		}
+		i = ptr - data;
+		if (strncmp(ptr, target, length) == 0) {
+			return i;
+		}
+		i++;
 	}
+	return -1;
+}
 
-	// Now search the trailer for an entry of the form:
-	//   /Prev 144425
-	// This is a byte offset of the previous xref entry, so call this
-	// function again with that offset value.  If no /Prev entry is
-	// found, before "%%EOF" string is found, then return to calling function.
 
-	int previous = getPreviousOffset(file);
-	if (previous >= 0) {
-		buildIndirectObjectIndex(file, previous);
-	} else{
-		return;
+
+//////////////////////////////
+//
+// PDFFile::getIntegerObject -- return the value of an indirect object
+//    which contains only an integer, such as a stream /Length which is
+//    stored after the stream data.  Returns -1 if there is no number.
+//
+
+int PDFFile::getIntegerObject(int objectindex) {
+	string text;
+	if (getCompressedObject(objectindex, text)) {
+		size_t k = text.find_first_not_of(" \t\r\n");
+		if ((k == string::npos) || !std::isdigit(text[k])) {
+			return -1;
+		}
+		return atol(text.c_str() + k);
+	}
+	int offset = getObjectOffset(objectindex);
+	if (offset < 0) {
+		return -1;
 	}
+	int i = findString("obj", offset, offset + 100);
+	if (i < 0) {
+		return -1;
+	}
+	const char* data = pdfdata.getBase();
+	i += strlen("obj");
+	while ((i < pdfdatasize) && std::isspace(data[i])) {
+		i++;
+	}
+	if ((i >= pdfdatasize) || !std::isdigit(data[i])) {
+		return -1;
+	}
+	return atol(data + i);
 }
 
 
 
 //////////////////////////////
 //
-// PDFFile::getOriginalTrailer --
+// PDFFile::getEmbeddedStreamObject -- return the object number of the
+//    embedded file stream referenced in a file specification dictionary,
+//    or -1 if there is no /EF entry.
 //
 
-void PDFFile::getOriginalTrailer(stringstream& trailer, int filesize, int xref,
-		istream& file) {
-	int i = filesize - 5;
-	int startindex = -1;
-	char ch;
-
-	for (i=xref; i<filesize; i++) {
-		startindex = -1;
-		file.seekg(i, ios::beg);
-		file.get(ch);
-		if (ch != 't') { continue; } else { startindex = i; }
-		i++; file.get(ch); if (ch != 'r') { continue; }
-		i++; file.get(ch); if (ch != 'a') { continue; }
-		i++; file.get(ch); if (ch != 'i') { continue; }
-		i++; file.get(ch); if (ch != 'l') { continue; }
-		i++; file.get(ch); if (ch != 'e') { continue; }
-		i++; file.get(ch); if (ch != 'r') { continue; }
-		break;
+int PDFFile::getEmbeddedStreamObject(const char* filedict) {
+	PerlRegularExpression pre;
+	if (pre.search(filedict, "/EF\\s*<<[^>]*/F\\s+(\\d+)\\s+(\\d+)\\s+R",
+			"m")) {
+		return atol(pre.getSubmatch(1));
 	}
+	return -1;
+}
 
-	if (startindex <= 5) {
-		cerr << "ERROR: Could not find the start of the trailer" << endl;
-		exit(1);
+
+
+//////////////////////////////
+//
+// PDFFile::isHumdrumDescription -- Returns true if the /Desc entry of
+//    a file specification dictionary contains "Embedded Humdrum File".
+//
+
+int PDFFile::isHumdrumDescription(const char* filedict) {
+	PerlRegularExpression pre;
+	if (pre.search(filedict,
+		"/Desc\\s*\\(.*[Ee]mbedded\\s+[Hh]umdrum\\s+[Ff]ile.*\\)", "m")) {
+		return 1;
+	} else {
+		return 0;
 	}
+}
 
-	int level = 0;
-	int indictionary = 0;
-	int slevel = 0;
 
-	file.seekg(startindex, ios::beg);
-	while (!file.eof()) {
-		file.get(ch);
-		trailer << ch;
-		if (!slevel) {
-			if (ch == '<') {
-				level++;
-				indictionary++;
-			} else if (ch == '>') {
-				level--;
-			}
-		}
-		if (ch == '(') {
-			slevel++;
-		} else if (ch == ')') {
-			slevel--;
-		}
-		if (indictionary && (level == 0)) {
+
+//////////////////////////////
+//
+// PDFFile::inflateData -- Uncompress stream data which was compressed
+//    with the /FlateDecode filter.  Requires the zlib library (compile
+//    with -DHAVE_ZLIB).
+//
+
+void PDFFile::inflateData(const char* data, int size, ostream& out) {
+#ifdef HAVE_ZLIB
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	if (inflateInit(&zs) != Z_OK) {
+		cerr << "ERROR: cannot initialize FlateDecode stream" << endl;
+		return;
+	}
+	zs.next_in  = (Bytef*)data;
+	zs.avail_in = size;
+
+	char buffer[65536];
+	int status = Z_OK;
+	while (status == Z_OK) {
+		zs.next_out  = (Bytef*)buffer;
+		zs.avail_out = sizeof(buffer);
+		status = inflate(&zs, Z_NO_FLUSH);
+		if ((status != Z_OK) && (status != Z_STREAM_END)) {
+			cerr << "ERROR: corrupt FlateDecode stream" << endl;
 			break;
 		}
+		out.write(buffer, sizeof(buffer) - zs.avail_out);
 	}
+	inflateEnd(&zs);
+#else
+	cerr << "ERROR: FlateDecode streams not supported in this compilation"
+		  << endl;
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// PDFFile::expandObjectListing --
+//
+
+void PDFFile::expandObjectListing(int newsize) {
+	int oldsize = indirectobjectoffset.getSize();
+
+	if (newsize <= oldsize) {
+		return;
+	}
+
+	indirectobjectoffset.setSize(newsize);
+	indirectobjectversions.setSize(newsize);
+	int i;
+	for (i=oldsize; i<newsize; i++) {
+		indirectobjectoffset[i].setSize(0);
+		indirectobjectversions[i].setSize(0);
+	}
+
 }
 
 
@@ -1,6 +1,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun 29 14:25:53 PDT 2009
 // Last Modified: Mon Jun 29 14:26:01 PDT 2009
+// Last Modified: Sun Oct 18 18:55:16 PDT 2026 added profiling timers
 // Filename:      ...sig/src/sig/PerlRegularExpression.cpp
 // Web Address:   http://sig.sapp.org/src/sig/PerlRegularExpression.cpp
 // Syntax:        C++; Perl Compatible Regular Expressions (http://www.pcre.org)
@@ -159,6 +160,7 @@
 
 #include "PerlRegularExpression.h"
 #include "Array.h"
+#include "Profiler.h"
 
 #include <cstring>
 #include <iostream>
@@ -440,6 +442,7 @@ void PerlRegularExpression::setNoIgnoreCase(void) {
 //
 
 void PerlRegularExpression::initializeSearch(void) {
+	PROFILE_SCOPE("PerlRegularExpression::compile");
 
 	int compflags = 0;
 	// PCRE always uses extended regular expressions
@@ -527,6 +530,7 @@ void PerlRegularExpression::initializeSearch(const char* searchstring) {
 //
 
 void PerlRegularExpression::studySearch() {
+	PROFILE_SCOPE("PerlRegularExpression::study");
 	if (pre == NULL) {
 		studyQ = 0;
 		return;
@@ -848,6 +852,7 @@ int PerlRegularExpression::searchAndReplace(string& output,
 
 int PerlRegularExpression::searchAndReplace(Array<char>& output,
 		const char* input) {
+	PROFILE_SCOPE("PerlRegularExpression::replace");
 
 	const char* ptr = input;
 	if (valid == 0) {
@@ -986,6 +991,7 @@ int PerlRegularExpression::search(const string& input) {
 
 
 int PerlRegularExpression::search(const char* input) {
+	PROFILE_SCOPE("PerlRegularExpression::search");
 	if (valid == 0) {
 		initializeSearch();
 	}
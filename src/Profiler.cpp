@@ -0,0 +1,242 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Sun Oct 18 18:55:16 PDT 2026
+// Last Modified: Sun Oct 18 18:55:16 PDT 2026
+// Filename:      ...sig/src/sigInfo/Profiler.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/Profiler.cpp
+// Syntax:        C++
+//
+// Description:   Timers and counters for the phases of the library.
+//
+
+#include "Profiler.h"
+
+#include <atomic>
+#include <mutex>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+using namespace std;
+
+// registered timers and counters (ids are indexes into these arrays):
+static const char*        profileNames[PROFILE_MAX];
+static atomic<long long>  profileCalls[PROFILE_MAX];
+static atomic<long long>  profileNanos[PROFILE_MAX];
+static atomic<int>        profileTimed[PROFILE_MAX];
+static atomic<int>        profileCount(0);
+static mutex              profileMutex;
+
+// nesting of timers in the current thread, so that recursive calls (or
+// overloaded functions which call each other) are only timed once:
+static thread_local int   profileDepth[PROFILE_MAX];
+
+
+//////////////////////////////
+//
+// Profiler::getId -- return the id of the timer or counter with the
+//    given name, adding it if it is new.  Functions which use the same
+//    name share a timer or counter.
+//
+
+int Profiler::getId(const char* name) {
+	lock_guard<mutex> lock(profileMutex);
+	int count = profileCount;
+	for (int i=0; i<count; i++) {
+		if (strcmp(profileNames[i], name) == 0) {
+			return i;
+		}
+	}
+	if (count >= PROFILE_MAX) {
+		// too many names: merge into the last entry
+		return PROFILE_MAX - 1;
+	}
+	profileNames[count] = name;
+	profileCalls[count] = 0;
+	profileNanos[count] = 0;
+	profileTimed[count] = 0;
+	profileCount = count + 1;
+	return count;
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::addTime -- add time to a timer.
+//
+
+void Profiler::addTime(int id, long long nanoseconds) {
+	profileNanos[id] += nanoseconds;
+	profileTimed[id] = 1;
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::addCount -- add to the number of calls or events of a timer
+//     or counter.
+//     default value: amount = 1
+//
+
+void Profiler::addCount(int id, long long amount) {
+	profileCalls[id] += amount;
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::enter -- start a call of a timer.
+//
+
+void Profiler::enter(int id) {
+	profileCalls[id]++;
+	profileDepth[id]++;
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::leave -- finish a call of a timer.  Returns true if it was
+//     the outermost call of the timer in the current thread.
+//
+
+int Profiler::leave(int id) {
+	profileDepth[id]--;
+	return profileDepth[id] == 0;
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::clear -- set all timers and counters to zero.
+//
+
+void Profiler::clear(void) {
+	int count = profileCount;
+	for (int i=0; i<count; i++) {
+		profileCalls[i] = 0;
+		profileNanos[i] = 0;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::enableReport -- print the timers and counters to standard
+//     error when the program exits.
+//
+
+void Profiler::enableReport(void) {
+	static int enabled = 0;
+	if (enabled) {
+		return;
+	}
+	enabled = 1;
+	atexit(printReportAtExit);
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::isCompiled -- returns true if the library was compiled with
+//     the timers and counters.
+//
+
+int Profiler::isCompiled(void) {
+	#ifdef HUMEXTRA_PROFILE
+		return 1;
+	#else
+		return 0;
+	#endif
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::printReport -- print the timers and counters as Humdrum data.
+//     Times include the time of any other timers which are called inside
+//     of them (such as spine analysis inside of reading a file).
+//
+
+ostream& Profiler::printReport(ostream& out) {
+	if (!isCompiled()) {
+		out << "!! Profiling is not compiled in: "
+		    << "recompile with make PROFILE=1" << endl;
+		return out;
+	}
+	char buffer[64];
+	double ms;
+	int count = profileCount;
+	out << "**phase\t**calls\t**ms\t**us/call\n";
+	for (int i=0; i<count; i++) {
+		if (profileCalls[i] == 0) {
+			continue;
+		}
+		out << profileNames[i] << "\t" << profileCalls[i];
+		if (profileTimed[i]) {
+			ms = profileNanos[i] / 1000000.0;
+			snprintf(buffer, sizeof(buffer), "\t%.3f\t%.3f", ms,
+					ms * 1000.0 / profileCalls[i]);
+			out << buffer;
+		} else {
+			out << "\t.\t.";
+		}
+		out << "\n";
+	}
+	out << "*-\t*-\t*-\t*-" << endl;
+	return out;
+}
+
+
+
+//////////////////////////////
+//
+// Profiler::printReportAtExit --
+//
+
+void Profiler::printReportAtExit(void) {
+	printReport(cerr);
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// ProfileTimer class functions
+//
+
+//////////////////////////////
+//
+// ProfileTimer::ProfileTimer -- start timing a call.
+//
+
+ProfileTimer::ProfileTimer(int anId) {
+	id = anId;
+	Profiler::enter(id);
+	start = chrono::steady_clock::now();
+}
+
+
+
+//////////////////////////////
+//
+// ProfileTimer::~ProfileTimer -- add the time of the call to the timer.
+//
+
+ProfileTimer::~ProfileTimer() {
+	chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+	if (Profiler::leave(id)) {
+		Profiler::addTime(id, chrono::duration_cast<chrono::nanoseconds>(
+				stop - start).count());
+	}
+}
+
+
+
@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Dec 24 18:25:42 PST 2002
 // Last Modified: Tue Dec 24 18:25:44 PST 2002
+// Last Modified: Sun Oct 18 16:29:47 PDT 2026 Added note-array calculate
+// Last Modified: Sun Oct 18 17:44:07 PDT 2026 Added pitch-class histogram
 // Filename:      ...sig/include/sigInfo/RootSpectrum.cpp
 // Web Address:   http://sig.sapp.org/include/sigInfo/RootSpectrum.cpp
 // Syntax:        C++
@@ -39,6 +41,10 @@ RootSpectrum::RootSpectrum(void) {
 	setResolutionFactor(1.0);
 	setDurationWeight(0.25);
 	setMetricLevelWeight(0.25);
+	histogram.setSize(40);
+	histogram.allowGrowth(0);
+	histogram.setAll(0.0);
+	notecount = 0;
 }
 
 
@@ -796,19 +802,23 @@ int RootSpectrum::calculate(IntervalWeight& distances, HumdrumFile& infile,
 		return -1;
 	}
 
+	if (!melodyQ) {
+		clearNotes();
+		for (j=0; j<pitches.getSize(); j++) {
+			addNote(pitches[j], durations[j], levels[j]);
+		}
+		return calculate(distances);
+	}
+
 	rootscores.setSize(40);
 	rootscores.setAll(0.0);
 	double melodyscaling;
 
 	for (i=0; i<rootscores.getSize(); i++) {
 		for (j=0; j<pitches.getSize(); j++) {
-			if (melodyQ) {
-				melodyscaling = getMelodicScaling(i, pitches[j],
-					lastpitches[j], nextpitches[j], distances,
-					absbeat[j], chordstartbeat, chordendbeat, durations[j]);
-			} else {
-				melodyscaling = 1.0;
-			}
+			melodyscaling = getMelodicScaling(i, pitches[j],
+				lastpitches[j], nextpitches[j], distances,
+				absbeat[j], chordstartbeat, chordendbeat, durations[j]);
 			rootscores[i] += distances[(pitches[j]-i+400)%40] *
 				durationscaling(durations[j]) *
 				metricscaling(levels[j]) *
@@ -820,6 +830,154 @@ int RootSpectrum::calculate(IntervalWeight& distances, HumdrumFile& infile,
 }
 
 
+
+//////////////////////////////
+//
+// RootSpectrum::calculate -- calculate root scores from a list of
+//     notes which has already been extracted from a score.  Melodic
+//     scaling is not applied since the notes have no voice-leading
+//     context.  Returns the best root, or -1 if there are no notes.
+//
+
+int RootSpectrum::calculate(IntervalWeight& distances, Array<int>& pitches,
+		Array<double>& durations, Array<double>& levels) {
+
+	clearNotes();
+	for (int j=0; j<pitches.getSize(); j++) {
+		addNote(pitches[j], durations[j], levels[j]);
+	}
+	return calculate(distances);
+}
+
+
+
+//////////////////////////////
+//
+// RootSpectrum::clearNotes -- remove all notes from the pitch-class
+//     histogram used by calculate(distances).
+//
+
+void RootSpectrum::clearNotes(void) {
+	histogram.setAll(0.0);
+	notecount = 0;
+}
+
+
+
+//////////////////////////////
+//
+// RootSpectrum::addNote -- add a note to the pitch-class histogram.  The
+//     duration and metric-level scaling of the note is calculated once
+//     here, so the cost of calculate(distances) does not depend on the
+//     number of notes.
+//
+
+void RootSpectrum::addNote(int pitch, double duration, double level) {
+	if (pitch < 0) {
+		return;
+	}
+	histogram[pitch % 40] += durationscaling(duration) * metricscaling(level);
+	notecount++;
+}
+
+
+
+//////////////////////////////
+//
+// RootSpectrum::removeNote -- remove a note which was previously added
+//     with addNote(), such as when a window of notes slides past it.
+//
+
+void RootSpectrum::removeNote(int pitch, double duration, double level) {
+	if (pitch < 0) {
+		return;
+	}
+	notecount--;
+	if (notecount <= 0) {
+		// avoid leaving rounding errors in the histogram
+		clearNotes();
+		return;
+	}
+	histogram[pitch % 40] -= durationscaling(duration) * metricscaling(level);
+}
+
+
+
+//////////////////////////////
+//
+// RootSpectrum::getNoteCount -- returns the number of notes in the
+//     pitch-class histogram.
+//
+
+int RootSpectrum::getNoteCount(void) {
+	return notecount;
+}
+
+
+
+//////////////////////////////
+//
+// RootSpectrum::calculate -- calculate root scores from the notes
+//     stored with addNote().  Returns the best root, or -1 if there
+//     are no notes.
+//
+
+int RootSpectrum::calculate(IntervalWeight& distances) {
+	if (notecount <= 0) {
+		values.setAll(100000.0);
+		return -1;
+	}
+
+	double weights[40];
+	for (int i=0; i<40; i++) {
+		weights[i] = distances[i];
+	}
+	values.setAll(0.0);
+	scoreRoots(values.getBase(), histogram.getBase(), weights, 0);
+
+	return bestIndex();
+}
+
+
+
+//////////////////////////////
+//
+// RootSpectrum::scoreRoots -- add the weighted distances from each root
+//     to each pitch class in a histogram into the 40 root scores:
+//
+//        scores[root] += histogram[pc] * weights[(pc - root - offset) % 40]
+//
+//     The distances are first laid out in a doubled table so that the
+//     inner loop runs over contiguous memory without a modulo, which
+//     lets the compiler vectorize it.  Empty pitch classes are skipped.
+//     default value: offset = 0
+//
+
+void RootSpectrum::scoreRoots(double* scores, double* histogram,
+		double* weights, int offset) {
+	// table[k] is the weight for root - pc == k - 40
+	double table[80];
+	int k;
+	for (k=0; k<80; k++) {
+		table[k] = weights[((40 - k - offset) % 40 + 80) % 40];
+	}
+
+	int pc, root;
+	double value;
+	double* row;
+	for (pc=0; pc<40; pc++) {
+		value = histogram[pc];
+		if (value == 0.0) {
+			continue;
+		}
+		row = table + 40 - pc;
+		for (root=0; root<40; root++) {
+			scores[root] += value * row[root];
+		}
+	}
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Private Functions
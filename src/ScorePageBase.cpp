@@ -7,6 +7,8 @@
 // Last Modified: Tue Mar 31 16:14:05 PST 2009 Updates for winscore version
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 Renamed SigCollection class
 // Last Modified: Sun Aug 26 00:55:11 PDT 2012 Renovated
+// Last Modified: Sun Oct 18 16:13:30 PDT 2026 Block reading, keyed sorting
+// Last Modified: Sun Oct 18 21:23:18 PDT 2026 Removed readFiles
 // Filename:      ...sig/src/sigInfo/ScorePageBase.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScorePageBase.h
 // Syntax:        C++
@@ -19,6 +21,7 @@
 
 #include "ScorePageBase.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <fstream>
@@ -464,29 +467,47 @@ void ScorePageBase::readBinary(const char* filename, int verboseQ) {
 //////////////////////////////
 //
 // ScorePageBase::readBinary --  Read a single SCORE page in the binary
-//      data format from an input stream.
+//      data format from an input stream.  The entire page is read into
+//      memory with a single read, the numbers are decoded into one
+//      contiguous float buffer, and then the items are filled in directly
+//      from that buffer.
 //
 
 void ScorePageBase::readBinary(istream& infile, int verboseQ) {
 	clear();
 
+	infile.seekg(0, ios::end);
+	int filesize = (int)infile.tellg();
+	infile.seekg(0, ios::beg);
+	if (filesize < 2 + 4 * 2) {
+		cerr << "Error: SCORE binary data is too short" << endl;
+		exit(1);
+	}
+	std::vector<char> bytes(filesize);
+	infile.read(bytes.data(), filesize);
+
 	// first read the count of 4-byte numbers/text chunks in the data file.
-	int numbercount = readLittleShort(infile);
+	int numbercount = ((unsigned char)bytes[1] << 8) | (unsigned char)bytes[0];
 	int readcount = 0;   // number of numbers which have been read
 	if (verboseQ) {
 		cout << "#NUMBER COUNT OF FILE IS " << numbercount << endl;
 	}
 
-	// now read the count of numbers in the trailer
-	infile.seekg(-8, ios::end);
-	int trailerSize = (int)readLittleFloat(infile);
+	// decode all of the 4-byte numbers after the count:
+	int wordcount = (filesize - 2) / 4;
+	std::vector<float> numbers(wordcount);
+	ScoreRecord::decodeLittleFloats(bytes.data() + 2, numbers.data(),
+			wordcount);
 
-	// go back to the start of the file, after the first number
-	infile.seekg(2, ios::beg);
+	// now read the count of numbers in the trailer
+	int trailerSize = (int)numbers[wordcount - 2];
 
 	double number = 0.0;
+	int pcount;
+	int k = 0;
+	m_data.reserve(wordcount / 8);
 	// now read each data number and store
-	while (!infile.eof()) {
+	while (k < wordcount) {
 		if (numbercount - readcount - trailerSize - 1 == 0) {
 			break;
 		} else if (numbercount - readcount - trailerSize - 1< 0) {
@@ -494,21 +515,25 @@ void ScorePageBase::readBinary(istream& infile, int verboseQ) {
 				  << numbercount - readcount - trailerSize - 1
 				  << endl;
 			exit(1);
-		} else {
-			number = readLittleFloat(infile);
-			number = ScoreParameters::roundFractionDigits(number, 3);
-			readcount++;
-			if (verboseQ) {
-				if (number - (int)number > 0.0) {
-					cout << "# Error in number parameter count: " << number << endl;
-					exit(1);
-				}
+		}
+		number = ScoreParameters::roundFractionDigits(numbers[k++], 3);
+		readcount++;
+		if (verboseQ) {
+			if (number - (int)number > 0.0) {
+				cout << "# Error in number parameter count: " << number << endl;
+				exit(1);
 			}
-
-			readcount += (int)number;
-         m_data.resize(m_data.size() + 1);
-			m_data.back()->readBinary(infile, (int)number);
 		}
+		pcount = (int)number;
+		if (k + pcount > wordcount) {
+			cerr << "Error: item extends past end of SCORE data" << endl;
+			exit(1);
+		}
+		readcount += pcount;
+		m_data.push_back(new ScoreRecord);
+		m_data.back()->readBinary(numbers.data() + k, bytes.data() + 2 + 4 * k,
+				pcount);
+		k += pcount;
 	}
 
 	if (verboseQ) {
@@ -516,8 +541,10 @@ void ScorePageBase::readBinary(istream& infile, int verboseQ) {
 		cout << "#READING Trailer: " << endl;
 	}
 
-	while (number != -9999.0 && !infile.eof()) {
-		number = readLittleFloat(infile);
+	trailer.setSize(0);
+	trailer.allowGrowth(1);
+	while ((number != -9999.0) && (k < wordcount)) {
+		number = numbers[k++];
 		trailer.append(number);
 		if (verboseQ) {
 			cout << "#TRAILER NUMBER: " << number << endl;
@@ -908,8 +935,7 @@ ScoreRecord& ScorePageBase::operator[](int index) {
 void ScorePageBase::appendItem(ScoreRecord& aRecord) {
 	invalidateAnalyses();
 
-   m_data.resize(m_data.size());
-	m_data.back() = new ScoreRecord;
+	m_data.push_back(new ScoreRecord);
 	*(m_data.back()) = aRecord;
 }
 
@@ -1066,14 +1092,14 @@ void ScorePageBase::createDefaultPrintSortOrder(void) {
 //
 // ScorePageBase::createLineStaffSequence -- split the page data into
 //      lists of objects divided by staff ownership, and sort each list
-//      by hpos (then by vpos, then by p1 value).
+//      by hpos (then by vpos, then by p1 value).  All items on the page
+//      are sorted at once using a compact array of sort keys ordered by
+//      staff, then each staff list is filled from consecutive keys.
 //
 
 void ScorePageBase::createLineStaffSequence(void) {
 	int i;
 
-	ScorePageBase& thispage = *this;
-
 	// first set the number of staves to 100.  The list will be indexed by
 	// the P2 value of the object (staff 0 will not be used for regular staves).
 	// Currently staff count on a page of 99 or less is allowed.
@@ -1082,37 +1108,41 @@ void ScorePageBase::createLineStaffSequence(void) {
 		lineStaffSequence[i].setSize(0);
 	}
 
-	// count the number of objects on each staff (so that the space
-	// can be preallocated).
+	// extract the sort keys, and count the number of objects on each
+	// staff (so that the space can be preallocated).
+	std::vector<ScoreSortKey> keys;
+	keys.reserve(m_data.size());
 	Array<int> objcount(100);
 	objcount.setAll(0);
-	int staffnum;
-	for (i=0; i<thispage.getSize(); i++) {
-		staffnum = thispage[i].getStaffNumber();
-		if (staffnum < 0 || staffnum >= 100) {
+	ScoreSortKey key;
+	maxStaffNumber = -1;
+	for (i=0; i<(int)m_data.size(); i++) {
+		key.staff = m_data[i]->getStaffNumber();
+		if (key.staff < 0 || key.staff >= 100) {
 			continue;
 		}
-		objcount[staffnum]++;
+		if (key.staff > maxStaffNumber) {
+			maxStaffNumber = key.staff;
+		}
+		key.hpos  = m_data[i]->getHpos();
+		key.vpos  = m_data[i]->getVpos();
+		key.type  = (int)m_data[i]->getValue(P1);
+		key.index = i;
+		keys.push_back(key);
+		objcount[key.staff]++;
 	}
 
-	// pre-allocate space for each staff;
-	for (i=0; i<lineStaffSequence.getSize(); i++) {
-		lineStaffSequence.setSize(objcount[i]);
-		lineStaffSequence.setGrowth(1000);
-		lineStaffSequence.setSize(0);
-	}
+	// Sort each stave from left to right (hpos) and ties from low to high
+	// (vpos), and ties by P1 (object type).
+	std::sort(keys.begin(), keys.end(), ScorePageBase::isStaffKeyLess);
 
 	// split out objects by staff number:
-	maxStaffNumber = -1;
-	for (i=0; i<thispage.getSize(); i++) {
-		staffnum = thispage[i].getStaffNumber();
-		if (staffnum < 0 || staffnum >= 100) {
-			continue;
-		}
-		if (staffnum > maxStaffNumber) {
-			maxStaffNumber = staffnum;
-		}
-		lineStaffSequence[staffnum].append(i);
+	for (i=0; i<lineStaffSequence.getSize(); i++) {
+		lineStaffSequence[i].setSize(objcount[i]);
+		lineStaffSequence[i].setSize(0);
+	}
+	for (i=0; i<(int)keys.size(); i++) {
+		lineStaffSequence[keys[i].staff].append(keys[i].index);
 	}
 
 	// Identify which staves have any data on them and store
@@ -1133,15 +1163,6 @@ void ScorePageBase::createLineStaffSequence(void) {
 		pageStaffListReverse[pageStaffList[i]] = i;
 	}
 
-	// Sort each stave from left to right (hpos) and ties from low to high
-	// (vpos), and ties by P1 (object type).
-	for (i=0; i<lineStaffSequence.getSize(); i++) {
-		if (lineStaffSequence[i].getSize() == 0) {
-			continue;
-		}
-		sortByHpos(lineStaffSequence[i]);
-	}
-
 	sortAnalysisQ = 1;
 }
 
@@ -1149,115 +1170,26 @@ void ScorePageBase::createLineStaffSequence(void) {
 
 //////////////////////////////
 //
-// ScorePageBase::sortByHpos -- Sort a list of data indices by their horizontal
-//    positions on a line (not distinguishing between different lines).
-//
-
-void ScorePageBase::sortByHpos(Array<int>& objects) {
-	ScorePageBase::quickSortByDataIndex(objects, 0, objects.getSize()-1);
-}
-
-
-
-//////////////////////////////
-//
-// ScorePageBase::quickSortByDataIndex -- Called by sortByHpos() and does all
-//    of the actual sorting.  Uses the contents of the data array for
-//    comparison of indices.
+// ScorePageBase::isStaffKeyLess -- Sort keys by staff, then hpos,
+//     then vpos, then (int)P1 value.  Remaining ties are kept in
+//     the order of the page data.
 //
 
-void ScorePageBase::quickSortByDataIndex(Array<int>& indexes,
-		int starti, int endi) {
-	if (starti < endi) {
-		int pivotvalue = indexes[starti];
-		int left = starti - 1;
-		int right = endi + 1;
-
-		for(;;) {
-			while (isGreater(indexes[--right], pivotvalue));
-			while (isLess(indexes[++left], pivotvalue));
-
-			if (left >= right) break;
-
-			int temp = indexes[right];
-			indexes[right] = indexes[left];
-			indexes[left] = temp;
-		}
-
-		int pivot = right;
-		quickSortByDataIndex(indexes, starti, pivot);
-		quickSortByDataIndex(indexes, pivot+1, endi);
-	}
-}
-
-
-
-//////////////////////////////
-//
-// isGreater --  returns true if the hpos of first item is greater
-//     than second item.
-//
-
-int ScorePageBase::isGreater(int a, int b) {
-	// primary sort by hpos
-	if (m_data[a]->getHpos() > m_data[b]->getHpos()) {
-		return 1;
-	} else if (m_data[a]->getHpos() < m_data[b]->getHpos()) {
-		return 0;
-	}
-
-	// ties sorted by vpos
-	if (m_data[a]->getVpos() > m_data[b]->getVpos()) {
-		return 1;
-	} else if (m_data[a]->getVpos() < m_data[b]->getVpos()) {
-		return 0;
+bool ScorePageBase::isStaffKeyLess(const ScoreSortKey& a,
+		const ScoreSortKey& b) {
+	if (a.staff != b.staff) {
+		return a.staff < b.staff;
 	}
-
-	// ties sorted by (int)P1 value
-	if ((int)m_data[a]->getValue(P1) > (int)m_data[b]->getValue(P1)) {
-		return 1;
-	} else if ((int)m_data[a]->getValue(P1) < (int)m_data[b]->getValue(P1)) {
-		return 0;
+	if (a.hpos != b.hpos) {
+		return a.hpos < b.hpos;
 	}
-
-	// same hpos, same vpos, same P1, so determine that two objects are equal
-	// (neither is greater than the other):
-	return 0;
-}
-
-
-
-//////////////////////////////
-//
-// isLess --  returns true if the hpos of first item is less
-//     than second item.
-//
-
-int ScorePageBase::isLess(int a, int b) {
-	// primary sort by hpos
-	if (m_data[a]->getHpos() < m_data[b]->getHpos()) {
-		return 1;
-	} else if (m_data[a]->getHpos() > m_data[b]->getHpos()) {
-		return 0;
-	}
-
-	// ties sorted by vpos
-	if (m_data[a]->getVpos() < m_data[b]->getVpos()) {
-		return 1;
-	} else if (m_data[a]->getVpos() > m_data[b]->getVpos()) {
-		return 0;
+	if (a.vpos != b.vpos) {
+		return a.vpos < b.vpos;
 	}
-
-	// ties sorted by (int)P1 value
-	if ((int)m_data[a]->getValue(P1) < (int)m_data[b]->getValue(P1)) {
-		return 1;
-	} else if ((int)m_data[a]->getValue(P1) > (int)m_data[b]->getValue(P1)) {
-		return 0;
+	if (a.type != b.type) {
+		return a.type < b.type;
 	}
-
-	// same hpos, same vpos, same P1, so determine that two objects are equal
-	// (neither is less than the other):
-	return 0;
+	return a.index < b.index;
 }
 
 
@@ -7,6 +7,8 @@
 // Last Modified: Tue Mar 26 00:52:54 PST 2002 (added staff access data)
 // Last Modified: Tue Mar 31 16:14:05 PST 2009 (updates for winscore version)
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 (renamed SigCollection class)
+// Last Modified: Sun Oct 18 16:13:30 PDT 2026 (block reading, keyed sorting)
+// Last Modified: Sun Oct 18 21:23:18 PDT 2026 (added readFiles, skip ASCII comments)
 // Filename:      ...sig/src/sigInfo/ScorePageBaseSimple.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScorePageBaseSimple.h
 // Syntax:        C++
@@ -16,11 +18,18 @@
 
 #include "ScorePageBaseSimple.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <thread>
+
+#ifdef VISUAL
+   #define strtok_r strtok_s
+#endif
 
 using namespace std;
 
@@ -213,6 +222,55 @@ void ScorePageBaseSimple::readFile(const char* filename, int verboseQ) {
 
 
 
+//////////////////////////////
+//
+// ScorePageBaseSimple::readFiles -- Read a list of SCORE files into
+//     the given pages, using the given number of threads (one file per
+//     thread at a time, 0 = all cores).  The pages vector must be the
+//     same size as the filenames vector.
+//     default value: threads = 1
+//     default value: verboseQ = 0
+//
+
+void ScorePageBaseSimple::readFiles(std::vector<ScorePageBaseSimple*>& pages,
+		const std::vector<std::string>& filenames, int threads, int verboseQ) {
+	int count = (int)filenames.size();
+	if ((int)pages.size() < count) {
+		count = (int)pages.size();
+	}
+	if (threads <= 0) {
+		threads = (int)std::thread::hardware_concurrency();
+	}
+	if (threads > count) {
+		threads = count;
+	}
+	int i;
+	if (threads <= 1) {
+		for (i=0; i<count; i++) {
+			pages[i]->clear();
+			pages[i]->readFile(filenames[i].c_str(), verboseQ);
+		}
+		return;
+	}
+
+	std::atomic<int> nextpage(0);
+	std::vector<std::thread> workers;
+	for (i=0; i<threads; i++) {
+		workers.push_back(std::thread([&]() {
+			int index;
+			while ((index = nextpage++) < count) {
+				pages[index]->clear();
+				pages[index]->readFile(filenames[index].c_str(), verboseQ);
+			}
+		}));
+	}
+	for (i=0; i<(int)workers.size(); i++) {
+		workers[i].join();
+	}
+}
+
+
+
 //////////////////////////////
 //
 // ScorePageBaseSimple::readAscii -- Read data in PMX format from given input
@@ -233,8 +291,11 @@ void ScorePageBaseSimple::readAscii(const char* filename, int verboseQ) {
 	while (!infile.eof()) {
       m_data.resize(m_data.size() + 1);
 		readAsciiScoreLine(infile, m_data.back());
+		if (m_data.back().getFixedSize() == 0) {
+			// not a SCORE item (comment or blank line)
+			m_data.pop_back();
+		}
 	}
-	m_data.resize((int)m_data.size()-1);
 
 	// union { long i; float f; } u;
 	// u.i = 0x50504153;
@@ -497,23 +558,39 @@ void ScorePageBaseSimple::readBinary(const char* filename, int verboseQ) {
 		exit(1);
 	}
 
+	// read the entire page into memory:
+	infile.seekg(0, ios::end);
+	int filesize = (int)infile.tellg();
+	infile.seekg(0, ios::beg);
+	if (filesize < 2 + 4 * 2) {
+		cerr << "Error: SCORE binary data is too short in " << filename << endl;
+		exit(1);
+	}
+	vector<char> bytes(filesize);
+	infile.read(bytes.data(), filesize);
+
 	// first read the number of numbers in the data file.
-	int numbercount = readLittleShort(infile);
+	int numbercount = ((unsigned char)bytes[1] << 8) | (unsigned char)bytes[0];
 	int readcount = 0;   // number of numbers which have been read
 	if (verboseQ) {
 		cout << "; NumberCount = " << numbercount << endl;
 	}
 
-	// now read the number of numbers in the trailer
-	infile.seekg(-8, ios::end);
-	int trailerSize = (int)readLittleFloat(infile);
+	// decode all of the 4-byte numbers after the count:
+	int wordcount = (filesize - 2) / 4;
+	vector<float> numbers(wordcount);
+	ScoreRecord::decodeLittleFloats(bytes.data() + 2, numbers.data(),
+			wordcount);
 
-	// go back to the start of the file, after the first number
-	infile.seekg(2, ios::beg);
+	// now read the number of numbers in the trailer
+	int trailerSize = (int)numbers[wordcount - 2];
 
 	float number = 0;
+	int pcount;
+	int k = 0;
+	m_data.reserve(wordcount / 8);
 	// now read each data number and store
-	while (!infile.eof()) {
+	while (k < wordcount) {
 		if (numbercount - readcount - trailerSize - 1 == 0) {
 			break;
 		} else if (numbercount - readcount - trailerSize - 1< 0) {
@@ -521,20 +598,25 @@ void ScorePageBaseSimple::readBinary(const char* filename, int verboseQ) {
 				  << numbercount - readcount - trailerSize - 1
 				  << endl;
 			exit(1);
-		} else {
-			number = readLittleFloat(infile);
-			readcount++;
-			if (verboseQ) {
-				if (number - (int)number > 0.0) {
-					cout << "; Error in number parameter count: " << number << endl;
-				}
+		}
+		number = numbers[k++];
+		readcount++;
+		if (verboseQ) {
+			if (number - (int)number > 0.0) {
+				cout << "; Error in number parameter count: " << number << endl;
 			}
-
-			readcount += (int)number;
-         // check the following line added when converting to vectors:
-         m_data.resize(m_data.size() + 1);
-			m_data.back().readBinary(infile, (int)number);
 		}
+		pcount = (int)number;
+		if (k + pcount > wordcount) {
+			cerr << "Error: item extends past end of data in " << filename
+				  << endl;
+			exit(1);
+		}
+		readcount += pcount;
+		m_data.resize(m_data.size() + 1);
+		m_data.back().readBinary(numbers.data() + k, bytes.data() + 2 + 4 * k,
+				pcount);
+		k += pcount;
 	}
 
 
@@ -545,8 +627,8 @@ void ScorePageBaseSimple::readBinary(const char* filename, int verboseQ) {
 
 
 
-	while (number != -9999.0 && !infile.eof()) {
-		number = readLittleFloat(infile);
+	while ((number != -9999.0) && (k < wordcount)) {
+		number = numbers[k++];
 		trailer.append(number);
 		if (verboseQ) {
 			cout << "TRAILER NUMBER: " << number << endl;
@@ -726,7 +808,8 @@ void ScorePageBaseSimple::readAsciiScoreLine(istream& infile, ScoreRecord& recor
 
 	record.clear();
 	record.setAllocSize(100);
-	char* ptr = strtok(buffer, "\n\t ");
+	char* state = NULL;
+	char* ptr = strtok_r(buffer, "\n\t ", &state);
 	float number = 0.0;
 	int counter = 0;
 	if (ptr != NULL) {
@@ -734,11 +817,11 @@ void ScorePageBaseSimple::readAsciiScoreLine(istream& infile, ScoreRecord& recor
 			// text parameter
 			number = 16.0;
 			record.setValue(counter++, number);
-			ptr = strtok(NULL, "\n\t ");
+			ptr = strtok_r(NULL, "\n\t ", &state);
 			while (ptr != NULL) {
 				number = (float)strtod(ptr, NULL);
 				record.setValue(counter++, number);
-				ptr = strtok(NULL, "\n\t ");
+				ptr = strtok_r(NULL, "\n\t ", &state);
 			}
 			// now read the text line for a text item
 			infile.getline(buffer, 1000, '\n');
@@ -755,11 +838,11 @@ void ScorePageBaseSimple::readAsciiScoreLine(istream& infile, ScoreRecord& recor
 				return;
 			} else {
 				record.setValue(counter++, number);
-				ptr = strtok(NULL, "\n\t ");
+				ptr = strtok_r(NULL, "\n\t ", &state);
 				while (ptr != NULL) {
 					number = (float)strtod(ptr, NULL);
 					record.setValue(counter++, number);
-					ptr = strtok(NULL, "\n\t ");
+					ptr = strtok_r(NULL, "\n\t ", &state);
 				}
 			}
 		}
@@ -776,7 +859,26 @@ void ScorePageBaseSimple::readAsciiScoreLine(istream& infile, ScoreRecord& recor
 
 int ScorePageBaseSimple::sortByStaff(void) {
 	sortQ = 1;
-	qsort(m_data.data(), m_data.size(), sizeof(ScoreRecord), compareStaff);
+	int size = (int)m_data.size();
+	vector<ScoreSortKey> keys(size);
+	int i;
+	for (i=0; i<size; i++) {
+		keys[i].staff = (int)m_data[i].getPValue(2);
+		keys[i].hpos  = m_data[i].getPValue(3);
+		keys[i].type  = (int)m_data[i].getPValue(1);
+		keys[i].vpos  = m_data[i].getPValue(4);
+		keys[i].index = i;
+	}
+	std::sort(keys.begin(), keys.end(), isStaffKeyLess);
+
+	// reorder the items according to the sorted keys:
+	vector<ScoreRecord> sorted;
+	sorted.reserve(m_data.capacity());
+	for (i=0; i<size; i++) {
+		sorted.push_back(m_data[keys[i].index]);
+	}
+	m_data.swap(sorted);
+
 	return sortQ;
 }
 
@@ -784,45 +886,26 @@ int ScorePageBaseSimple::sortByStaff(void) {
 
 //////////////////////////////
 //
-// ScorePageBaseSimple::compareStaff -- sort staff number, then horizontal position,
-//     then item code, then vertical position
+// ScorePageBaseSimple::isStaffKeyLess -- sort keys by staff number, then
+//     horizontal position, then item code, then vertical position.
+//     Remaining ties are kept in the original order of the items.
 //
 
-int ScorePageBaseSimple::compareStaff(const void* A, const void* B) {
-	ScoreRecord& a = *((ScoreRecord*)A);
-	ScoreRecord& b = *((ScoreRecord*)B);
-
-	if (a.getPValue(2) < b.getPValue(2)) {
-		return -1;
-	} else if (a.getPValue(2) > b.getPValue(2)) {
-		return 1;
+bool ScorePageBaseSimple::isStaffKeyLess(const ScoreSortKey& a,
+		const ScoreSortKey& b) {
+	if (a.staff != b.staff) {
+		return a.staff < b.staff;
 	}
-
-	// staff line tie: resolve by horizontal postion
-	if (a.getPValue(3) < b.getPValue(3)) {
-		return -1;
-	} else if (a.getPValue(3) > b.getPValue(3)) {
-		return 1;
+	if (a.hpos != b.hpos) {
+		return a.hpos < b.hpos;
 	}
-
-	// horizontal postion tie: resolve by code item
-	if (a.getPValue(1) < b.getPValue(1)) {
-		return -1;
-	} else if (a.getPValue(1) > b.getPValue(1)) {
-		return 1;
+	if (a.type != b.type) {
+		return a.type < b.type;
 	}
-
-	// still a tie: sort from lowest vertical postion to highest
-	// vertical position
-	if (a.getPValue(4) < b.getPValue(4)) {
-		return -1;
-	} else if (a.getPValue(4) > b.getPValue(4)) {
-		return 1;
+	if (a.vpos != b.vpos) {
+		return a.vpos < b.vpos;
 	}
-
-	// still a tie: give up and say they are equal
-	return 0;
-
+	return a.index < b.index;
 }
 
 
@@ -6,6 +6,7 @@
 // Last Modified: Sat Mar 21 14:28:55 PST 2009
 // Last Modified: Thu Jul 26 20:46:26 PDT 2012 Fixed text object reading.
 // Last Modified: Fri Aug 24 09:57:53 PDT 2012 Renovated.
+// Last Modified: Sun Oct 18 16:13:30 PDT 2026 Added reading from memory.
 // Filename:      ...sig/src/sigInfo/ScoreRecord.cpp
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScoreRecord.cpp
 // Syntax:        C++
@@ -46,6 +47,9 @@ ScoreRecord::ScoreRecord(void) {
 
 
 ScoreRecord::ScoreRecord(const ScoreRecord& a) {
+	ScoreParameters& sp = *this;
+	sp = a;
+
 	pageIndex         = a.pageIndex;
 	systemLineIndex   = a.systemLineIndex;
 	systemStaffIndex  = a.systemStaffIndex;
@@ -65,9 +69,6 @@ ScoreRecord::ScoreRecord(const ScoreRecord& a) {
 		textFont = new char[strlen(a.textFont)+1];
 		strcpy(textFont, a.textFont);
 	}
-
-
-	// copy ScoreParameter data?
 }
 
 
@@ -542,6 +543,78 @@ void ScoreRecord::readBinary(istream& instream, int pcount) {
 
 
 
+//////////////////////////////
+//
+// ScoreRecord::readBinary -- input parameter values from a block of
+//     SCORE data which has already been read into memory.  The data
+//     array contains the decoded 4-byte numbers starting with P1, and
+//     the bytes array points to the same position in the undecoded file
+//     data (needed for the characters of text items).  The pcount is
+//     the number of 4-byte words in the item (excluding the count itself).
+//
+
+void ScoreRecord::readBinary(const float* data, const char* bytes,
+		int pcount) {
+	int i;
+	if (pcount < 1) {
+		cout << "Error: invalid parameter count: " << pcount << endl;
+		exit(1);
+	}
+
+	if ((int)data[0] == 16) {
+		if (pcount < 13) {
+			cout << "Error: text item has only " << pcount
+			     << " parameters" << endl;
+			exit(1);
+		}
+		setFixedSize(13);
+		setValue(0, data[0]);
+		for (i=1; i<13; i++) {
+			setValue(i, ScoreParameters::roundFractionDigits(data[i], 3));
+		}
+		int count = (int)getPValue(12);
+		if (count > (pcount - 13) * 4) {
+			count = (pcount - 13) * 4;
+		}
+		if (count < 0) {
+			count = 0;
+		}
+		string textdata(bytes + 13 * 4, count);
+		setTextData(textdata.c_str());
+	} else {
+		// non-text data parameters
+		setFixedSize(pcount);
+		for (i=0; i<pcount; i++) {
+			fixedParameters[i] = data[i];
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// ScoreRecord::decodeLittleFloats -- convert a block of 4-byte
+//     little-endian numbers into floats.
+//
+
+void ScoreRecord::decodeLittleFloats(const char* bytes, float* output,
+		int count) {
+	const unsigned char* ptr = (const unsigned char*)bytes;
+	union { float f; unsigned int i; } num;
+	int i;
+	for (i=0; i<count; i++) {
+		num.i = ptr[3];
+		num.i = (num.i << 8) | ptr[2];
+		num.i = (num.i << 8) | ptr[1];
+		num.i = (num.i << 8) | ptr[0];
+		output[i] = num.f;
+		ptr += 4;
+	}
+}
+
+
+
 ///////////////////////////////
 //
 // ScoreRecord::writeLittleEndian --